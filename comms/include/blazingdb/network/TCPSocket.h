@@ -1,4 +1,5 @@
 #pragma once
+#include <atomic>
 #include <cstring>
 #include <functional>
 #include <iostream>
@@ -31,7 +32,7 @@ public:
   }
 
   void run(std::function<void(void *)> handler) {
-    while (context) {
+    while (context && !stopping) {
       if (socket.connected()) {
         handler((void *)&socket);
 
@@ -50,36 +51,63 @@ public:
     context.close();
   }
 
+  /// Makes run return, can be called from any thread. The calls on the socket
+  /// fail with ETERM from then on, so a handler that waits for a message
+  /// returns too. The socket is closed with close once run has returned.
+  void stop() {
+    stopping = true;
+    zmq_ctx_shutdown(static_cast<void *>(context));
+  }
+
 private:
   zmq::context_t context;
   zmq::socket_t socket;
+  std::atomic<bool> stopping{false};
   std::function<void(int)> handler;
 };
 
+/// Client sockets share one ZMQ context, so they do not start their own I/O
+/// thread. The context is never terminated: terminating it would block until
+/// every socket is closed, including the ones still pooled at exit.
+inline zmq::context_t &clientContext() {
+  static zmq::context_t *context = new zmq::context_t(1);
+  return *context;
+}
+
 class TCPClientSocket {
 public:
-  TCPClientSocket(const std::string &tcp_host, int tcp_port) : context(1) {
+  /// @param reply_timeout_ms  how long to wait for a reply before failing, -1
+  ///                          waits forever
+  TCPClientSocket(const std::string &tcp_host, int tcp_port,
+                  int reply_timeout_ms = -1) {
     try {
-      socket = zmq::socket_t(context, ZMQ_REQ);
+      socket = zmq::socket_t(clientContext(), ZMQ_REQ);
       auto connection = "tcp://" + tcp_host + ":" + std::to_string(tcp_port);
       std::cout << "client: " << connection << std::endl;
       int linger = -1;
       socket.setsockopt(ZMQ_LINGER, &linger, sizeof(linger));
+      socket.setsockopt(ZMQ_RCVTIMEO, &reply_timeout_ms,
+                        sizeof(reply_timeout_ms));
+#ifdef ZMQ_HEARTBEAT_IVL
+      // detects dead peers on idle connections kept by the client pool
+      int heartbeat_interval_ms = 1000;
+      int heartbeat_timeout_ms = 10000;
+      socket.setsockopt(ZMQ_HEARTBEAT_IVL, &heartbeat_interval_ms,
+                        sizeof(heartbeat_interval_ms));
+      socket.setsockopt(ZMQ_HEARTBEAT_TIMEOUT, &heartbeat_timeout_ms,
+                        sizeof(heartbeat_timeout_ms));
+#endif
       socket.connect(connection);
     } catch (std::exception &e) {
       std::cerr << e.what() << std::endl;
     }
   }
 
-  void close() {
-    socket.close();
-    context.close();
-  }
+  void close() { socket.close(); }
 
   void *fd() { return (void *)&socket; }
 
 private:
-  zmq::context_t context;
   zmq::socket_t socket;
 };
 
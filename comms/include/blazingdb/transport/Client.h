@@ -1,9 +1,11 @@
 #pragma once
 
+#include <chrono>
 #include <exception>
 #include <memory>
 
 #include "blazingdb/transport/Address.h"
+#include "blazingdb/transport/FlowControl.h"
 #include "blazingdb/transport/Message.h"
 #include "blazingdb/transport/Node.h"
 #include "blazingdb/transport/Status.h"
@@ -17,6 +19,12 @@ public:
 
   virtual Status Send(GPUMessage& message) = 0;
 
+  /// The credit the server granted in its reply to the last Send.
+  virtual Credit LastCredit() = 0;
+
+  /// Asks the server for its credit for the context, without a message.
+  virtual Credit QueryCredit(uint32_t context_token) = 0;
+
   virtual void Close() = 0;
 
   virtual void SetDevice(int) = 0;
@@ -26,11 +34,20 @@ class ClientTCP : public Client {
 public:
   virtual Status Send(GPUMessage& message) = 0;
 
+  virtual Credit LastCredit() = 0;
+
+  virtual Credit QueryCredit(uint32_t context_token) = 0;
+
   virtual void Close() = 0;
 
   virtual void SetDevice(int) = 0;
 
   static std::shared_ptr<Client> Make(const std::string& ip, int16_t port);
+
+  /// The client fails a Send when the reply of the server does not arrive
+  /// within reply_timeout.
+  static std::shared_ptr<Client> Make(const std::string& ip, int16_t port,
+                                      std::chrono::milliseconds reply_timeout);
 };
 
 }  // namespace transport
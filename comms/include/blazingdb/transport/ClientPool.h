@@ -0,0 +1,92 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include "blazingdb/transport/Client.h"
+
+namespace blazingdb {
+namespace transport {
+
+/// \brief Long-lived TCP clients, reused across messages sent to each peer
+///
+/// A client is used by one Send at a time: Send takes an idle client of the
+/// peer (or connects a new one), sends the message and gives the client back,
+/// so concurrent sends to the same peer use different connections. Clients
+/// that fail a Send, for example because the reply did not arrive within the
+/// reply timeout, are closed and the next Send reconnects. Clients idle for
+/// longer than the idle timeout are closed instead of reused.
+class ClientPool {
+public:
+  struct Options {
+    // idle clients kept for each peer, the rest are closed when released
+    std::size_t max_idle_per_peer{16};
+    std::chrono::milliseconds idle_timeout{std::chrono::minutes(5)};
+    std::chrono::milliseconds reply_timeout{std::chrono::minutes(10)};
+  };
+
+  /// The pool used by the RAL to send messages to other nodes.
+  static ClientPool& getInstance();
+
+  ClientPool();
+
+  explicit ClientPool(const Options& options);
+
+  ~ClientPool();
+
+  ClientPool(const ClientPool&) = delete;
+
+  ClientPool& operator=(const ClientPool&) = delete;
+
+public:
+  Status Send(const std::string& ip, int16_t port, GPUMessage& message);
+
+  /// Same as Send, but first waits until the server has credit for the
+  /// buffers of the message in its context, see FlowControl.h. The sends of
+  /// large amounts of data, like the partitions of a shuffle, use it so they
+  /// do not outrun the receiver.
+  Status SendWithCredits(const std::string& ip, int16_t port,
+                         GPUMessage& message);
+
+  /// Number of times SendWithCredits had to wait for credits.
+  std::size_t creditWaits();
+
+  /// Closes the idle clients. The pool can still be used afterwards.
+  void Close();
+
+  std::size_t idleClients();
+
+  /// Number of connections opened since the pool was created.
+  std::size_t connections();
+
+private:
+  using Peer = std::pair<std::string, int16_t>;
+
+  struct IdleClient {
+    std::shared_ptr<Client> client;
+    std::chrono::steady_clock::time_point released;
+  };
+
+  std::shared_ptr<Client> acquire(const Peer& peer);
+
+  void release(const Peer& peer, std::shared_ptr<Client> client);
+
+  // credit_bytes are the bytes taken from the credits of the peer, -1 if the
+  // message does not take credits
+  Status Send(const Peer& peer, GPUMessage& message, int64_t credit_bytes);
+
+private:
+  const Options options_;
+  std::mutex mutex_;
+  std::map<Peer, std::vector<IdleClient>> idle_clients_;
+  std::size_t connections_{0};
+  SendCredits credits_;
+};
+
+}  // namespace transport
+}  // namespace blazingdb
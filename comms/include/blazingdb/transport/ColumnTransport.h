@@ -4,13 +4,58 @@
 namespace blazingdb {
 namespace transport {
 
+/// Version of the layout of a message on the wire. Version 2 made the column
+/// sizes, null counts and buffer sizes 64-bit, version 3 added the codecs of
+/// the buffers, version 4 sends the string columns as dictionaries, version 5
+/// can send the buffers through a shared memory ring and version 6 added the
+/// credits of the flow control.
+constexpr uint32_t WIRE_FORMAT_VERSION = 6;
+constexpr uint32_t WIRE_FORMAT_MAGIC = 0x425a4442;  // "BZDB"
+
+/// What a request asks the server for.
+enum class WireRequest : uint32_t {
+  // deliver the message that follows
+  message = 0,
+  // only reply with the credit of the context for the sender
+  credit = 1,
+};
+
+/// The first part of every message, the server rejects the messages of other
+/// versions instead of misreading them.
+///
+/// The reply of a request the server accepts is "END" followed by the Credit
+/// of the context of the request for its sender, see FlowControl.h.
+struct WireHeader {
+  uint32_t magic{WIRE_FORMAT_MAGIC};
+  uint32_t version{WIRE_FORMAT_VERSION};
+  WireRequest request{WireRequest::message};
+  // context of a credit request, the messages have it in their metadata
+  uint32_t context_token{};
+  // process that sends the request, from getSenderId
+  uint64_t sender{};
+  // name of the SharedMemoryRing of the buffers, empty when they follow the
+  // metadata on the socket
+  char shared_memory_ring[64]{};
+};
+
+/// Start of the reply of a server that can not open the shared memory ring of
+/// a message, the client sends it again through the socket.
+constexpr char SHARED_MEMORY_RING_UNAVAILABLE[] =
+    "shared memory ring unavailable";
+
+/// Compression of a buffer on the wire.
+enum class Codec : int32_t { none = 0, lz4 = 1, zstd = 2 };
+
 struct ColumnTransport {
   struct MetaData {
     int32_t dtype{};
-    int32_t size{};
-    int32_t null_count{};
+    int64_t size{};
+    int64_t null_count{};
     int32_t time_unit{};
     char col_name[128]{};
+    // keys of a string column, which is sent as the int32 codes of its rows
+    // in data and its keys in the strings buffers
+    int64_t dictionary_size{};
   };
   MetaData metadata{};
   int data{};  // position del buffer? / (-1) no hay buffer
@@ -18,7 +63,13 @@ struct ColumnTransport {
   int strings_data{};
   int strings_offsets{};
   int strings_nullmask{};
+  // Codec of each of the buffers above
+  Codec data_codec{};
+  Codec valid_codec{};
+  Codec strings_data_codec{};
+  Codec strings_offsets_codec{};
+  Codec strings_nullmask_codec{};
 };
 
 }  // namespace transport
-}  // namespace blazingdb
\ No newline at end of file
+}  // namespace blazingdb
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <utility>
+#include "blazingdb/transport/Message.h"
+
+namespace blazingdb {
+namespace transport {
+
+/// \brief Credit-based flow control between the nodes
+///
+/// A server counts the bytes of the buffers of the messages it has received
+/// and nobody has retrieved yet, per context and sender process, and grants
+/// each sender the bytes left up to its limit and to the total limit of all
+/// the contexts and senders. The credit goes back to the
+/// sender in every reply, and a sender that waits for credits asks for it
+/// again until the messages are retrieved. So a fast sender can not fill the
+/// memory of a receiver that is busy with something else.
+
+/// Credit of a receiver for one context and sender.
+struct Credit {
+  // bytes the sender can send before it has to wait
+  int64_t available{};
+  // bytes of the sender received and not retrieved yet
+  int64_t outstanding{};
+  // order of the credits of a receiver, an older credit that arrives after a
+  // newer one is ignored
+  uint64_t sequence{};
+};
+
+/// The limit of each context and sender by default, a few partition chunks.
+constexpr int64_t DEFAULT_RECEIVE_CREDIT_LIMIT = int64_t{1} << 30;
+
+/// The limit of all the contexts and senders of a receiver by default, so a
+/// large cluster does not multiply the memory a receiver holds.
+constexpr int64_t DEFAULT_RECEIVE_TOTAL_CREDIT_LIMIT = int64_t{4} << 30;
+
+/// Identifies this process in the credits of the receivers.
+uint64_t getSenderId();
+
+/// \brief Bytes of each context and sender in the queues of a server
+class ReceiveCredits {
+public:
+  explicit ReceiveCredits(
+      int64_t limit = DEFAULT_RECEIVE_CREDIT_LIMIT,
+      int64_t total_limit = DEFAULT_RECEIVE_TOTAL_CREDIT_LIMIT);
+
+  ReceiveCredits(const ReceiveCredits &) = delete;
+
+  ReceiveCredits &operator=(const ReceiveCredits &) = delete;
+
+  /// Bytes of each context and sender, a limit of 0 or less disables the
+  /// flow control.
+  void setLimit(int64_t limit);
+
+  int64_t limit();
+
+  /// Bytes of all the contexts and senders, 0 or less leaves only the limit
+  /// of each of them. A sender with nothing waiting can always send a
+  /// message, so the senders of a full receiver still make progress.
+  void setTotalLimit(int64_t total_limit);
+
+  int64_t totalLimit();
+
+  /// Counts the bytes of a message that has been received, returns the
+  /// credit left afterwards.
+  Credit receive(uint32_t context_token, uint64_t sender, int64_t bytes);
+
+  /// The message received with receive is in the queue, its bytes are given
+  /// back when it is retrieved.
+  void track(const GPUMessage *message, uint32_t context_token,
+             uint64_t sender, int64_t bytes);
+
+  /// Gives back the bytes of a message that was received but never queued.
+  void release(uint32_t context_token, uint64_t sender, int64_t bytes);
+
+  /// Gives back the bytes of a tracked message, does nothing for the others.
+  void retrieved(const GPUMessage *message);
+
+  Credit credit(uint32_t context_token, uint64_t sender);
+
+  /// The messages of the context are gone with its queue.
+  void forgetContext(uint32_t context_token);
+
+private:
+  using Key = std::pair<uint32_t, uint64_t>;
+
+  // Must be called with mutex_ held.
+  Credit creditOf(const Key &key);
+
+  void releaseOf(const Key &key, int64_t bytes);
+
+  std::mutex mutex_;
+  int64_t limit_;
+  int64_t total_limit_;
+  uint64_t sequence_{0};
+  std::map<Key, int64_t> outstanding_;
+  // sum of outstanding_
+  int64_t total_outstanding_{0};
+  std::map<const GPUMessage *, std::pair<Key, int64_t>> tracked_;
+};
+
+/// \brief What a sender knows of the credits of its receivers
+///
+/// Concurrent sends to the same receiver and context share its credit: a send
+/// takes its bytes when it starts and the reply updates the credit.
+class SendCredits {
+public:
+  using Peer = std::pair<std::string, int16_t>;
+
+  /// Asks the receiver for its current credit.
+  using Query = std::function<Credit()>;
+
+  SendCredits() = default;
+
+  SendCredits(const SendCredits &) = delete;
+
+  SendCredits &operator=(const SendCredits &) = delete;
+
+  /// Waits until the receiver has credit for bytes more of the context and
+  /// takes them. A message is always allowed when nothing of the sender is
+  /// waiting in the receiver, however large it is.
+  void acquire(const Peer &peer, uint32_t context_token, int64_t bytes,
+               const Query &query);
+
+  /// Gives back the bytes taken by acquire once the send is over, credit is
+  /// the one of the reply or a default Credit if the send failed.
+  void release(const Peer &peer, uint32_t context_token, int64_t bytes,
+               const Credit &credit);
+
+  /// Records the credit of the reply to a send that did not acquire credits,
+  /// if the credit of the receiver is followed.
+  void update(const Peer &peer, uint32_t context_token, const Credit &credit);
+
+  /// Number of times a send had to wait for credits.
+  std::size_t waits();
+
+private:
+  using Key = std::tuple<std::string, int16_t, uint32_t>;
+
+  struct PeerCredit {
+    Credit credit;
+    bool known{false};
+    // bytes of the sends started and not replied yet
+    int64_t in_flight{0};
+    std::chrono::steady_clock::time_point updated;
+  };
+
+  // Must be called with mutex_ held.
+  bool canSend(const PeerCredit &peer_credit, int64_t bytes);
+
+  void updateOf(PeerCredit &peer_credit, const Credit &credit);
+
+  void forgetIdleCredits();
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::map<Key, PeerCredit> credits_;
+  std::size_t waits_{0};
+};
+
+}  // namespace transport
+}  // namespace blazingdb
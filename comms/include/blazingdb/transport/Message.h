@@ -2,6 +2,8 @@
 
 #include <cassert>
 #include <memory>
+#include <mutex>
+#include <tuple>
 #include <vector>
 #include "ColumnTransport.h"
 #include "blazingdb/transport/Node.h"
@@ -19,7 +21,11 @@ public:
   struct MetaData {
     char messageToken[128]{};  // use  uses '\0' for string ending
     uint32_t contextToken{};
-    int32_t total_row_size{};  // used by SampleToNodeMasterMessage
+    int64_t total_row_size{};  // used by SampleToNodeMasterMessage
+    // A large partition is sent as several messages, each one with a range of
+    // its rows, so the receiver can use them as they arrive
+    int32_t partition_chunk{};
+    int32_t partition_chunks{1};
 
     //    int32_t num_columns{}; // used by: writeBuffersFromGPUTCP,
     //    readBuffersIntoGPUTCP, update everywhere! int32_t num_buffers{};
@@ -63,7 +69,7 @@ protected:
 
 class GPUMessage : public Message {
 public:
-  using raw_buffer = std::tuple<std::vector<int>, std::vector<char *>,
+  using raw_buffer = std::tuple<std::vector<int64_t>, std::vector<char *>,
                                 std::vector<ColumnTransport>>;
 
 public:
@@ -74,6 +80,31 @@ public:
 
   virtual raw_buffer GetRawColumns() = 0;
 
+  /// The buffers of GetRawColumns, computed on the first call and kept for
+  /// the later ones, like the size of the credits of a message and its send.
+  const raw_buffer &rawColumns() {
+    std::lock_guard<std::mutex> lock(rawColumnsMutex_);
+    if (!hasRawColumns_) {
+      rawColumns_ = GetRawColumns();
+      hasRawColumns_ = true;
+    }
+    return rawColumns_;
+  }
+
+  /// The bytes of the buffers of the message.
+  int64_t rawColumnsSize() {
+    int64_t size = 0;
+    for (int64_t bufferSize : std::get<0>(rawColumns())) {
+      size += bufferSize;
+    }
+    return size;
+  }
+
+private:
+  std::mutex rawColumnsMutex_;
+  bool hasRawColumns_{false};
+  raw_buffer rawColumns_;
+
   BZ_INTERFACE(GPUMessage);
 };
 
@@ -1,14 +1,23 @@
 #pragma once
 
+#include <chrono>
 #include <condition_variable>
+#include <deque>
+#include <memory>
 #include <mutex>
 #include <string>
-#include <vector>
+#include <unordered_map>
 #include "blazingdb/transport/Message.h"
 
 namespace blazingdb {
 namespace transport {
 
+/// \brief Messages received for a context, indexed by message token
+///
+/// Each message token has its own FIFO queue and its own condition variable,
+/// so putting a message only wakes up the threads waiting for that token and
+/// getting a message does not look at the messages of other tokens. The
+/// queue of a token is removed once it is empty and nobody waits on it.
 class MessageQueue {
 public:
   MessageQueue() = default;
@@ -24,19 +33,38 @@ public:
   MessageQueue& operator=(const MessageQueue&) = delete;
 
 public:
+  /// Waits until there is a message with the token and returns it.
   std::shared_ptr<GPUMessage> getMessage(const std::string& messageToken);
 
+  /// Waits at most timeout for a message with the token. Returns nullptr if
+  /// no message arrived in time.
+  std::shared_ptr<GPUMessage> getMessage(const std::string& messageToken,
+                                         std::chrono::milliseconds timeout);
+
   void putMessage(std::shared_ptr<GPUMessage>& message);
 
+  /// Number of messages stored and not retrieved yet, of every token.
+  std::size_t size();
+
 private:
-  std::shared_ptr<GPUMessage> getMessageQueue(const std::string& messageToken);
+  struct TokenQueue {
+    std::deque<std::shared_ptr<GPUMessage>> messages;
+    std::condition_variable condition_variable;
+    std::size_t waiters{0};
+  };
+
+  // Both must be called with mutex_ held.
+  std::shared_ptr<GPUMessage> getMessageQueue(const std::string& messageToken,
+                                              TokenQueue& token_queue);
 
   void putMessageQueue(std::shared_ptr<GPUMessage>& message);
 
 private:
   std::mutex mutex_;
-  std::vector<std::shared_ptr<GPUMessage>> message_queue_;
-  std::condition_variable condition_variable_;
+  // TokenQueue holds a condition variable, which can not be moved, so the
+  // queues are kept by pointer to survive rehashing.
+  std::unordered_map<std::string, std::unique_ptr<TokenQueue>> token_queues_;
+  std::size_t size_{0};
 };
 
 }  // namespace transport
@@ -1,11 +1,13 @@
 #pragma once
 
+#include <chrono>
 #include <functional>
 #include <map>
 #include <memory>
 #include <shared_mutex>
 #include <string>
 #include "MessageQueue.h"
+#include "blazingdb/transport/FlowControl.h"
 #include "blazingdb/transport/Message.h"
 
 namespace blazingdb {
@@ -91,6 +93,17 @@ public:
   virtual std::shared_ptr<GPUMessage> getMessage(
       const uint32_t context_token, const std::string &messageToken);
 
+  /**
+   * Same as getMessage, but it waits at most 'timeout' for the message.
+   *
+   * @param context_token  identifier for the message queue using ContextToken.
+   * @param timeout        maximum time to wait for the message.
+   * @return               the message, or nullptr if it did not arrive in time.
+   */
+  virtual std::shared_ptr<GPUMessage> getMessage(
+      const uint32_t context_token, const std::string &messageToken,
+      std::chrono::milliseconds timeout);
+
   /**
    * It stores the message in the message queue and it uses the ContextToken to
    * select the queue. Each message queue works independently. Whether multiple
@@ -108,6 +121,30 @@ public:
   //
   Server::MakeCallback getDeserializationFunction(const std::string &endpoint);
 
+  /**
+   * Limits the bytes of the buffers of the messages of each context and
+   * sender that wait in the queues, the senders wait for credits when their
+   * messages reach it. 0 or less disables the limit.
+   *
+   * @param limit  bytes of each context and sender.
+   */
+  void setReceiveCreditLimit(int64_t limit);
+
+  /**
+   * Limits the bytes of the buffers of the messages of all the contexts and
+   * senders that wait in the queues. 0 or less leaves only the limit of each
+   * context and sender.
+   *
+   * @param limit  bytes of all the contexts and senders.
+   */
+  void setReceiveTotalCreditLimit(int64_t limit);
+
+  /**
+   * The credits of the senders, used by the implementations of the server to
+   * reply to them.
+   */
+  ReceiveCredits &receiveCredits();
+
 protected:
   /**
    * Defined in 'shared_mutex' header file.
@@ -131,6 +168,11 @@ protected:
    */
   std::map<std::string, MakeCallback> deserializer_;
 
+  /**
+   * Bytes of the messages of each context and sender in the queues.
+   */
+  ReceiveCredits receive_credits_;
+
 public:
   /**
    * Static function that creates a TCP server.
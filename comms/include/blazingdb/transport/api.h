@@ -2,6 +2,7 @@
 #include "blazingdb/manager/Context.h"
 #include "blazingdb/transport/Address.h"
 #include "blazingdb/transport/Client.h"
+#include "blazingdb/transport/ClientPool.h"
 #include "blazingdb/transport/Message.h"
 #include "blazingdb/transport/Node.h"
 #include "blazingdb/transport/Server.h"
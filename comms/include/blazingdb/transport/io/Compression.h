@@ -0,0 +1,53 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "blazingdb/transport/ColumnTransport.h"
+
+namespace blazingdb {
+namespace transport {
+namespace io {
+
+/// How the buffers of the messages are compressed. With automatic each buffer
+/// gets the codec that works best on a sample of it: LZ4 when it compresses,
+/// zstd when it compresses clearly better than LZ4, and none otherwise.
+enum class CompressionMode { none, lz4, zstd, automatic };
+
+/// The mode of the messages sent from now on, none by default, the RAL starts
+/// with automatic. The receivers decompress any codec whatever their own mode.
+void setCompressionMode(CompressionMode mode);
+
+CompressionMode getCompressionMode();
+
+/// Buffers smaller than this are sent as they are.
+constexpr std::size_t MIN_COMPRESSED_BUFFER_SIZE = 64 * 1024;
+
+/// Largest size of size bytes compressed with codec.
+std::size_t compressBound(Codec codec, std::size_t size);
+
+/// Compresses size bytes of source into destination, which has room for
+/// capacity bytes. Returns the compressed size, or 0 when it does not fit.
+std::size_t compress(Codec codec, const char *source, std::size_t size,
+                     char *destination, std::size_t capacity);
+
+/// Decompresses compressedSize bytes of source into the size bytes of
+/// destination, throws std::runtime_error if they do not decompress to
+/// exactly size bytes.
+void decompress(Codec codec, const char *source, std::size_t compressedSize,
+                char *destination, std::size_t size);
+
+/// The codec for a buffer in the given mode, sample is a copy of some of its
+/// bytes.
+Codec chooseCodec(CompressionMode mode, const char *sample,
+                  std::size_t sampleSize);
+
+/// The codec of each buffer of a message, indexed like its buffers.
+std::vector<Codec> getBufferCodecs(
+    const std::vector<ColumnTransport> &columnTransport,
+    std::size_t numBuffers);
+
+void setBufferCodecs(std::vector<ColumnTransport> &columnTransport,
+                     const std::vector<Codec> &codecs);
+
+}  // namespace io
+}  // namespace transport
+}  // namespace blazingdb
@@ -0,0 +1,133 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace blazingdb {
+namespace transport {
+namespace io {
+
+struct PinnedBuffer {
+  std::size_t size;
+  char *data;
+};
+
+/// \brief Memory backend of a PinnedBufferProvider
+class BufferAllocator {
+public:
+  virtual ~BufferAllocator() = default;
+
+  virtual char *allocate(std::size_t size) = 0;
+
+  virtual void deallocate(char *data, std::size_t size) = 0;
+};
+
+/// Page-locked host memory, from cudaMallocHost.
+std::unique_ptr<BufferAllocator> makePinnedAllocator();
+
+/// Plain host memory, for tests and hosts without CUDA.
+std::unique_ptr<BufferAllocator> makeHostAllocator();
+
+/// \brief Pool of the host buffers that stage the transfers between the GPU
+/// and the sockets
+///
+/// The buffers come in size classes, getBuffer(size) returns a buffer of the
+/// smallest class that fits. Freed buffers are kept for the next messages.
+/// The buffers allocated, idle or in use, never take more than the memory
+/// limit: when a new buffer does not fit the idle buffers of the other classes
+/// are released, and when there are none getBuffer waits until a buffer is
+/// freed. It can be used from any thread.
+class PinnedBufferProvider {
+public:
+  struct Stats {
+    std::size_t buffers_in_use{0};
+    std::size_t bytes_in_use{0};
+    // highest bytes_in_use so far
+    std::size_t high_water_bytes{0};
+    std::size_t bytes_allocated{0};
+    std::size_t allocations{0};
+    // getBuffer calls that had to wait for a buffer to be freed
+    std::size_t waits{0};
+  };
+
+  /// Pinned buffers of up to sizeBuffers bytes, with numBuffers of them
+  /// allocated up front. The memory limit is max(numBuffers, 2) * sizeBuffers.
+  PinnedBufferProvider(std::size_t sizeBuffers, std::size_t numBuffers);
+
+  /// @param sizeClasses  sizes of the buffers, in any order.
+  /// @param memoryLimit  at least twice the largest size class.
+  PinnedBufferProvider(std::vector<std::size_t> sizeClasses,
+                       std::size_t memoryLimit,
+                       std::unique_ptr<BufferAllocator> allocator);
+
+  ~PinnedBufferProvider();
+
+  PinnedBufferProvider(const PinnedBufferProvider &) = delete;
+
+  PinnedBufferProvider &operator=(const PinnedBufferProvider &) = delete;
+
+  /// A buffer of the largest size class.
+  PinnedBuffer *getBuffer();
+
+  /// A buffer of the smallest size class with at least size bytes, size can
+  /// not be larger than sizeBuffers().
+  PinnedBuffer *getBuffer(std::size_t size);
+
+  /// Same as getBuffer(size), but returns nullptr instead of waiting.
+  PinnedBuffer *tryGetBuffer(std::size_t size);
+
+  void freeBuffer(PinnedBuffer *buffer);
+
+  /// The largest size class, which is the size of the chunks the buffers are
+  /// transferred in.
+  std::size_t sizeBuffers();
+
+  std::size_t memoryLimit();
+
+  /// Allocates idle buffers of the largest size class until there are
+  /// numBuffers of them or the memory limit is reached.
+  void reserve(std::size_t numBuffers);
+
+  /// Releases the idle buffers.
+  void freeAll();
+
+  Stats stats();
+
+  /// Buffers that stay in use until a whole message is sent, like the ones
+  /// lent to ZMQ, must fit in a budget of half the memory limit, so the rest
+  /// of the pool keeps moving. tryLend reserves size bytes of that budget and
+  /// returns false if they do not fit, endLend gives them back.
+  bool tryLend(std::size_t size);
+
+  void endLend(std::size_t size);
+
+private:
+  PinnedBuffer *getBuffer(std::size_t size, bool wait);
+
+  // must be called with the mutex held
+  bool releaseIdleBuffer(std::size_t keepClass);
+
+  std::unique_ptr<BufferAllocator> allocator;
+
+  // ascending
+  std::vector<std::size_t> sizeClasses;
+
+  // idle buffers of each size class
+  std::vector<std::vector<PinnedBuffer *>> buffers;
+
+  std::size_t limit;
+
+  std::size_t lentBytes{0};
+
+  Stats counters;
+
+  std::mutex inUseMutex;
+
+  std::condition_variable cv;
+};
+
+}  // namespace io
+}  // namespace transport
+}  // namespace blazingdb
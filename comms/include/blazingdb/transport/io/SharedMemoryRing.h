@@ -0,0 +1,134 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace blazingdb {
+namespace transport {
+namespace io {
+
+/// \brief Ring of bytes in POSIX shared memory, from one producer process to
+/// one consumer process
+///
+/// The producer reserves regions of the ring, fills them and commits them in
+/// order; the consumer waits for them to be committed, reads them and releases
+/// them in order. Both sides only share two counters of bytes in the ring, so
+/// a region is never copied between them and no system call is made unless
+/// one side has to wait for the other.
+///
+/// The positions of the regions grow forever, their offset in the ring is the
+/// position modulo the capacity. A region never wraps around the end of the
+/// ring: when it does not fit before the end it starts at the beginning, so
+/// both sides can compute the positions of the same sequence of regions.
+class SharedMemoryRing {
+public:
+  /// Creates the ring named name (a shm_open name, "/" and at most 250
+  /// characters), with capacity bytes of data. The ring is unlinked when it
+  /// is destroyed, the processes that opened it keep it until they close it.
+  static std::unique_ptr<SharedMemoryRing> create(const std::string &name,
+                                                  std::size_t capacity);
+
+  /// Opens the ring created by another process.
+  static std::unique_ptr<SharedMemoryRing> open(const std::string &name);
+
+  ~SharedMemoryRing();
+
+  SharedMemoryRing(const SharedMemoryRing &) = delete;
+
+  SharedMemoryRing &operator=(const SharedMemoryRing &) = delete;
+
+  const std::string &name() const { return name_; }
+
+  std::size_t capacity() const { return capacity_; }
+
+  /// The data of the ring, page aligned.
+  char *data() { return data_; }
+
+  char *data(uint64_t position) { return data_ + position % capacity_; }
+
+  /// Position of the next region of size bytes after the region that ends at
+  /// end.
+  uint64_t nextPosition(uint64_t end, std::size_t size) const;
+
+  // Producer
+
+  /// Reserves the next size bytes, returns their position or -1 if the
+  /// consumer has not released enough bytes yet. size can be at most half the
+  /// capacity.
+  int64_t tryReserve(std::size_t size);
+
+  /// Same as tryReserve, but waits for at most timeout for the consumer.
+  /// Throws std::runtime_error when the time runs out.
+  uint64_t reserve(std::size_t size, std::chrono::milliseconds timeout);
+
+  /// Makes every reserved byte before end visible to the consumer.
+  void commit(uint64_t end);
+
+  /// Tells the consumer that the producer is gone, it can close the ring.
+  void markClosed();
+
+  // Consumer
+
+  /// Waits for at most timeout until every byte before end is committed.
+  /// Throws std::runtime_error when the time runs out or the producer closes
+  /// the ring first.
+  void waitCommitted(uint64_t end, std::chrono::milliseconds timeout);
+
+  /// Gives every byte before end back to the producer.
+  void release(uint64_t end);
+
+  /// End of the bytes released so far, where the next message starts.
+  uint64_t released() const;
+
+  bool isClosed() const;
+
+private:
+  struct Header;
+
+  SharedMemoryRing(const std::string &name, bool owner, Header *header,
+                   std::size_t mappedSize);
+
+  const std::string name_;
+  const bool owner_;
+  Header *header_;
+  const std::size_t mappedSize_;
+  const std::size_t capacity_;
+  char *data_;
+  // end of the last region reserved by the producer
+  uint64_t reserved_{0};
+};
+
+/// Whether ip is an address of this host, so a peer at ip can be reached
+/// through shared memory.
+bool isLocalAddress(const std::string &ip);
+
+/// Whether the messages to the peers of this host go through shared memory,
+/// true by default.
+void setSharedMemoryTransport(bool enabled);
+
+bool isSharedMemoryTransport();
+
+/// Capacity of the ring of each client, 32 MB by default. It only affects the
+/// rings created from now on.
+void setSharedMemoryRingSize(std::size_t size);
+
+std::size_t getSharedMemoryRingSize();
+
+/// Most rings the clients of this process keep at the same time, 8 by
+/// default, so the pinned memory of the rings is bounded however many clients
+/// the pool opens. A client that finds them all taken sends through TCP.
+void setSharedMemoryRingLimit(std::size_t limit);
+
+std::size_t getSharedMemoryRingLimit();
+
+/// Takes one of the rings of the limit, false when all of them are taken.
+bool acquireSharedMemoryRing();
+
+/// Gives back a ring taken with acquireSharedMemoryRing.
+void releaseSharedMemoryRing();
+
+}  // namespace io
+}  // namespace transport
+}  // namespace blazingdb
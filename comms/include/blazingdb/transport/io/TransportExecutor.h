@@ -0,0 +1,94 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace blazingdb {
+namespace transport {
+namespace io {
+
+/// \brief Threads shared by all the transfers of the process
+///
+/// The copy workers move chunks between the GPU and the staging buffers and
+/// the socket workers run whole sends to other nodes. Tasks wait in a FIFO
+/// queue for a worker of their kind, so no thread is created per buffer,
+/// chunk or destination. Copy tasks must not wait for other tasks, socket
+/// tasks can wait for copy tasks but not for other socket tasks.
+class TransportExecutor {
+public:
+  TransportExecutor(std::size_t numCopyWorkers, std::size_t numSocketWorkers);
+
+  ~TransportExecutor();
+
+  TransportExecutor(const TransportExecutor &) = delete;
+
+  TransportExecutor &operator=(const TransportExecutor &) = delete;
+
+  template <typename Function>
+  std::future<typename std::result_of<Function()>::type> submitCopy(
+      Function func) {
+    return submit(copyQueue, std::move(func));
+  }
+
+  template <typename Function>
+  std::future<typename std::result_of<Function()>::type> submitSocket(
+      Function func) {
+    return submit(socketQueue, std::move(func));
+  }
+
+  std::size_t numCopyWorkers() const { return copyQueue.workers.size(); }
+
+  std::size_t numSocketWorkers() const { return socketQueue.workers.size(); }
+
+private:
+  struct WorkQueue {
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool stopped{false};
+  };
+
+  template <typename Function>
+  std::future<typename std::result_of<Function()>::type> submit(
+      WorkQueue &queue, Function func) {
+    using result_type = typename std::result_of<Function()>::type;
+
+    auto task =
+        std::make_shared<std::packaged_task<result_type()>>(std::move(func));
+    std::future<result_type> result = task->get_future();
+    enqueue(queue, [task]() { (*task)(); });
+    return result;
+  }
+
+  static void enqueue(WorkQueue &queue, std::function<void()> task);
+
+  static void startWorkers(WorkQueue &queue, std::size_t numWorkers);
+
+  static void stopWorkers(WorkQueue &queue);
+
+  static void runWorker(WorkQueue &queue);
+
+  WorkQueue copyQueue;
+
+  WorkQueue socketQueue;
+};
+
+/// The executor used by the transfers, created with the default number of
+/// workers on first use.
+TransportExecutor &getTransportExecutor();
+
+/// Replaces the executor, it must be called before any transfer starts.
+void setTransportExecutor(std::size_t numCopyWorkers,
+                          std::size_t numSocketWorkers);
+
+}  // namespace io
+}  // namespace transport
+}  // namespace blazingdb
@@ -3,6 +3,7 @@
 #include <mutex>
 #include <stack>
 #include <vector>
+#include <zmq.hpp>
 #include "blazingdb/transport/ColumnTransport.h"
 
 namespace blazingdb {
@@ -16,6 +17,17 @@ size_t readFromSocket(void* fileDescriptor, char* buf, size_t nbyte);
 size_t writeToSocket(void* fileDescriptor, char* buf, size_t nbyte,
                      bool more = true);
 
+/// Sends nbyte of buf without copying them. ZMQ calls free_function(buf, hint)
+/// from one of its threads once it does not need buf anymore, which can be
+/// after this function returns. free_function is also called if the send
+/// fails.
+size_t writeToSocket(void* fileDescriptor, char* buf, size_t nbyte,
+                     zmq_free_fn* free_function, void* hint, bool more = true);
+
+/// Receives the next message part, its data is read in place instead of being
+/// copied out of the message. The message is empty if the receive fails.
+zmq::message_t readMessageFromSocket(void* fileDescriptor);
+
 }  // namespace io
 }  // namespace transport
 }  // namespace blazingdb
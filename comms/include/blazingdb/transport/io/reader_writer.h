@@ -1,55 +1,72 @@
 #pragma once
-#include <condition_variable>
-#include <mutex>
-#include <stack>
+#include <chrono>
+#include <memory>
 #include <vector>
 #include "blazingdb/transport/ColumnTransport.h"
+#include "blazingdb/transport/io/Compression.h"
+#include "blazingdb/transport/io/PinnedBufferProvider.h"
+#include "blazingdb/transport/io/SharedMemoryRing.h"
 
 namespace blazingdb {
 namespace transport {
 namespace io {
 
-struct PinnedBuffer {
-  std::size_t size;
-  char *data;
-};
-
-class PinnedBufferProvider {
-public:
-  PinnedBufferProvider(std::size_t sizeBuffers, std::size_t numBuffers);
-
-  PinnedBuffer *getBuffer();
-
-  void freeBuffer(PinnedBuffer *buffer);
-
-  std::size_t sizeBuffers();
-
-  void freeAll();
-
-private:
-  void grow();
+// Memory Pool
+PinnedBufferProvider &getPinnedBufferProvider();
 
-  std::condition_variable cv;
+void setPinnedBufferProvider(std::size_t sizeBuffers, std::size_t numBuffers);
 
-  std::mutex inUseMutex;
+void setPinnedBufferProvider(std::shared_ptr<PinnedBufferProvider> provider);
 
-  std::stack<PinnedBuffer *> buffers;
+/// In zero-copy mode (the default) the pinned chunks are handed to ZMQ as they
+/// are instead of being copied into ZMQ messages, and the received chunks are
+/// copied to the GPU straight from the ZMQ messages.
+void setZeroCopy(bool enabled);
 
-  std::size_t bufferSize;
-};
-// Memory Pool
-PinnedBufferProvider &getPinnedBufferProvider();
+bool isZeroCopy();
 
-void setPinnedBufferProvider(std::size_t sizeBuffers, std::size_t numBuffers);
+/// The codec of each buffer in the current compression mode, to record in the
+/// ColumnTransport of the message with setBufferCodecs before it is written.
+/// Copies a sample of each buffer that may be compressed from the GPU.
+std::vector<Codec> chooseBufferCodecs(const std::vector<int64_t> &bufferSizes,
+                                      const std::vector<char *> &buffers,
+                                      int gpuNum);
 
-std::vector<char *> readBuffersIntoGPUTCP(std::vector<int> bufferSizes,
-                                          void *fileDescriptor, int gpuNum);
+/// Reads the buffers written by writeBuffersFromGPUTCP, column_transport
+/// gives their codecs.
+std::vector<char *> readBuffersIntoGPUTCP(
+    const std::vector<ColumnTransport> &column_transport,
+    std::vector<int64_t> bufferSizes, void *fileDescriptor, int gpuNum);
 
 void writeBuffersFromGPUTCP(std::vector<ColumnTransport> &column_transport,
-                            std::vector<int> bufferSizes,
+                            std::vector<int64_t> bufferSizes,
                             std::vector<char *> buffers, void *fileDescriptor,
                             int gpuNum);
 
+/// Registers the data of the ring with CUDA, so the copies between the GPU
+/// and the ring are DMA transfers. The ring stays usable if it can not be
+/// registered, only slower.
+void pinSharedMemoryRing(SharedMemoryRing &ring);
+
+/// Must be called before a pinned ring is destroyed.
+void unpinSharedMemoryRing(SharedMemoryRing &ring);
+
+/// Copies the buffers from the GPU into the ring, in chunks of a quarter of
+/// the ring that are committed as they are copied. Only the metadata of the
+/// message goes through the socket, whose reply is the sign that the reader
+/// gave up on the message: returns false if the reply arrives before all the
+/// buffers have been written, then the ring can not be used again.
+bool writeBuffersToSharedMemory(SharedMemoryRing &ring,
+                                const std::vector<int64_t> &bufferSizes,
+                                const std::vector<char *> &buffers,
+                                void *fileDescriptor, int gpuNum,
+                                std::chrono::milliseconds timeout);
+
+/// Reads the buffers written by writeBuffersToSharedMemory into the GPU.
+std::vector<char *> readBuffersFromSharedMemory(
+    SharedMemoryRing &ring, const std::vector<int64_t> &bufferSizes,
+    int gpuNum, std::chrono::milliseconds timeout);
+
 }  // namespace io
 }  // namespace transport
 }  // namespace blazingdb
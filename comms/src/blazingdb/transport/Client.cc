@@ -1,10 +1,14 @@
 #include "blazingdb/transport/Client.h"
 #include <cuda_runtime_api.h>
+#include <unistd.h>
+#include <atomic>
+#include <cstring>
 #include <map>
 #include <numeric>
 #include "blazingdb/network/TCPSocket.h"
 #include "blazingdb/transport/ColumnTransport.h"
 #include "blazingdb/transport/Status.h"
+#include "blazingdb/transport/io/SharedMemoryRing.h"
 #include "blazingdb/transport/io/reader_writer.h"
 
 namespace blazingdb {
@@ -31,34 +35,138 @@ private:
 };
 
 template <typename MetadataType>
-void write_metadata(void* file_descriptor, const MetadataType& metadata) {
+void write_metadata(void* file_descriptor, const MetadataType& metadata,
+                    bool more = true) {
   blazingdb::transport::io::writeToSocket(file_descriptor, (char*)&metadata,
-                                          sizeof(MetadataType));
+                                          sizeof(MetadataType), more);
 }
 
 class ConcreteClientTCP : public ClientTCP {
 public:
-  ConcreteClientTCP(const std::string& ip, int16_t port)
-      : client_socket{ip, port} {}
-  void Close() override { client_socket.close(); }
+  ConcreteClientTCP(const std::string& ip, int16_t port, int reply_timeout_ms)
+      : client_socket{ip, port, reply_timeout_ms},
+        reply_timeout_ms{reply_timeout_ms},
+        shared_memory{io::isSharedMemoryTransport() &&
+                      io::isLocalAddress(ip)} {}
+
+  ~ConcreteClientTCP() { closeSharedMemoryRing(); }
+
+  void Close() override {
+    client_socket.close();
+    closeSharedMemoryRing();
+  }
 
   void SetDevice(int gpuId) override { this->gpuId = gpuId; }
 
   Status Send(GPUMessage& message) override {
+    // send message content (gpu buffers)
+    std::vector<int64_t> buffer_sizes;
+    std::vector<char*> buffers;
+    std::vector<ColumnTransport> column_offsets;
+    std::tie(buffer_sizes, buffers, column_offsets) = message.rawColumns();
+
+    io::SharedMemoryRing* ring = sharedMemoryRing();
+    if (ring != nullptr) {
+      std::string reply = SendThroughSharedMemory(
+          *ring, message, buffer_sizes, buffers, column_offsets);
+      if (reply == "END") {
+        return Status{true};
+      }
+      // the positions of the ring are unknown after a failure
+      closeSharedMemoryRing();
+      if (reply.compare(0, sizeof(SHARED_MEMORY_RING_UNAVAILABLE) - 1,
+                        SHARED_MEMORY_RING_UNAVAILABLE) != 0) {
+        throw std::runtime_error(
+            "transport::Client: the server rejected the message: " + reply);
+      }
+      // the peer does not share the shared memory of this process, e.g. it
+      // runs in another container
+      shared_memory = false;
+    }
+
     void* fd = client_socket.fd();
-    auto node = message.getSenderNode();
-    auto message_metadata = message.metadata();
+    blazingdb::transport::io::setBufferCodecs(
+        column_offsets, blazingdb::transport::io::chooseBufferCodecs(
+                            buffer_sizes, buffers, gpuId));
+    WireHeader header;
+    header.sender = getSenderId();
+    write_metadata(fd, header);
+    writeMetadata(message, buffer_sizes, column_offsets, true);
+    blazingdb::transport::io::writeBuffersFromGPUTCP(
+        column_offsets, buffer_sizes, buffers, fd, gpuId);
+    blazingdb::transport::io::writeToSocket(fd, "OK", 2, false);
+
+    std::string end_message = receiveReply();
+    if (end_message != "END") {
+      throw std::runtime_error(
+          "transport::Client: the server rejected the message: " +
+          end_message);
+    }
+    return Status{true};
+  }
+
+  Credit LastCredit() override { return last_credit; }
+
+  Credit QueryCredit(uint32_t context_token) override {
+    WireHeader header;
+    header.request = WireRequest::credit;
+    header.context_token = context_token;
+    header.sender = getSenderId();
+    write_metadata(client_socket.fd(), header, false);
+    std::string reply = receiveReply();
+    if (reply != "END") {
+      throw std::runtime_error(
+          "transport::Client: the server rejected the credit request: " +
+          reply);
+    }
+    return last_credit;
+  }
+
+protected:
+  // The ring of this client, created with the first message. nullptr when the
+  // peer is on another host, the ring can not be created or the other clients
+  // of this process already keep every ring of the limit; in the last case the
+  // next message tries again.
+  io::SharedMemoryRing* sharedMemoryRing() {
+    if (!shared_memory || ring != nullptr) {
+      return ring.get();
+    }
+    if (!io::acquireSharedMemoryRing()) {
+      return nullptr;
+    }
+    static std::atomic<int> ring_counter{0};
+    const std::string name = "/blazingdb-" + std::to_string(getpid()) + "-" +
+                             std::to_string(ring_counter++);
+    try {
+      ring = io::SharedMemoryRing::create(name,
+                                          io::getSharedMemoryRingSize());
+    } catch (const std::exception& exception) {
+      std::cerr << "Client: " << exception.what() << std::endl;
+      io::releaseSharedMemoryRing();
+      shared_memory = false;
+      return nullptr;
+    }
+    io::pinSharedMemoryRing(*ring);
+    return ring.get();
+  }
 
+  void closeSharedMemoryRing() {
+    if (ring != nullptr) {
+      io::unpinSharedMemoryRing(*ring);
+      ring.reset();
+      io::releaseSharedMemoryRing();
+    }
+  }
+
+  void writeMetadata(GPUMessage& message,
+                     const std::vector<int64_t>& buffer_sizes,
+                     const std::vector<ColumnTransport>& column_offsets,
+                     bool more) {
+    void* fd = client_socket.fd();
     // send message metadata
-    write_metadata(fd, message_metadata);
+    write_metadata(fd, message.metadata());
     // send address metadata
-    write_metadata(fd, node->address()->metadata());
-
-    // send message content (gpu buffers)
-    std::vector<int> buffer_sizes;
-    std::vector<char*> buffers;
-    std::vector<ColumnTransport> column_offsets;
-    std::tie(buffer_sizes, buffers, column_offsets) = message.GetRawColumns();
+    write_metadata(fd, message.getSenderNode()->address()->metadata());
 
     write_metadata(fd, (int32_t)column_offsets.size());
     blazingdb::transport::io::writeToSocket(
@@ -66,43 +174,81 @@ public:
         sizeof(ColumnTransport) * column_offsets.size());
 
     write_metadata(fd, (int32_t)buffer_sizes.size());
-    blazingdb::transport::io::writeToSocket(fd, (char*)buffer_sizes.data(),
-                                            sizeof(int) * buffer_sizes.size());
-
-    blazingdb::transport::io::writeBuffersFromGPUTCP(
-        column_offsets, buffer_sizes, buffers, fd, gpuId);
-    blazingdb::transport::io::writeToSocket(fd, "OK", 2, false);
-
-    zmq::socket_t* socket_ptr = (zmq::socket_t*)fd;
+    blazingdb::transport::io::writeToSocket(
+        fd, (char*)buffer_sizes.data(), sizeof(int64_t) * buffer_sizes.size(),
+        more);
+  }
 
-    int data_past_topic{0};
-    auto data_past_topic_size{sizeof(data_past_topic)};
-    socket_ptr->getsockopt(ZMQ_RCVMORE, &data_past_topic,
-                           &data_past_topic_size);
-    if (data_past_topic == 0 || data_past_topic_size == 0) {
-      std::cerr << "Client: No data inside message." << std::endl;
+  // The request is only the metadata, the server reads the buffers from the
+  // ring while they are copied into it and replies once it has all of them.
+  std::string SendThroughSharedMemory(
+      io::SharedMemoryRing& ring, GPUMessage& message,
+      const std::vector<int64_t>& buffer_sizes,
+      const std::vector<char*>& buffers,
+      const std::vector<ColumnTransport>& column_offsets) {
+    void* fd = client_socket.fd();
+    WireHeader header;
+    header.sender = getSenderId();
+    std::strncpy(header.shared_memory_ring, ring.name().c_str(),
+                 sizeof(header.shared_memory_ring) - 1);
+    write_metadata(fd, header);
+    writeMetadata(message, buffer_sizes, column_offsets, false);
+    try {
+      blazingdb::transport::io::writeBuffersToSharedMemory(
+          ring, buffer_sizes, buffers, fd, gpuId,
+          std::chrono::milliseconds(reply_timeout_ms));
+    } catch (...) {
+      closeSharedMemoryRing();
+      throw;
     }
+    // when the server gives up on the message its reply arrives early
+    return receiveReply();
+  }
+
+  // The reply and the credit that follows it when the server accepted the
+  // request
+  std::string receiveReply() {
+    zmq::socket_t* socket_ptr = (zmq::socket_t*)client_socket.fd();
+    last_credit = Credit{};
     // receive the ok
     zmq::message_t local_message;
     auto success = socket_ptr->recv(local_message);
-    if (success.value() == false || local_message.size() == 0) {
+    if (!success || local_message.size() == 0) {
       std::cerr << "Client:   throw zmq::error_t()" << std::endl;
       throw zmq::error_t();
     }
-
-    std::string end_message(static_cast<char*>(local_message.data()),
-                            local_message.size());
-    assert(end_message == "END");
-    return Status{true};
+    std::string reply(static_cast<char*>(local_message.data()),
+                      local_message.size());
+
+    int more{0};
+    auto more_size{sizeof(more)};
+    socket_ptr->getsockopt(ZMQ_RCVMORE, &more, &more_size);
+    if (more) {
+      zmq::message_t credit_message = io::readMessageFromSocket(socket_ptr);
+      if (credit_message.size() == sizeof(Credit)) {
+        memcpy(&last_credit, credit_message.data(), sizeof(Credit));
+      }
+    }
+    return reply;
   }
 
-protected:
   blazingdb::network::TCPClientSocket client_socket;
   int gpuId{0};
+  const int reply_timeout_ms;
+  bool shared_memory;
+  std::unique_ptr<io::SharedMemoryRing> ring;
+  Credit last_credit;
 };
 
 std::shared_ptr<Client> ClientTCP::Make(const std::string& ip, int16_t port) {
-  return std::shared_ptr<Client>(new ConcreteClientTCP(ip, port));
+  return std::shared_ptr<Client>(new ConcreteClientTCP(ip, port, -1));
+}
+
+std::shared_ptr<Client> ClientTCP::Make(
+    const std::string& ip, int16_t port,
+    std::chrono::milliseconds reply_timeout) {
+  return std::shared_ptr<Client>(new ConcreteClientTCP(
+      ip, port, static_cast<int>(reply_timeout.count())));
 }
 
 }  // namespace transport
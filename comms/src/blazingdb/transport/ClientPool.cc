@@ -0,0 +1,151 @@
+#include "blazingdb/transport/ClientPool.h"
+
+namespace blazingdb {
+namespace transport {
+
+ClientPool& ClientPool::getInstance() {
+  // never destroyed, the RAL closes the connections with Close
+  static ClientPool* pool = new ClientPool();
+  return *pool;
+}
+
+ClientPool::ClientPool() : ClientPool(Options{}) {}
+
+ClientPool::ClientPool(const Options& options) : options_{options} {}
+
+ClientPool::~ClientPool() { Close(); }
+
+Status ClientPool::Send(const std::string& ip, int16_t port,
+                        GPUMessage& message) {
+  return Send(Peer{ip, port}, message, -1);
+}
+
+Status ClientPool::SendWithCredits(const std::string& ip, int16_t port,
+                                   GPUMessage& message) {
+  const Peer peer{ip, port};
+  const int64_t bytes = message.rawColumnsSize();
+  const uint32_t context_token = message.getContextTokenValue();
+  credits_.acquire(peer, context_token, bytes, [this, &peer, context_token]() {
+    std::shared_ptr<Client> client = acquire(peer);
+    Credit credit;
+    try {
+      credit = client->QueryCredit(context_token);
+    } catch (...) {
+      client->Close();
+      throw;
+    }
+    release(peer, std::move(client));
+    return credit;
+  });
+  return Send(peer, message, bytes);
+}
+
+std::size_t ClientPool::creditWaits() { return credits_.waits(); }
+
+Status ClientPool::Send(const Peer& peer, GPUMessage& message,
+                        int64_t credit_bytes) {
+  const uint32_t context_token = message.getContextTokenValue();
+  std::shared_ptr<Client> client = acquire(peer);
+
+  Status status{false};
+  try {
+    status = client->Send(message);
+  } catch (...) {
+    if (credit_bytes >= 0) {
+      credits_.release(peer, context_token, credit_bytes, Credit{});
+    }
+    // the state of a REQ socket is unknown after a failed request
+    client->Close();
+    throw;
+  }
+  if (credit_bytes >= 0) {
+    credits_.release(peer, context_token, credit_bytes, client->LastCredit());
+  } else {
+    // the messages sent without credits count in the receiver too
+    credits_.update(peer, context_token, client->LastCredit());
+  }
+
+  if (status.IsOk()) {
+    release(peer, std::move(client));
+  } else {
+    client->Close();
+  }
+  return status;
+}
+
+void ClientPool::Close() {
+  std::map<Peer, std::vector<IdleClient>> idle_clients;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    idle_clients.swap(idle_clients_);
+  }
+  for (auto& peer_clients : idle_clients) {
+    for (auto& idle_client : peer_clients.second) {
+      idle_client.client->Close();
+    }
+  }
+}
+
+std::size_t ClientPool::idleClients() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::size_t count = 0;
+  for (const auto& peer_clients : idle_clients_) {
+    count += peer_clients.second.size();
+  }
+  return count;
+}
+
+std::size_t ClientPool::connections() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return connections_;
+}
+
+std::shared_ptr<Client> ClientPool::acquire(const Peer& peer) {
+  std::vector<std::shared_ptr<Client>> expired;
+  std::shared_ptr<Client> client;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = idle_clients_.find(peer);
+    if (it != idle_clients_.end()) {
+      const auto now = std::chrono::steady_clock::now();
+      auto& clients = it->second;
+      // the most recently released is at the back
+      while (!clients.empty()) {
+        IdleClient idle_client = std::move(clients.back());
+        clients.pop_back();
+        if (now - idle_client.released < options_.idle_timeout) {
+          client = std::move(idle_client.client);
+          break;
+        }
+        expired.push_back(std::move(idle_client.client));
+      }
+    }
+    if (!client) {
+      connections_++;
+    }
+  }
+
+  for (auto& expired_client : expired) {
+    expired_client->Close();
+  }
+  if (!client) {
+    client = ClientTCP::Make(peer.first, peer.second, options_.reply_timeout);
+  }
+  return client;
+}
+
+void ClientPool::release(const Peer& peer, std::shared_ptr<Client> client) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& clients = idle_clients_[peer];
+    if (clients.size() < options_.max_idle_per_peer) {
+      clients.push_back(
+          IdleClient{std::move(client), std::chrono::steady_clock::now()});
+      return;
+    }
+  }
+  client->Close();
+}
+
+}  // namespace transport
+}  // namespace blazingdb
@@ -0,0 +1,243 @@
+#include "blazingdb/transport/FlowControl.h"
+#include <unistd.h>
+#include <algorithm>
+#include <limits>
+#include <random>
+
+namespace blazingdb {
+namespace transport {
+
+uint64_t getSenderId() {
+  // the nodes of a host share the pid namespace, but not the random device
+  static const uint64_t sender_id = []() {
+    std::random_device device;
+    uint64_t id = (uint64_t{device()} << 32) ^ device();
+    return id ^ static_cast<uint64_t>(getpid());
+  }();
+  return sender_id;
+}
+
+ReceiveCredits::ReceiveCredits(int64_t limit, int64_t total_limit)
+    : limit_{limit}, total_limit_{total_limit} {}
+
+void ReceiveCredits::setLimit(int64_t limit) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  limit_ = limit;
+}
+
+int64_t ReceiveCredits::limit() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return limit_;
+}
+
+void ReceiveCredits::setTotalLimit(int64_t total_limit) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  total_limit_ = total_limit;
+}
+
+int64_t ReceiveCredits::totalLimit() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return total_limit_;
+}
+
+Credit ReceiveCredits::receive(uint32_t context_token, uint64_t sender,
+                               int64_t bytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const Key key{context_token, sender};
+  if (bytes > 0) {
+    outstanding_[key] += bytes;
+    total_outstanding_ += bytes;
+  }
+  return creditOf(key);
+}
+
+void ReceiveCredits::track(const GPUMessage *message, uint32_t context_token,
+                           uint64_t sender, int64_t bytes) {
+  if (bytes <= 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  tracked_[message] = std::make_pair(Key{context_token, sender}, bytes);
+}
+
+void ReceiveCredits::release(uint32_t context_token, uint64_t sender,
+                             int64_t bytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  releaseOf(Key{context_token, sender}, bytes);
+}
+
+void ReceiveCredits::retrieved(const GPUMessage *message) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = tracked_.find(message);
+  if (it == tracked_.end()) {
+    return;
+  }
+  releaseOf(it->second.first, it->second.second);
+  tracked_.erase(it);
+}
+
+Credit ReceiveCredits::credit(uint32_t context_token, uint64_t sender) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return creditOf(Key{context_token, sender});
+}
+
+void ReceiveCredits::forgetContext(uint32_t context_token) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto it = outstanding_.begin(); it != outstanding_.end();) {
+    if (it->first.first == context_token) {
+      total_outstanding_ -= it->second;
+      it = outstanding_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  for (auto it = tracked_.begin(); it != tracked_.end();) {
+    it = it->second.first.first == context_token ? tracked_.erase(it) : ++it;
+  }
+}
+
+Credit ReceiveCredits::creditOf(const Key &key) {
+  Credit credit;
+  auto it = outstanding_.find(key);
+  credit.outstanding = it != outstanding_.end() ? it->second : 0;
+  if (limit_ > 0) {
+    credit.available = std::max<int64_t>(limit_ - credit.outstanding, 0);
+    if (total_limit_ > 0) {
+      credit.available = std::min<int64_t>(
+          credit.available,
+          std::max<int64_t>(total_limit_ - total_outstanding_, 0));
+    }
+  } else {
+    credit.available = std::numeric_limits<int64_t>::max();
+  }
+  credit.sequence = ++sequence_;
+  return credit;
+}
+
+void ReceiveCredits::releaseOf(const Key &key, int64_t bytes) {
+  auto it = outstanding_.find(key);
+  if (it == outstanding_.end() || bytes <= 0) {
+    return;
+  }
+  total_outstanding_ -= std::min(bytes, it->second);
+  it->second -= bytes;
+  if (it->second <= 0) {
+    outstanding_.erase(it);
+  }
+}
+
+namespace {
+
+constexpr auto MIN_CREDIT_QUERY_INTERVAL = std::chrono::milliseconds(1);
+constexpr auto MAX_CREDIT_QUERY_INTERVAL = std::chrono::milliseconds(50);
+constexpr auto IDLE_CREDIT_TIMEOUT = std::chrono::minutes(1);
+
+}  // namespace
+
+void SendCredits::acquire(const Peer &peer, uint32_t context_token,
+                          int64_t bytes, const Query &query) {
+  const Key key{peer.first, peer.second, context_token};
+  auto interval = MIN_CREDIT_QUERY_INTERVAL;
+  bool waited = false;
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    // the entry can be erased while the lock is released
+    PeerCredit &peer_credit = credits_[key];
+    if (canSend(peer_credit, bytes)) {
+      peer_credit.in_flight += bytes;
+      return;
+    }
+    if (!waited) {
+      waits_++;
+      waited = true;
+    }
+    if (peer_credit.in_flight > 0) {
+      // the replies of the sends in flight bring newer credits
+      cv_.wait_for(lock, interval);
+      continue;
+    }
+    lock.unlock();
+    Credit credit = query();
+    lock.lock();
+    PeerCredit &queried_credit = credits_[key];
+    updateOf(queried_credit, credit);
+    if (!canSend(queried_credit, bytes)) {
+      cv_.wait_for(lock, interval);
+      interval = std::min(interval * 2, MAX_CREDIT_QUERY_INTERVAL);
+    }
+  }
+}
+
+void SendCredits::release(const Peer &peer, uint32_t context_token,
+                          int64_t bytes, const Credit &credit) {
+  const Key key{peer.first, peer.second, context_token};
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    PeerCredit &peer_credit = credits_[key];
+    peer_credit.in_flight -= bytes;
+    updateOf(peer_credit, credit);
+    forgetIdleCredits();
+  }
+  cv_.notify_all();
+}
+
+void SendCredits::update(const Peer &peer, uint32_t context_token,
+                         const Credit &credit) {
+  const Key key{peer.first, peer.second, context_token};
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // only the receivers waited for are followed
+    auto it = credits_.find(key);
+    if (it == credits_.end()) {
+      return;
+    }
+    updateOf(it->second, credit);
+    forgetIdleCredits();
+  }
+  cv_.notify_all();
+}
+
+std::size_t SendCredits::waits() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return waits_;
+}
+
+bool SendCredits::canSend(const PeerCredit &peer_credit, int64_t bytes) {
+  if (peer_credit.in_flight == 0 &&
+      (!peer_credit.known || peer_credit.credit.outstanding == 0)) {
+    return true;
+  }
+  return peer_credit.known &&
+         bytes + peer_credit.in_flight <= peer_credit.credit.available;
+}
+
+void SendCredits::updateOf(PeerCredit &peer_credit, const Credit &credit) {
+  // a default credit comes from a failed send and tells nothing
+  if (credit.sequence == 0 ||
+      (peer_credit.known && credit.sequence <= peer_credit.credit.sequence)) {
+    return;
+  }
+  peer_credit.credit = credit;
+  peer_credit.known = true;
+  peer_credit.updated = std::chrono::steady_clock::now();
+}
+
+void SendCredits::forgetIdleCredits() {
+  // An empty receiver is the same as an unknown one. The credits of the
+  // contexts that are over would stay otherwise, the receiver has dropped
+  // their messages.
+  const auto now = std::chrono::steady_clock::now();
+  for (auto it = credits_.begin(); it != credits_.end();) {
+    const PeerCredit &peer_credit = it->second;
+    if (peer_credit.in_flight <= 0 &&
+        (peer_credit.credit.outstanding == 0 ||
+         now - peer_credit.updated > IDLE_CREDIT_TIMEOUT)) {
+      it = credits_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+}  // namespace transport
+}  // namespace blazingdb
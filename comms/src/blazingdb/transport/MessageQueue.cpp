@@ -1,6 +1,5 @@
 #include "blazingdb/transport/MessageQueue.h"
-#include <algorithm>
-#include <iostream>
+#include <cassert>
 
 namespace blazingdb {
 namespace transport {
@@ -8,39 +7,78 @@ namespace transport {
 std::shared_ptr<GPUMessage> MessageQueue::getMessage(
     const std::string &messageToken) {
   std::unique_lock<std::mutex> lock(mutex_);
-  condition_variable_.wait(lock, [&, this] {
-    return std::any_of(this->message_queue_.cbegin(),
-                       this->message_queue_.cend(), [&](const auto &e) {
-                         return e->getMessageTokenValue() == messageToken;
-                       });
-  });
-
-  return getMessageQueue(messageToken);
+  auto &token_queue = token_queues_[messageToken];
+  if (!token_queue) {
+    token_queue.reset(new TokenQueue);
+  }
+  TokenQueue &queue = *token_queue;
+
+  queue.waiters++;
+  queue.condition_variable.wait(lock,
+                                [&queue] { return !queue.messages.empty(); });
+  queue.waiters--;
+
+  return getMessageQueue(messageToken, queue);
+}
+
+std::shared_ptr<GPUMessage> MessageQueue::getMessage(
+    const std::string &messageToken, std::chrono::milliseconds timeout) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto &token_queue = token_queues_[messageToken];
+  if (!token_queue) {
+    token_queue.reset(new TokenQueue);
+  }
+  TokenQueue &queue = *token_queue;
+
+  queue.waiters++;
+  const bool received = queue.condition_variable.wait_for(
+      lock, timeout, [&queue] { return !queue.messages.empty(); });
+  queue.waiters--;
+
+  if (!received) {
+    if (queue.messages.empty() && queue.waiters == 0) {
+      token_queues_.erase(messageToken);
+    }
+    return nullptr;
+  }
+  return getMessageQueue(messageToken, queue);
 }
 
 void MessageQueue::putMessage(std::shared_ptr<GPUMessage> &message) {
   std::unique_lock<std::mutex> lock(mutex_);
   putMessageQueue(message);
-  lock.unlock();
-  condition_variable_.notify_one();
+}
+
+std::size_t MessageQueue::size() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  return size_;
 }
 
 std::shared_ptr<GPUMessage> MessageQueue::getMessageQueue(
-    const std::string &messageToken) {
-  auto it = std::partition(message_queue_.begin(), message_queue_.end(),
-                           [&messageToken](const auto &e) {
-                             return e->getMessageTokenValue() != messageToken;
-                           });
-  assert(it != message_queue_.end());
+    const std::string &messageToken, TokenQueue &token_queue) {
+  assert(!token_queue.messages.empty());
 
-  std::shared_ptr<GPUMessage> message = *it;
-  message_queue_.erase(it, it + 1);
+  std::shared_ptr<GPUMessage> message = token_queue.messages.front();
+  token_queue.messages.pop_front();
+  size_--;
 
+  if (token_queue.messages.empty() && token_queue.waiters == 0) {
+    token_queues_.erase(messageToken);
+  }
   return message;
 }
 
 void MessageQueue::putMessageQueue(std::shared_ptr<GPUMessage> &message) {
-  message_queue_.push_back(message);
+  auto &token_queue = token_queues_[message->getMessageTokenValue()];
+  if (!token_queue) {
+    token_queue.reset(new TokenQueue);
+  }
+  token_queue->messages.push_back(message);
+  size_++;
+
+  // Notified with the lock held: once it is released a waiter may take the
+  // message and erase the queue, condition variable included.
+  token_queue->condition_variable.notify_one();
 }
 
 }  // namespace transport
@@ -1,12 +1,17 @@
 
 #include "blazingdb/transport/Server.h"
 #include "blazingdb/network/TCPSocket.h"
+#include "blazingdb/transport/io/SharedMemoryRing.h"
+#include "blazingdb/transport/io/fd_reader_writer.h"
 #include "blazingdb/transport/io/reader_writer.h"
 
 #include <cuda_runtime_api.h>
+#include <chrono>
 #include <condition_variable>
+#include <cstring>
 #include <deque>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <numeric>
 #include <shared_mutex>
@@ -42,13 +47,29 @@ void Server::deregisterContext(const uint32_t context_token) {
   if (it != context_messages_map_.end()) {
     context_messages_map_.erase(it);
   }
+  receive_credits_.forgetContext(context_token);
 }
 
 std::shared_ptr<GPUMessage> Server::getMessage(
     const uint32_t context_token, const std::string &messageToken) {
   std::shared_lock<std::shared_timed_mutex> lock(context_messages_mutex_);
   MessageQueue &message_queue = context_messages_map_.at(context_token);
-  return message_queue.getMessage(messageToken);
+  std::shared_ptr<GPUMessage> message = message_queue.getMessage(messageToken);
+  receive_credits_.retrieved(message.get());
+  return message;
+}
+
+std::shared_ptr<GPUMessage> Server::getMessage(
+    const uint32_t context_token, const std::string &messageToken,
+    std::chrono::milliseconds timeout) {
+  std::shared_lock<std::shared_timed_mutex> lock(context_messages_mutex_);
+  MessageQueue &message_queue = context_messages_map_.at(context_token);
+  std::shared_ptr<GPUMessage> message =
+      message_queue.getMessage(messageToken, timeout);
+  if (message != nullptr) {
+    receive_credits_.retrieved(message.get());
+  }
+  return message;
 }
 
 void Server::putMessage(const uint32_t context_token,
@@ -67,6 +88,16 @@ void Server::putMessage(const uint32_t context_token,
   message_queue.putMessage(message);
 }
 
+void Server::setReceiveCreditLimit(int64_t limit) {
+  receive_credits_.setLimit(limit);
+}
+
+void Server::setReceiveTotalCreditLimit(int64_t limit) {
+  receive_credits_.setTotalLimit(limit);
+}
+
+ReceiveCredits &Server::receiveCredits() { return receive_credits_; }
+
 Server::MakeCallback Server::getDeserializationFunction(
     const std::string &endpoint) {
   const auto &iterator = deserializer_.find(endpoint);
@@ -86,6 +117,40 @@ MetadataType read_metadata(void *fd) {
 
 namespace {
 
+// Reads the rest of the parts of the current message, the reply can only be
+// sent once the whole request has been received
+void discardMessage(void *socket) {
+  zmq::socket_t *socket_ptr = (zmq::socket_t *)socket;
+  int more = 1;
+  std::size_t more_size = sizeof(more);
+  socket_ptr->getsockopt(ZMQ_RCVMORE, &more, &more_size);
+  while (more) {
+    zmq::message_t part;
+    if (!socket_ptr->recv(part)) {
+      return;
+    }
+    socket_ptr->getsockopt(ZMQ_RCVMORE, &more, &more_size);
+  }
+}
+
+bool readWireHeader(void *socket, WireHeader &header) {
+  zmq::message_t message =
+      blazingdb::transport::io::readMessageFromSocket(socket);
+  if (message.size() != sizeof(WireHeader)) {
+    return false;
+  }
+  memcpy(&header, message.data(), sizeof(WireHeader));
+  return header.magic == WIRE_FORMAT_MAGIC &&
+         header.version == WIRE_FORMAT_VERSION;
+}
+
+// The reply to an accepted request
+void writeEnd(void *socket, const Credit &credit) {
+  blazingdb::transport::io::writeToSocket(socket, "END", 3, true);
+  blazingdb::transport::io::writeToSocket(socket, (char *)&credit,
+                                          sizeof(Credit), false);
+}
+
 class ServerTCP : public Server {
 public:
   ServerTCP(unsigned short port) : server_socket{port} {}
@@ -96,7 +161,21 @@ public:
 
   void Close() override;
 
-  ~ServerTCP() { thread.join(); }
+  ~ServerTCP() {
+    if (thread.joinable()) {
+      thread.join();
+    }
+    for (auto &ring : shared_memory_rings) {
+      io::unpinSharedMemoryRing(*ring.second);
+    }
+  }
+
+  /// The ring of a client on this host, opened with its first message.
+  /// Throws std::runtime_error if it can not be opened.
+  io::SharedMemoryRing &attachSharedMemoryRing(const std::string &name);
+
+  /// Forgets a ring whose positions are unknown after a failed message.
+  void detachSharedMemoryRing(const std::string &name);
 
 private:
   /**
@@ -107,8 +186,49 @@ private:
   std::thread thread;
 
   int gpuId{0};
+
+  // only used by the thread of the server
+  std::map<std::string, std::unique_ptr<io::SharedMemoryRing>>
+      shared_memory_rings;
 };
 
+io::SharedMemoryRing &ServerTCP::attachSharedMemoryRing(
+    const std::string &name) {
+  // the rings of the clients that are gone
+  for (auto it = shared_memory_rings.begin();
+       it != shared_memory_rings.end();) {
+    if (it->first != name && it->second->isClosed()) {
+      io::unpinSharedMemoryRing(*it->second);
+      it = shared_memory_rings.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  std::unique_ptr<io::SharedMemoryRing> &ring = shared_memory_rings[name];
+  if (ring == nullptr) {
+    try {
+      ring = io::SharedMemoryRing::open(name);
+    } catch (...) {
+      shared_memory_rings.erase(name);
+      throw;
+    }
+    io::pinSharedMemoryRing(*ring);
+  }
+  return *ring;
+}
+
+void ServerTCP::detachSharedMemoryRing(const std::string &name) {
+  auto it = shared_memory_rings.find(name);
+  if (it != shared_memory_rings.end()) {
+    io::unpinSharedMemoryRing(*it->second);
+    shared_memory_rings.erase(it);
+  }
+}
+
+// Longest wait for a chunk of a ring. Nothing else is received meanwhile, but
+// a client that is gone closes its ring and stops the wait earlier.
+constexpr std::chrono::milliseconds SHARED_MEMORY_CHUNK_TIMEOUT{60 * 1000};
+
 void connectionHandler(ServerTCP *server, void *socket, int gpuId) {
   try {
     // use io reader to read the message
@@ -117,6 +237,21 @@ void connectionHandler(ServerTCP *server, void *socket, int gpuId) {
     // read that from the buffer to get these values
 
     // begin of message
+    WireHeader header;
+    if (!readWireHeader(socket, header)) {
+      discardMessage(socket);
+      std::string reply =
+          "unsupported wire format, expected version " +
+          std::to_string(WIRE_FORMAT_VERSION);
+      blazingdb::transport::io::writeToSocket(socket, (char *)reply.data(),
+                                              reply.size(), false);
+      return;
+    }
+    ReceiveCredits &credits = server->receiveCredits();
+    if (header.request == WireRequest::credit) {
+      writeEnd(socket, credits.credit(header.context_token, header.sender));
+      return;
+    }
     Message::MetaData message_metadata =
         read_metadata<Message::MetaData>(socket);
     Address::MetaData address_metadata =
@@ -130,42 +265,79 @@ void connectionHandler(ServerTCP *server, void *socket, int gpuId) {
         column_offset_size * sizeof(ColumnTransport));
 
     auto buffer_sizes_size = read_metadata<int32_t>(socket);
-    std::vector<int> buffer_sizes(buffer_sizes_size);
+    std::vector<int64_t> buffer_sizes(buffer_sizes_size);
     blazingdb::transport::io::readFromSocket(
-        socket, (char *)buffer_sizes.data(), buffer_sizes_size * sizeof(int));
+        socket, (char *)buffer_sizes.data(),
+        buffer_sizes_size * sizeof(int64_t));
 
     std::vector<char *> raw_columns;
-    raw_columns = blazingdb::transport::io::readBuffersIntoGPUTCP(
-        buffer_sizes, socket, gpuId);
-    zmq::socket_t *socket_ptr = (zmq::socket_t *)socket;
-
-    int data_past_topic{0};
-    auto data_past_topic_size{sizeof(data_past_topic)};
-    socket_ptr->getsockopt(ZMQ_RCVMORE, &data_past_topic,
-                           &data_past_topic_size);
-    if (data_past_topic == 0 || data_past_topic_size == 0) {
-      std::cerr << "Server: No data inside message." << std::endl;
-      return;
+    const std::string ring_name(
+        header.shared_memory_ring,
+        strnlen(header.shared_memory_ring, sizeof(header.shared_memory_ring)));
+    if (!ring_name.empty()) {
+      // the request ends with the metadata, the buffers are in the ring
+      io::SharedMemoryRing *ring = nullptr;
+      std::string error;
+      try {
+        ring = &server->attachSharedMemoryRing(ring_name);
+        raw_columns = io::readBuffersFromSharedMemory(
+            *ring, buffer_sizes, gpuId, SHARED_MEMORY_CHUNK_TIMEOUT);
+      } catch (const std::exception &exception) {
+        error = ring == nullptr ? std::string(SHARED_MEMORY_RING_UNAVAILABLE) +
+                                      ": " + exception.what()
+                                : exception.what();
+        server->detachSharedMemoryRing(ring_name);
+      }
+      if (!error.empty()) {
+        blazingdb::transport::io::writeToSocket(socket, (char *)error.data(),
+                                                error.size(), false);
+        return;
+      }
+    } else {
+      raw_columns = blazingdb::transport::io::readBuffersIntoGPUTCP(
+          column_offsets, buffer_sizes, socket, gpuId);
+      zmq::socket_t *socket_ptr = (zmq::socket_t *)socket;
+
+      int data_past_topic{0};
+      auto data_past_topic_size{sizeof(data_past_topic)};
+      socket_ptr->getsockopt(ZMQ_RCVMORE, &data_past_topic,
+                             &data_past_topic_size);
+      if (data_past_topic == 0 || data_past_topic_size == 0) {
+        std::cerr << "Server: No data inside message." << std::endl;
+        return;
+      }
+      // receive the ok
+      zmq::message_t local_message;
+      auto success = socket_ptr->recv(local_message);
+      if (success.value() == false || local_message.size() == 0) {
+        throw zmq::error_t();
+      }
+
+      std::string ok_message(static_cast<char *>(local_message.data()),
+                             local_message.size());
+      assert(ok_message == "OK");
     }
-    // receive the ok
-    zmq::message_t local_message;
-    auto success = socket_ptr->recv(local_message);
-    if (success.value() == false || local_message.size() == 0) {
-      throw zmq::error_t();
-    }
-
-    std::string ok_message(static_cast<char *>(local_message.data()),
-                           local_message.size());
-    assert(ok_message == "OK");
-    blazingdb::transport::io::writeToSocket(socket, "END", 3, false);
+    // the buffers are held until the message is retrieved
+    const int64_t bytes =
+        std::accumulate(buffer_sizes.begin(), buffer_sizes.end(), int64_t{0});
+    writeEnd(socket, credits.receive(message_metadata.contextToken,
+                                     header.sender, bytes));
     // end of message
 
-    std::string messageToken = message_metadata.messageToken;
-    auto deserialize_function = server->getDeserializationFunction(
-        messageToken.substr(0, messageToken.find('_')));
-    std::shared_ptr<GPUMessage> message = deserialize_function(
-        message_metadata, address_metadata, column_offsets, raw_columns);
+    std::shared_ptr<GPUMessage> message;
+    try {
+      std::string messageToken = message_metadata.messageToken;
+      auto deserialize_function = server->getDeserializationFunction(
+          messageToken.substr(0, messageToken.find('_')));
+      message = deserialize_function(message_metadata, address_metadata,
+                                     column_offsets, raw_columns);
+    } catch (...) {
+      credits.release(message_metadata.contextToken, header.sender, bytes);
+      throw;
+    }
     assert(message != nullptr);
+    credits.track(message.get(), message_metadata.contextToken, header.sender,
+                  bytes);
     server->putMessage(message->metadata().contextToken, message);
 
     // TODO: write success
@@ -183,7 +355,15 @@ void ServerTCP::Run() {
   });
   std::this_thread::yield();
 }
-void ServerTCP::Close() { this->server_socket.close(); }
+void ServerTCP::Close() {
+  // the thread of the server closes the socket once it stops, closing it from
+  // here while that thread waits for a message is not safe
+  this->server_socket.stop();
+  if (thread.joinable()) {
+    thread.join();
+  }
+  this->server_socket.close();
+}
 
 }  // namespace
 
@@ -0,0 +1,204 @@
+#include "blazingdb/transport/io/Compression.h"
+#include <lz4.h>
+#include <zstd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace blazingdb {
+namespace transport {
+namespace io {
+
+namespace {
+
+// the fast end of zstd, it still compresses better than LZ4
+constexpr int COMPRESSION_ZSTD_LEVEL = 1;
+
+// a buffer is only compressed if its sample shrinks below this fraction
+constexpr double MAX_COMPRESSED_RATIO = 0.9;
+
+// and zstd is chosen over LZ4 if it makes the sample this much smaller
+constexpr double MIN_ZSTD_GAIN = 0.8;
+
+std::atomic<CompressionMode> compression_mode{CompressionMode::none};
+
+struct ZstdContexts {
+  ZstdContexts()
+      : compress{ZSTD_createCCtx()}, decompress{ZSTD_createDCtx()} {}
+
+  ~ZstdContexts() {
+    ZSTD_freeCCtx(compress);
+    ZSTD_freeDCtx(decompress);
+  }
+
+  ZSTD_CCtx *compress;
+  ZSTD_DCtx *decompress;
+};
+
+// each copy worker keeps its contexts instead of creating them per buffer
+ZstdContexts &zstdContexts() {
+  thread_local ZstdContexts contexts;
+  return contexts;
+}
+
+void checkLz4Size(std::size_t size) {
+  if (size > static_cast<std::size_t>(INT_MAX)) {
+    throw std::runtime_error("Compression: " + std::to_string(size) +
+                             " bytes are too many for LZ4");
+  }
+}
+
+}  // namespace
+
+void setCompressionMode(CompressionMode mode) { compression_mode = mode; }
+
+CompressionMode getCompressionMode() { return compression_mode; }
+
+std::size_t compressBound(Codec codec, std::size_t size) {
+  switch (codec) {
+    case Codec::lz4:
+      checkLz4Size(size);
+      return LZ4_compressBound(static_cast<int>(size));
+    case Codec::zstd:
+      return ZSTD_compressBound(size);
+    default:
+      return size;
+  }
+}
+
+std::size_t compress(Codec codec, const char *source, std::size_t size,
+                     char *destination, std::size_t capacity) {
+  switch (codec) {
+    case Codec::lz4: {
+      checkLz4Size(size);
+      int compressed = LZ4_compress_default(
+          source, destination, static_cast<int>(size),
+          static_cast<int>(std::min<std::size_t>(capacity, INT_MAX)));
+      return compressed > 0 ? compressed : 0;
+    }
+    case Codec::zstd: {
+      std::size_t compressed =
+          ZSTD_compressCCtx(zstdContexts().compress, destination, capacity,
+                            source, size, COMPRESSION_ZSTD_LEVEL);
+      return ZSTD_isError(compressed) ? 0 : compressed;
+    }
+    default:
+      throw std::runtime_error("Compression: unknown codec " +
+                               std::to_string(static_cast<int>(codec)));
+  }
+}
+
+void decompress(Codec codec, const char *source, std::size_t compressedSize,
+                char *destination, std::size_t size) {
+  switch (codec) {
+    case Codec::lz4: {
+      checkLz4Size(compressedSize);
+      checkLz4Size(size);
+      int decompressed =
+          LZ4_decompress_safe(source, destination,
+                              static_cast<int>(compressedSize),
+                              static_cast<int>(size));
+      if (decompressed < 0 ||
+          static_cast<std::size_t>(decompressed) != size) {
+        throw std::runtime_error("Compression: corrupt LZ4 buffer");
+      }
+      return;
+    }
+    case Codec::zstd: {
+      std::size_t decompressed =
+          ZSTD_decompressDCtx(zstdContexts().decompress, destination, size,
+                              source, compressedSize);
+      if (ZSTD_isError(decompressed)) {
+        throw std::runtime_error(std::string("Compression: corrupt zstd ") +
+                                 "buffer, " + ZSTD_getErrorName(decompressed));
+      }
+      if (decompressed != size) {
+        throw std::runtime_error("Compression: corrupt zstd buffer");
+      }
+      return;
+    }
+    default:
+      throw std::runtime_error("Compression: unknown codec " +
+                               std::to_string(static_cast<int>(codec)));
+  }
+}
+
+Codec chooseCodec(CompressionMode mode, const char *sample,
+                  std::size_t sampleSize) {
+  if (mode == CompressionMode::none || sampleSize == 0) {
+    return Codec::none;
+  }
+  auto compressedRatio = [&](Codec codec) {
+    std::unique_ptr<char[]> compressed(
+        new char[compressBound(codec, sampleSize)]);
+    std::size_t compressedSize =
+        compress(codec, sample, sampleSize, compressed.get(),
+                 compressBound(codec, sampleSize));
+    return compressedSize == 0
+               ? 1.0
+               : static_cast<double>(compressedSize) / sampleSize;
+  };
+
+  if (mode == CompressionMode::lz4 || mode == CompressionMode::zstd) {
+    Codec codec = mode == CompressionMode::lz4 ? Codec::lz4 : Codec::zstd;
+    return compressedRatio(codec) < MAX_COMPRESSED_RATIO ? codec
+                                                         : Codec::none;
+  }
+  double lz4Ratio = compressedRatio(Codec::lz4);
+  double zstdRatio = compressedRatio(Codec::zstd);
+  if (zstdRatio < MAX_COMPRESSED_RATIO &&
+      zstdRatio < MIN_ZSTD_GAIN * lz4Ratio) {
+    return Codec::zstd;
+  }
+  return lz4Ratio < MAX_COMPRESSED_RATIO ? Codec::lz4 : Codec::none;
+}
+
+namespace {
+
+// calls function(position, codec) for each buffer of the column
+template <typename Column, typename Function>
+void forEachBuffer(Column &column, Function function) {
+  function(column.data, column.data_codec);
+  function(column.valid, column.valid_codec);
+  function(column.strings_data, column.strings_data_codec);
+  function(column.strings_offsets, column.strings_offsets_codec);
+  function(column.strings_nullmask, column.strings_nullmask_codec);
+}
+
+}  // namespace
+
+std::vector<Codec> getBufferCodecs(
+    const std::vector<ColumnTransport> &columnTransport,
+    std::size_t numBuffers) {
+  std::vector<Codec> codecs(numBuffers, Codec::none);
+  for (const ColumnTransport &column : columnTransport) {
+    forEachBuffer(column, [&](int position, Codec codec) {
+      if (position >= 0 &&
+          static_cast<std::size_t>(position) < numBuffers) {
+        codecs[position] = codec;
+      }
+    });
+  }
+  return codecs;
+}
+
+void setBufferCodecs(std::vector<ColumnTransport> &columnTransport,
+                     const std::vector<Codec> &codecs) {
+  for (ColumnTransport &column : columnTransport) {
+    forEachBuffer(column, [&](int position, Codec &codec) {
+      if (position >= 0 &&
+          static_cast<std::size_t>(position) < codecs.size()) {
+        codec = codecs[position];
+      }
+    });
+  }
+}
+
+}  // namespace io
+}  // namespace transport
+}  // namespace blazingdb
@@ -0,0 +1,205 @@
+#include "blazingdb/transport/io/PinnedBufferProvider.h"
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+namespace blazingdb {
+namespace transport {
+namespace io {
+
+namespace {
+
+class HostAllocator : public BufferAllocator {
+public:
+  char *allocate(std::size_t size) override {
+    char *data = static_cast<char *>(std::malloc(size));
+    if (data == nullptr) {
+      throw std::bad_alloc();
+    }
+    return data;
+  }
+
+  void deallocate(char *data, std::size_t /*size*/) override {
+    std::free(data);
+  }
+};
+
+}  // namespace
+
+std::unique_ptr<BufferAllocator> makeHostAllocator() {
+  return std::unique_ptr<BufferAllocator>(new HostAllocator());
+}
+
+PinnedBufferProvider::PinnedBufferProvider(
+    std::vector<std::size_t> sizeClasses, std::size_t memoryLimit,
+    std::unique_ptr<BufferAllocator> allocator)
+    : allocator{std::move(allocator)},
+      sizeClasses{std::move(sizeClasses)},
+      limit{memoryLimit} {
+  std::sort(this->sizeClasses.begin(), this->sizeClasses.end());
+  this->sizeClasses.erase(
+      std::unique(this->sizeClasses.begin(), this->sizeClasses.end()),
+      this->sizeClasses.end());
+  if (this->sizeClasses.empty() || this->sizeClasses.front() == 0) {
+    throw std::runtime_error("PinnedBufferProvider: invalid size classes");
+  }
+  if (this->limit < 2 * this->sizeClasses.back()) {
+    throw std::runtime_error(
+        "PinnedBufferProvider: the memory limit " +
+        std::to_string(this->limit) +
+        " is less than twice the largest buffer size " +
+        std::to_string(this->sizeClasses.back()));
+  }
+  this->buffers.resize(this->sizeClasses.size());
+}
+
+PinnedBufferProvider::~PinnedBufferProvider() { freeAll(); }
+
+PinnedBuffer *PinnedBufferProvider::getBuffer() {
+  return getBuffer(this->sizeClasses.back());
+}
+
+PinnedBuffer *PinnedBufferProvider::getBuffer(std::size_t size) {
+  return getBuffer(size, true);
+}
+
+PinnedBuffer *PinnedBufferProvider::tryGetBuffer(std::size_t size) {
+  return getBuffer(size, false);
+}
+
+PinnedBuffer *PinnedBufferProvider::getBuffer(std::size_t size, bool wait) {
+  auto it = std::lower_bound(this->sizeClasses.begin(),
+                             this->sizeClasses.end(), size);
+  if (it == this->sizeClasses.end()) {
+    throw std::runtime_error("PinnedBufferProvider: no buffers of " +
+                             std::to_string(size) + " bytes");
+  }
+  const std::size_t sizeClass = it - this->sizeClasses.begin();
+  const std::size_t bufferSize = *it;
+
+  std::unique_lock<std::mutex> lock(inUseMutex);
+  PinnedBuffer *buffer = nullptr;
+  bool waited = false;
+  while (true) {
+    auto &idle = this->buffers[sizeClass];
+    if (!idle.empty()) {
+      buffer = idle.back();
+      idle.pop_back();
+      break;
+    }
+    if (this->counters.bytes_allocated + bufferSize <= this->limit) {
+      break;
+    }
+    if (releaseIdleBuffer(sizeClass)) {
+      continue;
+    }
+    if (!wait) {
+      return nullptr;
+    }
+    if (!waited) {
+      this->counters.waits++;
+      waited = true;
+    }
+    cv.wait(lock);
+  }
+
+  if (buffer == nullptr) {
+    // the memory is reserved while it is allocated without the lock
+    this->counters.bytes_allocated += bufferSize;
+    lock.unlock();
+    try {
+      buffer = new PinnedBuffer{bufferSize, allocator->allocate(bufferSize)};
+    } catch (...) {
+      lock.lock();
+      this->counters.bytes_allocated -= bufferSize;
+      cv.notify_all();
+      throw;
+    }
+    lock.lock();
+    this->counters.allocations++;
+  }
+
+  this->counters.buffers_in_use++;
+  this->counters.bytes_in_use += bufferSize;
+  this->counters.high_water_bytes =
+      std::max(this->counters.high_water_bytes, this->counters.bytes_in_use);
+  return buffer;
+}
+
+void PinnedBufferProvider::freeBuffer(PinnedBuffer *buffer) {
+  auto it = std::lower_bound(this->sizeClasses.begin(),
+                             this->sizeClasses.end(), buffer->size);
+  std::unique_lock<std::mutex> lock(inUseMutex);
+  this->buffers[it - this->sizeClasses.begin()].push_back(buffer);
+  this->counters.buffers_in_use--;
+  this->counters.bytes_in_use -= buffer->size;
+  // the waiters may want a buffer of another class, which now may fit
+  cv.notify_all();
+}
+
+std::size_t PinnedBufferProvider::sizeBuffers() {
+  return this->sizeClasses.back();
+}
+
+std::size_t PinnedBufferProvider::memoryLimit() { return this->limit; }
+
+void PinnedBufferProvider::reserve(std::size_t numBuffers) {
+  const std::size_t bufferSize = this->sizeClasses.back();
+  std::unique_lock<std::mutex> lock(inUseMutex);
+  auto &idle = this->buffers.back();
+  while (idle.size() < numBuffers &&
+         this->counters.bytes_allocated + bufferSize <= this->limit) {
+    idle.push_back(
+        new PinnedBuffer{bufferSize, allocator->allocate(bufferSize)});
+    this->counters.bytes_allocated += bufferSize;
+    this->counters.allocations++;
+  }
+}
+
+void PinnedBufferProvider::freeAll() {
+  std::unique_lock<std::mutex> lock(inUseMutex);
+  while (releaseIdleBuffer(this->sizeClasses.size())) {
+  }
+  cv.notify_all();
+}
+
+PinnedBufferProvider::Stats PinnedBufferProvider::stats() {
+  std::unique_lock<std::mutex> lock(inUseMutex);
+  return this->counters;
+}
+
+bool PinnedBufferProvider::tryLend(std::size_t size) {
+  std::unique_lock<std::mutex> lock(inUseMutex);
+  if (this->lentBytes + size > this->limit / 2) {
+    return false;
+  }
+  this->lentBytes += size;
+  return true;
+}
+
+void PinnedBufferProvider::endLend(std::size_t size) {
+  std::unique_lock<std::mutex> lock(inUseMutex);
+  this->lentBytes -= size;
+}
+
+bool PinnedBufferProvider::releaseIdleBuffer(std::size_t keepClass) {
+  // the largest buffers first, they make room for more
+  for (std::size_t sizeClass = this->buffers.size(); sizeClass-- > 0;) {
+    auto &idle = this->buffers[sizeClass];
+    if (sizeClass != keepClass && !idle.empty()) {
+      PinnedBuffer *buffer = idle.back();
+      idle.pop_back();
+      allocator->deallocate(buffer->data, buffer->size);
+      this->counters.bytes_allocated -= buffer->size;
+      delete buffer;
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace io
+}  // namespace transport
+}  // namespace blazingdb
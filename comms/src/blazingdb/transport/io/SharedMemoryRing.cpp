@@ -0,0 +1,293 @@
+#include "blazingdb/transport/io/SharedMemoryRing.h"
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <ifaddrs.h>
+#include <netinet/in.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <set>
+#include <stdexcept>
+#include <thread>
+
+namespace blazingdb {
+namespace transport {
+namespace io {
+
+namespace {
+
+constexpr uint32_t SHARED_MEMORY_RING_MAGIC = 0x425a5247;  // "BZRG"
+
+// the header takes the first page, the data starts page aligned after it
+constexpr std::size_t SHARED_MEMORY_RING_HEADER_SIZE = 4096;
+
+std::atomic<bool> shared_memory_transport{true};
+
+std::atomic<std::size_t> shared_memory_ring_size{32 * 1024 * 1024};
+
+std::atomic<std::size_t> shared_memory_ring_limit{8};
+
+// rings taken by the clients of this process
+std::atomic<std::size_t> shared_memory_rings{0};
+
+std::runtime_error systemError(const std::string &what,
+                               const std::string &name) {
+  return std::runtime_error("SharedMemoryRing: " + what + " " + name + ", " +
+                            std::strerror(errno));
+}
+
+// Spins for a while, then yields and then sleeps, until done returns true.
+// Returns false if the time runs out first.
+template <typename Predicate>
+bool waitUntil(Predicate done, std::chrono::milliseconds timeout) {
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  for (int attempt = 0; !done(); attempt++) {
+    if (attempt < 1000) {
+      continue;
+    }
+    if (timeout.count() >= 0 && std::chrono::steady_clock::now() > deadline) {
+      return false;
+    }
+    if (attempt < 2000) {
+      std::this_thread::yield();
+    } else {
+      std::this_thread::sleep_for(std::chrono::microseconds(20));
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+// The counters of each side are on their own cache line.
+struct SharedMemoryRing::Header {
+  uint32_t magic;
+  uint64_t capacity;
+  alignas(64) std::atomic<uint64_t> committed;
+  alignas(64) std::atomic<uint64_t> released;
+  alignas(64) std::atomic<uint32_t> closed;
+};
+
+std::unique_ptr<SharedMemoryRing> SharedMemoryRing::create(
+    const std::string &name, std::size_t capacity) {
+  static_assert(sizeof(Header) <= SHARED_MEMORY_RING_HEADER_SIZE,
+                "the header must fit in its page");
+  static_assert(ATOMIC_LLONG_LOCK_FREE == 2,
+                "the counters are shared between processes");
+  if (capacity == 0) {
+    throw std::runtime_error("SharedMemoryRing: empty ring " + name);
+  }
+  int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0) {
+    throw systemError("can not create", name);
+  }
+  const std::size_t mappedSize = SHARED_MEMORY_RING_HEADER_SIZE + capacity;
+  if (ftruncate(fd, mappedSize) != 0) {
+    ::close(fd);
+    shm_unlink(name.c_str());
+    throw systemError("can not size", name);
+  }
+  void *memory =
+      mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (memory == MAP_FAILED) {
+    shm_unlink(name.c_str());
+    throw systemError("can not map", name);
+  }
+
+  Header *header = new (memory) Header();
+  header->magic = SHARED_MEMORY_RING_MAGIC;
+  header->capacity = capacity;
+  header->committed = 0;
+  header->released = 0;
+  header->closed = 0;
+  return std::unique_ptr<SharedMemoryRing>(
+      new SharedMemoryRing(name, true, header, mappedSize));
+}
+
+std::unique_ptr<SharedMemoryRing> SharedMemoryRing::open(
+    const std::string &name) {
+  int fd = shm_open(name.c_str(), O_RDWR, 0600);
+  if (fd < 0) {
+    throw systemError("can not open", name);
+  }
+  struct stat status;
+  if (fstat(fd, &status) != 0 ||
+      static_cast<std::size_t>(status.st_size) <=
+          SHARED_MEMORY_RING_HEADER_SIZE) {
+    ::close(fd);
+    throw std::runtime_error("SharedMemoryRing: " + name + " is not a ring");
+  }
+  const std::size_t mappedSize = status.st_size;
+  void *memory =
+      mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (memory == MAP_FAILED) {
+    throw systemError("can not map", name);
+  }
+
+  Header *header = static_cast<Header *>(memory);
+  if (header->magic != SHARED_MEMORY_RING_MAGIC ||
+      header->capacity + SHARED_MEMORY_RING_HEADER_SIZE != mappedSize) {
+    munmap(memory, mappedSize);
+    throw std::runtime_error("SharedMemoryRing: " + name + " is not a ring");
+  }
+  return std::unique_ptr<SharedMemoryRing>(
+      new SharedMemoryRing(name, false, header, mappedSize));
+}
+
+SharedMemoryRing::SharedMemoryRing(const std::string &name, bool owner,
+                                   Header *header, std::size_t mappedSize)
+    : name_{name},
+      owner_{owner},
+      header_{header},
+      mappedSize_{mappedSize},
+      capacity_{header->capacity},
+      data_{reinterpret_cast<char *>(header) +
+            SHARED_MEMORY_RING_HEADER_SIZE},
+      reserved_{header->committed.load()} {}
+
+SharedMemoryRing::~SharedMemoryRing() {
+  if (owner_) {
+    markClosed();
+    shm_unlink(name_.c_str());
+  }
+  munmap(header_, mappedSize_);
+}
+
+uint64_t SharedMemoryRing::nextPosition(uint64_t end, std::size_t size) const {
+  const std::size_t offset = end % capacity_;
+  return offset + size > capacity_ ? end + (capacity_ - offset) : end;
+}
+
+int64_t SharedMemoryRing::tryReserve(std::size_t size) {
+  // the bytes skipped before a region that does not fit before the end are
+  // only released with it, together they must fit in the ring
+  if (size > capacity_ / 2) {
+    throw std::runtime_error("SharedMemoryRing: " + std::to_string(size) +
+                             " bytes do not fit in " + name_);
+  }
+  const uint64_t position = nextPosition(reserved_, size);
+  if (position + size - header_->released.load(std::memory_order_acquire) >
+      capacity_) {
+    return -1;
+  }
+  reserved_ = position + size;
+  return position;
+}
+
+uint64_t SharedMemoryRing::reserve(std::size_t size,
+                                   std::chrono::milliseconds timeout) {
+  int64_t position = -1;
+  if (!waitUntil([&]() { return (position = tryReserve(size)) >= 0; },
+                 timeout)) {
+    throw std::runtime_error("SharedMemoryRing: the consumer of " + name_ +
+                             " does not release the ring");
+  }
+  return position;
+}
+
+void SharedMemoryRing::commit(uint64_t end) {
+  header_->committed.store(end, std::memory_order_release);
+}
+
+void SharedMemoryRing::markClosed() {
+  header_->closed.store(1, std::memory_order_release);
+}
+
+void SharedMemoryRing::waitCommitted(uint64_t end,
+                                     std::chrono::milliseconds timeout) {
+  bool committed = false;
+  if (!waitUntil(
+          [&]() {
+            committed =
+                header_->committed.load(std::memory_order_acquire) >= end;
+            return committed || isClosed();
+          },
+          timeout)) {
+    throw std::runtime_error("SharedMemoryRing: the producer of " + name_ +
+                             " does not commit the ring");
+  }
+  if (!committed) {
+    throw std::runtime_error("SharedMemoryRing: the producer of " + name_ +
+                             " closed the ring");
+  }
+}
+
+void SharedMemoryRing::release(uint64_t end) {
+  header_->released.store(end, std::memory_order_release);
+}
+
+uint64_t SharedMemoryRing::released() const {
+  return header_->released.load(std::memory_order_acquire);
+}
+
+bool SharedMemoryRing::isClosed() const {
+  return header_->closed.load(std::memory_order_acquire) != 0;
+}
+
+bool isLocalAddress(const std::string &ip) {
+  if (ip == "localhost" || ip.compare(0, 4, "127.") == 0) {
+    return true;
+  }
+  // the addresses of the interfaces do not change while the RAL runs
+  static const std::set<std::string> local_addresses = []() {
+    std::set<std::string> addresses;
+    struct ifaddrs *interfaces = nullptr;
+    if (getifaddrs(&interfaces) != 0) {
+      return addresses;
+    }
+    for (struct ifaddrs *it = interfaces; it != nullptr; it = it->ifa_next) {
+      if (it->ifa_addr == nullptr || it->ifa_addr->sa_family != AF_INET) {
+        continue;
+      }
+      char address[INET_ADDRSTRLEN]{};
+      auto *ipv4 = reinterpret_cast<struct sockaddr_in *>(it->ifa_addr);
+      if (inet_ntop(AF_INET, &ipv4->sin_addr, address, sizeof(address))) {
+        addresses.insert(address);
+      }
+    }
+    freeifaddrs(interfaces);
+    return addresses;
+  }();
+  return local_addresses.count(ip) > 0;
+}
+
+void setSharedMemoryTransport(bool enabled) {
+  shared_memory_transport = enabled;
+}
+
+bool isSharedMemoryTransport() { return shared_memory_transport; }
+
+void setSharedMemoryRingSize(std::size_t size) {
+  shared_memory_ring_size = size;
+}
+
+std::size_t getSharedMemoryRingSize() { return shared_memory_ring_size; }
+
+void setSharedMemoryRingLimit(std::size_t limit) {
+  shared_memory_ring_limit = limit;
+}
+
+std::size_t getSharedMemoryRingLimit() { return shared_memory_ring_limit; }
+
+bool acquireSharedMemoryRing() {
+  std::size_t rings = shared_memory_rings.load();
+  do {
+    if (rings >= shared_memory_ring_limit) {
+      return false;
+    }
+  } while (!shared_memory_rings.compare_exchange_weak(rings, rings + 1));
+  return true;
+}
+
+void releaseSharedMemoryRing() { shared_memory_rings--; }
+
+}  // namespace io
+}  // namespace transport
+}  // namespace blazingdb
@@ -0,0 +1,105 @@
+#include "blazingdb/transport/io/TransportExecutor.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace blazingdb {
+namespace transport {
+namespace io {
+
+TransportExecutor::TransportExecutor(std::size_t numCopyWorkers,
+                                     std::size_t numSocketWorkers) {
+  if (numCopyWorkers == 0 || numSocketWorkers == 0) {
+    throw std::runtime_error(
+        "TransportExecutor: it needs at least a worker of each kind");
+  }
+  startWorkers(copyQueue, numCopyWorkers);
+  startWorkers(socketQueue, numSocketWorkers);
+}
+
+TransportExecutor::~TransportExecutor() {
+  // the socket tasks may be waiting for copy tasks
+  stopWorkers(socketQueue);
+  stopWorkers(copyQueue);
+}
+
+void TransportExecutor::enqueue(WorkQueue &queue, std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.stopped) {
+      throw std::runtime_error("TransportExecutor: the executor is stopped");
+    }
+    queue.tasks.push_back(std::move(task));
+  }
+  queue.cv.notify_one();
+}
+
+void TransportExecutor::startWorkers(WorkQueue &queue, std::size_t numWorkers) {
+  for (std::size_t i = 0; i < numWorkers; i++) {
+    queue.workers.emplace_back([&queue]() { runWorker(queue); });
+  }
+}
+
+void TransportExecutor::stopWorkers(WorkQueue &queue) {
+  {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.stopped = true;
+  }
+  queue.cv.notify_all();
+  for (std::thread &worker : queue.workers) {
+    worker.join();
+  }
+}
+
+void TransportExecutor::runWorker(WorkQueue &queue) {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(queue.mutex);
+      queue.cv.wait(lock, [&queue]() {
+        return queue.stopped || !queue.tasks.empty();
+      });
+      // the tasks queued before stopping still run
+      if (queue.tasks.empty()) {
+        return;
+      }
+      task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+    }
+    // exceptions are stored in the future by the packaged_task
+    task();
+  }
+}
+
+namespace {
+
+std::mutex executor_mutex;
+// not destroyed at exit, where its workers may still wait on sockets
+TransportExecutor *global_executor = nullptr;
+
+}  // namespace
+
+TransportExecutor &getTransportExecutor() {
+  std::lock_guard<std::mutex> lock(executor_mutex);
+  if (global_executor == nullptr) {
+    const std::size_t hardware_threads =
+        std::max(4u, std::thread::hardware_concurrency());
+    global_executor =
+        new TransportExecutor(std::min<std::size_t>(hardware_threads, 8), 32);
+  }
+  return *global_executor;
+}
+
+void setTransportExecutor(std::size_t numCopyWorkers,
+                          std::size_t numSocketWorkers) {
+  TransportExecutor *executor =
+      new TransportExecutor(numCopyWorkers, numSocketWorkers);
+  {
+    std::lock_guard<std::mutex> lock(executor_mutex);
+    std::swap(executor, global_executor);
+  }
+  delete executor;
+}
+
+}  // namespace io
+}  // namespace transport
+}  // namespace blazingdb
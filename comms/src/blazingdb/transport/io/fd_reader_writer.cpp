@@ -36,6 +36,31 @@ size_t writeToSocket(void* fileDescriptor, char* buf, size_t nbyte, bool more) {
   return nbyte;
 }
 
+size_t writeToSocket(void* fileDescriptor, char* buf, size_t nbyte,
+                     zmq_free_fn* free_function, void* hint, bool more) {
+  zmq::socket_t* socket = (zmq::socket_t*)fileDescriptor;
+  // the message owns buf from now on, it calls free_function when destroyed
+  zmq::message_t message(buf, nbyte, free_function, hint);
+  try {
+    socket->send(message, more ? ZMQ_SNDMORE : 0);
+  } catch (std::exception& e) {
+    // std::cerr << e.what() << std::endl;
+  }
+  return nbyte;
+}
+
+zmq::message_t readMessageFromSocket(void* fileDescriptor) {
+  zmq::socket_t* socket = (zmq::socket_t*)fileDescriptor;
+  zmq::message_t msg;
+  try {
+    socket->recv(&msg);
+  } catch (std::exception& e) {
+    // std::cerr << e.what() << std::endl;
+    msg.rebuild();
+  }
+  return msg;
+}
+
 }  // namespace io
 }  // namespace transport
 }  // namespace blazingdb
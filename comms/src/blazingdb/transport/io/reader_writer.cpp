@@ -1,80 +1,76 @@
 #include "blazingdb/transport/io/reader_writer.h"
 #include <cuda.h>
 #include <cuda_runtime_api.h>
+#include "blazingdb/transport/io/Compression.h"
+#include "blazingdb/transport/io/TransportExecutor.h"
 #include "blazingdb/transport/io/fd_reader_writer.h"
 #include "rmm/rmm.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <future>
 #include <iostream>
 #include <mutex>
-#include <stack>
+#include <new>
 #include <thread>
 #include <vector>
 
 #include <cassert>
-#include <queue>
 #include "blazingdb/transport/ColumnTransport.h"
+#include "blazingdb/transport/io/SharedMemoryRing.h"
 
 namespace blazingdb {
 namespace transport {
 namespace io {
 
-// numBuffers should be equal to number of threads
-PinnedBufferProvider::PinnedBufferProvider(std::size_t sizeBuffers,
-                                           std::size_t numBuffers) {
-  for (int bufferIndex = 0; bufferIndex < numBuffers; bufferIndex++) {
-    PinnedBuffer *buffer = new PinnedBuffer();
-    buffer->size = sizeBuffers;
-    this->bufferSize = sizeBuffers;
-    cudaError_t err = cudaMallocManaged((void **)&buffer->data, sizeBuffers);
+namespace {
+
+class PinnedAllocator : public BufferAllocator {
+public:
+  char *allocate(std::size_t size) override {
+    char *data = nullptr;
+    cudaError_t err = cudaMallocHost((void **)&data, size);
     if (err != cudaSuccess) {
-      throw std::exception();
+      throw std::bad_alloc();
     }
-    this->buffers.push(buffer);
+    return data;
   }
-}
 
-// TODO: consider adding some kind of priority
-// based on when the request was made
-PinnedBuffer *PinnedBufferProvider::getBuffer() {
-  std::unique_lock<std::mutex> lock(inUseMutex);
-  if (this->buffers.empty()) {
-    // cv.wait(lock, [this] { return !this->buffers.empty(); });
-    // if wait fail use:
-    this->grow();
+  void deallocate(char *data, std::size_t /*size*/) override {
+    cudaFreeHost(data);
   }
-  PinnedBuffer *temp = this->buffers.top();
-  this->buffers.pop();
-  return temp;
-}
+};
 
-void PinnedBufferProvider::grow() {
-  PinnedBuffer *buffer = new PinnedBuffer();
-  buffer->size = this->bufferSize;
-  cudaError_t err = cudaMallocManaged((void **)&buffer->data, this->bufferSize);
-  if (err != cudaSuccess) {
-    throw std::exception();
+// the chunks, and smaller classes for the last chunk of each buffer and for
+// the small buffers, like the valid masks
+std::vector<std::size_t> defaultSizeClasses(std::size_t sizeBuffers) {
+  constexpr std::size_t min_size_class = 4096;
+  std::vector<std::size_t> sizeClasses{sizeBuffers};
+  for (std::size_t divisor : {16, 256}) {
+    if (sizeBuffers / divisor >= min_size_class) {
+      sizeClasses.push_back(sizeBuffers / divisor);
+    }
   }
-  this->buffers.push(buffer);
+  return sizeClasses;
 }
 
-void PinnedBufferProvider::freeBuffer(PinnedBuffer *buffer) {
-  std::unique_lock<std::mutex> lock(inUseMutex);
-  this->buffers.push(buffer);
-  cv.notify_one();
-}
+}  // namespace
 
-void PinnedBufferProvider::freeAll() {
-  std::unique_lock<std::mutex> lock(inUseMutex);
-  while (false == this->buffers.empty()) {
-    PinnedBuffer *buffer = this->buffers.top();
-    cudaFree(buffer->data);
-    delete buffer;
-    this->buffers.pop();
-  }
+std::unique_ptr<BufferAllocator> makePinnedAllocator() {
+  return std::unique_ptr<BufferAllocator>(new PinnedAllocator());
 }
 
-std::size_t PinnedBufferProvider::sizeBuffers() { return this->bufferSize; }
+PinnedBufferProvider::PinnedBufferProvider(std::size_t sizeBuffers,
+                                           std::size_t numBuffers)
+    : PinnedBufferProvider(defaultSizeClasses(sizeBuffers),
+                           std::max<std::size_t>(numBuffers, 2) * sizeBuffers,
+                           makePinnedAllocator()) {
+  reserve(numBuffers);
+}
 
 static std::shared_ptr<PinnedBufferProvider> global_instance{};
 
@@ -83,198 +79,543 @@ void setPinnedBufferProvider(std::size_t sizeBuffers, std::size_t numBuffers) {
       std::make_shared<PinnedBufferProvider>(sizeBuffers, numBuffers);
 }
 
+void setPinnedBufferProvider(std::shared_ptr<PinnedBufferProvider> provider) {
+  global_instance = provider;
+}
+
 PinnedBufferProvider &getPinnedBufferProvider() { return *global_instance; }
 
+static std::atomic<bool> zero_copy{true};
+
+void setZeroCopy(bool enabled) { zero_copy = enabled; }
+
+bool isZeroCopy() { return zero_copy; }
+
+namespace {
+
+// A chunk lent to ZMQ. It keeps the provider alive, because ZMQ gives the
+// chunk back from its I/O thread, possibly after setPinnedBufferProvider has
+// replaced the provider.
+struct LentChunk {
+  std::shared_ptr<PinnedBufferProvider> provider;
+  PinnedBuffer *buffer;
+};
+
+void returnLentChunk(void * /*data*/, void *hint) {
+  LentChunk *chunk = static_cast<LentChunk *>(hint);
+  chunk->provider->endLend(chunk->buffer->size);
+  chunk->provider->freeBuffer(chunk->buffer);
+  delete chunk;
+}
+
+// A chunk compressed by a copy worker, data is nullptr when the chunk is sent
+// as it is because it does not get smaller.
+struct CompressedChunk {
+  char *data;
+  std::size_t size;
+};
+
+void freeCompressedChunk(void *data, void * /*hint*/) {
+  delete[] static_cast<char *>(data);
+}
+
+CompressedChunk compressChunk(Codec codec, const char *chunk,
+                              std::size_t size) {
+  if (codec == Codec::none || size == 0) {
+    return CompressedChunk{nullptr, 0};
+  }
+  const std::size_t capacity = compressBound(codec, size);
+  std::unique_ptr<char[]> compressed(new char[capacity]);
+  const std::size_t compressedSize =
+      compress(codec, chunk, size, compressed.get(), capacity);
+  if (compressedSize == 0 || compressedSize >= size) {
+    return CompressedChunk{nullptr, 0};
+  }
+  return CompressedChunk{compressed.release(), compressedSize};
+}
+
+// Decompresses a chunk received compressed into buffer and copies it to the
+// GPU, then frees the buffer.
+void copyCompressedChunk(PinnedBufferProvider &provider, PinnedBuffer *buffer,
+                         Codec codec, const zmq::message_t &message,
+                         char *destination, std::size_t size, int gpuNum) {
+  try {
+    decompress(codec, static_cast<const char *>(message.data()),
+               message.size(), (char *)buffer->data, size);
+  } catch (...) {
+    provider.freeBuffer(buffer);
+    throw;
+  }
+  cudaSetDevice(gpuNum);
+  cudaMemcpyAsync(destination, buffer->data, size, cudaMemcpyHostToDevice,
+                  nullptr);
+  cudaStreamSynchronize(nullptr);
+  provider.freeBuffer(buffer);
+}
+
+// The part of a buffer copied to pick its codec: its start, middle and end.
+constexpr std::size_t CODEC_SAMPLE_SLICE_SIZE = 16 * 1024;
+
+}  // namespace
+
+std::vector<Codec> chooseBufferCodecs(const std::vector<int64_t> &bufferSizes,
+                                      const std::vector<char *> &buffers,
+                                      int gpuNum) {
+  const CompressionMode mode = getCompressionMode();
+  std::vector<Codec> codecs(bufferSizes.size(), Codec::none);
+  if (mode == CompressionMode::none) {
+    return codecs;
+  }
+  std::vector<char> sample;
+  for (size_t bufferIndex = 0; bufferIndex < bufferSizes.size();
+       bufferIndex++) {
+    const std::size_t bufferSize = bufferSizes[bufferIndex];
+    if (bufferSize < MIN_COMPRESSED_BUFFER_SIZE) {
+      continue;
+    }
+    const std::size_t sliceSize =
+        std::min(CODEC_SAMPLE_SLICE_SIZE, bufferSize / 3);
+    sample.resize(3 * sliceSize);
+    const std::size_t offsets[] = {0, (bufferSize - sliceSize) / 2,
+                                   bufferSize - sliceSize};
+    cudaSetDevice(gpuNum);
+    for (std::size_t slice = 0; slice < 3; slice++) {
+      cudaMemcpy(sample.data() + slice * sliceSize,
+                 buffers[bufferIndex] + offsets[slice], sliceSize,
+                 cudaMemcpyDeviceToHost);
+    }
+    codecs[bufferIndex] = chooseCodec(mode, sample.data(), sample.size());
+  }
+  return codecs;
+}
+
 void writeBuffersFromGPUTCP(std::vector<ColumnTransport> &column_transport,
-                            std::vector<int> bufferSizes,
+                            std::vector<int64_t> bufferSizes,
                             std::vector<char *> buffers, void *fileDescriptor,
                             int gpuNum) {
   if (bufferSizes.size() == 0) {
     return;
   }
-  struct queue_item {
-    std::size_t bufferIndex{};
-    std::size_t chunkIndex{};
-    PinnedBuffer *chunk{nullptr};
-    std::size_t chunk_size{};
-
-    bool operator<(const queue_item &item) const {
-      if (bufferIndex == item.bufferIndex) {
-        return chunkIndex > item.chunkIndex;
-      } else {
-        return bufferIndex > item.bufferIndex;
-      }
+  struct chunk_item {
+    PinnedBuffer *chunk;
+    std::size_t chunk_size;
+    // the chunk has been freed if it was compressed
+    std::future<CompressedChunk> copied;
+  };
+  const bool zeroCopy = isZeroCopy();
+  std::shared_ptr<PinnedBufferProvider> provider = global_instance;
+  TransportExecutor &executor = getTransportExecutor();
+  const std::size_t chunkSize = provider->sizeBuffers();
+  // chunks being copied from the GPU ahead of the one being written
+  const std::size_t maxChunksInFlight = 2 * executor.numCopyWorkers();
+  const std::vector<Codec> codecs =
+      getBufferCodecs(column_transport, bufferSizes.size());
+
+  // The chunks are copied by the copy workers and written by this thread, in
+  // order. Waiting for the oldest chunk is how they are reassembled.
+  std::deque<chunk_item> chunksInFlight;
+  auto writeOldestChunk = [&]() {
+    chunk_item item = std::move(chunksInFlight.front());
+    chunksInFlight.pop_front();
+    PinnedBuffer *buffer = item.chunk;
+    CompressedChunk compressed;
+    try {
+      compressed = item.copied.get();
+    } catch (...) {
+      provider->freeBuffer(buffer);
+      throw;
     }
 
-    bool operator==(const queue_item &item) const {
-      return ((bufferIndex == item.bufferIndex) &&
-              (chunkIndex == item.chunkIndex));
+    if (compressed.data != nullptr) {
+      // the receiver tells it is compressed because it is smaller than the
+      // chunk
+      writeToSocket(fileDescriptor, compressed.data, compressed.size,
+                    freeCompressedChunk, nullptr);
+    } else if (zeroCopy && provider->tryLend(buffer->size)) {
+      // the chunk goes back to the provider once ZMQ has sent it. The parts
+      // of a message are only sent with the last one, so all the chunks of
+      // the message are in use until then.
+      writeToSocket(fileDescriptor, (char *)buffer->data, item.chunk_size,
+                    returnLentChunk, new LentChunk{provider, buffer});
+    } else {
+      std::size_t amountWritten = writeToSocket(
+          fileDescriptor, (char *)buffer->data, item.chunk_size);
+      provider->freeBuffer(buffer);
+      if (amountWritten != item.chunk_size) {
+        throw std::exception();
+      }
     }
   };
-  std::vector<std::thread> writeThreads(bufferSizes.size());
-  std::priority_queue<queue_item> writePairs;
-  std::condition_variable cv;
-  std::mutex writeMutex;
-  std::vector<std::thread> allocationThreads(bufferSizes.size());
-  std::vector<char *> tempReadAllocations(bufferSizes.size());
-  std::vector<std::thread> copyThreads(bufferSizes.size());
-  std::size_t amountWrittenTotalTotal = 0;
 
-  std::vector<queue_item> writeOrder;
-  for (size_t bufferIndex = 0; bufferIndex < bufferSizes.size();
-       bufferIndex++) {
-    std::size_t amountWrittenTotal = 0;
-    size_t chunkIndex = 0;
-    do {
-      writeOrder.push_back(
-          {.bufferIndex = bufferIndex, .chunkIndex = chunkIndex});
-      amountWrittenTotal += getPinnedBufferProvider().sizeBuffers();
-      chunkIndex++;
-    } while (amountWrittenTotal < bufferSizes[bufferIndex]);
-  }
+  try {
+    for (size_t bufferIndex = 0; bufferIndex < bufferSizes.size();
+         bufferIndex++) {
+      const std::size_t bufferSize = bufferSizes[bufferIndex];
+      std::size_t amountWrittenTotal = 0;
+      do {
+        std::size_t amountToWrite;
+        if ((bufferSize - amountWrittenTotal) > chunkSize)
+          amountToWrite = chunkSize;
+        else
+          amountToWrite = bufferSize - amountWrittenTotal;
 
-  // buffer is from gpu or is from cpu
-  for (size_t bufferIndex = 0; bufferIndex < bufferSizes.size();
-       bufferIndex++) {
-    copyThreads[bufferIndex] = std::thread(
-        [bufferIndex, &cv, &amountWrittenTotalTotal, &writeMutex, &buffers,
-         &writePairs, &writeOrder, &bufferSizes, &tempReadAllocations,
-         &allocationThreads, fileDescriptor, gpuNum]() {
-          cudaSetDevice(gpuNum);
-          std::size_t amountWrittenTotal = 0;
-          size_t chunkIndex = 0;
-          do {
-            PinnedBuffer *buffer = getPinnedBufferProvider().getBuffer();
-            std::size_t amountToWrite;
-            if ((bufferSizes[bufferIndex] - amountWrittenTotal) > buffer->size)
-              amountToWrite = buffer->size;
-            else
-              amountToWrite = bufferSizes[bufferIndex] - amountWrittenTotal;
+        if (chunksInFlight.size() == maxChunksInFlight) {
+          writeOldestChunk();
+        }
+        // This thread only waits for a buffer when it holds none, otherwise
+        // the memory it waits for could be in its own chunks.
+        const std::size_t size = std::max<std::size_t>(amountToWrite, 1);
+        PinnedBuffer *buffer = provider->tryGetBuffer(size);
+        while (buffer == nullptr && !chunksInFlight.empty()) {
+          writeOldestChunk();
+          buffer = provider->tryGetBuffer(size);
+        }
+        if (buffer == nullptr) {
+          buffer = provider->getBuffer(size);
+        }
 
-            cudaSetDevice(gpuNum);
-            cudaMemcpyAsync(buffer->data,
-                            buffers[bufferIndex] + amountWrittenTotal,
-                            amountToWrite, cudaMemcpyDeviceToHost, nullptr);
-            cudaStreamSynchronize(nullptr);
-            {
-              std::unique_lock<std::mutex> lock(writeMutex);
-              writePairs.push(queue_item{.bufferIndex = bufferIndex,
-                                         .chunkIndex = chunkIndex,
-                                         .chunk = buffer,
-                                         .chunk_size = amountToWrite});
-              chunkIndex++;
-              amountWrittenTotal += amountToWrite;
-              cv.notify_one();
-            }
-          } while (amountWrittenTotal < bufferSizes[bufferIndex]);
-          {
-            std::lock_guard<std::mutex> lock(writeMutex);
-            amountWrittenTotalTotal += amountWrittenTotal;
-          }
-        });
+        char *source = buffers[bufferIndex] + amountWrittenTotal;
+        const Codec codec = codecs[bufferIndex];
+        std::future<CompressedChunk> copied = executor.submitCopy(
+            [buffer, source, amountToWrite, gpuNum, codec, provider]() {
+              cudaSetDevice(gpuNum);
+              cudaMemcpyAsync(buffer->data, source, amountToWrite,
+                              cudaMemcpyDeviceToHost, nullptr);
+              cudaStreamSynchronize(nullptr);
+              CompressedChunk compressed =
+                  compressChunk(codec, (char *)buffer->data, amountToWrite);
+              if (compressed.data != nullptr) {
+                provider->freeBuffer(buffer);
+              }
+              return compressed;
+            });
+        chunksInFlight.push_back(
+            chunk_item{buffer, amountToWrite, std::move(copied)});
+        amountWrittenTotal += amountToWrite;
+      } while (amountWrittenTotal < bufferSize);
+    }
+    while (!chunksInFlight.empty()) {
+      writeOldestChunk();
+    }
+  } catch (...) {
+    for (chunk_item &item : chunksInFlight) {
+      try {
+        CompressedChunk compressed = item.copied.get();
+        if (compressed.data != nullptr) {
+          delete[] compressed.data;
+          continue;
+        }
+      } catch (...) {
+      }
+      provider->freeBuffer(item.chunk);
+    }
+    throw;
   }
+}
 
-  std::thread writeThread =
-      std::thread([fileDescriptor, &writePairs, &bufferSizes, writeOrder,
-                   &writeMutex, &cv] {
-        PinnedBuffer *buffer = nullptr;
-        std::size_t amountToWrite;
-        queue_item item;
-        std::size_t writeIndex = 0;
-        bool started = false;
-        do {
-          {
-            std::unique_lock<std::mutex> lock(writeMutex);
-            cv.wait(lock, [&writePairs, &writeOrder, writeIndex] {
-              return !writePairs.empty() &&
-                     writeOrder[writeIndex] == writePairs.top();
-            });
-            item = writePairs.top();
-            amountToWrite = item.chunk_size;
-            buffer = item.chunk;
-            started = false;
-            writePairs.pop();
-          }
+// The chunks are received in place into ZMQ messages and copied to the GPU
+// from there, each message lives until its copy is done. The compressed chunks
+// are decompressed into pinned buffers first.
+static void readBuffersIntoGPUZeroCopy(
+    const std::vector<int64_t> &bufferSizes, const std::vector<Codec> &codecs,
+    const std::vector<char *> &tempReadAllocations, void *fileDescriptor,
+    int gpuNum) {
+  if (bufferSizes.empty()) {
+    return;
+  }
+  std::shared_ptr<PinnedBufferProvider> provider = global_instance;
+  TransportExecutor &executor = getTransportExecutor();
+  const std::size_t chunkSize = provider->sizeBuffers();
+  std::vector<std::future<void>> copies;
+  auto waitCopies = [&copies]() {
+    for (auto &copy : copies) {
+      copy.get();
+    }
+  };
+  for (size_t bufferIndex = 0; bufferIndex < bufferSizes.size();
+       bufferIndex++) {
+    const std::size_t bufferSize = bufferSizes[bufferIndex];
+    std::size_t amountReadTotal = 0;
+    do {
+      std::size_t amountToRead = (bufferSize - amountReadTotal) > chunkSize
+                                     ? chunkSize
+                                     : bufferSize - amountReadTotal;
 
-          if (buffer != nullptr) {
-            std::lock_guard<std::mutex> lock(writeMutex);
-            std::size_t amountWritten = writeToSocket(
-                fileDescriptor, (char *)buffer->data, amountToWrite);
-            writeIndex++;
-            if (amountWritten != amountToWrite) {
-              getPinnedBufferProvider().freeBuffer(buffer);
-              throw std::exception();
-            }
-            getPinnedBufferProvider().freeBuffer(buffer);
-          }
-        } while (writeIndex < writeOrder.size());
-      });
+      zmq::message_t message = readMessageFromSocket(fileDescriptor);
+      const Codec codec = codecs[bufferIndex];
+      const bool compressed =
+          codec != Codec::none && message.size() < amountToRead;
+      if (!compressed && message.size() != amountToRead) {
+        waitCopies();
+        throw std::exception();
+      }
+      char *destination = tempReadAllocations[bufferIndex] + amountReadTotal;
+      if (compressed) {
+        // the copies free the buffers, so this does not wait forever
+        PinnedBuffer *buffer = provider->getBuffer(amountToRead);
+        copies.push_back(executor.submitCopy(
+            [provider, buffer, codec, destination, amountToRead, gpuNum,
+             message = std::move(message)]() {
+              copyCompressedChunk(*provider, buffer, codec, message,
+                                  destination, amountToRead, gpuNum);
+            }));
+      } else {
+        copies.push_back(executor.submitCopy(
+            [destination, gpuNum, message = std::move(message)]() {
+              cudaSetDevice(gpuNum);
+              cudaMemcpy(destination, message.data(), message.size(),
+                         cudaMemcpyHostToDevice);
+            }));
+      }
+      amountReadTotal += amountToRead;
 
-  for (std::size_t threadIndex = 0; threadIndex < writeThreads.size();
-       threadIndex++) {
-    copyThreads[threadIndex].join();
+    } while (amountReadTotal < bufferSize);
   }
-  {
-    std::unique_lock<std::mutex> lock(writeMutex);
-    writePairs.push({.bufferIndex = INT_MAX,
-                     .chunkIndex = INT_MAX,
-                     .chunk = nullptr,
-                     .chunk_size = amountWrittenTotalTotal});
-    cv.notify_one();
-  }
-  writeThread.join();
-  PinnedBuffer *buffer = getPinnedBufferProvider().getBuffer();
-  getPinnedBufferProvider().freeBuffer(buffer);
-  getPinnedBufferProvider().freeAll();
+  waitCopies();
 }
 
-std::vector<char *> readBuffersIntoGPUTCP(std::vector<int> bufferSizes,
-                                          void *fileDescriptor, int gpuNum) {
-  std::vector<std::thread> allocationThreads(bufferSizes.size());
-  std::vector<std::thread> readThreads(bufferSizes.size());
+std::vector<char *> readBuffersIntoGPUTCP(
+    const std::vector<ColumnTransport> &column_transport,
+    std::vector<int64_t> bufferSizes, void *fileDescriptor, int gpuNum) {
+  const std::vector<Codec> codecs =
+      getBufferCodecs(column_transport, bufferSizes.size());
   std::vector<char *> tempReadAllocations(bufferSizes.size());
-  for (int bufferIndex = 0; bufferIndex < bufferSizes.size(); bufferIndex++) {
+  for (size_t bufferIndex = 0; bufferIndex < bufferSizes.size();
+       bufferIndex++) {
     cudaSetDevice(gpuNum);
     RMM_ALLOC(reinterpret_cast<void **>(&tempReadAllocations[bufferIndex]),
               bufferSizes[bufferIndex], 0);
   }
-  for (int bufferIndex = 0; bufferIndex < bufferSizes.size(); bufferIndex++) {
-    std::vector<std::thread> copyThreads;
+  if (isZeroCopy()) {
+    readBuffersIntoGPUZeroCopy(bufferSizes, codecs, tempReadAllocations,
+                               fileDescriptor, gpuNum);
+    return tempReadAllocations;
+  }
+  std::shared_ptr<PinnedBufferProvider> provider = global_instance;
+  TransportExecutor &executor = getTransportExecutor();
+  std::vector<std::future<void>> copies;
+  for (size_t bufferIndex = 0; bufferIndex < bufferSizes.size();
+       bufferIndex++) {
+    const std::size_t bufferSize = bufferSizes[bufferIndex];
     std::size_t amountReadTotal = 0;
     do {
-      PinnedBuffer *buffer = getPinnedBufferProvider().getBuffer();
       std::size_t amountToRead =
-          (bufferSizes[bufferIndex] - amountReadTotal) > buffer->size
-              ? buffer->size
-              : bufferSizes[bufferIndex] - amountReadTotal;
+          (bufferSize - amountReadTotal) > provider->sizeBuffers()
+              ? provider->sizeBuffers()
+              : bufferSize - amountReadTotal;
+      // the copies free the buffers, so this does not wait forever
+      PinnedBuffer *buffer =
+          provider->getBuffer(std::max<std::size_t>(amountToRead, 1));
+      char *destination = tempReadAllocations[bufferIndex] + amountReadTotal;
 
-      std::size_t amountRead =
-          readFromSocket(fileDescriptor, (char *)buffer->data, amountToRead);
+      std::size_t amountRead;
+      const Codec codec = codecs[bufferIndex];
+      if (codec != Codec::none) {
+        // only the messages of the chunks tell whether they are compressed
+        zmq::message_t message = readMessageFromSocket(fileDescriptor);
+        if (message.size() < amountToRead) {
+          copies.push_back(executor.submitCopy(
+              [provider, buffer, codec, destination, amountToRead, gpuNum,
+               message = std::move(message)]() {
+                copyCompressedChunk(*provider, buffer, codec, message,
+                                    destination, amountToRead, gpuNum);
+              }));
+          amountReadTotal += amountToRead;
+          continue;
+        }
+        amountRead = message.size();
+        if (amountRead == amountToRead) {
+          memcpy(buffer->data, message.data(), amountRead);
+        }
+      } else {
+        amountRead =
+            readFromSocket(fileDescriptor, (char *)buffer->data, amountToRead);
+      }
 
       assert(amountRead == amountToRead);
       if (amountRead != amountToRead) {
-        getPinnedBufferProvider().freeBuffer(buffer);
+        provider->freeBuffer(buffer);
+        for (auto &copy : copies) {
+          copy.wait();
+        }
         throw std::exception();
       }
-      copyThreads.push_back(std::thread(
-          [&tempReadAllocations, &bufferSizes, &allocationThreads, bufferIndex,
-           buffer, amountRead, amountReadTotal, gpuNum]() {
+      copies.push_back(executor.submitCopy(
+          [destination, buffer, amountRead, gpuNum, provider]() {
             cudaSetDevice(gpuNum);
-            cudaMemcpyAsync(tempReadAllocations[bufferIndex] + amountReadTotal,
-                            buffer->data, amountRead, cudaMemcpyHostToDevice,
-                            nullptr);
-            getPinnedBufferProvider().freeBuffer(buffer);
+            cudaMemcpyAsync(destination, buffer->data, amountRead,
+                            cudaMemcpyHostToDevice, nullptr);
             cudaStreamSynchronize(nullptr);
+            provider->freeBuffer(buffer);
           }));
       amountReadTotal += amountRead;
 
-    } while (amountReadTotal < bufferSizes[bufferIndex]);
-    for (std::size_t threadIndex = 0; threadIndex < copyThreads.size();
-         threadIndex++) {
-      copyThreads[threadIndex].join();
+    } while (amountReadTotal < bufferSize);
+  }
+  for (auto &copy : copies) {
+    copy.get();
+  }
+
+  return tempReadAllocations;
+}
+
+void pinSharedMemoryRing(SharedMemoryRing &ring) {
+  if (cudaHostRegister(ring.data(), ring.capacity(),
+                       cudaHostRegisterPortable) != cudaSuccess) {
+    // the copies are staged by the driver instead
+    cudaGetLastError();
+  }
+}
+
+void unpinSharedMemoryRing(SharedMemoryRing &ring) {
+  if (cudaHostUnregister(ring.data()) != cudaSuccess) {
+    cudaGetLastError();
+  }
+}
+
+namespace {
+
+// Both sides split the buffers in chunks of this size and go through them in
+// the same order, so they compute the same positions in the ring
+std::size_t sharedMemoryChunkSize(const SharedMemoryRing &ring) {
+  return std::max<std::size_t>(ring.capacity() / 4, 1);
+}
+
+// Whether the reply to the request being written has arrived
+bool hasReply(void *fileDescriptor) {
+  zmq::socket_t *socket = (zmq::socket_t *)fileDescriptor;
+  int events = 0;
+  std::size_t events_size = sizeof(events);
+  socket->getsockopt(ZMQ_EVENTS, &events, &events_size);
+  return (events & ZMQ_POLLIN) != 0;
+}
+
+}  // namespace
+
+bool writeBuffersToSharedMemory(SharedMemoryRing &ring,
+                                const std::vector<int64_t> &bufferSizes,
+                                const std::vector<char *> &buffers,
+                                void *fileDescriptor, int gpuNum,
+                                std::chrono::milliseconds timeout) {
+  struct chunk_item {
+    uint64_t end;
+    std::future<void> copied;
+  };
+  TransportExecutor &executor = getTransportExecutor();
+  const std::size_t chunkSize = sharedMemoryChunkSize(ring);
+  const std::size_t maxChunksInFlight = 2 * executor.numCopyWorkers();
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+
+  // The chunks are copied by the copy workers and committed by this thread,
+  // in order, so the reader sees them as soon as they are complete.
+  std::deque<chunk_item> chunksInFlight;
+  auto commitOldestChunk = [&]() {
+    chunk_item item = std::move(chunksInFlight.front());
+    chunksInFlight.pop_front();
+    item.copied.get();
+    ring.commit(item.end);
+  };
+  auto waitChunksInFlight = [&]() {
+    for (chunk_item &item : chunksInFlight) {
+      item.copied.wait();
+    }
+  };
+
+  try {
+    for (size_t bufferIndex = 0; bufferIndex < bufferSizes.size();
+         bufferIndex++) {
+      const std::size_t bufferSize = bufferSizes[bufferIndex];
+      std::size_t amountToWrite = 0;
+      for (std::size_t amountWrittenTotal = 0; amountWrittenTotal < bufferSize;
+           amountWrittenTotal += amountToWrite) {
+        amountToWrite = std::min(chunkSize, bufferSize - amountWrittenTotal);
+        if (chunksInFlight.size() == maxChunksInFlight) {
+          commitOldestChunk();
+        }
+        int64_t position = ring.tryReserve(amountToWrite);
+        while (position < 0 && !chunksInFlight.empty()) {
+          commitOldestChunk();
+          position = ring.tryReserve(amountToWrite);
+        }
+        // the reader releases the chunks as it copies them to its GPU
+        for (int attempt = 0; position < 0; attempt++) {
+          if (attempt >= 1000) {
+            if (hasReply(fileDescriptor)) {
+              return false;
+            }
+            if (timeout.count() >= 0 &&
+                std::chrono::steady_clock::now() > deadline) {
+              throw std::runtime_error(
+                  "writeBuffersToSharedMemory: the reader does not release " +
+                  ring.name());
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(20));
+          }
+          position = ring.tryReserve(amountToWrite);
+        }
+
+        char *source = buffers[bufferIndex] + amountWrittenTotal;
+        char *destination = ring.data(position);
+        std::future<void> copied = executor.submitCopy(
+            [source, destination, amountToWrite, gpuNum]() {
+              cudaSetDevice(gpuNum);
+              cudaMemcpyAsync(destination, source, amountToWrite,
+                              cudaMemcpyDeviceToHost, nullptr);
+              cudaStreamSynchronize(nullptr);
+            });
+        chunksInFlight.push_back(
+            chunk_item{position + amountToWrite, std::move(copied)});
+      }
     }
+    while (!chunksInFlight.empty()) {
+      commitOldestChunk();
+    }
+  } catch (...) {
+    waitChunksInFlight();
+    throw;
   }
+  return true;
+}
 
+std::vector<char *> readBuffersFromSharedMemory(
+    SharedMemoryRing &ring, const std::vector<int64_t> &bufferSizes,
+    int gpuNum, std::chrono::milliseconds timeout) {
+  cudaSetDevice(gpuNum);
+  std::vector<char *> tempReadAllocations(bufferSizes.size());
+  for (size_t bufferIndex = 0; bufferIndex < bufferSizes.size();
+       bufferIndex++) {
+    RMM_ALLOC(reinterpret_cast<void **>(&tempReadAllocations[bufferIndex]),
+              bufferSizes[bufferIndex], 0);
+  }
+  const std::size_t chunkSize = sharedMemoryChunkSize(ring);
+  // the previous message has been released completely
+  uint64_t end = ring.released();
+  try {
+    for (size_t bufferIndex = 0; bufferIndex < bufferSizes.size();
+         bufferIndex++) {
+      const std::size_t bufferSize = bufferSizes[bufferIndex];
+      std::size_t amountToRead = 0;
+      for (std::size_t amountReadTotal = 0; amountReadTotal < bufferSize;
+           amountReadTotal += amountToRead) {
+        amountToRead = std::min(chunkSize, bufferSize - amountReadTotal);
+        const uint64_t position = ring.nextPosition(end, amountToRead);
+        end = position + amountToRead;
+        ring.waitCommitted(end, timeout);
+        // the ring is pinned, the copy is a DMA transfer while the writer
+        // fills the next chunks
+        cudaMemcpyAsync(tempReadAllocations[bufferIndex] + amountReadTotal,
+                        ring.data(position), amountToRead,
+                        cudaMemcpyHostToDevice, nullptr);
+        cudaStreamSynchronize(nullptr);
+        ring.release(end);
+      }
+    }
+  } catch (...) {
+    for (char *allocation : tempReadAllocations) {
+      RMM_FREE(allocation, 0);
+    }
+    throw;
+  }
   return tempReadAllocations;
 }
 
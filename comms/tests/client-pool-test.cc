@@ -0,0 +1,129 @@
+#include <blazingdb/transport/ClientPool.h>
+#include <blazingdb/transport/Server.h>
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace blazingdb {
+namespace transport {
+
+namespace {
+
+constexpr uint32_t context_token = 7301;
+constexpr unsigned short server_port = 8020;
+
+// Message without columns, like the row counts and pivots sent during a
+// shuffle. Only the metadata goes through the socket.
+class EmptyMessage : public GPUMessage {
+public:
+  EmptyMessage(const std::string &messageToken, uint32_t contextToken,
+               std::shared_ptr<Node> &sender_node)
+      : GPUMessage{messageToken, contextToken, sender_node} {}
+
+  raw_buffer GetRawColumns() override { return raw_buffer{}; }
+
+  static std::string MessageID() { return "EmptyMessage"; }
+
+  static std::shared_ptr<GPUMessage> MakeFrom(
+      const Message::MetaData &message_metadata,
+      const Address::MetaData &address_metadata,
+      const std::vector<ColumnTransport> &columns_offsets,
+      const std::vector<char *> &raw_buffers) {
+    auto node = Node::Make(Address::TCP(address_metadata.ip,
+                                        address_metadata.comunication_port,
+                                        address_metadata.protocol_port));
+    return std::make_shared<EmptyMessage>(message_metadata.messageToken,
+                                          message_metadata.contextToken, node);
+  }
+};
+
+class ClientPoolTest : public testing::Test {
+protected:
+  static void SetUpTestCase() {
+    server = Server::TCP(server_port).release();
+    server->registerEndPoint(EmptyMessage::MessageID());
+    server->registerMessageForEndPoint(EmptyMessage::MakeFrom,
+                                       EmptyMessage::MessageID());
+    server->registerContext(context_token);
+    server->Run();
+  }
+
+  static void TearDownTestCase() {
+    server->Close();
+    delete server;
+    server = nullptr;
+  }
+
+  ClientPoolTest()
+      : sender_node{Node::Make(Address::TCP("127.0.0.1", 8021, 1234))} {}
+
+  // sends num_messages from num_threads threads and waits for the server to
+  // receive them
+  void sendMessages(int num_messages, int num_threads,
+                    std::function<Status(GPUMessage &)> send) {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+      threads.emplace_back([&, t] {
+        for (int i = t; i < num_messages; i += num_threads) {
+          EmptyMessage message(EmptyMessage::MessageID(), context_token,
+                               sender_node);
+          EXPECT_TRUE(send(message).IsOk());
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    for (int i = 0; i < num_messages; i++) {
+      EXPECT_NE(server->getMessage(context_token, EmptyMessage::MessageID(),
+                                   std::chrono::seconds(10)),
+                nullptr);
+    }
+  }
+
+  static Server *server;
+  std::shared_ptr<Node> sender_node;
+};
+
+Server *ClientPoolTest::server = nullptr;
+
+}  // namespace
+
+TEST_F(ClientPoolTest, ReusesConnections) {
+  ClientPool pool;
+  sendMessages(100, 4, [&](GPUMessage &message) {
+    return pool.Send("127.0.0.1", server_port, message);
+  });
+  EXPECT_LE(pool.connections(), 4u);
+  EXPECT_EQ(pool.idleClients(), pool.connections());
+
+  pool.Close();
+  EXPECT_EQ(pool.idleClients(), 0u);
+  sendMessages(1, 1, [&](GPUMessage &message) {
+    return pool.Send("127.0.0.1", server_port, message);
+  });
+  EXPECT_EQ(pool.idleClients(), 1u);
+}
+
+TEST_F(ClientPoolTest, ExpiredConnectionsAreReplaced) {
+  ClientPool::Options options;
+  options.idle_timeout = std::chrono::milliseconds(10);
+  ClientPool pool(options);
+
+  auto send = [&](GPUMessage &message) {
+    return pool.Send("127.0.0.1", server_port, message);
+  };
+  sendMessages(1, 1, send);
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  sendMessages(1, 1, send);
+  EXPECT_EQ(pool.connections(), 2u);
+  EXPECT_EQ(pool.idleClients(), 1u);
+}
+
+}  // namespace transport
+}  // namespace blazingdb
@@ -0,0 +1,154 @@
+#include <blazingdb/transport/io/Compression.h>
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace blazingdb {
+namespace transport {
+namespace io {
+
+namespace {
+
+template <typename T>
+std::vector<char> toBytes(const std::vector<T> &values) {
+  std::vector<char> bytes(values.size() * sizeof(T));
+  memcpy(bytes.data(), values.data(), bytes.size());
+  return bytes;
+}
+
+// Buffers like the ones of a shuffle, of about size bytes each
+
+// keys of a sorted partition
+std::vector<char> makeIntegers(std::size_t size) {
+  std::vector<int64_t> values(size / sizeof(int64_t));
+  std::mt19937 generator(1);
+  int64_t key = 1000000;
+  for (auto &value : values) {
+    key += generator() % 4;
+    value = key;
+  }
+  return toBytes(values);
+}
+
+// prices with two decimals
+std::vector<char> makeFloats(std::size_t size) {
+  std::vector<double> values(size / sizeof(double));
+  std::mt19937 generator(2);
+  for (auto &value : values) {
+    value = (generator() % 100000) / 100.0;
+  }
+  return toBytes(values);
+}
+
+// the characters of a low cardinality string column
+std::vector<char> makeStrings(std::size_t size) {
+  const std::vector<std::string> words{"UNITED STATES", "PERU", "GERMANY",
+                                       "DELIVERED", "RETURNED", "PENDING",
+                                       "AIR", "TRUCK", "MAIL"};
+  std::vector<char> bytes;
+  bytes.reserve(size);
+  std::mt19937 generator(3);
+  while (bytes.size() < size) {
+    const std::string &word = words[generator() % words.size()];
+    bytes.insert(bytes.end(), word.begin(), word.end());
+  }
+  bytes.resize(size);
+  return bytes;
+}
+
+std::vector<char> makeRandom(std::size_t size) {
+  std::vector<char> bytes(size);
+  std::mt19937 generator(4);
+  for (auto &byte : bytes) {
+    byte = static_cast<char>(generator());
+  }
+  return bytes;
+}
+
+void expectRoundTrip(Codec codec, const std::vector<char> &buffer) {
+  std::vector<char> compressed(compressBound(codec, buffer.size()));
+  std::size_t compressedSize = compress(codec, buffer.data(), buffer.size(),
+                                        compressed.data(), compressed.size());
+  ASSERT_GT(compressedSize, 0u);
+  std::vector<char> decompressed(buffer.size());
+  decompress(codec, compressed.data(), compressedSize, decompressed.data(),
+             decompressed.size());
+  EXPECT_EQ(decompressed, buffer);
+}
+
+}  // namespace
+
+TEST(CompressionTest, RoundTrips) {
+  for (Codec codec : {Codec::lz4, Codec::zstd}) {
+    expectRoundTrip(codec, makeIntegers(1 << 20));
+    expectRoundTrip(codec, makeFloats(1 << 20));
+    expectRoundTrip(codec, makeStrings(1 << 20));
+    expectRoundTrip(codec, makeRandom(1 << 20));
+  }
+}
+
+TEST(CompressionTest, RejectsCorruptBuffers) {
+  std::vector<char> buffer = makeStrings(1 << 16);
+  for (Codec codec : {Codec::lz4, Codec::zstd}) {
+    std::vector<char> compressed(compressBound(codec, buffer.size()));
+    std::size_t compressedSize =
+        compress(codec, buffer.data(), buffer.size(), compressed.data(),
+                 compressed.size());
+    std::vector<char> decompressed(buffer.size());
+    EXPECT_THROW(decompress(codec, compressed.data(), compressedSize / 2,
+                            decompressed.data(), decompressed.size()),
+                 std::runtime_error);
+    EXPECT_THROW(decompress(codec, compressed.data(), compressedSize,
+                            decompressed.data(), decompressed.size() - 1),
+                 std::runtime_error);
+  }
+}
+
+TEST(CompressionTest, ChoosesTheCodecFromTheSample) {
+  std::vector<char> strings = makeStrings(48 * 1024);
+  std::vector<char> random = makeRandom(48 * 1024);
+
+  EXPECT_EQ(chooseCodec(CompressionMode::none, strings.data(), strings.size()),
+            Codec::none);
+  EXPECT_EQ(chooseCodec(CompressionMode::lz4, strings.data(), strings.size()),
+            Codec::lz4);
+  EXPECT_EQ(chooseCodec(CompressionMode::zstd, strings.data(), strings.size()),
+            Codec::zstd);
+  EXPECT_NE(
+      chooseCodec(CompressionMode::automatic, strings.data(), strings.size()),
+      Codec::none);
+  for (CompressionMode mode : {CompressionMode::lz4, CompressionMode::zstd,
+                               CompressionMode::automatic}) {
+    EXPECT_EQ(chooseCodec(mode, random.data(), random.size()), Codec::none);
+  }
+}
+
+TEST(CompressionTest, BufferCodecsFollowTheColumnPositions) {
+  std::vector<ColumnTransport> columns(2);
+  columns[0].data = 0;
+  columns[0].valid = 1;
+  columns[0].strings_data = -1;
+  columns[0].strings_offsets = -1;
+  columns[0].strings_nullmask = -1;
+  columns[1].data = -1;
+  columns[1].valid = -1;
+  columns[1].strings_data = 2;
+  columns[1].strings_offsets = 3;
+  columns[1].strings_nullmask = -1;
+
+  std::vector<Codec> codecs{Codec::lz4, Codec::none, Codec::zstd, Codec::lz4};
+  setBufferCodecs(columns, codecs);
+  EXPECT_EQ(columns[0].data_codec, Codec::lz4);
+  EXPECT_EQ(columns[1].strings_data_codec, Codec::zstd);
+  EXPECT_EQ(columns[1].strings_offsets_codec, Codec::lz4);
+  EXPECT_EQ(getBufferCodecs(columns, codecs.size()), codecs);
+}
+
+}  // namespace io
+}  // namespace transport
+}  // namespace blazingdb
@@ -0,0 +1,249 @@
+#include <blazingdb/transport/ClientPool.h>
+#include <blazingdb/transport/FlowControl.h>
+#include <blazingdb/transport/Server.h>
+#include <cuda_runtime_api.h>
+#include "rmm/rmm.h"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace blazingdb {
+namespace transport {
+
+namespace {
+
+constexpr uint32_t context_token = 7501;
+constexpr unsigned short server_port = 8024;
+constexpr std::size_t buffer_size = 1024 * 1024;
+
+const SendCredits::Peer peer{"127.0.0.1", 8000};
+
+// Message with one device buffer. The buffers of a received one are freed
+// right away, only their size is kept.
+class BufferMessage : public GPUMessage {
+public:
+  BufferMessage(uint32_t contextToken, std::shared_ptr<Node> &sender_node,
+                char *buffer, int64_t size)
+      : GPUMessage{MessageID(), contextToken, sender_node},
+        buffer{buffer},
+        size{size} {}
+
+  raw_buffer GetRawColumns() override {
+    ColumnTransport column;
+    column.metadata.size = size;
+    column.data = 0;
+    column.valid = -1;
+    column.strings_data = -1;
+    column.strings_offsets = -1;
+    column.strings_nullmask = -1;
+    return std::make_tuple(std::vector<int64_t>{size},
+                           std::vector<char *>{buffer},
+                           std::vector<ColumnTransport>{column});
+  }
+
+  static std::string MessageID() { return "BufferMessage"; }
+
+  static std::shared_ptr<GPUMessage> MakeFrom(
+      const Message::MetaData &message_metadata,
+      const Address::MetaData &address_metadata,
+      const std::vector<ColumnTransport> &columns_offsets,
+      const std::vector<char *> &raw_buffers) {
+    for (char *raw_buffer : raw_buffers) {
+      RMM_FREE(raw_buffer, 0);
+    }
+    auto node = Node::Make(Address::TCP(address_metadata.ip,
+                                        address_metadata.comunication_port,
+                                        address_metadata.protocol_port));
+    return std::make_shared<BufferMessage>(message_metadata.contextToken,
+                                           node, nullptr,
+                                           columns_offsets.at(0).metadata.size);
+  }
+
+  char *buffer;
+  int64_t size;
+};
+
+class FlowControlTest : public testing::Test {
+protected:
+  static void SetUpTestCase() {
+    server = Server::TCP(server_port).release();
+    server->registerEndPoint(BufferMessage::MessageID());
+    server->registerMessageForEndPoint(BufferMessage::MakeFrom,
+                                       BufferMessage::MessageID());
+    server->registerContext(context_token);
+    server->Run();
+  }
+
+  FlowControlTest()
+      : sender_node{Node::Make(Address::TCP("127.0.0.1", 8025, 1234))} {
+    cudaMalloc(reinterpret_cast<void **>(&buffer), buffer_size);
+    cudaMemset(buffer, 1, buffer_size);
+  }
+
+  ~FlowControlTest() { cudaFree(buffer); }
+
+  // not closed: closing the socket of the server from another thread while it
+  // waits for a message is not safe, it lives until the process exits
+  static Server *server;
+  std::shared_ptr<Node> sender_node;
+  char *buffer{nullptr};
+};
+
+Server *FlowControlTest::server = nullptr;
+
+Credit makeCredit(int64_t available, int64_t outstanding, uint64_t sequence) {
+  Credit credit;
+  credit.available = available;
+  credit.outstanding = outstanding;
+  credit.sequence = sequence;
+  return credit;
+}
+
+}  // namespace
+
+TEST(ReceiveCreditsTest, CountsTheBytesUntilRetrieved) {
+  ReceiveCredits credits(1000);
+  std::shared_ptr<Node> node =
+      Node::Make(Address::TCP("127.0.0.1", 8026, 1234));
+  BufferMessage first(1, node, nullptr, 600);
+  BufferMessage second(1, node, nullptr, 600);
+
+  EXPECT_EQ(credits.receive(1, 10, 600).available, 400);
+  credits.track(&first, 1, 10, 600);
+  Credit credit = credits.receive(1, 10, 600);
+  credits.track(&second, 1, 10, 600);
+  EXPECT_EQ(credit.available, 0);
+  EXPECT_EQ(credit.outstanding, 1200);
+
+  // the other senders and contexts have their own credits
+  EXPECT_EQ(credits.credit(1, 11).available, 1000);
+  EXPECT_EQ(credits.credit(2, 10).available, 1000);
+
+  credits.retrieved(&first);
+  EXPECT_EQ(credits.credit(1, 10).available, 400);
+  credits.retrieved(&first);
+  EXPECT_EQ(credits.credit(1, 10).outstanding, 600);
+
+  credits.forgetContext(1);
+  EXPECT_EQ(credits.credit(1, 10).outstanding, 0);
+  credits.retrieved(&second);
+  EXPECT_EQ(credits.credit(1, 10).outstanding, 0);
+
+  // newer credits have a greater sequence
+  const uint64_t sequence = credits.credit(1, 10).sequence;
+  EXPECT_LT(sequence, credits.credit(1, 10).sequence);
+
+  credits.setLimit(0);
+  EXPECT_GT(credits.receive(1, 10, int64_t{1} << 40).available,
+            int64_t{1} << 40);
+}
+
+TEST(ReceiveCreditsTest, TheTotalLimitCoversEverySender) {
+  ReceiveCredits credits(1000, 1500);
+  EXPECT_EQ(credits.totalLimit(), 1500);
+
+  EXPECT_EQ(credits.receive(1, 10, 600).available, 400);
+  // a sender gets at most what is left of the total
+  EXPECT_EQ(credits.receive(1, 11, 600).available, 300);
+  EXPECT_EQ(credits.receive(2, 12, 500).available, 0);
+  EXPECT_EQ(credits.credit(2, 13).available, 0);
+
+  credits.release(1, 10, 600);
+  EXPECT_EQ(credits.credit(2, 13).available, 400);
+  credits.forgetContext(2);
+  EXPECT_EQ(credits.credit(2, 13).available, 900);
+
+  credits.setTotalLimit(0);
+  EXPECT_EQ(credits.credit(2, 13).available, 1000);
+}
+
+TEST(SendCreditsTest, WaitsUntilTheReceiverHasCredit) {
+  SendCredits credits;
+  auto never = []() -> Credit {
+    ADD_FAILURE() << "an unknown receiver is not queried";
+    return Credit{};
+  };
+
+  // the first message is always allowed, however large it is
+  credits.acquire(peer, 1, 5000, never);
+  credits.release(peer, 1, 5000, makeCredit(0, 5000, 1));
+  EXPECT_EQ(credits.waits(), 0u);
+
+  // the receiver is full until the third query
+  std::atomic<int> queries{0};
+  credits.acquire(peer, 1, 100, [&]() {
+    return ++queries < 3 ? makeCredit(0, 5000, 1 + queries)
+                         : makeCredit(1000, 0, 1 + queries);
+  });
+  EXPECT_EQ(queries, 3);
+  EXPECT_EQ(credits.waits(), 1u);
+
+  // a reply of a send in flight wakes the ones that wait
+  std::thread waiting([&]() {
+    credits.acquire(peer, 1, 950, []() { return Credit{}; });
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  credits.release(peer, 1, 100, makeCredit(1000, 100, 10));
+  waiting.join();
+  EXPECT_EQ(credits.waits(), 2u);
+
+  // an old reply does not take the newer credits back
+  credits.update(peer, 1, makeCredit(0, 5000, 5));
+  credits.acquire(peer, 1, 0, never);
+  credits.release(peer, 1, 950, makeCredit(0, 0, 11));
+  credits.release(peer, 1, 0, Credit{});
+  // and a receiver with nothing outstanding is forgotten
+  credits.update(peer, 1, makeCredit(0, 5000, 12));
+  credits.acquire(peer, 1, 100, never);
+  credits.release(peer, 1, 100, Credit{});
+}
+
+TEST_F(FlowControlTest, SendsWaitForTheReceiver) {
+  server->setReceiveCreditLimit(2 * buffer_size);
+  ClientPool pool;
+  constexpr int num_messages = 8;
+
+  std::atomic<int> sent{0};
+  std::thread sender([&]() {
+    for (int i = 0; i < num_messages; i++) {
+      BufferMessage message(context_token, sender_node, buffer, buffer_size);
+      EXPECT_TRUE(
+          pool.SendWithCredits("127.0.0.1", server_port, message).IsOk());
+      sent++;
+    }
+  });
+
+  // the receiver takes only the first message and a second that fits
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  EXPECT_EQ(sent, 2);
+  for (int i = 0; i < num_messages; i++) {
+    auto message = server->getMessage(context_token, BufferMessage::MessageID(),
+                                      std::chrono::seconds(10));
+    ASSERT_NE(message, nullptr);
+    EXPECT_EQ(static_cast<BufferMessage *>(message.get())->size,
+              static_cast<int64_t>(buffer_size));
+  }
+  sender.join();
+  EXPECT_EQ(sent, num_messages);
+  EXPECT_GT(pool.creditWaits(), 0u);
+
+  // the messages without credits are never held back
+  BufferMessage message(context_token, sender_node, buffer, buffer_size);
+  for (int i = 0; i < 3; i++) {
+    EXPECT_TRUE(pool.Send("127.0.0.1", server_port, message).IsOk());
+  }
+  for (int i = 0; i < 3; i++) {
+    EXPECT_NE(server->getMessage(context_token, BufferMessage::MessageID(),
+                                 std::chrono::seconds(10)),
+              nullptr);
+  }
+  server->setReceiveCreditLimit(DEFAULT_RECEIVE_CREDIT_LIMIT);
+}
+
+}  // namespace transport
+}  // namespace blazingdb
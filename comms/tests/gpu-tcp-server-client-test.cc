@@ -122,7 +122,7 @@ public:
   }
 
   virtual raw_buffer GetRawColumns() override {
-    std::vector<int> buffer_sizes;
+    std::vector<int64_t> buffer_sizes;
     std::vector<char *> raw_buffers;
     std::vector<ColumnTransport> column_offset;
 
@@ -277,7 +277,7 @@ std::shared_ptr<GPUMessage> CreateSampleToNodeMaster(
   auto gpu_message = std::make_shared<GPUComponentMessage>(
       context_token, sender_node, total_row_size, samples);
   std::vector<char *> buffers;
-  std::vector<int> buffer_sizes;
+  std::vector<int64_t> buffer_sizes;
   std::vector<ColumnTransport> column_offsets;
   std::tie(buffer_sizes, buffers, column_offsets) =
       gpu_message->GetRawColumns();
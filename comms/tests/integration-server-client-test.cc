@@ -26,7 +26,7 @@ public:
   }
 
   virtual raw_buffer GetRawColumns() {
-    std::vector<int> bufferSizes;
+    std::vector<int64_t> bufferSizes;
     std::vector<char *> buffers;
     std::vector<ColumnTransport> column_offset;
 
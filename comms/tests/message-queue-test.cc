@@ -0,0 +1,149 @@
+#include <blazingdb/transport/MessageQueue.h>
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace blazingdb {
+namespace transport {
+
+namespace {
+
+class EmptyMessage : public GPUMessage {
+public:
+  EmptyMessage(const std::string &messageToken, uint32_t contextToken,
+               std::shared_ptr<Node> &sender_node, int value)
+      : GPUMessage{messageToken, contextToken, sender_node}, value{value} {}
+
+  raw_buffer GetRawColumns() override { return raw_buffer{}; }
+
+  const int value;
+};
+
+std::shared_ptr<GPUMessage> makeMessage(const std::string &messageToken,
+                                        int value = 0) {
+  std::shared_ptr<Node> node;
+  return std::make_shared<EmptyMessage>(messageToken, 0, node, value);
+}
+
+int valueOf(const std::shared_ptr<GPUMessage> &message) {
+  return static_cast<EmptyMessage *>(message.get())->value;
+}
+
+}  // namespace
+
+TEST(MessageQueueTest, MessagesOfATokenAreRetrievedInOrder) {
+  MessageQueue queue;
+  for (int i = 0; i < 3; i++) {
+    auto message = makeMessage("a", i);
+    queue.putMessage(message);
+    auto other = makeMessage("b", 10 + i);
+    queue.putMessage(other);
+  }
+  EXPECT_EQ(queue.size(), 6u);
+
+  for (int i = 0; i < 3; i++) {
+    EXPECT_EQ(valueOf(queue.getMessage("b")), 10 + i);
+  }
+  for (int i = 0; i < 3; i++) {
+    EXPECT_EQ(valueOf(queue.getMessage("a")), i);
+  }
+  EXPECT_EQ(queue.size(), 0u);
+}
+
+TEST(MessageQueueTest, WaitsForTheMessageOfItsToken) {
+  MessageQueue queue;
+  std::shared_ptr<GPUMessage> received;
+  std::thread consumer([&] { received = queue.getMessage("wanted"); });
+
+  auto other = makeMessage("other");
+  queue.putMessage(other);
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_EQ(received, nullptr);
+
+  auto wanted = makeMessage("wanted", 7);
+  queue.putMessage(wanted);
+  consumer.join();
+  ASSERT_NE(received, nullptr);
+  EXPECT_EQ(valueOf(received), 7);
+  EXPECT_EQ(queue.size(), 1u);
+}
+
+TEST(MessageQueueTest, GetMessageTimesOut) {
+  MessageQueue queue;
+  auto other = makeMessage("other");
+  queue.putMessage(other);
+
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_EQ(queue.getMessage("missing", std::chrono::milliseconds(20)),
+            nullptr);
+  EXPECT_GE(std::chrono::steady_clock::now() - start,
+            std::chrono::milliseconds(20));
+
+  auto missing = makeMessage("missing", 3);
+  queue.putMessage(missing);
+  auto received = queue.getMessage("missing", std::chrono::milliseconds(20));
+  ASSERT_NE(received, nullptr);
+  EXPECT_EQ(valueOf(received), 3);
+}
+
+// Every token has its own consumer, the producers put the messages of all the
+// tokens interleaved, which is what happens when many partitions of many
+// nodes are exchanged at the same time. The time it takes is measured in
+// engine/benchmarks/transport/message_queue_benchmark.cpp
+TEST(MessageQueueTest, ManyConcurrentTokensGetTheirOwnMessages) {
+  constexpr int num_tokens = 200;
+  constexpr int messages_per_token = 8;
+  constexpr int num_producers = 4;
+
+  MessageQueue queue;
+  std::vector<std::string> tokens;
+  for (int i = 0; i < num_tokens; i++) {
+    tokens.push_back("partition_" + std::to_string(i));
+  }
+
+  std::atomic<int> errors{0};
+  std::vector<std::thread> consumers;
+  for (int i = 0; i < num_tokens; i++) {
+    consumers.emplace_back([&, i] {
+      for (int j = 0; j < messages_per_token; j++) {
+        auto message =
+            queue.getMessage(tokens[i], std::chrono::milliseconds(60000));
+        if (message == nullptr ||
+            message->getMessageTokenValue() != tokens[i] ||
+            valueOf(message) != j) {
+          errors++;
+        }
+      }
+    });
+  }
+
+  std::vector<std::thread> producers;
+  for (int p = 0; p < num_producers; p++) {
+    producers.emplace_back([&, p] {
+      for (int j = 0; j < messages_per_token; j++) {
+        for (int i = p; i < num_tokens; i += num_producers) {
+          auto message = makeMessage(tokens[i], j);
+          queue.putMessage(message);
+        }
+      }
+    });
+  }
+
+  for (auto &thread : producers) {
+    thread.join();
+  }
+  for (auto &thread : consumers) {
+    thread.join();
+  }
+
+  EXPECT_EQ(errors, 0);
+  EXPECT_EQ(queue.size(), 0u);
+}
+
+}  // namespace transport
+}  // namespace blazingdb
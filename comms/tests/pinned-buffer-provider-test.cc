@@ -0,0 +1,141 @@
+#include <blazingdb/transport/io/PinnedBufferProvider.h>
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace blazingdb {
+namespace transport {
+namespace io {
+
+namespace {
+
+std::unique_ptr<PinnedBufferProvider> makeProvider(std::size_t memoryLimit) {
+  return std::unique_ptr<PinnedBufferProvider>(new PinnedBufferProvider(
+      {4096, 1024, 256}, memoryLimit, makeHostAllocator()));
+}
+
+}  // namespace
+
+TEST(PinnedBufferProviderTest, ReturnsTheSmallestSizeClassThatFits) {
+  auto provider = makeProvider(16 * 1024);
+  EXPECT_EQ(provider->sizeBuffers(), 4096u);
+
+  PinnedBuffer *small = provider->getBuffer(100);
+  PinnedBuffer *medium = provider->getBuffer(257);
+  PinnedBuffer *large = provider->getBuffer();
+  EXPECT_EQ(small->size, 256u);
+  EXPECT_EQ(medium->size, 1024u);
+  EXPECT_EQ(large->size, 4096u);
+  EXPECT_THROW(provider->getBuffer(4097), std::runtime_error);
+
+  auto stats = provider->stats();
+  EXPECT_EQ(stats.buffers_in_use, 3u);
+  EXPECT_EQ(stats.bytes_in_use, 256u + 1024u + 4096u);
+
+  provider->freeBuffer(small);
+  provider->freeBuffer(medium);
+  provider->freeBuffer(large);
+  stats = provider->stats();
+  EXPECT_EQ(stats.buffers_in_use, 0u);
+  EXPECT_EQ(stats.bytes_in_use, 0u);
+  EXPECT_EQ(stats.high_water_bytes, 256u + 1024u + 4096u);
+}
+
+TEST(PinnedBufferProviderTest, ReusesFreedBuffers) {
+  auto provider = makeProvider(16 * 1024);
+  for (int i = 0; i < 10; i++) {
+    PinnedBuffer *buffer = provider->getBuffer();
+    buffer->data[0] = 1;
+    provider->freeBuffer(buffer);
+  }
+  EXPECT_EQ(provider->stats().allocations, 1u);
+  EXPECT_EQ(provider->stats().bytes_allocated, 4096u);
+
+  provider->freeAll();
+  EXPECT_EQ(provider->stats().bytes_allocated, 0u);
+}
+
+TEST(PinnedBufferProviderTest, ReleasesIdleBuffersOfOtherClassesToMakeRoom) {
+  auto provider = makeProvider(8 * 1024);
+  std::vector<PinnedBuffer *> small;
+  for (int i = 0; i < 32; i++) {
+    small.push_back(provider->getBuffer(256));
+  }
+  for (PinnedBuffer *buffer : small) {
+    provider->freeBuffer(buffer);
+  }
+  EXPECT_EQ(provider->stats().bytes_allocated, 8u * 1024);
+
+  PinnedBuffer *first = provider->getBuffer();
+  PinnedBuffer *second = provider->getBuffer();
+  EXPECT_EQ(provider->stats().bytes_allocated, 8u * 1024);
+  EXPECT_EQ(provider->stats().waits, 0u);
+  provider->freeBuffer(first);
+  provider->freeBuffer(second);
+}
+
+TEST(PinnedBufferProviderTest, WaitsWhenTheMemoryLimitIsReached) {
+  auto provider = makeProvider(8 * 1024);
+  PinnedBuffer *first = provider->getBuffer();
+  PinnedBuffer *second = provider->getBuffer();
+
+  std::atomic<bool> acquired{false};
+  std::thread waiter([&] {
+    PinnedBuffer *buffer = provider->getBuffer(256);
+    acquired = true;
+    provider->freeBuffer(buffer);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_FALSE(acquired);
+
+  provider->freeBuffer(first);
+  waiter.join();
+  EXPECT_TRUE(acquired);
+  EXPECT_EQ(provider->stats().waits, 1u);
+  EXPECT_LE(provider->stats().bytes_allocated, 8u * 1024);
+  provider->freeBuffer(second);
+}
+
+TEST(PinnedBufferProviderTest, LendingUsesHalfOfTheMemoryLimit) {
+  auto provider = makeProvider(16 * 1024);
+  EXPECT_TRUE(provider->tryLend(4096));
+  EXPECT_TRUE(provider->tryLend(4096));
+  EXPECT_FALSE(provider->tryLend(256));
+  provider->endLend(4096);
+  EXPECT_TRUE(provider->tryLend(256));
+}
+
+TEST(PinnedBufferProviderTest, RejectsAMemoryLimitBelowTwoBuffers) {
+  EXPECT_THROW(PinnedBufferProvider({4096}, 4096, makeHostAllocator()),
+               std::runtime_error);
+}
+
+TEST(PinnedBufferProviderTest, StaysWithinTheMemoryLimitUnderContention) {
+  auto provider = makeProvider(16 * 1024);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; t++) {
+    threads.emplace_back([&, t] {
+      const std::size_t sizes[] = {100, 1000, 4000};
+      for (int i = 0; i < 1000; i++) {
+        PinnedBuffer *buffer = provider->getBuffer(sizes[(t + i) % 3]);
+        buffer->data[buffer->size - 1] = 1;
+        provider->freeBuffer(buffer);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  auto stats = provider->stats();
+  EXPECT_EQ(stats.buffers_in_use, 0u);
+  EXPECT_LE(stats.high_water_bytes, 16u * 1024);
+  EXPECT_LE(stats.bytes_allocated, 16u * 1024);
+}
+
+}  // namespace io
+}  // namespace transport
+}  // namespace blazingdb
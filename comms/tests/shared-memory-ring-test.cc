@@ -0,0 +1,145 @@
+#include <blazingdb/transport/io/SharedMemoryRing.h>
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace blazingdb {
+namespace transport {
+namespace io {
+
+namespace {
+
+constexpr auto wait_timeout = std::chrono::milliseconds(10000);
+
+std::string ringName(const std::string &test) {
+  return "/blazingdb-test-" + std::to_string(getpid()) + "-" + test;
+}
+
+// Both ends of a ring in one process, the consumer opens it like the server
+// of another process does
+struct RingPair {
+  explicit RingPair(const std::string &name, std::size_t capacity)
+      : producer{SharedMemoryRing::create(name, capacity)},
+        consumer{SharedMemoryRing::open(name)} {}
+
+  std::unique_ptr<SharedMemoryRing> producer;
+  std::unique_ptr<SharedMemoryRing> consumer;
+};
+
+// The regions of the sizes in order, like the chunks of the buffers of a
+// message. Returns the number of bytes that do not match.
+std::size_t sendRegions(RingPair &rings, const std::vector<std::size_t> &sizes,
+                        uint64_t first) {
+  std::thread producer_thread([&] {
+    for (std::size_t i = 0; i < sizes.size(); i++) {
+      uint64_t position = rings.producer->reserve(sizes[i], wait_timeout);
+      memset(rings.producer->data(position), static_cast<int>(first + i),
+             sizes[i]);
+      rings.producer->commit(position + sizes[i]);
+    }
+  });
+
+  std::size_t errors = 0;
+  uint64_t end = rings.consumer->released();
+  for (std::size_t i = 0; i < sizes.size(); i++) {
+    uint64_t position = rings.consumer->nextPosition(end, sizes[i]);
+    end = position + sizes[i];
+    rings.consumer->waitCommitted(end, wait_timeout);
+    const char *data = rings.consumer->data(position);
+    errors += std::count_if(data, data + sizes[i], [&](char value) {
+      return value != static_cast<char>(first + i);
+    });
+    rings.consumer->release(end);
+  }
+  producer_thread.join();
+  return errors;
+}
+
+}  // namespace
+
+TEST(SharedMemoryRingTest, RegionsArriveInOrderAcrossTheEnd) {
+  RingPair rings(ringName("order"), 1000);
+  // regions that do not fit before the end start again at the beginning
+  std::vector<std::size_t> sizes;
+  for (std::size_t i = 0; i < 500; i++) {
+    sizes.push_back(1 + (i * 97) % 400);
+  }
+  EXPECT_EQ(sendRegions(rings, sizes, 0), 0u);
+  // the next message starts where the last one was released
+  EXPECT_EQ(sendRegions(rings, {500, 1, 499, 500}, 7), 0u);
+}
+
+TEST(SharedMemoryRingTest, RegionsDoNotWrap) {
+  RingPair rings(ringName("wrap"), 100);
+  EXPECT_EQ(rings.producer->nextPosition(0, 100), 0u);
+  EXPECT_EQ(rings.producer->nextPosition(60, 40), 60u);
+  EXPECT_EQ(rings.producer->nextPosition(60, 41), 100u);
+  EXPECT_EQ(rings.producer->nextPosition(260, 50), 300u);
+}
+
+TEST(SharedMemoryRingTest, ProducerWaitsForTheConsumer) {
+  RingPair rings(ringName("full"), 100);
+  EXPECT_EQ(rings.producer->tryReserve(40), 0);
+  EXPECT_EQ(rings.producer->tryReserve(50), 40);
+  EXPECT_EQ(rings.producer->tryReserve(20), -1);
+  EXPECT_THROW(rings.producer->tryReserve(51), std::runtime_error);
+  EXPECT_THROW(rings.producer->reserve(20, std::chrono::milliseconds(10)),
+               std::runtime_error);
+
+  rings.producer->commit(90);
+  rings.consumer->waitCommitted(90, wait_timeout);
+  rings.consumer->release(40);
+  // it skips the last 10 bytes, which are only released with it
+  EXPECT_EQ(rings.producer->tryReserve(20), 100);
+}
+
+TEST(SharedMemoryRingTest, ConsumerStopsWhenTheProducerCloses) {
+  RingPair rings(ringName("closed"), 100);
+  EXPECT_THROW(rings.consumer->waitCommitted(10, std::chrono::milliseconds(10)),
+               std::runtime_error);
+  EXPECT_FALSE(rings.consumer->isClosed());
+  rings.producer.reset();
+  EXPECT_TRUE(rings.consumer->isClosed());
+  EXPECT_THROW(rings.consumer->waitCommitted(10, wait_timeout),
+               std::runtime_error);
+  // the name is gone with the producer
+  EXPECT_THROW(SharedMemoryRing::open(ringName("closed")), std::runtime_error);
+}
+
+TEST(SharedMemoryRingTest, OnlyRingsCanBeOpened) {
+  EXPECT_THROW(SharedMemoryRing::open(ringName("missing")),
+               std::runtime_error);
+  auto ring = SharedMemoryRing::create(ringName("twice"), 100);
+  EXPECT_THROW(SharedMemoryRing::create(ringName("twice"), 100),
+               std::runtime_error);
+}
+
+TEST(SharedMemoryRingTest, LocalAddresses) {
+  EXPECT_TRUE(isLocalAddress("127.0.0.1"));
+  EXPECT_TRUE(isLocalAddress("localhost"));
+  EXPECT_FALSE(isLocalAddress("192.0.2.1"));  // TEST-NET-1
+}
+
+TEST(SharedMemoryRingTest, RingsAreLimited) {
+  const std::size_t limit = getSharedMemoryRingLimit();
+  setSharedMemoryRingLimit(2);
+  EXPECT_TRUE(acquireSharedMemoryRing());
+  EXPECT_TRUE(acquireSharedMemoryRing());
+  EXPECT_FALSE(acquireSharedMemoryRing());
+  releaseSharedMemoryRing();
+  EXPECT_TRUE(acquireSharedMemoryRing());
+  releaseSharedMemoryRing();
+  releaseSharedMemoryRing();
+  setSharedMemoryRingLimit(limit);
+}
+
+}  // namespace io
+}  // namespace transport
+}  // namespace blazingdb
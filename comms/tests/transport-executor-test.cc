@@ -0,0 +1,74 @@
+#include <blazingdb/transport/io/TransportExecutor.h>
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace blazingdb {
+namespace transport {
+namespace io {
+
+TEST(TransportExecutorTest, RunsTasksAndReturnsTheirResults) {
+  TransportExecutor executor(2, 2);
+  auto copy = executor.submitCopy([]() { return 21; });
+  auto socket = executor.submitSocket([]() { return std::string("sent"); });
+  EXPECT_EQ(copy.get(), 21);
+  EXPECT_EQ(socket.get(), "sent");
+}
+
+TEST(TransportExecutorTest, PropagatesExceptions) {
+  TransportExecutor executor(1, 1);
+  auto result =
+      executor.submitCopy([]() { throw std::runtime_error("copy failed"); });
+  EXPECT_THROW(result.get(), std::runtime_error);
+  EXPECT_EQ(executor.submitCopy([]() { return 1; }).get(), 1);
+}
+
+TEST(TransportExecutorTest, SocketTasksCanWaitForCopyTasks) {
+  TransportExecutor executor(1, 2);
+  std::vector<std::future<int>> sends;
+  for (int i = 0; i < 4; i++) {
+    sends.push_back(executor.submitSocket([&executor, i]() {
+      int total = 0;
+      std::vector<std::future<int>> copies;
+      for (int j = 0; j < 10; j++) {
+        copies.push_back(executor.submitCopy([i, j]() { return i * j; }));
+      }
+      for (auto &copy : copies) {
+        total += copy.get();
+      }
+      return total;
+    }));
+  }
+  for (int i = 0; i < 4; i++) {
+    EXPECT_EQ(sends[i].get(), i * 45);
+  }
+}
+
+TEST(TransportExecutorTest, UsesAFixedNumberOfWorkers) {
+  TransportExecutor executor(3, 1);
+  std::atomic<int> running{0};
+  std::atomic<int> max_running{0};
+  std::vector<std::future<void>> copies;
+  for (int i = 0; i < 30; i++) {
+    copies.push_back(executor.submitCopy([&]() {
+      int now = ++running;
+      int seen = max_running;
+      while (now > seen && !max_running.compare_exchange_weak(seen, now)) {
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      running--;
+    }));
+  }
+  for (auto &copy : copies) {
+    copy.get();
+  }
+  EXPECT_LE(max_running, 3);
+}
+
+}  // namespace io
+}  // namespace transport
+}  // namespace blazingdb
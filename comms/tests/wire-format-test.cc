@@ -0,0 +1,138 @@
+#include <blazingdb/network/TCPSocket.h>
+#include <blazingdb/transport/Client.h>
+#include <blazingdb/transport/Server.h>
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <zmq.hpp>
+
+namespace blazingdb {
+namespace transport {
+
+namespace {
+
+constexpr uint32_t context_token = 7401;
+constexpr unsigned short server_port = 8022;
+
+// Message without columns that keeps the metadata it was received with
+class MetadataMessage : public GPUMessage {
+public:
+  MetadataMessage(const Message::MetaData &metadata,
+                  std::shared_ptr<Node> &sender_node)
+      : GPUMessage{metadata.messageToken, metadata.contextToken,
+                   sender_node} {
+    this->metadata() = metadata;
+  }
+
+  raw_buffer GetRawColumns() override { return raw_buffer{}; }
+
+  static std::string MessageID() { return "MetadataMessage"; }
+
+  static std::shared_ptr<GPUMessage> MakeFrom(
+      const Message::MetaData &message_metadata,
+      const Address::MetaData &address_metadata,
+      const std::vector<ColumnTransport> &columns_offsets,
+      const std::vector<char *> &raw_buffers) {
+    auto node = Node::Make(Address::TCP(address_metadata.ip,
+                                        address_metadata.comunication_port,
+                                        address_metadata.protocol_port));
+    return std::make_shared<MetadataMessage>(message_metadata, node);
+  }
+};
+
+class WireFormatTest : public testing::Test {
+protected:
+  static void SetUpTestCase() {
+    server = Server::TCP(server_port).release();
+    server->registerEndPoint(MetadataMessage::MessageID());
+    server->registerMessageForEndPoint(MetadataMessage::MakeFrom,
+                                       MetadataMessage::MessageID());
+    server->registerContext(context_token);
+    server->Run();
+  }
+
+  static void TearDownTestCase() {
+    server->Close();
+    delete server;
+    server = nullptr;
+  }
+
+  WireFormatTest()
+      : sender_node{Node::Make(Address::TCP("127.0.0.1", 8023, 1234))} {}
+
+  Message::MetaData makeMetadata() {
+    Message::MetaData metadata;
+    strcpy(metadata.messageToken, MetadataMessage::MessageID().c_str());
+    metadata.contextToken = context_token;
+    return metadata;
+  }
+
+  static Server *server;
+  std::shared_ptr<Node> sender_node;
+};
+
+Server *WireFormatTest::server = nullptr;
+
+template <typename T>
+void sendPart(zmq::socket_t &socket, const T &value, bool more = true) {
+  zmq::message_t part(sizeof(T));
+  memcpy(part.data(), &value, sizeof(T));
+  socket.send(part, more ? ZMQ_SNDMORE : 0);
+}
+
+}  // namespace
+
+TEST_F(WireFormatTest, SendsSixtyFourBitSizesAndPartitionChunks) {
+  Message::MetaData metadata = makeMetadata();
+  metadata.total_row_size = 5000000000;
+  metadata.partition_chunk = 2;
+  metadata.partition_chunks = 3;
+  MetadataMessage message(metadata, sender_node);
+
+  auto client = ClientTCP::Make("127.0.0.1", server_port);
+  EXPECT_TRUE(client->Send(message).IsOk());
+  client->Close();
+
+  auto received = server->getMessage(
+      context_token, MetadataMessage::MessageID(), std::chrono::seconds(10));
+  ASSERT_NE(received, nullptr);
+  EXPECT_EQ(received->metadata().total_row_size, 5000000000);
+  EXPECT_EQ(received->metadata().partition_chunk, 2);
+  EXPECT_EQ(received->metadata().partition_chunks, 3);
+}
+
+TEST_F(WireFormatTest, RejectsOtherVersions) {
+  zmq::context_t context;
+  zmq::socket_t socket(context, ZMQ_REQ);
+  int timeout_ms = 10000;
+  socket.setsockopt(ZMQ_RCVTIMEO, &timeout_ms, sizeof(timeout_ms));
+  socket.connect("tcp://127.0.0.1:" + std::to_string(server_port));
+
+  WireHeader header;
+  header.version = WIRE_FORMAT_VERSION - 1;
+  sendPart(socket, header);
+  sendPart(socket, makeMetadata());
+  sendPart(socket, sender_node->address()->metadata());
+  sendPart(socket, int32_t{0}, false);
+
+  zmq::message_t reply;
+  ASSERT_TRUE(socket.recv(&reply));
+  std::string reply_message(static_cast<char *>(reply.data()), reply.size());
+  EXPECT_EQ(reply_message.find("unsupported wire format"), 0u);
+  socket.close();
+
+  // the server keeps serving the messages of its version
+  MetadataMessage message(makeMetadata(), sender_node);
+  auto client = ClientTCP::Make("127.0.0.1", server_port);
+  EXPECT_TRUE(client->Send(message).IsOk());
+  client->Close();
+  EXPECT_NE(server->getMessage(context_token, MetadataMessage::MessageID(),
+                               std::chrono::seconds(10)),
+            nullptr);
+}
+
+}  // namespace transport
+}  // namespace blazingdb
@@ -0,0 +1,121 @@
+#include <blazingdb/transport/io/fd_reader_writer.h>
+
+#include <gtest/gtest.h>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <numeric>
+#include <stack>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace blazingdb {
+namespace transport {
+namespace io {
+
+namespace {
+
+constexpr std::size_t chunk_size = 64 * 1024;
+constexpr std::size_t num_chunks = 64;
+constexpr std::size_t num_pool_chunks = 8;
+
+// Stands for the PinnedBufferProvider: the sender waits for a free chunk, and
+// chunks sent without copy come back from the ZMQ thread.
+class ChunkPool {
+public:
+  ChunkPool() : chunks_(num_pool_chunks, std::vector<char>(chunk_size)) {
+    for (std::size_t i = 0; i < chunks_.size(); i++) {
+      std::iota(chunks_[i].begin(), chunks_[i].end(), static_cast<char>(i));
+      free_.push(chunks_[i].data());
+    }
+  }
+
+  char *get() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return !free_.empty(); });
+    char *chunk = free_.top();
+    free_.pop();
+    return chunk;
+  }
+
+  void put(char *chunk) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_.push(chunk);
+    cv_.notify_one();
+  }
+
+  static void returnChunk(void *data, void *hint) {
+    static_cast<ChunkPool *>(hint)->put(static_cast<char *>(data));
+  }
+
+private:
+  std::vector<std::vector<char>> chunks_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::stack<char *> free_;
+};
+
+// Sends num_chunks over a loopback TCP connection and checks what arrives. The
+// GB/s of both ways are measured in
+// engine/benchmarks/transport/zero_copy_socket_benchmark.cpp
+void transfer(bool zero_copy, unsigned short port) {
+  zmq::context_t context(1);
+  zmq::socket_t receiver(context, ZMQ_PULL);
+  zmq::socket_t sender(context, ZMQ_PUSH);
+  const std::string endpoint = "tcp://127.0.0.1:" + std::to_string(port);
+  receiver.bind(endpoint);
+  sender.connect(endpoint);
+
+  ChunkPool pool;
+  std::size_t received = 0;
+  std::size_t errors = 0;
+
+  std::thread receiver_thread([&] {
+    std::vector<char> destination(chunk_size);
+    for (std::size_t i = 0; i < num_chunks; i++) {
+      if (zero_copy) {
+        zmq::message_t message = readMessageFromSocket(&receiver);
+        const char *data = static_cast<const char *>(message.data());
+        received += message.size();
+        errors += data[1] != static_cast<char>(data[0] + 1);
+      } else {
+        received +=
+            readFromSocket(&receiver, destination.data(), destination.size());
+        errors += destination[1] != static_cast<char>(destination[0] + 1);
+      }
+    }
+  });
+
+  for (std::size_t i = 0; i < num_chunks; i++) {
+    char *chunk = pool.get();
+    if (zero_copy) {
+      writeToSocket(&sender, chunk, chunk_size, ChunkPool::returnChunk, &pool,
+                    false);
+    } else {
+      writeToSocket(&sender, chunk, chunk_size, false);
+      pool.put(chunk);
+    }
+  }
+  receiver_thread.join();
+
+  EXPECT_EQ(received, num_chunks * chunk_size);
+  EXPECT_EQ(errors, 0u);
+
+  // every chunk lent to ZMQ has been given back
+  for (std::size_t i = 0; i < num_pool_chunks; i++) {
+    pool.get();
+  }
+}
+
+}  // namespace
+
+TEST(ZeroCopySocketTest, CopiedChunksArrive) { transfer(false, 8030); }
+
+TEST(ZeroCopySocketTest, ChunksSentWithoutCopyArriveAndAreGivenBack) {
+  transfer(true, 8031);
+}
+
+}  // namespace io
+}  // namespace transport
+}  // namespace blazingdb
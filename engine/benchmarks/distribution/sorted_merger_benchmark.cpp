@@ -0,0 +1,222 @@
+#include "DataFrame.h"
+#include "GDFColumn.cuh"
+#include "cudf/legacy/merge.hpp"
+#include "distribution/NodeColumns.h"
+#include "distribution/kway_merge.h"
+#include "distribution/primitives.h"
+#include "utilities/CommonOperations.h"
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <blazingdb/transport/Address.h>
+#include <blazingdb/transport/Node.h>
+#include <chrono>
+#include <cuda_runtime_api.h>
+#include <random>
+#include <rmm/rmm.h>
+#include <vector>
+
+using blazingdb::transport::Address;
+using blazingdb::transport::Node;
+using ral::distribution::host_kway_merge;
+using ral::distribution::merge_position;
+using ral::distribution::NodeColumns;
+
+namespace {
+
+const gdf_size_type num_rows = 1 << 24;
+const int num_payload_columns = 4;
+// the host merges are much slower, they get fewer rows
+const gdf_size_type num_host_rows = 1 << 22;
+
+// A sorted run: ascending by first, then descending by second
+struct host_run {
+	std::vector<int64_t> first;
+	std::vector<int32_t> second;
+	// position of each row in the concatenation of all the runs
+	std::vector<int32_t> row;
+};
+
+bool run_less(const host_run & a, gdf_size_type a_row, const host_run & b, gdf_size_type b_row) {
+	if(a.first[a_row] != b.first[b_row]) {
+		return a.first[a_row] < b.first[b_row];
+	}
+	return a.second[a_row] > b.second[b_row];
+}
+
+// k runs of the same size
+std::vector<host_run> random_runs(int k, gdf_size_type total_rows, int64_t max_key) {
+	std::mt19937 generator(k);
+	std::uniform_int_distribution<int64_t> distribution(0, max_key);
+	std::vector<host_run> runs(k);
+	int32_t row = 0;
+	for(auto & run : runs) {
+		std::vector<std::pair<int64_t, int32_t>> keys(total_rows / k);
+		for(auto & key : keys) {
+			key = {distribution(generator), static_cast<int32_t>(distribution(generator) % 8)};
+		}
+		std::sort(keys.begin(), keys.end(), [](std::pair<int64_t, int32_t> a, std::pair<int64_t, int32_t> b) {
+			return a.first != b.first ? a.first < b.first : a.second > b.second;
+		});
+		for(const auto & key : keys) {
+			run.first.push_back(key.first);
+			run.second.push_back(key.second);
+			run.row.push_back(row++);
+		}
+	}
+	return runs;
+}
+
+std::vector<gdf_column_cpp> to_device(const host_run & run) {
+	const gdf_size_type num_rows = run.first.size();
+	std::vector<gdf_column_cpp> table(3 + num_payload_columns);
+	table[0].create_gdf_column(GDF_INT64,
+		gdf_dtype_extra_info{},
+		num_rows,
+		const_cast<int64_t *>(run.first.data()),
+		sizeof(int64_t),
+		"first");
+	table[1].create_gdf_column(GDF_INT32,
+		gdf_dtype_extra_info{},
+		num_rows,
+		const_cast<int32_t *>(run.second.data()),
+		sizeof(int32_t),
+		"second");
+	table[2].create_gdf_column(
+		GDF_INT32, gdf_dtype_extra_info{}, num_rows, const_cast<int32_t *>(run.row.data()), sizeof(int32_t), "row");
+	for(int i = 0; i < num_payload_columns; i++) {
+		table[3 + i].create_gdf_column(GDF_INT64,
+			gdf_dtype_extra_info{},
+			num_rows,
+			const_cast<int64_t *>(run.first.data()),
+			sizeof(int64_t),
+			"payload");
+	}
+	return table;
+}
+
+// What sortedMerger did before: every table merged into the result, one after another
+std::vector<gdf_column_cpp> pairwise_merge(std::vector<std::vector<gdf_column_cpp>> & tables,
+	std::vector<int> & sortColIndices,
+	std::vector<order_by_type> & ascDesc) {
+	std::vector<gdf_column_cpp> leftCols(tables[0]);
+	cudf::table leftTable = ral::utilities::create_table(leftCols);
+	for(size_t i = 1; i < tables.size(); i++) {
+		cudf::table rightTable = ral::utilities::create_table(tables[i]);
+		cudf::table mergedTable = cudf::merge(leftTable, rightTable, sortColIndices, ascDesc);
+		for(size_t j = 0; j < mergedTable.num_columns(); j++) {
+			leftCols[j].create_gdf_column(mergedTable.get_column(j));
+		}
+		leftTable = mergedTable;
+	}
+	return leftCols;
+}
+
+// the number of runs
+void merge_arguments(benchmark::internal::Benchmark * b) {
+	for(int k = 2; k <= 64; k *= 2) {
+		b->Arg(k);
+	}
+}
+
+}  // namespace
+
+static void BM_host_loser_tree(benchmark::State & state) {
+	std::vector<host_run> runs = random_runs(state.range(0), num_host_rows, 1 << 20);
+	std::vector<gdf_size_type> run_sizes;
+	for(const host_run & run : runs) {
+		run_sizes.push_back(run.first.size());
+	}
+
+	for(auto _ : state) {
+		std::vector<merge_position> merged =
+			host_kway_merge(run_sizes, [&runs](const merge_position & a, const merge_position & b) {
+				return run_less(runs[a.run], a.row, runs[b.run], b.row);
+			});
+		benchmark::DoNotOptimize(merged.data());
+	}
+	state.SetItemsProcessed(state.iterations() * num_host_rows);
+}
+BENCHMARK(BM_host_loser_tree)->Apply(merge_arguments)->Unit(benchmark::kMillisecond);
+
+// the rows of the concatenation of the runs, each run merged into the result in turn
+static void BM_host_pairwise_merge(benchmark::State & state) {
+	std::vector<host_run> runs = random_runs(state.range(0), num_host_rows, 1 << 20);
+	const int run_rows = runs[0].row.size();
+
+	for(auto _ : state) {
+		std::vector<int32_t> merged(runs[0].row);
+		for(size_t i = 1; i < runs.size(); i++) {
+			std::vector<int32_t> result(merged.size() + runs[i].row.size());
+			std::merge(merged.begin(),
+				merged.end(),
+				runs[i].row.begin(),
+				runs[i].row.end(),
+				result.begin(),
+				[&runs, run_rows](int32_t a, int32_t b) {
+					return run_less(runs[a / run_rows], a % run_rows, runs[b / run_rows], b % run_rows);
+				});
+			merged = std::move(result);
+		}
+		benchmark::DoNotOptimize(merged.data());
+	}
+	state.SetItemsProcessed(state.iterations() * num_host_rows);
+}
+BENCHMARK(BM_host_pairwise_merge)->Apply(merge_arguments)->Unit(benchmark::kMillisecond);
+
+// Only the merges are timed, between device synchronizations
+struct GpuMergeBench : public benchmark::Fixture {
+	void SetUp(benchmark::State & state) override {
+		rmmInitialize(nullptr);
+		node = Node::Make(Address::TCP("127.0.0.1", 8000, 9000));
+		runs = random_runs(state.range(0), num_rows, int64_t{1} << 40);
+	}
+
+	void TearDown(benchmark::State & state) override { runs.clear(); }
+
+	std::shared_ptr<Node> node;
+	std::vector<host_run> runs;
+	std::vector<int8_t> sortOrderTypes{0, 1};
+	std::vector<int> sortColIndices{0, 1};
+};
+
+BENCHMARK_DEFINE_F(GpuMergeBench, sorted_merger)(benchmark::State & state) {
+	for(auto _ : state) {
+		std::vector<NodeColumns> columns;
+		for(const host_run & run : runs) {
+			columns.emplace_back(*node, to_device(run));
+		}
+		blazing_frame output;
+		cudaDeviceSynchronize();
+		auto start = std::chrono::steady_clock::now();
+		ral::distribution::sortedMerger(columns, sortOrderTypes, sortColIndices, output);
+		cudaDeviceSynchronize();
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		state.SetIterationTime(elapsed.count());
+	}
+	state.SetItemsProcessed(state.iterations() * num_rows);
+}
+BENCHMARK_REGISTER_F(GpuMergeBench, sorted_merger)
+	->Apply(merge_arguments)
+	->Unit(benchmark::kMillisecond)
+	->UseManualTime();
+
+BENCHMARK_DEFINE_F(GpuMergeBench, pairwise_merge)(benchmark::State & state) {
+	std::vector<order_by_type> ascDesc{GDF_ORDER_ASC, GDF_ORDER_DESC};
+	for(auto _ : state) {
+		std::vector<std::vector<gdf_column_cpp>> tables;
+		for(const host_run & run : runs) {
+			tables.push_back(to_device(run));
+		}
+		cudaDeviceSynchronize();
+		auto start = std::chrono::steady_clock::now();
+		std::vector<gdf_column_cpp> merged = pairwise_merge(tables, sortColIndices, ascDesc);
+		cudaDeviceSynchronize();
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		state.SetIterationTime(elapsed.count());
+	}
+	state.SetItemsProcessed(state.iterations() * num_rows);
+}
+BENCHMARK_REGISTER_F(GpuMergeBench, pairwise_merge)
+	->Apply(merge_arguments)
+	->Unit(benchmark::kMillisecond)
+	->UseManualTime();
@@ -0,0 +1,119 @@
+#include "DataFrame.h"
+#include "GDFColumn.cuh"
+#include "operators/OrderBy.h"
+#include "operators/TopN.h"
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <blazingdb/manager/Context.h>
+#include <blazingdb/transport/Address.h>
+#include <blazingdb/transport/Node.h>
+#include <chrono>
+#include <cuda_runtime_api.h>
+#include <numeric>
+#include <random>
+#include <rmm/rmm.h>
+#include <vector>
+
+using blazingdb::manager::Context;
+using blazingdb::transport::Address;
+using blazingdb::transport::Node;
+using ral::operators::host_row_order;
+using ral::operators::host_top_n;
+
+namespace {
+
+const gdf_size_type limit = 100;
+const gdf_size_type num_rows = 1 << 25;
+const int num_payload_columns = 4;
+// the host sort is much slower, it gets fewer rows
+const gdf_size_type num_host_rows = 1 << 22;
+
+std::vector<int64_t> random_keys(std::size_t size) {
+	std::mt19937 generator(7);
+	std::uniform_int_distribution<int64_t> distribution(0, int64_t{1} << 40);
+	std::vector<int64_t> keys(size);
+	for(auto & key : keys) {
+		key = distribution(generator);
+	}
+	return keys;
+}
+
+}  // namespace
+
+static void BM_host_top_n(benchmark::State & state) {
+	std::vector<int64_t> keys = random_keys(num_host_rows);
+	host_row_order order;
+	order.add_column(keys, {}, false);
+
+	for(auto _ : state) {
+		std::vector<gdf_size_type> rows = host_top_n(num_host_rows, limit, order);
+		benchmark::DoNotOptimize(rows.data());
+	}
+	state.SetItemsProcessed(state.iterations() * num_host_rows);
+}
+BENCHMARK(BM_host_top_n)->Unit(benchmark::kMillisecond);
+
+// the first limit rows of a stable sort, what the top-N must return
+static void BM_host_sort_and_limit(benchmark::State & state) {
+	std::vector<int64_t> keys = random_keys(num_host_rows);
+	host_row_order order;
+	order.add_column(keys, {}, false);
+
+	for(auto _ : state) {
+		std::vector<gdf_size_type> rows(num_host_rows);
+		std::iota(rows.begin(), rows.end(), 0);
+		std::stable_sort(rows.begin(), rows.end(), std::cref(order));
+		rows.resize(limit);
+		benchmark::DoNotOptimize(rows.data());
+	}
+	state.SetItemsProcessed(state.iterations() * num_host_rows);
+}
+BENCHMARK(BM_host_sort_and_limit)->Unit(benchmark::kMillisecond);
+
+struct GpuSortBench : public benchmark::Fixture {
+	void SetUp(benchmark::State & state) override {
+		rmmInitialize(nullptr);
+		keys = random_keys(num_rows);
+	}
+
+	void TearDown(benchmark::State & state) override { keys.clear(); }
+
+	// sorts a table of an INT64 key and num_payload_columns payloads, only process_sort is timed
+	void run(benchmark::State & state, int limit_rows) {
+		std::shared_ptr<Node> node = Node::Make(Address::TCP("127.0.0.1", 8000, 9000));
+		Context context(7601, {node}, node, "");
+
+		for(auto _ : state) {
+			std::vector<gdf_column_cpp> table(1 + num_payload_columns);
+			table[0].create_gdf_column(
+				GDF_INT64, gdf_dtype_extra_info{}, num_rows, keys.data(), sizeof(int64_t), "key");
+			for(int i = 1; i <= num_payload_columns; i++) {
+				table[i].create_gdf_column(
+					GDF_INT64, gdf_dtype_extra_info{}, num_rows, keys.data(), sizeof(int64_t), "payload");
+			}
+			blazing_frame input;
+			input.add_table(table);
+
+			ral::operators::sort_plan plan;
+			plan.sort_column_indices = {0};
+			plan.sort_order_types = {0};
+			plan.limit_rows = limit_rows;
+			cudaDeviceSynchronize();
+			auto start = std::chrono::steady_clock::now();
+			ral::operators::process_sort(input, plan, &context);
+			cudaDeviceSynchronize();
+			std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+			state.SetIterationTime(elapsed.count());
+		}
+		state.SetItemsProcessed(state.iterations() * num_rows);
+	}
+
+	std::vector<int64_t> keys;
+};
+
+BENCHMARK_DEFINE_F(GpuSortBench, top_n)(benchmark::State & state) { run(state, limit); }
+BENCHMARK_REGISTER_F(GpuSortBench, top_n)->Unit(benchmark::kMillisecond)->UseManualTime();
+
+// a sort without fetch is the full sort and materialization that the limit used to follow
+BENCHMARK_DEFINE_F(GpuSortBench, sort)(benchmark::State & state) { run(state, -1); }
+BENCHMARK_REGISTER_F(GpuSortBench, sort)->Unit(benchmark::kMillisecond)->UseManualTime();
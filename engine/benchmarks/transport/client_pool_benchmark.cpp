@@ -0,0 +1,100 @@
+#include <blazingdb/transport/Client.h>
+#include <blazingdb/transport/ClientPool.h>
+#include <blazingdb/transport/Server.h>
+
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace blazingdb::transport;
+
+namespace {
+
+const uint32_t context_token = 7301;
+const unsigned short server_port = 8030;
+const int num_threads = 4;
+
+// Message without columns, like the row counts and pivots sent during a shuffle. Only the metadata goes through the
+// socket
+class EmptyMessage : public GPUMessage {
+public:
+	EmptyMessage(const std::string & messageToken, uint32_t contextToken, std::shared_ptr<Node> & sender_node)
+		: GPUMessage{messageToken, contextToken, sender_node} {}
+
+	raw_buffer GetRawColumns() override { return raw_buffer{}; }
+
+	static std::string MessageID() { return "EmptyMessage"; }
+
+	static std::shared_ptr<GPUMessage> MakeFrom(const Message::MetaData & message_metadata,
+		const Address::MetaData & address_metadata,
+		const std::vector<ColumnTransport> & columns_offsets,
+		const std::vector<char *> & raw_buffers) {
+		auto node = Node::Make(Address::TCP(
+			address_metadata.ip, address_metadata.comunication_port, address_metadata.protocol_port));
+		return std::make_shared<EmptyMessage>(message_metadata.messageToken, message_metadata.contextToken, node);
+	}
+};
+
+// sends state.range(0) messages per iteration from a few threads and waits for the server to receive them
+void send_messages(benchmark::State & state, std::function<Status(GPUMessage &)> send) {
+	std::unique_ptr<Server> server = Server::TCP(server_port);
+	server->registerEndPoint(EmptyMessage::MessageID());
+	server->registerMessageForEndPoint(EmptyMessage::MakeFrom, EmptyMessage::MessageID());
+	server->registerContext(context_token);
+	server->Run();
+
+	const int num_messages = state.range(0);
+	std::shared_ptr<Node> sender_node = Node::Make(Address::TCP("127.0.0.1", 8031, 1234));
+	for(auto _ : state) {
+		std::atomic<int> errors{0};
+		std::vector<std::thread> threads;
+		for(int t = 0; t < num_threads; t++) {
+			threads.emplace_back([&, t] {
+				for(int i = t; i < num_messages; i += num_threads) {
+					EmptyMessage message(EmptyMessage::MessageID(), context_token, sender_node);
+					if(!send(message).IsOk()) {
+						errors++;
+					}
+				}
+			});
+		}
+		for(auto & thread : threads) {
+			thread.join();
+		}
+		for(int i = 0; i < num_messages - errors; i++) {
+			if(server->getMessage(context_token, EmptyMessage::MessageID(), std::chrono::seconds(10)) == nullptr) {
+				errors++;
+			}
+		}
+		if(errors > 0) {
+			state.SkipWithError("some messages were not received");
+			break;
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * num_messages);
+	server->Close();
+}
+
+}  // namespace
+
+// opens a connection per message, as the RAL did before the client pool
+static void BM_connection_per_message(benchmark::State & state) {
+	send_messages(state, [](GPUMessage & message) {
+		auto client = ClientTCP::Make("127.0.0.1", server_port);
+		Status status = client->Send(message);
+		client->Close();
+		return status;
+	});
+}
+BENCHMARK(BM_connection_per_message)->Arg(2000)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void BM_client_pool(benchmark::State & state) {
+	ClientPool pool;
+	send_messages(state, [&](GPUMessage & message) { return pool.Send("127.0.0.1", server_port, message); });
+}
+BENCHMARK(BM_client_pool)->Arg(2000)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,85 @@
+#include <blazingdb/transport/MessageQueue.h>
+
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using blazingdb::transport::GPUMessage;
+using blazingdb::transport::MessageQueue;
+using blazingdb::transport::Node;
+
+namespace {
+
+class EmptyMessage : public GPUMessage {
+public:
+	EmptyMessage(const std::string & messageToken, std::shared_ptr<Node> & sender_node)
+		: GPUMessage{messageToken, 0, sender_node} {}
+
+	raw_buffer GetRawColumns() override { return raw_buffer{}; }
+};
+
+}  // namespace
+
+// Every token has its own consumer, the producers put the messages of all the tokens interleaved, which is what
+// happens when many partitions of many nodes are exchanged at the same time
+static void BM_message_queue_concurrent_tokens(benchmark::State & state) {
+	const int num_tokens = state.range(0);
+	const int messages_per_token = 8;
+	const int num_producers = 4;
+
+	std::vector<std::string> tokens;
+	for(int i = 0; i < num_tokens; i++) {
+		tokens.push_back("partition_" + std::to_string(i));
+	}
+
+	for(auto _ : state) {
+		MessageQueue queue;
+		std::atomic<int> errors{0};
+
+		std::vector<std::thread> consumers;
+		for(int i = 0; i < num_tokens; i++) {
+			consumers.emplace_back([&, i] {
+				for(int j = 0; j < messages_per_token; j++) {
+					auto message = queue.getMessage(tokens[i], std::chrono::milliseconds(60000));
+					if(message == nullptr) {
+						errors++;
+					}
+				}
+			});
+		}
+
+		std::vector<std::thread> producers;
+		for(int p = 0; p < num_producers; p++) {
+			producers.emplace_back([&, p] {
+				std::shared_ptr<Node> node;
+				for(int j = 0; j < messages_per_token; j++) {
+					for(int i = p; i < num_tokens; i += num_producers) {
+						std::shared_ptr<GPUMessage> message = std::make_shared<EmptyMessage>(tokens[i], node);
+						queue.putMessage(message);
+					}
+				}
+			});
+		}
+
+		for(auto & thread : producers) {
+			thread.join();
+		}
+		for(auto & thread : consumers) {
+			thread.join();
+		}
+		if(errors > 0) {
+			state.SkipWithError("a consumer did not get its messages");
+			break;
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * num_tokens * messages_per_token);
+}
+BENCHMARK(BM_message_queue_concurrent_tokens)
+	->Arg(500)
+	->Arg(4000)
+	->Unit(benchmark::kMillisecond)
+	->UseRealTime();
@@ -0,0 +1,148 @@
+#include <blazingdb/transport/io/SharedMemoryRing.h>
+#include <blazingdb/transport/io/fd_reader_writer.h>
+
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace blazingdb::transport::io;
+
+namespace {
+
+const std::size_t ring_size = 32 * 1024 * 1024;
+const std::size_t chunk_size = 4 * 1024 * 1024;
+const std::size_t num_chunks = 256;
+const std::size_t num_round_trips = 1000;
+const auto wait_timeout = std::chrono::milliseconds(10000);
+
+std::string ring_name(const std::string & benchmark) {
+	return "/blazingdb-benchmark-" + std::to_string(getpid()) + "-" + benchmark;
+}
+
+// Both ends of a ring in one process, the consumer opens it like the server of another process does
+struct ring_pair {
+	ring_pair(const std::string & name, std::size_t capacity)
+		: producer{SharedMemoryRing::create(name, capacity)}, consumer{SharedMemoryRing::open(name)} {}
+
+	std::unique_ptr<SharedMemoryRing> producer;
+	std::unique_ptr<SharedMemoryRing> consumer;
+};
+
+}  // namespace
+
+// Sends num_chunks through a ring per iteration
+static void BM_ring_transfer(benchmark::State & state) {
+	ring_pair rings(ring_name("transfer"), ring_size);
+	std::vector<char> source(chunk_size, 1);
+	std::vector<char> destination(chunk_size);
+
+	uint64_t end = 0;
+	for(auto _ : state) {
+		std::thread producer_thread([&] {
+			for(std::size_t i = 0; i < num_chunks; i++) {
+				uint64_t position = rings.producer->reserve(chunk_size, wait_timeout);
+				std::memcpy(rings.producer->data(position), source.data(), chunk_size);
+				rings.producer->commit(position + chunk_size);
+			}
+		});
+		for(std::size_t i = 0; i < num_chunks; i++) {
+			uint64_t position = rings.consumer->nextPosition(end, chunk_size);
+			end = position + chunk_size;
+			rings.consumer->waitCommitted(end, wait_timeout);
+			std::memcpy(destination.data(), rings.consumer->data(position), chunk_size);
+			rings.consumer->release(end);
+		}
+		producer_thread.join();
+		benchmark::DoNotOptimize(destination.data());
+	}
+	state.SetBytesProcessed(state.iterations() * num_chunks * chunk_size);
+}
+BENCHMARK(BM_ring_transfer)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Sends num_chunks over a loopback TCP connection per iteration
+static void BM_tcp_transfer(benchmark::State & state) {
+	zmq::context_t context(1);
+	zmq::socket_t receiver(context, ZMQ_PULL);
+	zmq::socket_t sender(context, ZMQ_PUSH);
+	const std::string endpoint = "tcp://127.0.0.1:8034";
+	receiver.bind(endpoint);
+	sender.connect(endpoint);
+
+	std::vector<char> source(chunk_size, 1);
+	for(auto _ : state) {
+		std::thread receiver_thread([&] {
+			std::vector<char> destination(chunk_size);
+			for(std::size_t i = 0; i < num_chunks; i++) {
+				readFromSocket(&receiver, destination.data(), destination.size());
+			}
+			benchmark::DoNotOptimize(destination.data());
+		});
+		for(std::size_t i = 0; i < num_chunks; i++) {
+			writeToSocket(&sender, source.data(), chunk_size, false);
+		}
+		receiver_thread.join();
+	}
+	state.SetBytesProcessed(state.iterations() * num_chunks * chunk_size);
+}
+BENCHMARK(BM_tcp_transfer)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// num_round_trips of a small message through a pair of rings per iteration
+static void BM_ring_round_trip(benchmark::State & state) {
+	ring_pair requests(ring_name("requests"), 4096);
+	ring_pair replies(ring_name("replies"), 4096);
+
+	uint64_t request_end = 0;
+	uint64_t reply_end = 0;
+	for(auto _ : state) {
+		std::thread server_thread([&] {
+			for(std::size_t i = 0; i < num_round_trips; i++) {
+				request_end = requests.consumer->nextPosition(request_end, 8) + 8;
+				requests.consumer->waitCommitted(request_end, wait_timeout);
+				requests.consumer->release(request_end);
+				replies.producer->commit(replies.producer->reserve(8, wait_timeout) + 8);
+			}
+		});
+		for(std::size_t i = 0; i < num_round_trips; i++) {
+			requests.producer->commit(requests.producer->reserve(8, wait_timeout) + 8);
+			reply_end = replies.consumer->nextPosition(reply_end, 8) + 8;
+			replies.consumer->waitCommitted(reply_end, wait_timeout);
+			replies.consumer->release(reply_end);
+		}
+		server_thread.join();
+	}
+	state.SetItemsProcessed(state.iterations() * num_round_trips);
+}
+BENCHMARK(BM_ring_round_trip)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// num_round_trips of a small message over loopback TCP per iteration, like the requests and replies of the client
+// and the server
+static void BM_tcp_round_trip(benchmark::State & state) {
+	zmq::context_t context(1);
+	zmq::socket_t server(context, ZMQ_REP);
+	zmq::socket_t client(context, ZMQ_REQ);
+	const std::string endpoint = "tcp://127.0.0.1:8035";
+	server.bind(endpoint);
+	client.connect(endpoint);
+
+	char message[8]{};
+	for(auto _ : state) {
+		std::thread server_thread([&] {
+			char request[8];
+			for(std::size_t i = 0; i < num_round_trips; i++) {
+				readFromSocket(&server, request, sizeof(request));
+				writeToSocket(&server, request, sizeof(request), false);
+			}
+		});
+		for(std::size_t i = 0; i < num_round_trips; i++) {
+			writeToSocket(&client, message, sizeof(message), false);
+			readFromSocket(&client, message, sizeof(message));
+		}
+		server_thread.join();
+	}
+	state.SetItemsProcessed(state.iterations() * num_round_trips);
+}
+BENCHMARK(BM_tcp_round_trip)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,82 @@
+#include <blazingdb/transport/io/TransportExecutor.h>
+
+#include <benchmark/benchmark.h>
+#include <cstring>
+#include <future>
+#include <thread>
+#include <vector>
+
+using blazingdb::transport::io::TransportExecutor;
+
+namespace {
+
+const int num_nodes = 32;
+const int num_columns = 200;
+const std::size_t column_size = 16 * 1024;
+
+// A 200 column shuffle to 32 nodes: every send copies the chunks of every column
+struct shuffle {
+	shuffle() : source(num_columns * column_size, 1), destinations(num_nodes, std::vector<char>(source.size())) {}
+
+	void copy_column(int node, int column) {
+		std::memcpy(
+			destinations[node].data() + column * column_size, source.data() + column * column_size, column_size);
+	}
+
+	int64_t bytes() const { return static_cast<int64_t>(num_nodes) * source.size(); }
+
+	std::vector<char> source;
+	std::vector<std::vector<char>> destinations;
+};
+
+}  // namespace
+
+// a thread per destination and per column, as writeBuffersFromGPUTCP and distributePartitions did
+static void BM_shuffle_thread_per_buffer(benchmark::State & state) {
+	shuffle data;
+	for(auto _ : state) {
+		std::vector<std::thread> sends;
+		for(int node = 0; node < num_nodes; node++) {
+			sends.emplace_back([&, node]() {
+				std::vector<std::thread> copies;
+				for(int column = 0; column < num_columns; column++) {
+					copies.emplace_back([&, node, column]() { data.copy_column(node, column); });
+				}
+				for(auto & copy : copies) {
+					copy.join();
+				}
+			});
+		}
+		for(auto & send : sends) {
+			send.join();
+		}
+	}
+	state.SetBytesProcessed(state.iterations() * data.bytes());
+	state.counters["threads"] = num_nodes * (num_columns + 1);
+}
+BENCHMARK(BM_shuffle_thread_per_buffer)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void BM_shuffle_transport_executor(benchmark::State & state) {
+	shuffle data;
+	TransportExecutor executor(8, num_nodes);
+	for(auto _ : state) {
+		std::vector<std::future<void>> sends;
+		for(int node = 0; node < num_nodes; node++) {
+			sends.push_back(executor.submitSocket([&, node]() {
+				std::vector<std::future<void>> copies;
+				for(int column = 0; column < num_columns; column++) {
+					copies.push_back(executor.submitCopy([&, node, column]() { data.copy_column(node, column); }));
+				}
+				for(auto & copy : copies) {
+					copy.get();
+				}
+			}));
+		}
+		for(auto & send : sends) {
+			send.get();
+		}
+	}
+	state.SetBytesProcessed(state.iterations() * data.bytes());
+	state.counters["threads"] = executor.numCopyWorkers() + executor.numSocketWorkers();
+}
+BENCHMARK(BM_shuffle_transport_executor)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,105 @@
+#include <blazingdb/transport/io/fd_reader_writer.h>
+
+#include <benchmark/benchmark.h>
+#include <condition_variable>
+#include <mutex>
+#include <numeric>
+#include <stack>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace blazingdb::transport::io;
+
+namespace {
+
+const std::size_t chunk_size = 4 * 1024 * 1024;
+const std::size_t num_chunks = 256;
+const std::size_t num_pool_chunks = 8;
+
+// Stands for the PinnedBufferProvider: the sender waits for a free chunk, and chunks sent without copy come back from
+// the ZMQ thread
+class chunk_pool {
+public:
+	chunk_pool() : chunks(num_pool_chunks, std::vector<char>(chunk_size)) {
+		for(std::size_t i = 0; i < chunks.size(); i++) {
+			std::iota(chunks[i].begin(), chunks[i].end(), static_cast<char>(i));
+			free_chunks.push(chunks[i].data());
+		}
+	}
+
+	char * get() {
+		std::unique_lock<std::mutex> lock(mutex);
+		cv.wait(lock, [this] { return !free_chunks.empty(); });
+		char * chunk = free_chunks.top();
+		free_chunks.pop();
+		return chunk;
+	}
+
+	void put(char * chunk) {
+		std::lock_guard<std::mutex> lock(mutex);
+		free_chunks.push(chunk);
+		cv.notify_one();
+	}
+
+	static void return_chunk(void * data, void * hint) {
+		static_cast<chunk_pool *>(hint)->put(static_cast<char *>(data));
+	}
+
+private:
+	std::vector<std::vector<char>> chunks;
+	std::mutex mutex;
+	std::condition_variable cv;
+	std::stack<char *> free_chunks;
+};
+
+// sends num_chunks over a loopback TCP connection per iteration
+void transfer(benchmark::State & state, bool zero_copy, unsigned short port) {
+	zmq::context_t context(1);
+	zmq::socket_t receiver(context, ZMQ_PULL);
+	zmq::socket_t sender(context, ZMQ_PUSH);
+	const std::string endpoint = "tcp://127.0.0.1:" + std::to_string(port);
+	receiver.bind(endpoint);
+	sender.connect(endpoint);
+
+	chunk_pool pool;
+	for(auto _ : state) {
+		std::thread receiver_thread([&] {
+			std::vector<char> destination(chunk_size);
+			for(std::size_t i = 0; i < num_chunks; i++) {
+				if(zero_copy) {
+					zmq::message_t message = readMessageFromSocket(&receiver);
+					benchmark::DoNotOptimize(message.data());
+				} else {
+					readFromSocket(&receiver, destination.data(), destination.size());
+					benchmark::DoNotOptimize(destination.data());
+				}
+			}
+		});
+
+		for(std::size_t i = 0; i < num_chunks; i++) {
+			char * chunk = pool.get();
+			if(zero_copy) {
+				writeToSocket(&sender, chunk, chunk_size, chunk_pool::return_chunk, &pool, false);
+			} else {
+				writeToSocket(&sender, chunk, chunk_size, false);
+				pool.put(chunk);
+			}
+		}
+		receiver_thread.join();
+	}
+	state.SetBytesProcessed(state.iterations() * num_chunks * chunk_size);
+
+	// every chunk lent to ZMQ is given back before the pool goes away
+	for(std::size_t i = 0; i < num_pool_chunks; i++) {
+		pool.get();
+	}
+}
+
+}  // namespace
+
+static void BM_loopback_copy(benchmark::State & state) { transfer(state, false, 8032); }
+BENCHMARK(BM_loopback_copy)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void BM_loopback_zero_copy(benchmark::State & state) { transfer(state, true, 8033); }
+BENCHMARK(BM_loopback_zero_copy)->Unit(benchmark::kMillisecond)->UseRealTime();
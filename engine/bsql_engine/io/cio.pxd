@@ -30,6 +30,7 @@ cdef extern from "../include/engine/errors.h":
     cdef void raiseRegisterFileSystemGCSError();
     cdef void raiseRegisterFileSystemS3Error();
     cdef void raiseRegisterFileSystemLocalError();
+    cdef void raiseSetFileCacheError();
 
 cdef extern from "cudf/types.hpp" namespace "cudf" nogil:
 
@@ -209,6 +210,9 @@ cdef extern from "../include/io/io.h":
         vector[string] datasource
         vector[unsigned long] calcite_to_file_indices
         vector[unsigned long] num_row_groups
+        vector[unsigned long] num_rows
+        vector[unsigned long] file_sizes
+        vector[vector[int]] row_group_ids
         vector[bool] in_file
         int data_type
         ReaderArgs args
@@ -235,6 +239,15 @@ cdef extern from "../include/io/io.h":
     pair[bool, string] registerFileSystemGCS( GCS gcs, string root, string authority) except +raiseRegisterFileSystemGCSError
     pair[bool, string] registerFileSystemS3( S3 s3, string root, string authority) except +raiseRegisterFileSystemS3Error
     pair[bool, string] registerFileSystemLocal(  string root, string authority) except +raiseRegisterFileSystemLocalError
+    cdef struct FileCacheInfo:
+        long long hits
+        long long misses
+        long long evictions
+        long long blocks
+        long long size
+        long long capacity
+    pair[bool, string] setFileCache(string directory, long long capacity, long long blockSize) except +raiseSetFileCacheError
+    FileCacheInfo getFileCacheInfo()
     TableSchema parseSchema(vector[string] files, string file_format_hint, vector[string] arg_keys, vector[string] arg_values, vector[pair[string,gdf_dtype]] types) except +raiseParseSchemaError
 
 ctypedef gdf_scalar* gdf_scalar_ptr
@@ -255,6 +268,13 @@ cdef extern from "../include/engine/engine.h":
             vector[vector[int]] table_columns
         TableScanInfo getTableScanInfo(string logicalPlan)
 
+        cdef struct PlanCacheInfo:
+            size_t hits
+            size_t misses
+            size_t size
+            size_t capacity
+        PlanCacheInfo getPlanCacheInfo()
+
 cdef extern from "../include/engine/initialize.h":
-    cdef void initialize(int ralId, int gpuId, string network_iface_name, string ralHost, int ralCommunicationPort, bool singleNode) except +raiseInitializeError
+    cdef void initialize(int ralId, int gpuId, string network_iface_name, string ralHost, int ralCommunicationPort, bool singleNode, map[string, string] config_options) except +raiseInitializeError
     cdef void finalize() except +raiseFinalizeError
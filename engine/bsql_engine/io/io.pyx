@@ -80,6 +80,10 @@ class RegisterFileSystemLocalError(BlazingError):
     """RegisterFileSystemLocal Error."""
 cdef public PyObject * RegisterFileSystemLocalError_ = <PyObject *>RegisterFileSystemLocalError
 
+class SetFileCacheError(BlazingError):
+    """SetFileCache Error."""
+cdef public PyObject * SetFileCacheError_ = <PyObject *>SetFileCacheError
+
 
 cdef cio.TableSchema parseSchemaPython(vector[string] files, string file_format_hint, vector[string] arg_keys, vector[string] arg_values,vector[pair[string,gdf_dtype]] extra_columns):
     temp = cio.parseSchema(files,file_format_hint,arg_keys,arg_values,extra_columns)
@@ -93,8 +97,12 @@ cdef cio.TableScanInfo getTableScanInfoPython(string logicalPlan):
     temp = cio.getTableScanInfo(logicalPlan)
     return temp
 
-cdef void initializePython(int ralId, int gpuId, string network_iface_name, string ralHost, int ralCommunicationPort, bool singleNode) except *:
-    cio.initialize( ralId,  gpuId, network_iface_name,  ralHost,  ralCommunicationPort, singleNode)
+cdef cio.PlanCacheInfo getPlanCacheInfoPython():
+    temp = cio.getPlanCacheInfo()
+    return temp
+
+cdef void initializePython(int ralId, int gpuId, string network_iface_name, string ralHost, int ralCommunicationPort, bool singleNode, map[string, string] config_options) except *:
+    cio.initialize( ralId,  gpuId, network_iface_name,  ralHost,  ralCommunicationPort, singleNode, config_options)
 
 cdef void finalizePython() except *:
     cio.finalize()
@@ -133,8 +141,18 @@ cpdef pair[bool, string] registerFileSystemCaller(fs, root, authority):
     if fs['type'] == 'local':
         return cio.registerFileSystemLocal( str.encode( root), str.encode(authority))
 
-cpdef initializeCaller(int ralId, int gpuId, string network_iface_name, string ralHost, int ralCommunicationPort, bool singleNode):
-    initializePython( ralId,  gpuId, network_iface_name,  ralHost,  ralCommunicationPort, singleNode)
+cpdef pair[bool, string] setFileCacheCaller(directory, capacity, block_size):
+    return cio.setFileCache(str.encode(directory), capacity, block_size)
+
+cpdef getFileCacheInfoCaller():
+    temp = cio.getFileCacheInfo()
+    return {'hits': temp.hits, 'misses': temp.misses, 'evictions': temp.evictions, 'blocks': temp.blocks, 'size': temp.size, 'capacity': temp.capacity}
+
+cpdef initializeCaller(int ralId, int gpuId, string network_iface_name, string ralHost, int ralCommunicationPort, bool singleNode, config_options):
+    cdef map[string, string] config_options_cpp
+    for key, value in config_options.items():
+      config_options_cpp[str.encode(key)] = str.encode(str(value))
+    initializePython( ralId,  gpuId, network_iface_name,  ralHost,  ralCommunicationPort, singleNode, config_options_cpp)
 
 cpdef finalizeCaller():
     finalizePython()
@@ -166,6 +184,8 @@ cpdef parseSchemaCaller(fileList, file_format_hint, args, extra_columns):
     return_object['names'] = temp.names
     return_object['calcite_to_file_indices']= temp.calcite_to_file_indices
     return_object['num_row_groups']= temp.num_row_groups
+    return_object['num_rows']= temp.num_rows
+    return_object['file_sizes']= temp.file_sizes
     i = 0
     for column in temp.columns:
       column.col_name = return_object['names'][i]
@@ -254,6 +274,12 @@ cpdef runQueryCaller(int masterIndex,  tcpMetadata,  tables,  vector[int] fileTy
         currentTableSchemaCpp.calcite_to_file_indices = table.calcite_to_file_indices
       if table.num_row_groups is not None:
         currentTableSchemaCpp.num_row_groups = table.num_row_groups
+      currentTableSchemaCpp.num_rows.resize(0)
+      if table.num_rows is not None:
+        currentTableSchemaCpp.num_rows = table.num_rows
+      currentTableSchemaCpp.row_group_ids.resize(0)
+      if table.row_group_ids is not None:
+        currentTableSchemaCpp.row_group_ids = table.row_group_ids
       currentTableSchemaCpp.in_file = table.in_file
       currentTableSchemaCppArgKeys.resize(0)
       currentTableSchemaCppArgValues.resize(0)
@@ -316,3 +342,7 @@ cpdef getTableScanInfoCaller(logicalPlan,tables):
 
         new_tables[table_name] = new_table
     return new_tables, relational_algebra_steps
+
+cpdef getPlanCacheInfoCaller():
+    temp = getPlanCacheInfoPython()
+    return {'hits': temp.hits, 'misses': temp.misses, 'size': temp.size, 'capacity': temp.capacity}
@@ -4,4 +4,9 @@ import pytest
 
 def test_Initialize():
     with pytest.raises(bsql_engine.InitializeError):
-        bsql_engine.initializeCaller(1, -1, b'', b'', 0, False)
+        bsql_engine.initializeCaller(1, -1, b'', b'', 0, False, {})
+
+
+def test_InitializeUnknownConfigOption():
+    with pytest.raises(bsql_engine.InitializeError):
+        bsql_engine.initializeCaller(1, 0, b'lo', b'', 0, True, {'RECEIVE_CREDIT': 1024})
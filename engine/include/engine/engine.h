@@ -36,3 +36,12 @@ struct TableScanInfo {
 };
 
 TableScanInfo getTableScanInfo(std::string logicalPlan);
+
+struct PlanCacheInfo {
+	std::size_t hits;
+	std::size_t misses;
+	std::size_t size;
+	std::size_t capacity;
+};
+
+PlanCacheInfo getPlanCacheInfo();
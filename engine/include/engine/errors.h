@@ -6,3 +6,4 @@ void raiseRegisterFileSystemHDFSError();
 void raiseRegisterFileSystemGCSError();
 void raiseRegisterFileSystemS3Error();
 void raiseRegisterFileSystemLocalError();
+void raiseSetFileCacheError();
@@ -1,3 +1,4 @@
+#include <map>
 #include <string>
 
 void initialize(int ralId,
@@ -5,5 +6,6 @@ void initialize(int ralId,
 	std::string network_iface_name,
 	std::string ralHost,
 	int ralCommunicationPort,
-	bool singleNode);
+	bool singleNode,
+	std::map<std::string, std::string> config_options);
 void finalize();
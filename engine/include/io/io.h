@@ -24,6 +24,11 @@ struct TableSchema {
 	std::vector<std::string> names;
 	std::vector<size_t> calcite_to_file_indices;
 	std::vector<size_t> num_row_groups;
+	std::vector<size_t> num_rows;
+	// bytes of each file, 0 when the file system did not report it
+	std::vector<size_t> file_sizes;
+	// row groups of each file to read, all of them when the list is empty
+	std::vector<std::vector<int>> row_group_ids;
 	std::vector<bool> in_file;
 	int data_type;
 	ReaderArgs args;
@@ -74,3 +79,17 @@ std::pair<bool, std::string> registerFileSystemHDFS(HDFS hdfs, std::string root,
 std::pair<bool, std::string> registerFileSystemGCS(GCS gcs, std::string root, std::string authority);
 std::pair<bool, std::string> registerFileSystemS3(S3 s3, std::string root, std::string authority);
 std::pair<bool, std::string> registerFileSystemLocal(std::string root, std::string authority);
+
+struct FileCacheInfo {
+	long long hits;
+	long long misses;
+	long long evictions;
+	long long blocks;
+	long long size;
+	long long capacity;
+};
+
+// the remote file systems registered afterwards are read through a block cache in directory. A capacity of 0 disables
+// the cache
+std::pair<bool, std::string> setFileCache(std::string directory, long long capacity, long long blockSize);
+FileCacheInfo getFileCacheInfo();
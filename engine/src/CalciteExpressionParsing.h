@@ -25,6 +25,9 @@ size_t get_index(std::string operand_string);
 // interprets the expression and if is n-ary and logical, then returns their corresponding binary version
 std::string expand_if_logical_op(std::string expression);
 
+// rewrites the Calcite syntax that the expression parser does not understand, i.e. IS NULL into IS_NULL
+std::string replace_calcite_regex(std::string expression);
+
 std::string clean_calcite_expression(std::string expression);
 
 std::vector<std::string> get_tokens_in_reverse_order(const std::string & expression);
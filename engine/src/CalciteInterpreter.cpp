@@ -4,6 +4,9 @@
 #include <blazingdb/io/Util/StringUtil.h>
 
 #include <algorithm>
+#include <functional>
+#include <future>
+#include <memory>
 #include <regex>
 #include <set>
 #include <string>
@@ -20,6 +23,7 @@
 #include "Utils.cuh"
 #include "communication/network/Server.h"
 #include "config/GPUManager.cuh"
+#include "execution/TaskExecutor.h"
 #include "cuDF/safe_nvcategory_gather.hpp"
 #include "cudf/legacy/binaryop.hpp"
 #include "io/DataLoader.h"
@@ -36,101 +40,46 @@
 #include <cudf/legacy/table.hpp>
 #include <rmm/thrust_rmm_allocator.h>
 #include "parser/expression_tree.hpp"
+#include "parser/plan_cache.hpp"
+#include "parser/relational_plan.hpp"
 
-const std::string LOGICAL_JOIN_TEXT = "LogicalJoin";
-const std::string LOGICAL_UNION_TEXT = "LogicalUnion";
 const std::string LOGICAL_SCAN_TEXT = "LogicalTableScan";
 const std::string BINDABLE_SCAN_TEXT = "BindableTableScan";
-const std::string LOGICAL_AGGREGATE_TEXT = "LogicalAggregate";
-const std::string LOGICAL_PROJECT_TEXT = "LogicalProject";
-const std::string LOGICAL_SORT_TEXT = "LogicalSort";
-const std::string LOGICAL_FILTER_TEXT = "LogicalFilter";
-const std::string ASCENDING_ORDER_SORT_TEXT = "ASC";
-const std::string DESCENDING_ORDER_SORT_TEXT = "DESC";
-
-bool is_union(std::string query_part) { return (query_part.find(LOGICAL_UNION_TEXT) != std::string::npos); }
-
-bool is_project(std::string query_part) { return (query_part.find(LOGICAL_PROJECT_TEXT) != std::string::npos); }
 
 bool is_logical_scan(std::string query_part) { return (query_part.find(LOGICAL_SCAN_TEXT) != std::string::npos); }
 
 bool is_bindable_scan(std::string query_part) { return (query_part.find(BINDABLE_SCAN_TEXT) != std::string::npos); }
 
-bool is_filtered_bindable_scan(std::string query_part) {
-	return is_bindable_scan(query_part) && (query_part.find("filters") != std::string::npos);
-}
-
 bool is_scan(std::string query_part) { return is_logical_scan(query_part) || is_bindable_scan(query_part); }
 
+project_plan_params parse_project_plan(blazing_frame & input, std::string query_part) {
+	// LogicalProject(x=[$0], y=[$1], z=[$2], e=[$3], join_x=[$4], y0=[$5], EXPR$6=[+($0, $5)])
+	std::string combined_expression =
+		query_part.substr(query_part.find("(") + 1, (query_part.rfind(")") - query_part.find("(")) - 1);
 
-bool is_filter(std::string query_part) { return (query_part.find(LOGICAL_FILTER_TEXT) != std::string::npos); }
-
-int count_string_occurrence(std::string haystack, std::string needle) {
-	int position = haystack.find(needle, 0);
-	int count = 0;
-	while(position != std::string::npos) {
-		count++;
-		position = haystack.find(needle, position + needle.size());
-	}
-
-	return count;
-}
-
-bool is_double_input(std::string query_part) {
-	if(ral::operators::is_join(query_part)) {
-		return true;
-	} else if(is_union(query_part)) {
-		return true;
-	} else {
-		return false;
-	}
-}
-
-std::string get_filter_expression(std::string query_part) {
-	std::string filter_string = query_part.substr(query_part.find("filters="));
-	size_t start = filter_string.find("[[") + 2;
-	size_t end = filter_string.find("]]");
-	return filter_string.substr(start, end - start);
-}
-
-// Input: [[hr, emps]] or [[emps]] Output: hr.emps or emps
-std::string extract_table_name(std::string query_part) {
-	size_t start = query_part.find("[[") + 2;
-	size_t end = query_part.find("]]");
-	std::string table_name_text = query_part.substr(start, end - start);
-	std::vector<std::string> table_parts = StringUtil::split(table_name_text, ',');
-	std::string table_name = "";
-	for(int i = 0; i < table_parts.size(); i++) {
-		if(table_parts[i][0] == ' ') {
-			table_parts[i] = table_parts[i].substr(1, table_parts[i].size() - 1);
-		}
-		table_name += table_parts[i];
-		if(i != table_parts.size() - 1) {
-			table_name += ".";
-		}
+	std::vector<std::string> named_expressions = get_expressions_from_expression_list(combined_expression);
+	std::vector<std::string> names(named_expressions.size());
+	std::vector<std::string> expressions(named_expressions.size());
+	for(int i = 0; i < named_expressions.size(); i++) {
+		names[i] = named_expressions[i].substr(0, named_expressions[i].find("=["));
+		expressions[i] = named_expressions[i].substr(
+			named_expressions[i].find("=[") + 2, (named_expressions[i].size() - named_expressions[i].find("=[")) - 3);
 	}
 
-	return table_name;
+	return parse_project_plan(input, names, expressions);
 }
 
-project_plan_params parse_project_plan(blazing_frame & input, std::string query_part) {
+project_plan_params parse_project_plan(
+	blazing_frame & input, const std::vector<std::string> & names, const std::vector<std::string> & expressions) {
 	gdf_error err = GDF_SUCCESS;
 
 	size_t size = input.get_num_rows_in_table(0);
 
-
-	// LogicalProject(x=[$0], y=[$1], z=[$2], e=[$3], join_x=[$4], y0=[$5], EXPR$6=[+($0, $5)])
-	std::string combined_expression =
-		query_part.substr(query_part.find("(") + 1, (query_part.rfind(")") - query_part.find("(")) - 1);
-
-	std::vector<std::string> expressions = get_expressions_from_expression_list(combined_expression);
-
 	// now we have a vector
 	// x=[$0
 	std::vector<bool> input_used_in_output(input.get_width(), false);
 
 	std::vector<gdf_column_cpp> columns(expressions.size());
-	std::vector<std::string> names(expressions.size());
 
 
 	std::vector<column_index_type> final_output_positions;
@@ -149,10 +98,8 @@ project_plan_params parse_project_plan(blazing_frame & input, std::string query_
 	std::vector<bool> input_used_in_expression(input.get_size_column(), false);
 
 	for(int i = 0; i < expressions.size(); i++) {  // last not an expression
-		std::string expression = expressions[i].substr(
-			expressions[i].find("=[") + 2, (expressions[i].size() - expressions[i].find("=[")) - 3);
-
-		std::string name = expressions[i].substr(0, expressions[i].find("=["));
+		const std::string & expression = expressions[i];
+		const std::string & name = names[i];
 
 		if(contains_evaluation(expression)) {
 			output_type_expressions[i] = get_output_type_expression(&input, &max_temp_type, expression);
@@ -197,10 +144,8 @@ project_plan_params parse_project_plan(blazing_frame & input, std::string query_
 	std::vector<gdf_scalar> right_scalars;
 	size_t cur_expression_out = 0;
 	for(int i = 0; i < expressions.size(); i++) {  // last not an expression
-		std::string expression = expressions[i].substr(
-			expressions[i].find("=[") + 2, (expressions[i].size() - expressions[i].find("=[")) - 3);
-
-		std::string name = expressions[i].substr(0, expressions[i].find("=["));
+		const std::string & expression = expressions[i];
+		const std::string & name = names[i];
 
 		if(contains_evaluation(expression)) {
 			final_output_positions.push_back(input_columns.size() + final_output_positions.size());
@@ -308,8 +253,15 @@ project_plan_params parse_project_plan(blazing_frame & input, std::string query_
 }
 
 void execute_project_plan(blazing_frame & input, std::string query_part) {
-	project_plan_params params = parse_project_plan(input, query_part);
+	execute_project_plan(input, parse_project_plan(input, query_part));
+}
+
+void execute_project_plan(
+	blazing_frame & input, const std::vector<std::string> & names, const std::vector<std::string> & expressions) {
+	execute_project_plan(input, parse_project_plan(input, names, expressions));
+}
 
+void execute_project_plan(blazing_frame & input, project_plan_params params) {
 	// perform operations
 	if(params.num_expressions_out > 0) {
 		size_t size = params.input_columns[0]->size;
@@ -349,11 +301,7 @@ std::string get_named_expression(std::string query_part, std::string expression_
 	return query_part.substr(start_position, end_position - start_position);
 }
 
-std::string get_condition_expression(std::string query_part) { return get_named_expression(query_part, "condition"); }
-
-
-blazing_frame process_union(blazing_frame & left, blazing_frame & right, std::string query_part) {
-	bool isUnionAll = (get_named_expression(query_part, "all") == "true");
+blazing_frame process_union(blazing_frame & left, blazing_frame & right, bool isUnionAll) {
 	if(!isUnionAll) {
 		throw std::runtime_error{"In process_union function: UNION is not supported, use UNION ALL"};
 	}
@@ -453,9 +401,8 @@ void split_inequality_join_into_join_and_filter(const std::string & join_stateme
 
 
 //TODO: this does not compact the allocations which would be nice if it could
-void process_filter(Context * context, blazing_frame & input, std::string query_part){
-	static CodeTimer timer;
-	timer.reset();
+void process_filter(Context * context, blazing_frame & input, const std::string & conditional_expression){
+	CodeTimer timer;
 
 	size_t size = input.get_num_rows_in_table(0);
 	if(size <= 0) {
@@ -475,11 +422,6 @@ void process_filter(Context * context, blazing_frame & input, std::string query_
 		timer.logDuration(*context, "Filter part 1 initialize stencil", "num rows", input.get_num_rows_in_table(0)));
 	timer.reset();
 
-	std::string conditional_expression = get_condition_expression(query_part);
-	if(conditional_expression == "") {
-		conditional_expression = get_filter_expression(query_part);
-	}
-
 	evaluate_expression(input, conditional_expression, stencil);
 
 	Library::Logging::Logger().logInfo(
@@ -528,359 +470,237 @@ size_t get_table_index(std::vector<std::string> table_names, std::string table_n
 	}
 }
 
-// TODO: if a table needs to be used more than once you need to include it twice
-// i know that kind of sucks, its for the 0 copy stuff, this can easily be remedied
-// by changings scan to make copies
-blazing_frame evaluate_split_query(std::vector<std::vector<gdf_column_cpp>> input_tables,
-	std::vector<std::string> table_names,
-	std::vector<std::vector<std::string>> column_names,
-	std::vector<std::string> query,
-	Context * queryContext,
-	int call_depth) {
-	assert(input_tables.size() == table_names.size());
+namespace {
 
-	CodeTimer blazing_timer;
-	blazing_timer.reset();
+using ral::parser::relational_node;
+using ral::parser::relational_node_type;
 
-	if(query.size() == 1) {
-		// process yourself and return
+/**
+ * produces the frame of a scan node, either from tables already in memory or by loading it
+ */
+using scan_function = std::function<blazing_frame(const relational_node & node, Context * queryContext)>;
 
-		if(is_scan(query[0])) {
-			blazing_frame scan_frame;
-			// EnumerableTableScan(table=[[hr, joiner]])
-			scan_frame.add_table(input_tables[get_table_index(table_names, extract_table_name(query[0]))]);
-			return scan_frame;
-		} else {
-			// i dont think there are any other type of end nodes at the moment
-		}
+// A subtree can be evaluated concurrently with its sibling when it does not share any table with it and its
+// evaluation does not depend on the messaging order with other nodes. This only depends on the plan, so every
+// node takes the same decision.
+bool can_run_detached(Context * queryContext, const relational_node & subtree, const relational_node & sibling) {
+	if(queryContext->getTotalNodes() > 1 && subtree.needs_communication()) {
+		return false;
 	}
 
-	if(is_double_input(query[0])) {
-		int other_depth_one_start = 2;
-		for(int i = 2; i < query.size(); i++) {
-			int j = 0;
-			while(query[i][j] == ' ') {
-				j += 2;
-			}
-			int depth = (j / 2) - call_depth;
-			if(depth == 1) {
-				other_depth_one_start = i;
-			}
-		}
-		// these shoudl be split up and run on different threads
-		blazing_frame left_frame;
-		left_frame = evaluate_split_query(input_tables,
-			table_names,
-			column_names,
-			std::vector<std::string>(query.begin() + 1, query.begin() + other_depth_one_start),
-			queryContext,
-			call_depth + 1);
-
-		blazing_frame right_frame;
-		right_frame = evaluate_split_query(input_tables,
-			table_names,
-			column_names,
-			std::vector<std::string>(query.begin() + other_depth_one_start, query.end()),
-			queryContext,
-			call_depth + 1);
-
-		blazing_frame result_frame;
-
-		if(ral::operators::is_join(query[0])) {
-			// we know that left and right are dataframes we want to join together
-			blazing_timer.reset();  // doing a reset before to not include other calls to evaluate_split_query
-			int numLeft = left_frame.get_num_rows_in_table(0);
-			int numRight = right_frame.get_num_rows_in_table(0);
-			left_frame.add_table(right_frame.get_table(0));
-			/// left_frame.consolidate_tables();
-			result_frame = ral::operators::process_join(queryContext, left_frame, query[0]);
-			std::string extraInfo =
-				"left_side_num_rows:" + std::to_string(numLeft) + ":right_side_num_rows:" + std::to_string(numRight);
-			Library::Logging::Logger().logInfo(blazing_timer.logDuration(*queryContext,
-				"evaluate_split_query process_join",
-				"num rows result",
-				result_frame.get_num_rows_in_table(0),
-				extraInfo));
-			blazing_timer.reset();
-			return result_frame;
-		} else if(is_union(query[0])) {
-			// TODO: append the frames to each other
-			// return right_frame;//!!
-			blazing_timer.reset();  // doing a reset before to not include other calls to evaluate_split_query
-			int numLeft = left_frame.get_num_rows_in_table(0);
-			int numRight = right_frame.get_num_rows_in_table(0);
-			result_frame = process_union(left_frame, right_frame, query[0]);
-			std::string extraInfo =
-				"left_side_num_rows:" + std::to_string(numLeft) + ":right_side_num_rows:" + std::to_string(numRight);
-			Library::Logging::Logger().logInfo(blazing_timer.logDuration(*queryContext,
-				"evaluate_split_query process_union",
-				"num rows result",
-				result_frame.get_num_rows_in_table(0),
-				extraInfo));
-			blazing_timer.reset();
-			return result_frame;
-		} else {
-			throw std::runtime_error{"In evaluate_split_query function: unsupported query operator"};
-		}
-
-	} else {
-		// process child
-		blazing_frame child_frame = evaluate_split_query(input_tables,
-			table_names,
-			column_names,
-			std::vector<std::string>(query.begin() + 1, query.end()),
-			queryContext,
-			call_depth + 1);
-		// process self
-		if(is_project(query[0])) {
-			blazing_timer.reset();  // doing a reset before to not include other calls to evaluate_split_query
-			execute_project_plan(child_frame, query[0]);
-			Library::Logging::Logger().logInfo(blazing_timer.logDuration(*queryContext,
-				"evaluate_split_query process_project",
-				"num rows",
-				child_frame.get_num_rows_in_table(0)));
-			blazing_timer.reset();
-			return child_frame;
-		} else if(ral::operators::is_aggregate(query[0])) {
-			blazing_timer.reset();  // doing a reset before to not include other calls to evaluate_split_query
-			ral::operators::process_aggregate(child_frame, query[0], queryContext);
-			Library::Logging::Logger().logInfo(blazing_timer.logDuration(*queryContext,
-				"evaluate_split_query process_aggregate",
-				"num rows",
-				child_frame.get_num_rows_in_table(0)));
-			blazing_timer.reset();
-			return child_frame;
-		} else if(ral::operators::is_sort(query[0])) {
-			blazing_timer.reset();  // doing a reset before to not include other calls to evaluate_split_query
-			ral::operators::process_sort(child_frame, query[0], queryContext);
-			Library::Logging::Logger().logInfo(blazing_timer.logDuration(
-				*queryContext, "evaluate_split_query process_sort", "num rows", child_frame.get_num_rows_in_table(0)));
-			blazing_timer.reset();
-			return child_frame;
-		} else if(is_filter(query[0])) {
-			blazing_timer.reset();  // doing a reset before to not include other calls to evaluate_split_query
-			process_filter(queryContext, child_frame, query[0]);
-			Library::Logging::Logger().logInfo(blazing_timer.logDuration(*queryContext,
-				"evaluate_split_query process_filter",
-				"num rows",
-				child_frame.get_num_rows_in_table(0)));
-			blazing_timer.reset();
-			return child_frame;
-		} else {
-			throw std::runtime_error{"In evaluate_split_query function: unsupported query operator"};
+	std::vector<std::string> sibling_tables = sibling.get_table_names();
+	for(const std::string & table_name : subtree.get_table_names()) {
+		if(std::find(sibling_tables.begin(), sibling_tables.end(), table_name) != sibling_tables.end()) {
+			return false;
 		}
-		// return frame
 	}
+	return true;
 }
 
-blazing_frame evaluate_split_query(std::vector<ral::io::data_loader> input_loaders,
-	std::vector<ral::io::Schema> schemas,
-	std::vector<std::string> table_names,
-	std::vector<std::string> query,
-	Context * queryContext,
-	int call_depth = 0) {
-	assert(input_loaders.size() == table_names.size());
-
-	CodeTimer blazing_timer;
-	blazing_timer.reset();
-
-	if(query.size() == 1) {
-		// process yourself and return
-
-		if(is_scan(query[0])) {
-			blazing_frame scan_frame;
-			std::vector<gdf_column_cpp> input_table;
-
-			size_t table_index = get_table_index(table_names, extract_table_name(query[0]));
-			if(is_bindable_scan(query[0])) {
-				blazing_timer.reset();  // doing a reset before to not include other calls to evaluate_split_query
-				std::string project_string = get_named_expression(query[0], "projects");
-				std::vector<std::string> project_string_split =
-					get_expressions_from_expression_list(project_string, true);
-
-				std::string aliases_string = get_named_expression(query[0], "aliases");
-				std::vector<std::string> aliases_string_split =
-					get_expressions_from_expression_list(aliases_string, true);
+blazing_frame evaluate_relational_node(
+	const relational_node & node, const scan_function & scan, Context * queryContext);
 
-				std::vector<size_t> projections;
-				for(int i = 0; i < project_string_split.size(); i++) {
-					projections.push_back(std::stoull(project_string_split[i]));
-				}
-
-				// This is for the count(*) case, we don't want to load all the columns
-				if(projections.size() == 0 && aliases_string_split.size() == 1) {
-					projections.push_back(0);
-				}
+// When one of the inputs can be detached it is evaluated on the task executor while the other one is evaluated
+// on this thread, so that the loading of one side overlaps the compute of the other
+void evaluate_inputs(const relational_node & node,
+	const scan_function & scan,
+	Context * queryContext,
+	blazing_frame & left_frame,
+	blazing_frame & right_frame) {
+	const relational_node & left = *node.children[0];
+	const relational_node & right = *node.children[1];
+
+	bool detach_left = can_run_detached(queryContext, left, right);
+	bool detach_right = !detach_left && can_run_detached(queryContext, right, left);
+	if(!detach_left && !detach_right) {
+		left_frame = evaluate_relational_node(left, scan, queryContext);
+		right_frame = evaluate_relational_node(right, scan, queryContext);
+		return;
+	}
 
-				input_loaders[table_index].load_data(*queryContext, input_table, projections, schemas[table_index]);
+	const relational_node & detached_node = detach_left ? left : right;
+	const relational_node & inline_node = detach_left ? right : left;
+	blazing_frame & detached_frame = detach_left ? left_frame : right_frame;
+	blazing_frame & inline_frame = detach_left ? right_frame : left_frame;
+
+	// the detached input always works on its own copy of the context, that way the query steps used to
+	// communicate with other nodes do not depend on whether it actually ran concurrently or not
+	std::shared_ptr<Context> detached_context = std::make_shared<Context>(*queryContext);
+	auto detached_task = [&detached_node, &scan, detached_context]() {
+		return evaluate_relational_node(detached_node, scan, detached_context.get());
+	};
+
+	std::future<blazing_frame> detached_result = ral::execution::task_executor::getInstance().try_submit(detached_task);
+	if(!detached_result.valid()) {
+		detached_frame = detached_task();
+		inline_frame = evaluate_relational_node(inline_node, scan, queryContext);
+		return;
+	}
 
-				// Setting the aliases only when is not an empty set
-				for(size_t col_idx = 0; col_idx < aliases_string_split.size(); col_idx++) {
-					// TODO: Rommel, this check is needed when for example the scan has not projects but there are extra
-					// aliases
-					if(col_idx < input_table.size()) {
-						input_table[col_idx].set_name_cpp_only(aliases_string_split[col_idx]);
-					}
-				}
-				int num_rows = input_table.size() > 0 ? input_table[0].size() : 0;
-				Library::Logging::Logger().logInfo(
-					blazing_timer.logDuration(*queryContext, "evaluate_split_query load_data", "num rows", num_rows));
-				blazing_timer.reset();
-
-				if(is_filtered_bindable_scan(query[0])) {
-					scan_frame.add_table(input_table);
-					process_filter(queryContext, scan_frame, query[0]);
-					Library::Logging::Logger().logInfo(blazing_timer.logDuration(*queryContext,
-						"evaluate_split_query process_filter",
-						"num rows",
-						scan_frame.get_num_rows_in_table(0)));
-					blazing_timer.reset();
-					queryContext->incrementQueryStep();
-					return scan_frame;
-				}
-			} else {
-				blazing_timer.reset();  // doing a reset before to not include other calls to evaluate_split_query
-				input_loaders[table_index].load_data(*queryContext, input_table, {}, schemas[table_index]);
-				int num_rows = input_table.size() > 0 ? input_table[0].size() : 0;
-				Library::Logging::Logger().logInfo(
-					blazing_timer.logDuration(*queryContext, "evaluate_split_query load_data", "num rows", num_rows));
-				blazing_timer.reset();
-			}
+	try {
+		inline_frame = evaluate_relational_node(inline_node, scan, queryContext);
+	} catch(...) {
+		// the detached task references the plan and the scan function, it has to finish before unwinding
+		detached_result.wait();
+		throw;
+	}
 
+	CodeTimer blazing_timer;
+	detached_frame = detached_result.get();
+	Library::Logging::Logger().logInfo(blazing_timer.logDuration(*queryContext,
+		"evaluate_split_query wait concurrent subtree",
+		"num rows",
+		detached_frame.get_num_rows_in_table(0)));
+}
 
-			// EnumerableTableScan(table=[[hr, joiner]])
-			scan_frame.add_table(input_table);
-			queryContext->incrementQueryStep();
-			return scan_frame;
-		} else {
-			// i dont think there are any other type of end nodes at the moment
-		}
+blazing_frame evaluate_relational_node(
+	const relational_node & node, const scan_function & scan, Context * queryContext) {
+	if(node.is_scan()) {
+		blazing_frame scan_frame = scan(node, queryContext);
+		queryContext->incrementQueryStep();
+		return scan_frame;
 	}
 
-	if(is_double_input(query[0])) {
-		int other_depth_one_start = 2;
-		for(int i = 2; i < query.size(); i++) {
-			int j = 0;
-			while(query[i][j] == ' ') {
-				j += 2;
-			}
-			int depth = (j / 2) - call_depth;
-			if(depth == 1) {
-				other_depth_one_start = i;
-			}
-		}
-		// these shoudl be split up and run on different threads
+	if(node.is_double_input()) {
 		blazing_frame left_frame;
-		left_frame = evaluate_split_query(input_loaders,
-			schemas,
-			table_names,
-			std::vector<std::string>(query.begin() + 1, query.begin() + other_depth_one_start),
-			queryContext,
-			call_depth + 1);
-
 		blazing_frame right_frame;
-		right_frame = evaluate_split_query(input_loaders,
-			schemas,
-			table_names,
-			std::vector<std::string>(query.begin() + other_depth_one_start, query.end()),
-			queryContext,
-			call_depth + 1);
+		evaluate_inputs(node, scan, queryContext, left_frame, right_frame);
+
+		CodeTimer blazing_timer;  // created after evaluating the inputs to not include them
+		int numLeft = left_frame.get_num_rows_in_table(0);
+		int numRight = right_frame.get_num_rows_in_table(0);
+		std::string extraInfo =
+			"left_side_num_rows:" + std::to_string(numLeft) + ":right_side_num_rows:" + std::to_string(numRight);
 
 		blazing_frame result_frame;
-		if(ral::operators::is_join(query[0])) {
-			blazing_timer.reset();  // doing a reset before to not include other calls to evaluate_split_query
+		if(node.type == relational_node_type::JOIN) {
 			// we know that left and right are dataframes we want to join together
-			int numLeft = left_frame.get_num_rows_in_table(0);
-			int numRight = right_frame.get_num_rows_in_table(0);
 			left_frame.add_table(right_frame.get_table(0));
-			///left_frame.consolidate_tables();
-			std::string new_join_statement, filter_statement;
-			split_inequality_join_into_join_and_filter(query[0], new_join_statement, filter_statement);
-			result_frame = ral::operators::process_join(queryContext, left_frame, new_join_statement);
-			std::string extraInfo = "left_side_num_rows:" + std::to_string(numLeft) + ":right_side_num_rows:" + std::to_string(numRight);
-			Library::Logging::Logger().logInfo(blazing_timer.logDuration(*queryContext, "evaluate_split_query process_join", "num rows result", result_frame.get_num_rows_in_table(0), extraInfo));
+			result_frame = ral::operators::process_join(queryContext, left_frame, node.join_statement);
+			Library::Logging::Logger().logInfo(blazing_timer.logDuration(*queryContext,
+				"evaluate_split_query process_join",
+				"num rows result",
+				result_frame.get_num_rows_in_table(0),
+				extraInfo));
 			blazing_timer.reset();
 			queryContext->incrementQueryStep();
-			if (filter_statement != ""){
-				process_filter(queryContext, result_frame,filter_statement);
-				Library::Logging::Logger().logInfo(blazing_timer.logDuration(*queryContext, "evaluate_split_query inequality join process_filter", "num rows", result_frame.get_num_rows_in_table(0)));
-				blazing_timer.reset();
+			if(node.condition != "") {
+				process_filter(queryContext, result_frame, node.condition);
+				Library::Logging::Logger().logInfo(blazing_timer.logDuration(*queryContext,
+					"evaluate_split_query inequality join process_filter",
+					"num rows",
+					result_frame.get_num_rows_in_table(0)));
 				queryContext->incrementQueryStep();
 			}
-			return result_frame;
-		} else if(is_union(query[0])) {
-			blazing_timer.reset();  // doing a reset before to not include other calls to evaluate_split_query
-			// TODO: append the frames to each other
-			// return right_frame;//!!
-			int numLeft = left_frame.get_num_rows_in_table(0);
-			int numRight = right_frame.get_num_rows_in_table(0);
-			result_frame = process_union(left_frame, right_frame, query[0]);
-			std::string extraInfo =
-				"left_side_num_rows:" + std::to_string(numLeft) + ":right_side_num_rows:" + std::to_string(numRight);
+		} else {
+			result_frame = process_union(left_frame, right_frame, node.union_all);
 			Library::Logging::Logger().logInfo(blazing_timer.logDuration(*queryContext,
 				"evaluate_split_query process_union",
 				"num rows result",
 				result_frame.get_num_rows_in_table(0),
 				extraInfo));
-			blazing_timer.reset();
 			queryContext->incrementQueryStep();
-			return result_frame;
-		} else {
-			throw std::runtime_error{"In evaluate_split_query function: unsupported query operator"};
 		}
+		return result_frame;
+	}
 
-	} else {
-		// process child
-		blazing_frame child_frame = evaluate_split_query(input_loaders,
-			schemas,
-			table_names,
-			std::vector<std::string>(query.begin() + 1, query.end()),
-			queryContext,
-			call_depth + 1);
-		// process self
-		if(is_project(query[0])) {
-			blazing_timer.reset();  // doing a reset before to not include other calls to evaluate_split_query
-			execute_project_plan(child_frame, query[0]);
-			Library::Logging::Logger().logInfo(blazing_timer.logDuration(*queryContext,
-				"evaluate_split_query process_project",
-				"num rows",
-				child_frame.get_num_rows_in_table(0)));
-			blazing_timer.reset();
-			queryContext->incrementQueryStep();
-			return child_frame;
-		} else if(ral::operators::is_aggregate(query[0])) {
-			blazing_timer.reset();  // doing a reset before to not include other calls to evaluate_split_query
-			ral::operators::process_aggregate(child_frame, query[0], queryContext);
-			Library::Logging::Logger().logInfo(blazing_timer.logDuration(*queryContext,
-				"evaluate_split_query process_aggregate",
-				"num rows",
-				child_frame.get_num_rows_in_table(0)));
-			blazing_timer.reset();
-			queryContext->incrementQueryStep();
-			return child_frame;
-		} else if(ral::operators::is_sort(query[0])) {
-			blazing_timer.reset();  // doing a reset before to not include other calls to evaluate_split_query
-			ral::operators::process_sort(child_frame, query[0], queryContext);
-			Library::Logging::Logger().logInfo(blazing_timer.logDuration(
-				*queryContext, "evaluate_split_query process_sort", "num rows", child_frame.get_num_rows_in_table(0)));
-			blazing_timer.reset();
-			queryContext->incrementQueryStep();
-			return child_frame;
-		} else if(is_filter(query[0])) {
-			blazing_timer.reset();  // doing a reset before to not include other calls to evaluate_split_query
-			process_filter(queryContext, child_frame, query[0]);
+	// process child
+	blazing_frame child_frame = evaluate_relational_node(*node.children[0], scan, queryContext);
+
+	// process self
+	CodeTimer blazing_timer;  // created after evaluating the child to not include it
+	std::string event_description;
+	switch(node.type) {
+	case relational_node_type::PROJECT:
+		execute_project_plan(child_frame, node.expression_names, node.expressions);
+		event_description = "evaluate_split_query process_project";
+		break;
+	case relational_node_type::AGGREGATE:
+		ral::operators::process_aggregate(child_frame, node.aggregate, queryContext);
+		event_description = "evaluate_split_query process_aggregate";
+		break;
+	case relational_node_type::SORT:
+		ral::operators::process_sort(child_frame, node.sort, queryContext);
+		event_description = "evaluate_split_query process_sort";
+		break;
+	case relational_node_type::FILTER:
+		process_filter(queryContext, child_frame, node.condition);
+		event_description = "evaluate_split_query process_filter";
+		break;
+	default: throw std::runtime_error{"In evaluate_split_query function: unsupported query operator"};
+	}
+	Library::Logging::Logger().logInfo(
+		blazing_timer.logDuration(*queryContext, event_description, "num rows", child_frame.get_num_rows_in_table(0)));
+	queryContext->incrementQueryStep();
+	return child_frame;
+}
+
+// Returns the tables used by the scans of the plan, the data is already in memory
+scan_function make_table_scan(
+	const std::vector<std::vector<gdf_column_cpp>> & input_tables, const std::vector<std::string> & table_names) {
+	return [&input_tables, &table_names](const relational_node & node, Context * queryContext) {
+		blazing_frame scan_frame;
+		// EnumerableTableScan(table=[[hr, joiner]])
+		scan_frame.add_table(input_tables[get_table_index(table_names, node.table_name)]);
+		return scan_frame;
+	};
+}
+
+// Loads the data used by the scans of the plan, bindable scans only load their projected columns and apply their
+// filters right after loading
+scan_function make_loader_scan(std::vector<ral::io::data_loader> & input_loaders,
+	const std::vector<ral::io::Schema> & schemas,
+	const std::vector<std::string> & table_names) {
+	return [&input_loaders, &schemas, &table_names](const relational_node & node, Context * queryContext) {
+		CodeTimer blazing_timer;
+
+		blazing_frame scan_frame;
+		std::vector<gdf_column_cpp> input_table;
+
+		size_t table_index = get_table_index(table_names, node.table_name);
+		input_loaders[table_index].load_data(
+			*queryContext, input_table, node.projections, schemas[table_index], node.condition);
+
+		// Setting the aliases only when is not an empty set
+		for(size_t col_idx = 0; col_idx < node.aliases.size(); col_idx++) {
+			// TODO: Rommel, this check is needed when for example the scan has not projects but there are extra
+			// aliases
+			if(col_idx < input_table.size()) {
+				input_table[col_idx].set_name_cpp_only(node.aliases[col_idx]);
+			}
+		}
+		int num_rows = input_table.size() > 0 ? input_table[0].size() : 0;
+		Library::Logging::Logger().logInfo(
+			blazing_timer.logDuration(*queryContext, "evaluate_split_query load_data", "num rows", num_rows));
+		blazing_timer.reset();
+
+		scan_frame.add_table(input_table);
+		if(node.condition != "") {
+			process_filter(queryContext, scan_frame, node.condition);
 			Library::Logging::Logger().logInfo(blazing_timer.logDuration(*queryContext,
 				"evaluate_split_query process_filter",
 				"num rows",
-				child_frame.get_num_rows_in_table(0)));
-			blazing_timer.reset();
-			queryContext->incrementQueryStep();
-			return child_frame;
-		} else {
-			throw std::runtime_error{"In evaluate_split_query function: unsupported query operator"};
+				scan_frame.get_num_rows_in_table(0)));
 		}
-		// return frame
-	}
+		return scan_frame;
+	};
+}
+
+}  // namespace
+
+// TODO: if a table needs to be used more than once you need to include it twice
+// i know that kind of sucks, its for the 0 copy stuff, this can easily be remedied
+// by changings scan to make copies
+blazing_frame evaluate_split_query(std::vector<std::vector<gdf_column_cpp>> input_tables,
+	std::vector<std::string> table_names,
+	std::vector<std::vector<std::string>> column_names,
+	std::vector<std::string> query,
+	Context * queryContext,
+	int call_depth) {
+	assert(input_tables.size() == table_names.size());
+
+	std::unique_ptr<relational_node> plan = ral::parser::parse_relational_plan(StringUtil::join(query, "\n"));
+	return evaluate_relational_node(*plan, make_table_scan(input_tables, table_names), queryContext);
 }
 
 query_token_t evaluate_query(std::vector<ral::io::data_loader> input_loaders,
@@ -893,14 +713,12 @@ query_token_t evaluate_query(std::vector<ral::io::data_loader> input_loaders,
 	std::thread t([=] {
 		CodeTimer blazing_timer;
 
-		std::vector<std::string> splitted = StringUtil::split(logicalPlan, "\n");
-		if(splitted[splitted.size() - 1].length() == 0) {
-			splitted.erase(splitted.end() - 1);
-		}
-
 		try {
 			Context context = queryContext;
-			blazing_frame output_frame = evaluate_split_query(input_loaders, schemas, table_names, splitted, &context);
+			std::vector<ral::io::data_loader> loaders = input_loaders;
+			std::shared_ptr<const relational_node> plan = ral::parser::plan_cache::getInstance().get_plan(logicalPlan);
+			blazing_frame output_frame =
+				evaluate_relational_node(*plan, make_loader_scan(loaders, schemas, table_names), &context);
 
 			// REMOVE any columns that were ipcd to put into the result set
 			for(size_t index = 0; index < output_frame.get_size_column(); index++) {
@@ -949,13 +767,9 @@ blazing_frame evaluate_query(
 
 		Library::Logging::Logger().logInfo(blazing_timer.logDuration(queryContext, "\"Query Start\n" + logicalPlan + "\""));
 
-		std::vector<std::string> splitted = StringUtil::split(logicalPlan, "\n");
-		if (splitted[splitted.size() - 1].length() == 0) {
-			splitted.erase(splitted.end() -1);
-		}
-
 		try {
-			blazing_frame output_frame = evaluate_split_query(input_loaders, schemas,table_names, splitted, &queryContext);
+			std::shared_ptr<const relational_node> plan = ral::parser::plan_cache::getInstance().get_plan(logicalPlan);
+			blazing_frame output_frame = evaluate_relational_node(*plan, make_loader_scan(input_loaders, schemas, table_names), &queryContext);
 			output_frame.deduplicate();
 			for (size_t i=0;i<output_frame.get_width();i++) {
 				if (output_frame.get_column(i).dtype() == GDF_STRING_CATEGORY) {
@@ -1003,7 +817,7 @@ void getTableScanInfo(std::string & logicalPlan_in,
 		if (is_scan(step)) {
 			relational_algebra_steps_out.push_back(step);
 
-			std::string table_name = extract_table_name(step);
+			std::string table_name = ral::parser::extract_table_name(step);
 			if(StringUtil::beginsWith(table_name, "main.")) {
 				table_name = table_name.substr(5);
 			}
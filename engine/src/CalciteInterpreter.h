@@ -43,8 +43,16 @@ std::string get_named_expression(std::string query_part, std::string expression_
 
 void execute_project_plan(blazing_frame & input, std::string query_part);
 
+void execute_project_plan(
+	blazing_frame & input, const std::vector<std::string> & names, const std::vector<std::string> & expressions);
+
+void execute_project_plan(blazing_frame & input, project_plan_params params);
+
 project_plan_params parse_project_plan(blazing_frame & input, std::string query_part);
 
+project_plan_params parse_project_plan(
+	blazing_frame & input, const std::vector<std::string> & names, const std::vector<std::string> & expressions);
+
 void process_project(blazing_frame & input, std::string query_part);
 
 blazing_frame evaluate_query(std::vector<ral::io::data_loader> input_loaders,
@@ -13,7 +13,7 @@ struct SampleToNodeMasterMessage : GPUComponentMessage {
 		const uint32_t & context_token,
 		std::shared_ptr<Node> & sender_node,
 		std::vector<gdf_column_cpp> & samples,
-		int total_row_size)
+		std::uint64_t total_row_size)
 		: GPUComponentMessage(message_token, context_token, sender_node, samples, total_row_size) {}
 
 	DefineClassName(SampleToNodeMasterMessage);
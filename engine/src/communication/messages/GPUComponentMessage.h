@@ -25,7 +25,20 @@ using Node = blazingdb::transport::Node;
 using Address = blazingdb::transport::Address;
 using ColumnTransport = blazingdb::transport::ColumnTransport;
 using GPUMessage = blazingdb::transport::GPUMessage;
-using StrDataPtrTuple = std::tuple<char *, gdf_size_type, int *, gdf_size_type, unsigned char *, gdf_size_type>;
+
+/**
+ * The dictionary of a string category column on the wire: the keys of its NVCategory as chars, offsets and null mask.
+ * The rows are sent as their int32 codes into the keys.
+ */
+struct DictionaryBuffers {
+	char * chars;
+	int64_t chars_size;
+	int * offsets;
+	int64_t offsets_size;
+	unsigned char * null_mask;
+	int64_t null_mask_size;
+	int64_t keys_count;
+};
 
 inline bool isGdfString(const gdf_column * column) {
 	return GDF_STRING == column->dtype || GDF_STRING_CATEGORY == column->dtype;
@@ -47,78 +60,77 @@ public:
 	}
 
 	~GPUComponentMessage() {
-		for(auto && e : strDataColToPtrMap) {
-			char * stringsPointer;
-			int * offsetsPointer;
-			unsigned char * nullBitmask;
-			std::tie(stringsPointer, std::ignore, offsetsPointer, std::ignore, nullBitmask, std::ignore) = e.second;
-			RMM_TRY(RMM_FREE(stringsPointer, 0));
-			RMM_TRY(RMM_FREE(offsetsPointer, 0));
-			RMM_TRY(RMM_FREE(nullBitmask, 0));
+		for(auto && e : dictionaries) {
+			RMM_TRY(RMM_FREE(e.second.chars, 0));
+			RMM_TRY(RMM_FREE(e.second.offsets, 0));
+			RMM_TRY(RMM_FREE(e.second.null_mask, 0));
+		}
+		for(NVCategory * category : compacted_categories) {
+			NVCategory::destroy(category);
 		}
 	}
 
-	auto get_raw_pointers(gdf_column * column) {
-		std::lock_guard<std::mutex> lock(strigDataMutex);
-
-		auto strDataTupleIt = strDataColToPtrMap.find(column);
-		if(strDataTupleIt != strDataColToPtrMap.end()) {
-			return strDataTupleIt->second;
+	DictionaryBuffers get_dictionary(NVCategory * category) {
+		auto dictionaryIt = dictionaries.find(category);
+		if(dictionaryIt != dictionaries.end()) {
+			return dictionaryIt->second;
 		}
 
-		bool deleteCategory = false;
-		void * category_ptr = column->dtype_info.category;
-		if(!category_ptr) {
-			category_ptr = NVCategory::create_from_array(nullptr, 0);
-			deleteCategory = true;
-		}
-		auto size = column->size;
-		auto null_count = column->null_count;
-		std::string output;
-		NVCategory * category = static_cast<NVCategory *>(category_ptr);
-		NVStrings * nvStrings_ = category->gather_strings(category->values_cptr(), category->size(), true);
-		gdf_size_type stringsLength_ = nvStrings_->size();
-		auto offsetsLength_ = stringsLength_ + 1;
-
-		int * const lengthPerStrings = new int[stringsLength_];
-		nvStrings_->byte_count(lengthPerStrings, false);
-		gdf_size_type stringsSize_ =
-			std::accumulate(lengthPerStrings,
-				lengthPerStrings + stringsLength_,
-				0,
-				[](int accumulator, int currentValue) { return accumulator + std::max(currentValue, 0); }) *
-			sizeof(char);
-		char * stringsPointer_ = nullptr;
-		gdf_size_type offsetsSize_ = offsetsLength_ * sizeof(int);
-		int * offsetsPointer_ = nullptr;
-		RMM_TRY(RMM_ALLOC(reinterpret_cast<void **>(&stringsPointer_), stringsSize_, 0));
-		RMM_TRY(RMM_ALLOC(reinterpret_cast<void **>(&offsetsPointer_), offsetsSize_, 0));
-
-		gdf_size_type nullMaskSize_ = 0;
-		unsigned char * nullBitmask_ = nullptr;
-		if(null_count > 0) {
-			nullMaskSize_ = ral::traits::get_bitmask_size_in_bytes(stringsLength_);
-			RMM_TRY(RMM_ALLOC(reinterpret_cast<void **>(&nullBitmask_), nullMaskSize_, 0));
-		}
-		nvStrings_->create_offsets(stringsPointer_, offsetsPointer_, nullBitmask_, true);
+		NVStrings * keys = category->get_keys();
+		gdf_size_type keysCount = keys->size();
+		std::vector<int> lengthPerStrings(keysCount);
+		keys->byte_count(lengthPerStrings.data(), false);
+		int64_t charsSize = std::accumulate(lengthPerStrings.begin(),
+			lengthPerStrings.end(),
+			int64_t{0},
+			[](int64_t accumulator, int currentValue) { return accumulator + std::max(currentValue, 0); });
 
-		delete[] lengthPerStrings;
-		NVStrings::destroy(nvStrings_);
-		if(deleteCategory) {
-			NVCategory::destroy(category);
+		DictionaryBuffers dictionary{};
+		dictionary.keys_count = keysCount;
+		dictionary.chars_size = charsSize;
+		dictionary.offsets_size = (int64_t{keysCount} + 1) * sizeof(int);
+		RMM_TRY(RMM_ALLOC(reinterpret_cast<void **>(&dictionary.chars), dictionary.chars_size, 0));
+		RMM_TRY(RMM_ALLOC(reinterpret_cast<void **>(&dictionary.offsets), dictionary.offsets_size, 0));
+		if(category->has_nulls()) {
+			dictionary.null_mask_size = ral::traits::get_bitmask_size_in_bytes(keysCount);
+			RMM_TRY(RMM_ALLOC(reinterpret_cast<void **>(&dictionary.null_mask), dictionary.null_mask_size, 0));
 		}
+		keys->create_offsets(dictionary.chars, dictionary.offsets, dictionary.null_mask, true);
+		NVStrings::destroy(keys);
 
-		auto strDataTuple =
-			std::make_tuple(stringsPointer_, stringsSize_, offsetsPointer_, offsetsSize_, nullBitmask_, nullMaskSize_);
-		strDataColToPtrMap[column] = strDataTuple;
+		dictionaries[category] = dictionary;
+		return dictionary;
+	}
+
+	// The category and codes sent for a string category column. A category with more keys than the column has rows,
+	// like the one shared by the partitions of a column, is compacted to the keys the column uses, once per column.
+	std::pair<NVCategory *, int *> get_encoded_strings(gdf_column * column) {
+		auto encodedIt = encoded_strings.find(column);
+		if(encodedIt != encoded_strings.end()) {
+			return encodedIt->second;
+		}
 
-		return strDataTuple;
+		NVCategory * category = static_cast<NVCategory *>(column->dtype_info.category);
+		int * codes = static_cast<int *>(column->data);
+		if(category == nullptr || column->size == 0) {
+			category = NVCategory::create_from_array(nullptr, 0);
+			compacted_categories.push_back(category);
+			codes = nullptr;
+		} else if(category->keys_size() > static_cast<unsigned int>(column->size)) {
+			category = category->gather_and_remap(codes, column->size);
+			compacted_categories.push_back(category);
+			codes = const_cast<int *>(category->values_cptr());
+		}
+		encoded_strings[column] = std::make_pair(category, codes);
+		return encoded_strings[column];
 	}
 
 	virtual raw_buffer GetRawColumns() override {
-		std::vector<int> buffer_sizes;
+		std::vector<int64_t> buffer_sizes;
 		std::vector<char *> raw_buffers;
 		std::vector<ColumnTransport> column_offset;
+		// position of the first buffer of the keys of each category
+		std::map<NVCategory *, int> keys_positions;
 		for(int i = 0; i < samples.size(); ++i) {
 			auto * column = samples[i].get_gdf_column();
 			ColumnTransport col_transport = ColumnTransport{ColumnTransport::MetaData{
@@ -135,27 +147,38 @@ public:
 				.strings_nullmask = -1};
 			strcpy(col_transport.metadata.col_name, column->col_name);
 			if(isGdfString(column)) {
-				char * stringsPointer;
-				gdf_size_type stringsSize;
-				int * offsetsPointer;
-				gdf_size_type offsetsSize;
-				unsigned char * nullBitmask;
-				gdf_size_type nullMaskSize;
-				std::tie(stringsPointer, stringsSize, offsetsPointer, offsetsSize, nullBitmask, nullMaskSize) =
-					get_raw_pointers(column);
-
-				col_transport.strings_data = raw_buffers.size();
-				buffer_sizes.push_back(stringsSize);
-				raw_buffers.push_back((char *) stringsPointer);
-
-				col_transport.strings_offsets = raw_buffers.size();
-				buffer_sizes.push_back(offsetsSize);
-				raw_buffers.push_back((char *) offsetsPointer);
-
-				if(nullBitmask != nullptr) {
-					col_transport.strings_nullmask = raw_buffers.size();
-					buffer_sizes.push_back(nullMaskSize);
-					raw_buffers.push_back((char *) nullBitmask);
+				std::lock_guard<std::mutex> lock(dictionariesMutex);
+				NVCategory * category;
+				int * codes;
+				std::tie(category, codes) = get_encoded_strings(column);
+
+				col_transport.data = raw_buffers.size();
+				buffer_sizes.push_back(codes != nullptr ? int64_t{column->size} * sizeof(int) : 0);
+				raw_buffers.push_back((char *) codes);
+
+				DictionaryBuffers dictionary = get_dictionary(category);
+				col_transport.metadata.dictionary_size = dictionary.keys_count;
+				// the columns that share a category share its keys
+				auto keysPositionIt = keys_positions.find(category);
+				if(keysPositionIt != keys_positions.end()) {
+					col_transport.strings_data = keysPositionIt->second;
+					col_transport.strings_offsets = keysPositionIt->second + 1;
+					col_transport.strings_nullmask = dictionary.null_mask != nullptr ? keysPositionIt->second + 2 : -1;
+				} else {
+					keys_positions[category] = raw_buffers.size();
+					col_transport.strings_data = raw_buffers.size();
+					buffer_sizes.push_back(dictionary.chars_size);
+					raw_buffers.push_back(dictionary.chars);
+
+					col_transport.strings_offsets = raw_buffers.size();
+					buffer_sizes.push_back(dictionary.offsets_size);
+					raw_buffers.push_back((char *) dictionary.offsets);
+
+					if(dictionary.null_mask != nullptr) {
+						col_transport.strings_nullmask = raw_buffers.size();
+						buffer_sizes.push_back(dictionary.null_mask_size);
+						raw_buffers.push_back((char *) dictionary.null_mask);
+					}
 				}
 			} else if(column->valid and column->null_count > 0) {
 				// case: valid
@@ -184,35 +207,40 @@ public:
 			Address::TCP(address_metadata.ip, address_metadata.comunication_port, address_metadata.protocol_port));
 		auto num_columns = columns_offsets.size();
 		std::vector<gdf_column_cpp> received_samples(num_columns);
+		// the keys of the string category columns, by the position of their chars
+		std::map<int, NVCategory *> received_keys;
 		assert(raw_buffers.size() >= 0);
 		for(size_t i = 0; i < num_columns; ++i) {
 			auto column = new gdf_column{};
 			auto data_offset = columns_offsets[i].data;
 			auto string_offset = columns_offsets[i].strings_data;
 			if(string_offset != -1) {
-				// this is a string
-				// NVCategory *nvcategory_ptr = nullptr;
-				// auto string_offset = columns_offsets[i].strings_data;
-				// nvcategory_ptr = (NVCategory *) raw_buffers[string_offset];
-				char * stringsPointer = (char *) raw_buffers[columns_offsets[i].strings_data];
-				int * offsetsPointer = (int *) raw_buffers[columns_offsets[i].strings_offsets];
-				unsigned char * nullMaskPointer = nullptr;
-				if(columns_offsets[i].strings_nullmask != -1) {
-					nullMaskPointer = (unsigned char *) raw_buffers[columns_offsets[i].strings_nullmask];
+				// a string category column, its keys can be shared with other columns of the message
+				NVCategory *& keys = received_keys[string_offset];
+				if(keys == nullptr) {
+					unsigned char * nullMaskPointer = nullptr;
+					if(columns_offsets[i].strings_nullmask != -1) {
+						nullMaskPointer = (unsigned char *) raw_buffers[columns_offsets[i].strings_nullmask];
+					}
+					keys = NVCategory::create_from_offsets(raw_buffers[string_offset],
+						columns_offsets[i].metadata.dictionary_size,
+						reinterpret_cast<const int *>(raw_buffers[columns_offsets[i].strings_offsets]),
+						reinterpret_cast<const unsigned char *>(nullMaskPointer),
+						nullMaskPointer != nullptr ? 1 : 0,
+						true);
+					RMM_TRY(RMM_FREE(raw_buffers[string_offset], 0));
+					RMM_TRY(RMM_FREE(raw_buffers[columns_offsets[i].strings_offsets], 0));
+					RMM_TRY(RMM_FREE(nullMaskPointer, 0));
 				}
 
-				auto nvcategory_ptr = NVCategory::create_from_offsets(reinterpret_cast<const char *>(stringsPointer),
-					columns_offsets[i].metadata.size,
-					reinterpret_cast<const int *>(offsetsPointer),
-					reinterpret_cast<const unsigned char *>(nullMaskPointer),
-					columns_offsets[i].metadata.null_count,
-					true);
+				auto num_rows = columns_offsets[i].metadata.size;
+				int * codes = (int *) raw_buffers[data_offset];
+				NVCategory * nvcategory_ptr =
+					num_rows > 0 && keys->keys_size() > 0 ? keys->gather(codes, num_rows)
+												  : NVCategory::create_from_array(nullptr, 0);
 				received_samples[i].create_gdf_column(
-					nvcategory_ptr, columns_offsets[i].metadata.size, (char *) columns_offsets[i].metadata.col_name);
-
-				RMM_TRY(RMM_FREE(stringsPointer, 0));
-				RMM_TRY(RMM_FREE(offsetsPointer, 0));
-				RMM_TRY(RMM_FREE(nullMaskPointer, 0));
+					nvcategory_ptr, nvcategory_ptr->size(), (char *) columns_offsets[i].metadata.col_name);
+				RMM_TRY(RMM_FREE(codes, 0));
 			} else {
 				gdf_valid_type * valid_ptr = nullptr;
 				if(columns_offsets[i].valid != -1) {
@@ -233,20 +261,33 @@ public:
 			}
 			received_samples[i].set_name(std::string{columns_offsets[i].metadata.col_name});
 		}
-		return std::make_shared<GPUComponentMessage>(message_metadata.messageToken,
+		for(auto && e : received_keys) {
+			NVCategory::destroy(e.second);
+		}
+		auto message = std::make_shared<GPUComponentMessage>(message_metadata.messageToken,
 			message_metadata.contextToken,
 			node,
 			received_samples,
 			message_metadata.total_row_size);
+		message->metadata().partition_chunk = message_metadata.partition_chunk;
+		message->metadata().partition_chunks = message_metadata.partition_chunks;
+		return message;
 	}
 	std::vector<gdf_column_cpp> getSamples() { return samples; }
 
 protected:
 	std::vector<gdf_column_cpp> samples;
 
-	std::map<gdf_column *, StrDataPtrTuple> strDataColToPtrMap;
+	// the dictionaries of the categories sent, a message can be sent to several nodes at the same time
+	std::map<NVCategory *, DictionaryBuffers> dictionaries;
+
+	// categories created for the message
+	std::vector<NVCategory *> compacted_categories;
+
+	// the category and codes sent for each string category column
+	std::map<const gdf_column *, std::pair<NVCategory *, int *>> encoded_strings;
 
-	std::mutex strigDataMutex;
+	std::mutex dictionariesMutex;
 };
 
 }  // namespace messages
@@ -19,6 +19,9 @@ public:
 public:
 	static Status send(const Node & node, GPUMessage & message);
 
+	// Waits for the credits of the receiver first, for the partitions of a shuffle
+	static Status sendWithCredits(const Node & node, GPUMessage & message);
+
 	static Status sendNodeData(std::string ip, int16_t port, Message & message);
 
 	static void closeConnections();
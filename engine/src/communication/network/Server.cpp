@@ -1,6 +1,7 @@
 #include "communication/network/Server.h"
 #include "communication/messages/ComponentMessages.h"
 #include "communication/messages/GPUComponentMessage.h"
+#include "config/BlazingConfig.h"
 #include "config/GPUManager.cuh"
 
 namespace ral {
@@ -28,6 +29,8 @@ Server & Server::getInstance() { return *servers_[port_]; }
 Server::Server() {
 	comm_server = CommServer::TCP(port_);
 	setEndPoints();
+	comm_server->setReceiveCreditLimit(ral::config::BlazingConfig::getInstance().getReceiveCreditLimit());
+	comm_server->setReceiveTotalCreditLimit(ral::config::BlazingConfig::getInstance().getReceiveTotalCreditLimit());
 	comm_server->Run();
 }
 
@@ -37,6 +40,8 @@ void Server::registerContext(const ContextToken context_token) { comm_server->re
 
 void Server::deregisterContext(const ContextToken context_token) { comm_server->deregisterContext(context_token); }
 
+void Server::setReceiveCreditLimit(int64_t limit) { comm_server->setReceiveCreditLimit(limit); }
+
 std::shared_ptr<GPUMessage> Server::getMessage(
 	const ContextToken & token_value, const MessageTokenType & messageToken) {
 	return comm_server->getMessage(token_value, messageToken);
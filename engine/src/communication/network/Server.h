@@ -31,6 +31,9 @@ public:
 	void registerContext(const ContextToken context_token);
 	void deregisterContext(const ContextToken context_token);
 
+	// Bytes of the partitions of each context and node that are received and not merged yet
+	void setReceiveCreditLimit(int64_t limit);
+
 public:
 	std::shared_ptr<GPUMessage> getMessage(const ContextToken & token_value, const MessageTokenType & messageToken);
 
@@ -29,5 +29,68 @@ BlazingConfig & BlazingConfig::setSocketPath(const std::string & value) {
 	return *this;
 }
 
+size_t BlazingConfig::getExecutorThreads() const { return executor_threads; }
+
+BlazingConfig & BlazingConfig::setExecutorThreads(size_t value) {
+	executor_threads = value;
+	return *this;
+}
+
+double BlazingConfig::getExecutorMemoryReserve() const { return executor_memory_reserve; }
+
+BlazingConfig & BlazingConfig::setExecutorMemoryReserve(double value) {
+	executor_memory_reserve = value;
+	return *this;
+}
+
+size_t BlazingConfig::getPlanCacheSize() const { return plan_cache_size; }
+
+BlazingConfig & BlazingConfig::setPlanCacheSize(size_t value) {
+	plan_cache_size = value;
+	return *this;
+}
+
+size_t BlazingConfig::getDataLoaderThreads() const { return data_loader_threads; }
+
+BlazingConfig & BlazingConfig::setDataLoaderThreads(size_t value) {
+	data_loader_threads = value;
+	return *this;
+}
+
+size_t BlazingConfig::getMetadataCacheSize() const { return metadata_cache_size; }
+
+BlazingConfig & BlazingConfig::setMetadataCacheSize(size_t value) {
+	metadata_cache_size = value;
+	return *this;
+}
+
+size_t BlazingConfig::getPartitionChunkSize() const { return partition_chunk_size; }
+
+BlazingConfig & BlazingConfig::setPartitionChunkSize(size_t value) {
+	partition_chunk_size = value;
+	return *this;
+}
+
+int64_t BlazingConfig::getReceiveCreditLimit() const { return receive_credit_limit; }
+
+BlazingConfig & BlazingConfig::setReceiveCreditLimit(int64_t value) {
+	receive_credit_limit = value;
+	return *this;
+}
+
+int64_t BlazingConfig::getReceiveTotalCreditLimit() const { return receive_total_credit_limit; }
+
+BlazingConfig & BlazingConfig::setReceiveTotalCreditLimit(int64_t value) {
+	receive_total_credit_limit = value;
+	return *this;
+}
+
+bool BlazingConfig::getGroupByRangePartitioning() const { return group_by_range_partitioning; }
+
+BlazingConfig & BlazingConfig::setGroupByRangePartitioning(bool value) {
+	group_by_range_partitioning = value;
+	return *this;
+}
+
 }  // namespace config
 }  // namespace ral
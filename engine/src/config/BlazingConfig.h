@@ -1,6 +1,7 @@
 #ifndef RAL_CONFIG_BLAZINGCONFIG_H
 #define RAL_CONFIG_BLAZINGCONFIG_H
 
+#include <cstdint>
 #include <string>
 
 namespace ral {
@@ -27,6 +28,50 @@ public:
 
 	BlazingConfig & setSocketPath(const std::string & value);
 
+public:
+	size_t getExecutorThreads() const;
+
+	BlazingConfig & setExecutorThreads(size_t value);
+
+	double getExecutorMemoryReserve() const;
+
+	BlazingConfig & setExecutorMemoryReserve(double value);
+
+public:
+	size_t getPlanCacheSize() const;
+
+	BlazingConfig & setPlanCacheSize(size_t value);
+
+public:
+	size_t getDataLoaderThreads() const;
+
+	BlazingConfig & setDataLoaderThreads(size_t value);
+
+public:
+	size_t getMetadataCacheSize() const;
+
+	BlazingConfig & setMetadataCacheSize(size_t value);
+
+public:
+	size_t getPartitionChunkSize() const;
+
+	BlazingConfig & setPartitionChunkSize(size_t value);
+
+public:
+	int64_t getReceiveCreditLimit() const;
+
+	BlazingConfig & setReceiveCreditLimit(int64_t value);
+
+public:
+	int64_t getReceiveTotalCreditLimit() const;
+
+	BlazingConfig & setReceiveTotalCreditLimit(int64_t value);
+
+public:
+	bool getGroupByRangePartitioning() const;
+
+	BlazingConfig & setGroupByRangePartitioning(bool value);
+
 private:
 	BlazingConfig();
 
@@ -41,6 +86,20 @@ private:
 private:
 	std::string log_name{};
 	std::string socket_path{};
+	size_t executor_threads{4};
+	double executor_memory_reserve{0.2};
+	size_t plan_cache_size{256};
+	size_t data_loader_threads{4};
+	size_t metadata_cache_size{256 * 1024 * 1024};
+	size_t partition_chunk_size{256 * 1024 * 1024};
+	// bytes of the partitions of each query and sending node waiting to be merged, so a node holds up to this many
+	// bytes per node of the cluster and query. 0 or less does not limit them
+	int64_t receive_credit_limit{1024 * 1024 * 1024};
+	// bytes of the partitions of all the queries and sending nodes waiting to be merged, 0 or less leaves only the
+	// limit of each of them
+	int64_t receive_total_credit_limit{int64_t{4} * 1024 * 1024 * 1024};
+	// distributed GROUP BY sends the groups by ranges of sampled pivots instead of by hash, for skewed keys
+	bool group_by_range_partitioning{false};
 };
 
 }  // namespace config
@@ -13,6 +13,7 @@
 #include "../io/data_parser/ParserUtil.h"
 #include "../io/data_provider/DummyProvider.h"
 #include "../io/data_provider/UriDataProvider.h"
+#include "../parser/plan_cache.hpp"
 #include "communication/network/Server.h"
 #include <numeric>
 
@@ -88,7 +89,9 @@ ResultSet runQuery(int32_t masterIndex,
 			types,
 			tableSchema.num_row_groups,
 			time_units,
-			tableSchema.in_file);
+			tableSchema.in_file,
+			tableSchema.num_rows);
+		schema.set_row_group_ids(tableSchema.row_group_ids);
 
 		std::shared_ptr<ral::io::data_parser> parser;
 		if(fileType == ral::io::DataType::PARQUET) {
@@ -167,3 +170,8 @@ TableScanInfo getTableScanInfo(std::string logicalPlan){
 	getTableScanInfo(logicalPlan, relational_algebra_steps, table_names, table_columns);
 	return TableScanInfo{relational_algebra_steps, table_names, table_columns};
 }
+
+PlanCacheInfo getPlanCacheInfo() {
+	ral::parser::plan_cache & cache = ral::parser::plan_cache::getInstance();
+	return PlanCacheInfo{cache.get_hits(), cache.get_misses(), cache.get_size(), cache.get_capacity()};
+}
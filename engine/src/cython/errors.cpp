@@ -30,3 +30,4 @@ RAISE_ERROR(RegisterFileSystemHDFS)
 RAISE_ERROR(RegisterFileSystemGCS)
 RAISE_ERROR(RegisterFileSystemS3)
 RAISE_ERROR(RegisterFileSystemLocal)
+RAISE_ERROR(SetFileCache)
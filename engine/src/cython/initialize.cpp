@@ -13,10 +13,13 @@
 
 #include <algorithm>
 #include <cuda_runtime.h>
+#include <map>
 #include <memory>
+#include <stdexcept>
 #include <thread>
 
 
+#include <blazingdb/transport/io/Compression.h>
 #include <blazingdb/transport/io/reader_writer.h>
 
 
@@ -63,12 +66,48 @@ std::string get_ip(const std::string & iface_name = "eth0") {
 	return the_ip;
 }
 
+blazingdb::transport::io::CompressionMode get_compression_mode(const std::string & name) {
+	using blazingdb::transport::io::CompressionMode;
+	if(name == "none") {
+		return CompressionMode::none;
+	} else if(name == "lz4") {
+		return CompressionMode::lz4;
+	} else if(name == "zstd") {
+		return CompressionMode::zstd;
+	} else if(name == "automatic") {
+		return CompressionMode::automatic;
+	}
+	throw std::runtime_error{"In initialize function: unknown TRANSPORT_COMPRESSION " + name};
+}
+
+// the options of BlazingContext that every node must share, set before the server reads them
+void set_config_options(const std::map<std::string, std::string> & config_options) {
+	auto & config = ral::config::BlazingConfig::getInstance();
+	// the receivers decompress any codec, automatic only compresses the buffers that shrink
+	blazingdb::transport::io::setCompressionMode(blazingdb::transport::io::CompressionMode::automatic);
+	for(const auto & option : config_options) {
+		if(option.first == "RECEIVE_CREDIT_LIMIT") {
+			config.setReceiveCreditLimit(std::stoll(option.second));
+		} else if(option.first == "RECEIVE_TOTAL_CREDIT_LIMIT") {
+			config.setReceiveTotalCreditLimit(std::stoll(option.second));
+		} else if(option.first == "GROUP_BY_RANGE_PARTITIONING") {
+			const std::string & value = option.second;
+			config.setGroupByRangePartitioning(value == "True" || value == "true" || value == "1");
+		} else if(option.first == "TRANSPORT_COMPRESSION") {
+			blazingdb::transport::io::setCompressionMode(get_compression_mode(option.second));
+		} else {
+			throw std::runtime_error{"In initialize function: unknown config option " + option.first};
+		}
+	}
+}
+
 void initialize(int ralId,
 	int gpuId,
 	std::string network_iface_name,
 	std::string ralHost,
 	int ralCommunicationPort,
-	bool singleNode) {
+	bool singleNode,
+	std::map<std::string, std::string> config_options) {
   // ---------------------------------------------------------------------------
   // DISCLAIMER
   // TODO: Support proper locale support for non-US cases (percy)
@@ -76,6 +115,8 @@ void initialize(int ralId,
   std::setlocale(LC_NUMERIC, "en_US.UTF-8");
   // ---------------------------------------------------------------------------
 
+	set_config_options(config_options);
+
 	ralHost = get_ip(network_iface_name);
 
 	std::string loggingName = "RAL." + std::to_string(ralId) + ".log";
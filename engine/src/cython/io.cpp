@@ -10,6 +10,7 @@
 #include "../io/data_provider/UriDataProvider.h"
 
 #include <blazingdb/io/Config/BlazingContext.h>
+#include <blazingdb/io/FileSystem/BlockCache.h>
 #include <blazingdb/io/FileSystem/FileSystemConnection.h>
 #include <blazingdb/io/FileSystem/FileSystemManager.h>
 #include <blazingdb/io/FileSystem/HadoopFileSystem.h>
@@ -73,6 +74,16 @@ TableSchema parseSchema(std::vector<std::string> files,
 	}
 	tableSchema.files = schema.get_files();
 	tableSchema.num_row_groups = schema.get_num_row_groups();
+	tableSchema.num_rows = schema.get_num_rows();
+	for(const std::string & file : tableSchema.files) {
+		size_t file_size = 0;
+		try {
+			file_size = BlazingContext::getInstance()->getFileSystemManager()->getFileStatus(Uri{file}).getFileSize();
+		} catch(const std::exception &) {
+			// the scan is balanced by number of files when the sizes are not known
+		}
+		tableSchema.file_sizes.push_back(file_size);
+	}
 	tableSchema.calcite_to_file_indices = schema.get_calcite_to_file_indices();
 	tableSchema.in_file = schema.get_in_file();
 
@@ -125,3 +136,33 @@ std::pair<bool, std::string> registerFileSystemLocal(std::string root, std::stri
 	FileSystemConnection fileSystemConnection = FileSystemConnection(FileSystemType::LOCAL);
 	return registerFileSystem(fileSystemConnection, root, authority);
 }
+
+std::pair<bool, std::string> setFileCache(std::string directory, long long capacity, long long blockSize) {
+	if(capacity <= 0) {
+		BlockCache::setInstance(nullptr);
+		return std::make_pair(true, "");
+	}
+	BlockCacheOptions options;
+	options.directory = directory;
+	options.capacity = capacity;
+	options.blockSize = blockSize;
+	try {
+		BlockCache::setInstance(std::make_shared<BlockCache>(options));
+	} catch(const std::exception & e) {
+		return std::make_pair(false, std::string(e.what()));
+	}
+	return std::make_pair(true, "");
+}
+
+FileCacheInfo getFileCacheInfo() {
+	std::shared_ptr<BlockCache> cache = BlockCache::getInstance();
+	if(cache == nullptr) {
+		return FileCacheInfo{0, 0, 0, 0, 0, 0};
+	}
+	return FileCacheInfo{cache->getHits(),
+		cache->getMisses(),
+		cache->getEvictions(),
+		cache->getNumBlocks(),
+		cache->getSizeInBytes(),
+		cache->getCapacity()};
+}
@@ -0,0 +1,268 @@
+#include "distribution/collectives.h"
+#include "Traits/RuntimeTraits.h"
+#include "communication/CommunicationData.h"
+#include "communication/factory/MessageFactory.h"
+#include "communication/messages/ComponentMessages.h"
+#include "communication/network/Client.h"
+#include "communication/network/Server.h"
+#include "distribution/Exception.h"
+#include "distribution/primitives.h"
+#include "utilities/CommonOperations.h"
+#include <algorithm>
+#include <blazingdb/transport/io/TransportExecutor.h>
+#include <future>
+#include <memory>
+#include <string>
+
+namespace ral {
+namespace distribution {
+
+namespace collectives {
+
+namespace {
+
+int lowestBit(int rank) { return rank & -rank; }
+
+}  // namespace
+
+int binomialTreeParent(int rank) { return rank == 0 ? -1 : rank - lowestBit(rank); }
+
+std::vector<int> binomialTreeChildren(int rank, int num_nodes) {
+	// the subtree of a node spans the ranks up to its lowest bit, the one of the root spans all the ranks
+	int span = rank == 0 ? num_nodes : lowestBit(rank);
+	std::vector<int> children;
+	for(int distance = 1; distance < span; distance <<= 1) {
+		if(rank + distance < num_nodes) {
+			children.push_back(rank + distance);
+		}
+	}
+	std::reverse(children.begin(), children.end());
+	return children;
+}
+
+int allGatherRounds(int num_nodes) {
+	int rounds = 0;
+	for(int distance = 1; distance < num_nodes; distance <<= 1) {
+		rounds++;
+	}
+	return rounds;
+}
+
+}  // namespace collectives
+
+namespace {
+
+using ral::communication::CommunicationData;
+using ral::communication::messages::ColumnDataMessage;
+using ral::communication::messages::Factory;
+using ral::communication::messages::SampleToNodeMasterMessage;
+using ral::communication::network::Client;
+using ral::communication::network::Server;
+
+std::string getCollectiveMessageId(
+	const std::string & message_class_id, const Context & context, const std::string & name) {
+	return message_class_id + "_" + std::to_string(context.getContextCommunicationToken()) + "_" + name;
+}
+
+int getSelfNodeIndex(const Context & context) {
+	return context.getNodeIndex(CommunicationData::getInstance().getSelfNode());
+}
+
+// The nodes this node forwards the table of root to
+std::vector<std::shared_ptr<Node>> getTreeChildren(const Context & context, int root) {
+	int num_nodes = context.getTotalNodes();
+	int rank = (getSelfNodeIndex(context) - root + num_nodes) % num_nodes;
+	std::vector<std::shared_ptr<Node>> nodes = context.getAllNodes();
+	std::vector<std::shared_ptr<Node>> children;
+	for(int child_rank : collectives::binomialTreeChildren(rank, num_nodes)) {
+		children.push_back(nodes[(child_rank + root) % num_nodes]);
+	}
+	return children;
+}
+
+// The message keeps the root as its sender when it is forwarded, so every node knows whose table it is
+std::future<void> sendChunk(const Context & context,
+	const std::string & message_id,
+	std::shared_ptr<Node> root_node,
+	std::shared_ptr<Node> destination_node,
+	std::vector<gdf_column_cpp> columns,
+	int chunk,
+	int num_chunks) {
+	const uint32_t context_token = context.getContextToken();
+	return blazingdb::transport::io::getTransportExecutor().submitSocket(
+		[message_id, context_token, root_node, destination_node, columns, chunk, num_chunks]() mutable {
+			auto message = Factory::createColumnDataMessage(message_id, context_token, root_node, columns);
+			message->metadata().partition_chunk = chunk;
+			message->metadata().partition_chunks = num_chunks;
+			Client::send(*destination_node, *message);
+		});
+}
+
+void sendTable(const Context & context, std::vector<gdf_column_cpp> & table, std::vector<std::future<void>> & sends) {
+	int self_node_idx = getSelfNodeIndex(context);
+	const std::string message_id =
+		getCollectiveMessageId(ColumnDataMessage::MessageID(), context, "broadcast_" + std::to_string(self_node_idx));
+	auto self_node = CommunicationData::getInstance().getSharedSelfNode();
+
+	std::vector<std::shared_ptr<Node>> children = getTreeChildren(context, self_node_idx);
+	if(children.empty()) {
+		return;
+	}
+	std::vector<std::vector<gdf_column_cpp>> chunks = splitPartitionIntoChunks(table);
+	for(std::size_t i = 0; i < chunks.size(); i++) {
+		for(auto & child : children) {
+			sends.push_back(sendChunk(context, message_id, self_node, child, chunks[i], i, chunks.size()));
+		}
+	}
+}
+
+// Receives the chunks of the table of root from the parent of this node and forwards each one to its children as
+// soon as it arrives. Returns the chunks in order.
+std::vector<std::vector<gdf_column_cpp>> receiveTable(
+	const Context & context, int root, std::vector<std::future<void>> & sends) {
+	const uint32_t context_token = context.getContextToken();
+	const std::string message_id =
+		getCollectiveMessageId(ColumnDataMessage::MessageID(), context, "broadcast_" + std::to_string(root));
+	std::vector<std::shared_ptr<Node>> children = getTreeChildren(context, root);
+
+	std::vector<std::vector<gdf_column_cpp>> chunks;
+	std::size_t num_received = 0;
+	do {
+		auto message = Server::getInstance().getMessage(context_token, message_id);
+		if(message->getMessageTokenValue() != message_id) {
+			throw createMessageMismatchException(__FUNCTION__, message_id, message->getMessageTokenValue());
+		}
+		auto column_message = std::static_pointer_cast<ColumnDataMessage>(message);
+		int chunk = message->metadata().partition_chunk;
+		int num_chunks = message->metadata().partition_chunks;
+		std::vector<gdf_column_cpp> columns = column_message->getColumns();
+		for(auto & child : children) {
+			sends.push_back(
+				sendChunk(context, message_id, message->getSenderNode(), child, columns, chunk, num_chunks));
+		}
+		chunks.resize(num_chunks);
+		chunks[chunk] = std::move(columns);
+		num_received++;
+	} while(num_received < chunks.size());
+	return chunks;
+}
+
+void waitForSends(std::vector<std::future<void>> & sends) {
+	for(std::size_t i = 0; i < sends.size(); i++) {
+		sends[i].get();
+	}
+	sends.clear();
+}
+
+}  // namespace
+
+std::vector<gdf_column_cpp> broadcastTable(const Context & context, int root, std::vector<gdf_column_cpp> & table) {
+	std::vector<std::future<void>> sends;
+	if(getSelfNodeIndex(context) == root) {
+		sendTable(context, table, sends);
+		waitForSends(sends);
+		return table;
+	}
+
+	std::vector<std::vector<gdf_column_cpp>> chunks = receiveTable(context, root, sends);
+	waitForSends(sends);
+	return chunks.size() == 1 ? chunks[0] : ral::utilities::concatTables(chunks);
+}
+
+std::vector<NodeColumns> allGatherTables(
+	const Context & context, std::vector<gdf_column_cpp> & table, const std::vector<gdf_size_type> & nodes_num_rows) {
+	int self_node_idx = getSelfNodeIndex(context);
+	std::vector<std::shared_ptr<Node>> nodes = context.getAllNodes();
+
+	std::vector<std::future<void>> sends;
+	if(nodes_num_rows[self_node_idx] > 0) {
+		sendTable(context, table, sends);
+	}
+	// every node goes through the trees in the same order, so a node never waits for a table its parent has not
+	// started to forward
+	std::vector<NodeColumns> node_columns;
+	for(int root = 0; root < context.getTotalNodes(); root++) {
+		if(root == self_node_idx || nodes_num_rows[root] == 0) {
+			continue;
+		}
+		for(auto & chunk : receiveTable(context, root, sends)) {
+			node_columns.emplace_back(*nodes[root], chunk);
+		}
+	}
+	waitForSends(sends);
+	return node_columns;
+}
+
+std::vector<std::vector<int64_t>> allGather(const Context & context, const std::vector<int64_t> & values) {
+	int num_nodes = context.getTotalNodes();
+	int self_node_idx = getSelfNodeIndex(context);
+	std::size_t num_values = values.size();
+	if(num_nodes == 1 || num_values == 0) {
+		std::vector<std::vector<int64_t>> node_values(num_nodes);
+		node_values[self_node_idx] = values;
+		return node_values;
+	}
+
+	const uint32_t context_token = context.getContextToken();
+	auto self_node = CommunicationData::getInstance().getSharedSelfNode();
+	std::vector<std::shared_ptr<Node>> nodes = context.getAllNodes();
+
+	// the values of the nodes self_node_idx, self_node_idx + 1, ... in a ring, each round doubles them
+	std::vector<int64_t> gathered_values(values);
+	gathered_values.reserve(num_nodes * num_values);
+	int round = 0;
+	for(int distance = 1; distance < num_nodes; distance <<= 1, round++) {
+		const std::string message_id = getCollectiveMessageId(
+			SampleToNodeMasterMessage::MessageID(), context, "allgather_" + std::to_string(round));
+		std::size_t num_sent = std::min(distance, num_nodes - distance) * num_values;
+
+		std::vector<gdf_column_cpp> sent_values(1);
+		sent_values[0].create_gdf_column(GDF_INT64,
+			gdf_dtype_extra_info{},
+			num_sent,
+			gathered_values.data(),
+			ral::traits::get_dtype_size_in_bytes(GDF_INT64),
+			"");
+		auto message = Factory::createSampleToNodeMaster(message_id, context_token, self_node, 0, sent_values);
+		Client::send(*nodes[(self_node_idx - distance + num_nodes) % num_nodes], *message);
+
+		auto received_message = Server::getInstance().getMessage(context_token, message_id);
+		if(received_message->getMessageTokenValue() != message_id) {
+			throw createMessageMismatchException(__FUNCTION__, message_id, received_message->getMessageTokenValue());
+		}
+		auto concrete_message = std::static_pointer_cast<SampleToNodeMasterMessage>(received_message);
+		std::vector<gdf_column_cpp> received_values = concrete_message->getSamples();
+		assert(received_values.size() == 1);
+		assert(received_values[0].dtype() == GDF_INT64);
+		std::size_t num_received = received_values[0].size();
+		gathered_values.resize(gathered_values.size() + num_received);
+		CUDA_TRY(cudaMemcpy(gathered_values.data() + gathered_values.size() - num_received,
+			received_values[0].data(),
+			num_received * sizeof(int64_t),
+			cudaMemcpyDeviceToHost));
+	}
+
+	std::vector<std::vector<int64_t>> node_values(num_nodes);
+	for(int i = 0; i < num_nodes; i++) {
+		auto first = gathered_values.begin() + i * num_values;
+		node_values[(self_node_idx + i) % num_nodes].assign(first, first + num_values);
+	}
+	return node_values;
+}
+
+std::vector<int64_t> allReduce(const Context & context,
+	const std::vector<int64_t> & values,
+	const std::function<int64_t(int64_t, int64_t)> & reduction) {
+	// the scalars are few, gathering them takes as many rounds as a recursive doubling all-reduce
+	std::vector<std::vector<int64_t>> node_values = allGather(context, values);
+	std::vector<int64_t> reduced_values = node_values[0];
+	for(std::size_t i = 1; i < node_values.size(); i++) {
+		for(std::size_t k = 0; k < reduced_values.size(); k++) {
+			reduced_values[k] = reduction(reduced_values[k], node_values[i][k]);
+		}
+	}
+	return reduced_values;
+}
+
+}  // namespace distribution
+}  // namespace ral
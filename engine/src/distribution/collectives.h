@@ -0,0 +1,80 @@
+#ifndef BLAZINGDB_RAL_DISTRIBUTION_COLLECTIVES_H
+#define BLAZINGDB_RAL_DISTRIBUTION_COLLECTIVES_H
+
+#include "GDFColumn.cuh"
+#include "blazingdb/manager/Context.h"
+#include "distribution/NodeColumns.h"
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace ral {
+namespace distribution {
+
+namespace {
+using Context = blazingdb::manager::Context;
+}  // namespace
+
+/**
+ * Collective operations between all the nodes of a query. Every node of the context must call the same collectives in
+ * the same order and query substep, like it does with the other distribution primitives.
+ *
+ * The tables are broadcast through a binomial tree rooted at the sending node: each node receives the table once from
+ * its parent and forwards it to its children, chunk by chunk as the chunks arrive, so the sender uploads the table at
+ * most log2(N) times instead of N - 1 times. The scalars are gathered with Bruck's algorithm, in ceil(log2(N)) rounds
+ * of one message per node instead of a mesh of N * (N - 1) messages.
+ */
+namespace collectives {
+
+// The ranks are relative to the root of the tree, the root has rank 0
+
+// The rank the node with the given rank receives from, -1 for the root
+int binomialTreeParent(int rank);
+
+// The ranks the node with the given rank forwards to, those with the largest subtrees first
+std::vector<int> binomialTreeChildren(int rank, int num_nodes);
+
+// Rounds of the all-gather of num_nodes nodes
+int allGatherRounds(int num_nodes);
+
+}  // namespace collectives
+
+/**
+ * Sends the table of the root node to all the other nodes.
+ *
+ * @param[in] root index of the sending node in the context.
+ * @param[in] table the table to send, only used by the root.
+ * @return the table of the root in every node, in the root the given table.
+ */
+std::vector<gdf_column_cpp> broadcastTable(const Context & context, int root, std::vector<gdf_column_cpp> & table);
+
+/**
+ * Every node with rows sends its table to all the other nodes, through a binomial tree rooted at it. This is the
+ * exchange of a broadcast join, the trees of the different senders spread the forwarding over all the nodes.
+ *
+ * @param[in] table the table of this node, sent if its node has rows.
+ * @param[in] nodes_num_rows the number of rows of each node, indexed like the nodes of the context.
+ * @return the tables of the other nodes with rows, one NodeColumns per chunk received.
+ */
+std::vector<NodeColumns> allGatherTables(
+	const Context & context, std::vector<gdf_column_cpp> & table, const std::vector<gdf_size_type> & nodes_num_rows);
+
+/**
+ * Gathers the values of every node in all the nodes. All the nodes must give the same number of values.
+ *
+ * @return the values of each node, indexed like the nodes of the context.
+ */
+std::vector<std::vector<int64_t>> allGather(const Context & context, const std::vector<int64_t> & values);
+
+/**
+ * Reduces the values of every node position by position, with an associative and commutative reduction. The result
+ * is the same in all the nodes.
+ */
+std::vector<int64_t> allReduce(const Context & context,
+	const std::vector<int64_t> & values,
+	const std::function<int64_t(int64_t, int64_t)> & reduction);
+
+}  // namespace distribution
+}  // namespace ral
+
+#endif  // BLAZINGDB_RAL_DISTRIBUTION_COLLECTIVES_H
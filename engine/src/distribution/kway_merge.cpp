@@ -0,0 +1,86 @@
+#include "distribution/kway_merge.h"
+#include <utility>
+
+namespace ral {
+namespace distribution {
+
+namespace {
+
+// Tournament of the next row of each run. The internal nodes 1 .. k - 1 keep the loser of the match played there and
+// node 0 the overall winner, the parent of the run i is the node (i + k) / 2.
+class loser_tree {
+public:
+	loser_tree(const std::vector<gdf_size_type> & run_sizes,
+		const std::function<bool(const merge_position &, const merge_position &)> & less)
+		: run_sizes(run_sizes), less(less), next_rows(run_sizes.size(), 0), nodes(run_sizes.size(), -1) {
+		const int k = run_sizes.size();
+		// a run goes up until an empty node, exactly one of them reaches the root
+		for(int run = 0; run < k; run++) {
+			int winner = run;
+			int node = (run + k) / 2;
+			for(; node > 0 && nodes[node] != -1; node /= 2) {
+				if(beats(nodes[node], winner)) {
+					std::swap(nodes[node], winner);
+				}
+			}
+			nodes[node] = winner;
+		}
+	}
+
+	bool empty() const { return nodes.empty() || exhausted(nodes[0]); }
+
+	merge_position pop() {
+		const int k = run_sizes.size();
+		int winner = nodes[0];
+		merge_position position{winner, next_rows[winner]++};
+		for(int node = (winner + k) / 2; node > 0; node /= 2) {
+			if(beats(nodes[node], winner)) {
+				std::swap(nodes[node], winner);
+			}
+		}
+		nodes[0] = winner;
+		return position;
+	}
+
+private:
+	bool exhausted(int run) const { return next_rows[run] >= run_sizes[run]; }
+
+	// whether the next row of run a comes before the next row of run b, an exhausted run loses every match
+	bool beats(int a, int b) const {
+		if(exhausted(a) || exhausted(b)) {
+			return !exhausted(a);
+		}
+		merge_position a_position{a, next_rows[a]};
+		merge_position b_position{b, next_rows[b]};
+		if(less(a_position, b_position)) {
+			return true;
+		}
+		return !less(b_position, a_position) && a < b;
+	}
+
+	const std::vector<gdf_size_type> & run_sizes;
+	const std::function<bool(const merge_position &, const merge_position &)> & less;
+	std::vector<gdf_size_type> next_rows;
+	std::vector<int> nodes;
+};
+
+}  // namespace
+
+std::vector<merge_position> host_kway_merge(const std::vector<gdf_size_type> & run_sizes,
+	const std::function<bool(const merge_position &, const merge_position &)> & less) {
+	gdf_size_type num_rows = 0;
+	for(gdf_size_type run_size : run_sizes) {
+		num_rows += run_size;
+	}
+
+	std::vector<merge_position> merged;
+	merged.reserve(num_rows);
+	loser_tree tree(run_sizes, less);
+	while(!tree.empty()) {
+		merged.push_back(tree.pop());
+	}
+	return merged;
+}
+
+}  // namespace distribution
+}  // namespace ral
@@ -0,0 +1,34 @@
+#ifndef BLAZINGDB_RAL_DISTRIBUTION_KWAY_MERGE_H
+#define BLAZINGDB_RAL_DISTRIBUTION_KWAY_MERGE_H
+
+#include "GDFColumn.cuh"
+#include <functional>
+#include <vector>
+
+namespace ral {
+namespace distribution {
+
+// A row of one of the sorted runs of a merge
+struct merge_position {
+	int run;
+	gdf_size_type row;
+};
+
+inline bool operator==(const merge_position & a, const merge_position & b) { return a.run == b.run && a.row == b.row; }
+
+/**
+ * Host k-way merge of sorted runs with a loser tree: each output row replays one path of ceil(log2(k)) comparisons,
+ * so the merge takes O(n log k) comparisons instead of the O(n k) of merging the runs one after another. The rows
+ * with the same keys keep their order, those of the earlier runs first. The reference of sortedMerger, for the tests.
+ *
+ * @param run_sizes number of rows of each run.
+ * @param less whether the row at a comes before the row at b, the runs must be sorted by it.
+ * @return the rows of all the runs in the merged order.
+ */
+std::vector<merge_position> host_kway_merge(const std::vector<gdf_size_type> & run_sizes,
+	const std::function<bool(const merge_position &, const merge_position &)> & less);
+
+}  // namespace distribution
+}  // namespace ral
+
+#endif  // BLAZINGDB_RAL_DISTRIBUTION_KWAY_MERGE_H
@@ -7,10 +7,12 @@
 #include "communication/messages/ComponentMessages.h"
 #include "communication/network/Client.h"
 #include "communication/network/Server.h"
+#include "config/BlazingConfig.h"
 #include "config/GPUManager.cuh"
 #include "cuDF/generator/sample_generator.h"
 #include "cuDF/safe_nvcategory_gather.hpp"
 #include "distribution/Exception.h"
+#include "distribution/collectives.h"
 #include "distribution/primitives_util.cuh"
 #include "legacy/groupby.hpp"
 #include "legacy/reduction.hpp"
@@ -20,6 +22,7 @@
 #include "utilities/TableWrapper.h"
 #include <algorithm>
 #include <blazingdb/io/Library/Logging/Logger.h>
+#include <blazingdb/transport/io/TransportExecutor.h>
 #include <cassert>
 #include <cmath>
 #include <cudf/legacy/table.hpp>
@@ -30,6 +33,7 @@
 
 #include "cudf/legacy/copying.hpp"
 #include "cudf/legacy/merge.hpp"
+#include "cudf/legacy/replace.hpp"
 #include "cudf/legacy/search.hpp"
 
 #include "utilities/CommonOperations.h"
@@ -289,36 +293,12 @@ std::vector<gdf_column_cpp> generatePartitionPlans(
 }
 
 void distributePartitionPlan(const Context & context, std::vector<gdf_column_cpp> & pivots) {
-	using ral::communication::CommunicationData;
-	using ral::communication::messages::Factory;
-	using ral::communication::messages::PartitionPivotsMessage;
-
-	const uint32_t context_comm_token = context.getContextCommunicationToken();
-	const uint32_t context_token = context.getContextToken();
-	const std::string message_id = PartitionPivotsMessage::MessageID() + "_" + std::to_string(context_comm_token);
-
-	auto node = CommunicationData::getInstance().getSharedSelfNode();
-	auto message = Factory::createPartitionPivotsMessage(message_id, context_token, node, pivots);
-	broadcastMessage(context.getWorkerNodes(), message);
+	broadcastTable(context, context.getNodeIndex(context.getMasterNode()), pivots);
 }
 
 std::vector<gdf_column_cpp> getPartitionPlan(const Context & context) {
-	using ral::communication::messages::PartitionPivotsMessage;
-	using ral::communication::network::Server;
-
-	const uint32_t context_comm_token = context.getContextCommunicationToken();
-	const uint32_t context_token = context.getContextToken();
-	const std::string message_id = PartitionPivotsMessage::MessageID() + "_" + std::to_string(context_comm_token);
-
-	auto message = Server::getInstance().getMessage(context_token, message_id);
-
-	if(message->getMessageTokenValue() != message_id) {
-		throw createMessageMismatchException(__FUNCTION__, message_id, message->getMessageTokenValue());
-	}
-
-	auto concreteMessage = std::static_pointer_cast<PartitionPivotsMessage>(message);
-
-	return concreteMessage->getColumns();
+	std::vector<gdf_column_cpp> pivots;
+	return broadcastTable(context, context.getNodeIndex(context.getMasterNode()), pivots);
 }
 
 std::vector<NodeColumns> split_data_into_NodeColumns(
@@ -519,7 +499,74 @@ std::vector<NodeColumns> partitionData(const Context & context,
 	return split_data_into_NodeColumns(context, table, indexes);
 }
 
-void distributePartitions(const Context & context, std::vector<NodeColumns> & partitions) {
+namespace {
+
+// Estimated bytes a row takes on the wire. The strings are estimated with the average length of their distinct values.
+std::size_t estimateRowSize(const std::vector<gdf_column_cpp> & table) {
+	std::size_t row_size = 0;
+	for(auto & column : table) {
+		if(column.dtype() != GDF_STRING_CATEGORY) {
+			row_size += ral::traits::get_dtype_size_in_bytes(column.dtype());
+			continue;
+		}
+		row_size += sizeof(int);  // the offset of the string
+		NVCategory * category = static_cast<NVCategory *>(column.get_gdf_column()->dtype_info.category);
+		if(category == nullptr || category->keys_size() == 0) {
+			continue;
+		}
+		NVStrings * keys = category->get_keys();
+		std::vector<int> lengths(keys->size());
+		keys->byte_count(lengths.data(), false);
+		std::size_t keys_bytes = std::accumulate(
+			lengths.begin(), lengths.end(), std::size_t{0}, [](std::size_t total, int length) {
+				return total + std::max(length, 0);
+			});
+		row_size += keys_bytes / lengths.size();
+		NVStrings::destroy(keys);
+	}
+	return std::max<std::size_t>(row_size, 1);
+}
+
+}  // namespace
+
+std::vector<std::vector<gdf_column_cpp>> splitPartitionIntoChunks(const std::vector<gdf_column_cpp> & table) {
+	gdf_size_type num_rows = table.empty() ? 0 : table[0].size();
+	std::size_t chunk_size = ral::config::BlazingConfig::getInstance().getPartitionChunkSize();
+	std::size_t rows_per_chunk = std::max<std::size_t>(chunk_size / estimateRowSize(table), 1);
+	if(static_cast<std::size_t>(num_rows) <= rows_per_chunk) {
+		return {table};
+	}
+
+	std::vector<gdf_index_type> split_indexes;
+	for(std::size_t row = rows_per_chunk; row < static_cast<std::size_t>(num_rows); row += rows_per_chunk) {
+		split_indexes.push_back(row);
+	}
+	gdf_column_cpp indexes;
+	indexes.create_gdf_column(GDF_INT32,
+		gdf_dtype_extra_info{TIME_UNIT_NONE, nullptr},
+		split_indexes.size(),
+		split_indexes.data(),
+		ral::traits::get_dtype_size_in_bytes(GDF_INT32),
+		"");
+
+	std::vector<std::vector<gdf_column_cpp>> chunks(split_indexes.size() + 1, std::vector<gdf_column_cpp>(table.size()));
+	for(std::size_t k = 0; k < table.size(); ++k) {
+		std::vector<gdf_column *> split_column =
+			cudf::split(*(table[k].get_gdf_column()), static_cast<gdf_index_type *>(indexes.data()), indexes.size());
+		for(std::size_t i = 0; i < chunks.size(); ++i) {
+			split_column[i]->col_name = nullptr;
+			chunks[i][k].create_gdf_column(split_column[i]);
+			chunks[i][k].set_name(table[k].name());
+		}
+	}
+	return chunks;
+}
+
+namespace {
+
+// Starts the sends of the partitions of the other nodes on the socket workers. Each chunk waits for the credits of its
+// receiver, so a node only gets as many chunks as it can hold until it merges them.
+std::vector<std::future<void>> sendPartitions(const Context & context, std::vector<NodeColumns> & partitions) {
 	using ral::communication::CommunicationData;
 	using ral::communication::messages::ColumnDataMessage;
 	using ral::communication::messages::Factory;
@@ -530,38 +577,70 @@ void distributePartitions(const Context & context, std::vector<NodeColumns> & pa
 	const std::string message_id = ColumnDataMessage::MessageID() + "_" + std::to_string(context_comm_token);
 
 	auto self_node = CommunicationData::getInstance().getSharedSelfNode();
-	std::vector<std::thread> threads;
+	auto & executor = blazingdb::transport::io::getTransportExecutor();
+	std::vector<std::future<void>> sends;
 	for(auto & nodeColumn : partitions) {
 		if(nodeColumn.getNode() == *self_node) {
 			continue;
 		}
 		std::vector<gdf_column_cpp> columns = nodeColumn.getColumns();
 		auto destination_node = nodeColumn.getNode();
-		threads.push_back(std::thread([message_id, context_token, self_node, destination_node, columns]() mutable {
-			auto message = Factory::createColumnDataMessage(message_id, context_token, self_node, columns);
-			Client::send(destination_node, *message);
+		sends.push_back(executor.submitSocket([message_id, context_token, self_node, destination_node, columns]() mutable {
+			// the chunks of a partition are sent one after the other, the receiver can use each one as it arrives
+			std::vector<std::vector<gdf_column_cpp>> chunks = splitPartitionIntoChunks(columns);
+			for(std::size_t i = 0; i < chunks.size(); i++) {
+				auto message = Factory::createColumnDataMessage(message_id, context_token, self_node, chunks[i]);
+				message->metadata().partition_chunk = i;
+				message->metadata().partition_chunks = chunks.size();
+				Client::sendWithCredits(destination_node, *message);
+			}
 		}));
 	}
-	for(size_t i = 0; i < threads.size(); i++) {
-		threads[i].join();
+	return sends;
+}
+
+}  // namespace
+
+void distributePartitions(const Context & context, std::vector<NodeColumns> & partitions) {
+	std::vector<std::future<void>> sends = sendPartitions(context, partitions);
+	for(size_t i = 0; i < sends.size(); i++) {
+		sends[i].get();
 	}
 }
 
+std::vector<NodeColumns> exchangePartitions(const Context & context, std::vector<NodeColumns> & partitions) {
+	// the sends can wait for the other nodes to collect, so this node collects while its own sends are in progress
+	std::vector<std::future<void>> sends = sendPartitions(context, partitions);
+	std::vector<NodeColumns> node_columns = collectPartitions(context);
+	for(size_t i = 0; i < sends.size(); i++) {
+		sends[i].get();
+	}
+	return node_columns;
+}
+
 std::vector<NodeColumns> collectPartitions(const Context & context) {
 	int num_partitions = context.getTotalNodes() - 1;
 	return collectSomePartitions(context, num_partitions);
 }
 
 std::vector<NodeColumns> collectSomePartitions(const Context & context, int num_partitions) {
+	std::vector<NodeColumns> node_columns;
+	collectSomePartitions(context, num_partitions, [&node_columns](NodeColumns && chunk) {
+		node_columns.push_back(std::move(chunk));
+	});
+	return node_columns;
+}
+
+void collectSomePartitions(
+	const Context & context, int num_partitions, const std::function<void(NodeColumns &&)> & consume_chunk) {
 	using ral::communication::messages::ColumnDataMessage;
 	using ral::communication::network::Server;
 
 	// Get the numbers of rals in the query
 	int number_rals = context.getTotalNodes() - 1;
 	std::vector<bool> received(context.getTotalNodes(), false);
-
-	// Create return value
-	std::vector<NodeColumns> node_columns;
+	// chunks of the partition of each node that have not arrived yet, -1 before its first chunk
+	std::vector<int> chunks_left(context.getTotalNodes(), -1);
 
 	// Get message from the server
 	const uint32_t context_comm_token = context.getContextCommunicationToken();
@@ -570,7 +649,6 @@ std::vector<NodeColumns> collectSomePartitions(const Context & context, int num_
 
 	while(0 < num_partitions) {
 		auto message = Server::getInstance().getMessage(context_token, message_id);
-		num_partitions--;
 
 		if(message->getMessageTokenValue() != message_id) {
 			throw createMessageMismatchException(__FUNCTION__, message_id, message->getMessageTokenValue());
@@ -585,24 +663,16 @@ std::vector<NodeColumns> collectSomePartitions(const Context & context, int num_
 				std::to_string(context.getQuerySubstep()),
 				"ERROR: Already received collectSomePartitions from node " + std::to_string(node_idx)));
 		}
-		node_columns.emplace_back(*node, column_message->getColumns());
-		received[node_idx] = true;
-	}
-	return node_columns;
-}
-
-void scatterData(const Context & context, std::vector<gdf_column_cpp> & table) {
-	using ral::communication::CommunicationData;
-
-	std::vector<NodeColumns> array_node_columns;
-	auto nodes = context.getAllNodes();
-	for(std::size_t i = 0; i < nodes.size(); ++i) {
-		if(!(*(nodes[i].get()) == CommunicationData::getInstance().getSelfNode())) {
-			std::vector<gdf_column_cpp> columns = table;
-			array_node_columns.emplace_back(*nodes[i], std::move(columns));
+		if(chunks_left[node_idx] < 0) {
+			chunks_left[node_idx] = message->metadata().partition_chunks;
+		}
+		chunks_left[node_idx]--;
+		consume_chunk(NodeColumns(*node, column_message->getColumns()));
+		if(chunks_left[node_idx] == 0) {
+			received[node_idx] = true;
+			num_partitions--;
 		}
 	}
-	distributePartitions(context, array_node_columns);
 }
 
 void sortedMerger(std::vector<NodeColumns> & columns,
@@ -629,31 +699,88 @@ void sortedMerger(std::vector<NodeColumns> & columns,
 		return;
 	}
 
-	std::vector<gdf_column_cpp> leftCols(gdfColTables[0]);
-	cudf::table leftTable = ral::utilities::create_table(leftCols);
-	for(size_t i = 1; i < gdfColTables.size(); i++) {
-		std::vector<gdf_column_cpp> rightCols(gdfColTables[i]);
-		cudf::table rightTable = ral::utilities::create_table(rightCols);
-
-		// GDF_STRING_CATEGORY columns are sorted but the underlying nvstring may not be, so gather them
-		// to ensure they're sorted guaranteeing that sync_column_categories (called in cudf::merge)
-		// results are sorted
-		gather_and_remap_nvcategory(leftTable);
-		gather_and_remap_nvcategory(rightTable);
-
-		cudf::table mergedTable = cudf::merge(leftTable, rightTable, sortColIndices, ascDesc);
-
-		for(size_t j = 0; j < mergedTable.num_columns(); j++) {
-			gdf_column * col = mergedTable.get_column(j);
-			std::string colName = leftCols[j].name();
-			leftCols[j].create_gdf_column(col);
-			leftCols[j].set_name(colName);
+	if(gdfColTables.size() == 1) {
+		output.add_table(gdfColTables[0]);
+		return;
+	}
+
+	// GDF_STRING_CATEGORY columns are sorted but the underlying nvstring may not be, so gather them once to ensure
+	// they're sorted guaranteeing that sync_column_categories (called in cudf::merge) results are sorted
+	for(std::vector<gdf_column_cpp> & table : gdfColTables) {
+		cudf::table gdfTable = ral::utilities::create_table(table);
+		gather_and_remap_nvcategory(gdfTable);
+	}
+
+	// Each run has the sort columns of a table and the position of its rows in the concatenation of all the tables.
+	// The runs are merged in pairs in a balanced tree, so only the keys are copied in each of the log2(k) rounds and
+	// every column is gathered once at the end, instead of merging all the columns into the result k - 1 times.
+	std::vector<std::vector<gdf_column_cpp>> runs(gdfColTables.size());
+	gdf_size_type rowOffset = 0;
+	for(size_t i = 0; i < gdfColTables.size(); i++) {
+		for(int sortColIndex : sortColIndices) {
+			runs[i].push_back(gdfColTables[i][sortColIndex]);
+		}
+
+		gdf_column_cpp rowIndices;
+		rowIndices.create_gdf_column(GDF_INT32,
+			gdf_dtype_extra_info{TIME_UNIT_NONE, nullptr},
+			gdfColTables[i][0].size(),
+			nullptr,
+			nullptr,
+			ral::traits::get_dtype_size_in_bytes(GDF_INT32),
+			"");
+		gdf_sequence(static_cast<int32_t *>(rowIndices.get_gdf_column()->data), rowIndices.size(), rowOffset);
+		runs[i].push_back(rowIndices);
+		rowOffset += rowIndices.size();
+	}
+
+	std::vector<int> runSortColIndices(sortColIndices.size());
+	std::iota(runSortColIndices.begin(), runSortColIndices.end(), 0);
+	while(runs.size() > 1) {
+		std::vector<std::vector<gdf_column_cpp>> mergedRuns;
+		for(size_t i = 0; i + 1 < runs.size(); i += 2) {
+			cudf::table leftTable = ral::utilities::create_table(runs[i]);
+			cudf::table rightTable = ral::utilities::create_table(runs[i + 1]);
+			cudf::table mergedTable = cudf::merge(leftTable, rightTable, runSortColIndices, ascDesc);
+
+			std::vector<gdf_column_cpp> mergedRun(mergedTable.num_columns());
+			for(size_t j = 0; j < mergedTable.num_columns(); j++) {
+				mergedRun[j].create_gdf_column(mergedTable.get_column(j));
+			}
+			mergedRuns.push_back(mergedRun);
+		}
+		if(runs.size() % 2 == 1) {
+			mergedRuns.push_back(runs.back());
 		}
+		runs = std::move(mergedRuns);
+	}
+	gdf_column_cpp mergedRowIndices = runs[0].back();
 
-		leftTable = mergedTable;
+	std::vector<gdf_column_cpp> concatenated = ral::utilities::concatTables(gdfColTables);
+	std::vector<gdf_column_cpp> mergedCols(concatenated.size());
+	for(size_t i = 0; i < concatenated.size(); i++) {
+		gdf_column_cpp & col = concatenated[i];
+		if(col.valid()) {
+			mergedCols[i].create_gdf_column(col.dtype(),
+				col.dtype_info(),
+				mergedRowIndices.size(),
+				nullptr,
+				ral::traits::get_dtype_size_in_bytes(col.dtype()),
+				gdfColTables[0][i].name());
+		} else {
+			mergedCols[i].create_gdf_column(col.dtype(),
+				col.dtype_info(),
+				mergedRowIndices.size(),
+				nullptr,
+				nullptr,
+				ral::traits::get_dtype_size_in_bytes(col.dtype()),
+				gdfColTables[0][i].name());
+		}
+		materialize_column(col.get_gdf_column(), mergedCols[i].get_gdf_column(), mergedRowIndices.get_gdf_column());
+		mergedCols[i].update_null_count();
 	}
 
-	output.add_table(leftCols);
+	output.add_table(mergedCols);
 }
 
 std::vector<gdf_column_cpp> generatePartitionPlansGroupBy(const Context & context, std::vector<NodeSamples> & samples) {
@@ -770,6 +897,13 @@ void groupByWithoutAggregationsMerger(
 
 	std::vector<gdf_column_cpp> concatGroups = ral::utilities::concatTables(tables);
 
+	// no node sent groups, there is nothing to merge
+	if(concatGroups[0].size() == 0) {
+		output.clear();
+		output.add_table(concatGroups);
+		return;
+	}
+
 	std::vector<gdf_column_cpp> groupedOutput =
 		ral::operators::groupby_without_aggregations(concatGroups, groupColIndices);
 
@@ -777,130 +911,6 @@ void groupByWithoutAggregationsMerger(
 	output.add_table(groupedOutput);
 }
 
-void distributeRowSize(const Context & context, std::size_t total_row_size) {
-	using ral::communication::CommunicationData;
-	using ral::communication::messages::Factory;
-	using ral::communication::messages::SampleToNodeMasterMessage;
-	using ral::communication::network::Client;
-
-
-	const uint32_t context_comm_token = context.getContextCommunicationToken();
-	const uint32_t context_token = context.getContextToken();
-	const std::string message_id = SampleToNodeMasterMessage::MessageID() + "_" + std::to_string(context_comm_token);
-
-	auto self_node = CommunicationData::getInstance().getSharedSelfNode();
-	auto message = Factory::createSampleToNodeMaster(message_id, context_token, self_node, total_row_size, {});
-
-	int self_node_idx = context.getNodeIndex(CommunicationData::getInstance().getSelfNode());
-	broadcastMessage(context.getAllOtherNodes(self_node_idx), message);
-}
-
-std::vector<gdf_size_type> collectRowSize(const Context & context) {
-	using ral::communication::CommunicationData;
-	using ral::communication::messages::SampleToNodeMasterMessage;
-	using ral::communication::network::Server;
-
-	int num_nodes = context.getTotalNodes();
-	std::vector<gdf_size_type> node_row_sizes(num_nodes);
-	std::vector<bool> received(num_nodes, false);
-
-	const uint32_t context_comm_token = context.getContextCommunicationToken();
-	const uint32_t context_token = context.getContextToken();
-	const std::string message_id = SampleToNodeMasterMessage::MessageID() + "_" + std::to_string(context_comm_token);
-
-	int self_node_idx = context.getNodeIndex(CommunicationData::getInstance().getSelfNode());
-	for(gdf_size_type i = 0; i < num_nodes - 1; ++i) {
-		auto message = Server::getInstance().getMessage(context_token, message_id);
-		if(message->getMessageTokenValue() != message_id) {
-			throw createMessageMismatchException(__FUNCTION__, message_id, message->getMessageTokenValue());
-		}
-		auto concrete_message = std::static_pointer_cast<SampleToNodeMasterMessage>(message);
-		auto node = concrete_message->getSenderNode();
-		int node_idx = context.getNodeIndex(*node);
-		assert(node_idx >= 0);
-		if(received[node_idx]) {
-			Library::Logging::Logger().logError(ral::utilities::buildLogString(std::to_string(context_token),
-				std::to_string(context.getQueryStep()),
-				std::to_string(context.getQuerySubstep()),
-				"ERROR: Already received collectRowSize from node " + std::to_string(node_idx)));
-		}
-		node_row_sizes[node_idx] = concrete_message->getTotalRowSize();
-		received[node_idx] = true;
-	}
-
-	return node_row_sizes;
-}
-
-
-void distributeLeftRightNumRows(const Context & context, std::size_t left_num_rows, std::size_t right_num_rows) {
-	using ral::communication::CommunicationData;
-	using ral::communication::messages::Factory;
-	using ral::communication::messages::SampleToNodeMasterMessage;
-	using ral::communication::network::Client;
-
-	const uint32_t context_comm_token = context.getContextCommunicationToken();
-	const uint32_t context_token = context.getContextToken();
-	const std::string message_id = SampleToNodeMasterMessage::MessageID() + "_" + std::to_string(context_comm_token);
-
-	auto self_node = CommunicationData::getInstance().getSharedSelfNode();
-	std::vector<gdf_column_cpp> num_rows(1);
-	std::vector<int64_t> num_rows_host{left_num_rows, right_num_rows};
-	num_rows[0].create_gdf_column(
-		GDF_INT64, gdf_dtype_extra_info{}, 2, &num_rows_host[0], ral::traits::get_dtype_size_in_bytes(GDF_INT64), "");
-	auto message = Factory::createSampleToNodeMaster(message_id, context_token, self_node, 0, num_rows);
-
-	int self_node_idx = context.getNodeIndex(CommunicationData::getInstance().getSelfNode());
-	broadcastMessage(context.getAllOtherNodes(self_node_idx), message);
-}
-
-void collectLeftRightNumRows(const Context & context,
-	std::vector<gdf_size_type> & node_num_rows_left,
-	std::vector<gdf_size_type> & node_num_rows_right) {
-	using ral::communication::CommunicationData;
-	using ral::communication::messages::SampleToNodeMasterMessage;
-	using ral::communication::network::Server;
-
-	int num_nodes = context.getTotalNodes();
-	node_num_rows_left.resize(num_nodes);
-	node_num_rows_right.resize(num_nodes);
-	std::vector<bool> received(num_nodes, false);
-
-	const uint32_t context_comm_token = context.getContextCommunicationToken();
-	const uint32_t context_token = context.getContextToken();
-	const std::string message_id = SampleToNodeMasterMessage::MessageID() + "_" + std::to_string(context_comm_token);
-
-	int self_node_idx = context.getNodeIndex(CommunicationData::getInstance().getSelfNode());
-	for(gdf_size_type i = 0; i < num_nodes - 1; ++i) {
-		auto message = Server::getInstance().getMessage(context_token, message_id);
-		if(message->getMessageTokenValue() != message_id) {
-			throw createMessageMismatchException(__FUNCTION__, message_id, message->getMessageTokenValue());
-		}
-		auto concrete_message = std::static_pointer_cast<SampleToNodeMasterMessage>(message);
-		auto node = concrete_message->getSenderNode();
-		std::vector<gdf_column_cpp> num_rows_data = concrete_message->getSamples();
-		assert(num_rows_data.size() == 1);
-		assert(num_rows_data[0].size() == 2);
-		assert(num_rows_data[0].dtype() == GDF_INT64);
-		std::vector<int64_t> num_rows_host(2);
-		cudaMemcpy(num_rows_host.data(),
-			num_rows_data[0].data(),
-			ral::traits::get_dtype_size_in_bytes(GDF_INT64) * 2,
-			cudaMemcpyDeviceToHost);
-		int node_idx = context.getNodeIndex(*node);
-		assert(node_idx >= 0);
-		if(received[node_idx]) {
-			Library::Logging::Logger().logError(ral::utilities::buildLogString(std::to_string(context_token),
-				std::to_string(context.getQueryStep()),
-				std::to_string(context.getQuerySubstep()),
-				"ERROR: Already received collectLeftRightNumRows from node " + std::to_string(node_idx)));
-		}
-		node_num_rows_left[node_idx] = num_rows_host[0];
-		node_num_rows_right[node_idx] = num_rows_host[1];
-		received[node_idx] = true;
-	}
-}
-
-
 }  // namespace distribution
 }  // namespace ral
 
@@ -942,8 +952,23 @@ std::vector<NodeColumns> generateJoinPartitions(
 	for(size_t i = 0; i < columnIndices.size(); i++) {
 		gdf_column_cpp & col = table[columnIndices[i]];
 
-		if(col.dtype() != GDF_STRING_CATEGORY)
+		if(col.dtype() != GDF_STRING_CATEGORY) {
+			// the value under a null is whatever the row had, a null key is hashed as a zero so the groups of the null
+			// keys of every node go to the same node
+			if(col.null_count() > 0) {
+				gdf_scalar zero{};
+				zero.dtype = col.dtype();
+				zero.is_valid = true;
+				gdf_column * replaced = new gdf_column{};
+				*replaced = cudf::replace_nulls(*col.get_gdf_column(), zero);
+				gdf_column_cpp key_without_nulls;
+				key_without_nulls.create_gdf_column(replaced);
+
+				temp_input_col_indices[i] = temp_input_table.size();
+				temp_input_table.push_back(key_without_nulls);
+			}
 			continue;
+		}
 
 		NVCategory * nvCategory = static_cast<NVCategory *>(col.get_gdf_column()->dtype_info.category);
 		NVStrings * nvStrings =
@@ -1032,20 +1057,5 @@ std::vector<NodeColumns> generateJoinPartitions(
 	return split_data_into_NodeColumns(context, temp_output_columns, indexes);
 }
 
-
-void broadcastMessage(
-	std::vector<std::shared_ptr<Node>> nodes, std::shared_ptr<communication::messages::Message> message) {
-	std::vector<std::thread> threads(nodes.size());
-	for(size_t i = 0; i < nodes.size(); i++) {
-		std::shared_ptr<Node> node = nodes[i];
-		threads[i] = std::thread([node, message]() {
-			ral::communication::network::Client::send(*node, *message);
-		});
-	}
-	for(size_t i = 0; i < threads.size(); i++) {
-		threads[i].join();
-	}
-}
-
 }  // namespace distribution
 }  // namespace ral
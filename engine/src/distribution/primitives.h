@@ -7,6 +7,7 @@
 #include "communication/factory/MessageFactory.h"
 #include "distribution/NodeColumns.h"
 #include "distribution/NodeSamples.h"
+#include <functional>
 #include <vector>
 
 namespace ral {
@@ -80,14 +81,29 @@ std::vector<NodeColumns> partitionData(const Context & context,
 	bool isTableSorted,
 	std::vector<int8_t> sortOrderTypes = {});
 
+// Splits a partition into row ranges of about the configured partition chunk size, each one is sent as a message
+std::vector<std::vector<gdf_column_cpp>> splitPartitionIntoChunks(const std::vector<gdf_column_cpp> & table);
+
+// Sends the partitions of the other nodes and waits until they are sent. Only for nodes that do not expect partitions
+// back, like the ones that send their results to the master.
 void distributePartitions(const Context & context, std::vector<NodeColumns> & partitions);
 
+// Sends the partitions of the other nodes and collects the ones they send to this node, like a distributePartitions
+// followed by a collectPartitions. The sends wait for the credits of the receivers, which have to collect meanwhile.
+std::vector<NodeColumns> exchangePartitions(const Context & context, std::vector<NodeColumns> & partitions);
+
 std::vector<NodeColumns> collectPartitions(const Context & context);
 std::vector<NodeColumns> collectSomePartitions(const Context & context, int num_partitions);
 
-// this functions sends the data in table to all nodes except itself
-void scatterData(const Context & context, std::vector<gdf_column_cpp> & table);
+// A partition larger than the partition chunk size arrives as several NodeColumns, one per chunk. consume_chunk is
+// called with each chunk as it arrives, until the partitions of num_partitions nodes are complete. The master of a
+// distributed top-N (distributed_top_n in OrderBy.cpp) merges the candidates of the other nodes this way.
+void collectSomePartitions(
+	const Context & context, int num_partitions, const std::function<void(NodeColumns &&)> & consume_chunk);
 
+// Merges the sorted partitions of the nodes into one sorted table. The keys are merged in log2(k) rounds of pairwise
+// merges and every column is gathered once in the merged order, the rows of the same keys keep the order of the
+// partitions.
 void sortedMerger(std::vector<NodeColumns> & columns,
 	std::vector<int8_t> & sortOrderTypes,
 	std::vector<int> & sortColIndices,
@@ -98,19 +114,6 @@ std::vector<gdf_column_cpp> generatePartitionPlansGroupBy(const Context & contex
 void groupByWithoutAggregationsMerger(
 	std::vector<NodeColumns> & groups, const std::vector<int> & groupColIndices, blazing_frame & output);
 
-void distributeRowSize(const Context & context, std::size_t total_row_size);
-
-std::vector<gdf_size_type> collectRowSize(const Context & context);
-
-void distributeLeftRightNumRows(const Context & context, std::size_t left_num_rows, std::size_t right_num_rows);
-void collectLeftRightNumRows(const Context & context,
-	std::vector<gdf_size_type> & node_num_rows_left,
-	std::vector<gdf_size_type> & node_num_rows_right);
-
-// multi-threaded message sender
-void broadcastMessage(
-	std::vector<std::shared_ptr<Node>> nodes, std::shared_ptr<communication::messages::Message> message);
-
 }  // namespace distribution
 }  // namespace ral
 
@@ -0,0 +1,92 @@
+#include "execution/TaskExecutor.h"
+
+#include <cuda_runtime.h>
+
+#include "config/BlazingConfig.h"
+
+namespace ral {
+namespace execution {
+
+task_executor & task_executor::getInstance() {
+	static task_executor executor(ral::config::BlazingConfig::getInstance().getExecutorThreads(),
+		ral::config::BlazingConfig::getInstance().getExecutorMemoryReserve());
+	return executor;
+}
+
+task_executor::task_executor(size_t num_workers, double memory_reserve)
+	: idle_workers{0}, stopped{false}, memory_reserve{memory_reserve} {
+	for(size_t i = 0; i < num_workers; i++) {
+		workers.emplace_back([this]() { this->run_worker(); });
+	}
+
+	std::unique_lock<std::mutex> lock(tasks_mutex);
+	idle_cv.wait(lock, [this, num_workers]() { return idle_workers == num_workers; });
+}
+
+task_executor::~task_executor() {
+	{
+		std::lock_guard<std::mutex> lock(tasks_mutex);
+		stopped = true;
+	}
+	tasks_cv.notify_all();
+	for(std::thread & worker : workers) {
+		worker.join();
+	}
+}
+
+bool task_executor::has_memory_available() const {
+	if(memory_reserve <= 0) {
+		return true;
+	}
+
+	size_t free, total;
+	if(cudaMemGetInfo(&free, &total) != cudaSuccess) {
+		return false;
+	}
+	return free >= memory_reserve * total;
+}
+
+bool task_executor::try_enqueue(std::function<void()> task) {
+	int device_id = 0;
+	cudaGetDevice(&device_id);
+
+	if(!has_memory_available()) {
+		return false;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(tasks_mutex);
+		if(stopped || idle_workers <= tasks.size()) {
+			return false;
+		}
+		tasks.push_back([device_id, task]() {
+			cudaSetDevice(device_id);
+			task();
+		});
+	}
+	tasks_cv.notify_one();
+	return true;
+}
+
+void task_executor::run_worker() {
+	while(true) {
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(tasks_mutex);
+			idle_workers++;
+			idle_cv.notify_all();
+			tasks_cv.wait(lock, [this]() { return stopped || !tasks.empty(); });
+			idle_workers--;
+			if(tasks.empty()) {
+				return;
+			}
+			task = std::move(tasks.front());
+			tasks.pop_front();
+		}
+		// exceptions are stored in the future by the packaged_task
+		task();
+	}
+}
+
+}  // namespace execution
+}  // namespace ral
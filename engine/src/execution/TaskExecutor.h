@@ -0,0 +1,86 @@
+#ifndef BLAZINGDB_RAL_EXECUTION_TASKEXECUTOR_H
+#define BLAZINGDB_RAL_EXECUTION_TASKEXECUTOR_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace ral {
+namespace execution {
+
+/**
+ * Bounded pool of worker threads used to run independent pieces of a query (i.e. sibling plan subtrees)
+ * concurrently.
+ *
+ * Work is only admitted when a worker is idle and the device still has enough free memory, otherwise
+ * try_submit returns an invalid future and the caller runs the work inline. Because nothing ever waits in a
+ * queue for a worker, tasks can submit more tasks and wait on them without deadlocking the pool.
+ */
+class task_executor {
+public:
+	static task_executor & getInstance();
+
+	/**
+	 * Tries to run func on a pool worker. The worker uses the same CUDA device as the calling thread.
+	 * @return a valid future if the task was admitted, an invalid one (valid() == false) otherwise
+	 */
+	template <typename Function>
+	std::future<typename std::result_of<Function()>::type> try_submit(Function func) {
+		using result_type = typename std::result_of<Function()>::type;
+
+		auto task = std::make_shared<std::packaged_task<result_type()>>(std::move(func));
+		std::future<result_type> result = task->get_future();
+		if(!try_enqueue([task]() { (*task)(); })) {
+			return std::future<result_type>();
+		}
+		return result;
+	}
+
+	size_t get_num_workers() const { return workers.size(); }
+
+	/**
+	 * The engine uses the instance configured by BlazingConfig, see getInstance. Returns once all the workers are
+	 * idle, so a task submitted right after is admitted if the memory allows it.
+	 * @param memory_reserve fraction of the device memory that must be free to admit a task, 0 admits every task
+	 */
+	task_executor(size_t num_workers, double memory_reserve);
+
+	~task_executor();
+
+private:
+
+	task_executor(const task_executor &) = delete;
+
+	task_executor & operator=(const task_executor &) = delete;
+
+	bool has_memory_available() const;
+
+	bool try_enqueue(std::function<void()> task);
+
+	void run_worker();
+
+private:
+	std::vector<std::thread> workers;
+	std::deque<std::function<void()>> tasks;
+	std::mutex tasks_mutex;
+	std::condition_variable tasks_cv;
+	// notified when a worker becomes idle
+	std::condition_variable idle_cv;
+	size_t idle_workers;
+	bool stopped;
+	/**
+	 * fraction of the total device memory that has to be free for a new task to be admitted
+	 */
+	double memory_reserve;
+};
+
+}  // namespace execution
+}  // namespace ral
+
+#endif  // BLAZINGDB_RAL_EXECUTION_TASKEXECUTOR_H
@@ -1,13 +1,23 @@
 
 #include "DataLoader.h"
 #include "Traits/RuntimeTraits.h"
+#include "config/BlazingConfig.h"
 #include "config/GPUManager.cuh"
+#include "io/data_parser/MetadataCache.h"
+#include "cudf/legacy/copying.hpp"
 #include "cudf/legacy/filling.hpp"
+#include "cudf/legacy/unary.hpp"
 #include "rmm/thrust_rmm_allocator.h"
 #include "utilities/CommonOperations.h"
 #include "utilities/StringUtils.h"
 #include <CodeTimer.h>
 #include <blazingdb/io/Library/Logging/Logger.h>
+#include <cuda_runtime.h>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
 #include <thread>
 
 namespace ral {
@@ -15,6 +25,245 @@ namespace io {
 
 namespace {
 using blazingdb::manager::Context;
+
+/**
+ * key of the file in the metadata_cache, empty when the file was not opened from a file system that reports versions
+ */
+std::string get_metadata_key(const data_handle & file) {
+	if(file.uri.isEmpty()) {
+		return "";
+	}
+	return metadata_cache::make_key(
+		file.uri.toString(true), file.fileStatus.getFileSize(), file.fileStatus.getVersion());
+}
+
+/**
+ * parses a file and adds the columns whose values come from its uri instead of its content (i.e. hive partitions)
+ */
+std::vector<gdf_column_cpp> load_file(data_parser & parser,
+	data_handle & file,
+	const std::string & user_readable_file_handle,
+	const Schema & schema,
+	const std::vector<size_t> & column_indices,
+	const row_group_filter & filter,
+	const std::vector<int> & row_group_ids,
+	row_group_counts & counts) {
+	std::vector<gdf_column_cpp> converted_data;
+
+	Schema fileSchema = schema.fileSchema();
+	counts = parser.parse_filtered(file.fileHandle,
+		user_readable_file_handle,
+		get_metadata_key(file),
+		converted_data,
+		fileSchema,
+		column_indices,
+		filter,
+		row_group_ids);
+
+	for(int i = 0; i < schema.get_num_columns(); i++) {
+		if(!schema.get_in_file()[i]) {
+			auto num_rows = converted_data[0].size();
+			std::string name = schema.get_name(i);
+			if(file.is_column_string[name]) {
+				std::string string_value = file.string_values[name];
+				NVCategory * category = repeated_string_category(string_value, num_rows);
+				gdf_column_cpp column;
+				column.create_gdf_column(category, num_rows, name);
+				converted_data.push_back(column);
+			} else {
+				gdf_scalar scalar = file.column_values[name];
+
+				gdf_column_cpp column;
+				column.create_gdf_column(scalar.dtype,
+					gdf_dtype_extra_info{TIME_UNIT_ms},
+					num_rows,
+					nullptr,
+					ral::traits::get_dtype_size_in_bytes(scalar.dtype),
+					name);
+				cudf::fill(column.get_gdf_column(), scalar, 0, num_rows);
+				converted_data.push_back(column);
+			}
+		}
+	}
+
+	return converted_data;
+}
+
+/**
+ * The output of a load whose number of rows is known before parsing. Fixed width columns are allocated once and
+ * every file is copied into its slice as soon as it is parsed, so it can be freed right away. String columns can not
+ * be pre-sized, their pieces are kept and concatenated when the table is released.
+ */
+class presized_table {
+public:
+	/**
+	 * @param dtypes the type of every output column, the files are converted to it as they are appended so the output
+	 * does not depend on which file is parsed first
+	 * @param dtype_infos the time unit of every output column
+	 */
+	presized_table(size_t num_files,
+		std::vector<gdf_size_type> row_offsets,
+		gdf_size_type total_rows,
+		std::vector<gdf_dtype> dtypes,
+		std::vector<gdf_dtype_extra_info> dtype_infos)
+		: string_columns_per_file(num_files), row_offsets(row_offsets), total_rows{total_rows}, dtypes(dtypes),
+		  dtype_infos(dtype_infos) {}
+
+	void append(size_t file_index, const std::vector<gdf_column_cpp> & file_columns) {
+		if(file_columns.size() == 0) {
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(output_mutex);
+		if(columns.size() == 0) {
+			allocate(file_columns);
+		}
+		if(file_columns.size() != columns.size()) {
+			throw std::runtime_error{"In data_loader::load_data function: files have a different number of columns"};
+		}
+
+		gdf_size_type num_rows = file_columns[0].size();
+		for(size_t i = 0; i < columns.size(); i++) {
+			if(is_string_column[i] != (file_columns[i].dtype() == GDF_STRING_CATEGORY)) {
+				throw std::runtime_error{
+					"In data_loader::load_data function: column " + file_columns[i].name() + " has different types"};
+			}
+
+			if(is_string_column[i]) {
+				string_columns_per_file[file_index].push_back(file_columns[i]);
+			} else if(num_rows > 0) {
+				gdf_column_cpp file_column = cast_to_output_type(file_columns[i], columns[i]);
+				cudf::copy_range(columns[i].get_gdf_column(),
+					*file_column.get_gdf_column(),
+					row_offsets[file_index],
+					row_offsets[file_index] + num_rows,
+					0);
+			}
+		}
+	}
+
+	std::vector<gdf_column_cpp> release() {
+		std::lock_guard<std::mutex> lock(output_mutex);
+		for(size_t i = 0; i < columns.size(); i++) {
+			if(!is_string_column[i]) {
+				columns[i].update_null_count();
+			}
+		}
+
+		if(std::find(is_string_column.begin(), is_string_column.end(), true) != is_string_column.end()) {
+			std::vector<std::vector<gdf_column_cpp>> string_tables;
+			for(std::vector<gdf_column_cpp> & string_columns : string_columns_per_file) {
+				if(string_columns.size() > 0) {
+					string_tables.push_back(std::move(string_columns));
+				}
+			}
+
+			std::vector<gdf_column_cpp> string_columns = ral::utilities::concatTables(string_tables);
+			for(size_t i = 0, string_index = 0; i < columns.size(); i++) {
+				if(is_string_column[i]) {
+					columns[i] = string_columns[string_index++];
+				}
+			}
+		}
+
+		std::vector<gdf_column_cpp> output;
+		output.swap(columns);
+		return output;
+	}
+
+private:
+	void allocate(const std::vector<gdf_column_cpp> & file_columns) {
+		if(file_columns.size() != dtypes.size()) {
+			throw std::runtime_error{
+				"In data_loader::load_data function: files do not have the number of columns of the schema"};
+		}
+
+		columns.resize(file_columns.size());
+		is_string_column.resize(file_columns.size());
+		for(size_t i = 0; i < file_columns.size(); i++) {
+			is_string_column[i] = dtypes[i] == GDF_STRING || dtypes[i] == GDF_STRING_CATEGORY;
+			if(!is_string_column[i]) {
+				columns[i].create_gdf_column(dtypes[i],
+					dtype_infos[i],
+					total_rows,
+					nullptr,
+					ral::traits::get_dtype_size_in_bytes(dtypes[i]),
+					file_columns[i].name());
+			}
+		}
+	}
+
+	gdf_column_cpp cast_to_output_type(const gdf_column_cpp & file_column, gdf_column_cpp & output_column) {
+		if(file_column.dtype() == output_column.dtype() &&
+			(file_column.dtype() != GDF_TIMESTAMP ||
+				file_column.dtype_info().time_unit == output_column.dtype_info().time_unit)) {
+			return file_column;
+		}
+
+		gdf_column_cpp casted_column = file_column;
+		gdf_column raw_column_out = cudf::cast(
+			*(casted_column.get_gdf_column()), output_column.dtype(), output_column.dtype_info());
+		gdf_column * temp_raw_column = new gdf_column{};
+		*temp_raw_column = raw_column_out;
+		casted_column.create_gdf_column(temp_raw_column);
+		casted_column.set_name(file_column.name());
+		return casted_column;
+	}
+
+	std::vector<gdf_column_cpp> columns;
+	std::vector<bool> is_string_column;
+	std::vector<std::vector<gdf_column_cpp>> string_columns_per_file;
+	std::vector<gdf_size_type> row_offsets;
+	gdf_size_type total_rows;
+	std::vector<gdf_dtype> dtypes;
+	std::vector<gdf_dtype_extra_info> dtype_infos;
+	std::mutex output_mutex;
+};
+
+/**
+ * types of the columns returned by load_file, the parsed columns in the order of column_indices followed by the
+ * columns that are not in the file in schema order
+ */
+void get_output_types(const Schema & schema,
+	const std::vector<size_t> & column_indices,
+	std::vector<gdf_dtype> & dtypes,
+	std::vector<gdf_dtype_extra_info> & dtype_infos) {
+	std::vector<gdf_dtype> schema_dtypes = schema.get_dtypes();
+	std::vector<gdf_time_unit> schema_time_units = schema.get_time_units();
+	std::vector<bool> in_file = schema.get_in_file();
+
+	// column_indices refer to the schema of the file, which only has the columns that are in the file
+	std::vector<size_t> file_to_schema_indices;
+	std::vector<size_t> schema_indices;
+	for(size_t i = 0; i < schema.get_num_columns(); i++) {
+		if(in_file[i]) {
+			file_to_schema_indices.push_back(i);
+		}
+	}
+	if(column_indices.size() > 0) {
+		for(size_t column_index : column_indices) {
+			schema_indices.push_back(file_to_schema_indices[column_index]);
+		}
+	} else {
+		schema_indices = file_to_schema_indices;
+	}
+	for(size_t i = 0; i < schema.get_num_columns(); i++) {
+		if(!in_file[i]) {
+			schema_indices.push_back(i);
+		}
+	}
+
+	for(size_t schema_index : schema_indices) {
+		gdf_time_unit time_unit =
+			schema_index < schema_time_units.size() ? schema_time_units[schema_index] : TIME_UNIT_NONE;
+		if(time_unit == TIME_UNIT_NONE && (schema_dtypes[schema_index] == GDF_TIMESTAMP || !in_file[schema_index])) {
+			time_unit = TIME_UNIT_ms;
+		}
+		dtypes.push_back(schema_dtypes[schema_index]);
+		dtype_infos.push_back(gdf_dtype_extra_info{time_unit});
+	}
+}
+
 }  // namespace
 
 data_loader::data_loader(std::shared_ptr<data_parser> _parser, std::shared_ptr<data_provider> _data_provider)
@@ -27,84 +276,134 @@ data_loader::~data_loader() {}
 void data_loader::load_data(const Context & context,
 	std::vector<gdf_column_cpp> & columns,
 	const std::vector<size_t> & column_indices,
-	const Schema & schema) {
-	static CodeTimer timer;
-	timer.reset();
+	const Schema & schema,
+	const std::string & filter_condition) {
+	CodeTimer timer;
+
+	// the columns of the condition are the loaded columns
+	std::vector<std::string> loaded_column_names;
+	for(size_t i = 0; i < (column_indices.size() > 0 ? column_indices.size() : schema.get_num_columns()); i++) {
+		loaded_column_names.push_back(schema.get_name(column_indices.size() > 0 ? column_indices[i] : i));
+	}
+	row_group_filter filter(filter_condition, loaded_column_names);
+	std::atomic<size_t> row_groups_pruned{0};
+	std::atomic<size_t> row_groups_read{0};
 
-	std::vector<std::vector<gdf_column_cpp>> columns_per_file;  // stores all of the columns parsed from each file
 	std::vector<std::string> user_readable_file_handles;
 	std::vector<data_handle> files;
 
 	// iterates through files and parses them into columns
 	while(this->provider->has_next()) {
-		// std::cout<<"pushing back files!"<<std::endl;
 		// a file handle that we can use in case errors occur to tell the user which file had parsing issues
 		user_readable_file_handles.push_back(this->provider->get_current_user_readable_file_handle());
 		files.push_back(this->provider->get_next());
 	}
-	// std::cout<<"pushed back"<<std::endl;
 
-	columns_per_file.resize(files.size());
-	// TODO NOTE percy c.gonzales rommel fix our concurrent reads here (better use of thread)
-	// make sure cudf supports concurrent reads
-	std::vector<std::thread> threads;
-
-	for(int file_index = 0; file_index < files.size(); file_index++) {
-		threads.push_back(std::thread([&, file_index]() {
-			// std::cout<<"starting file thread"<<std::endl;
-			std::vector<gdf_column_cpp> converted_data;
-			// std::cout<<"converted data"<<std::endl;
+	// files that are split between nodes only have some of their row groups read here
+	std::vector<std::vector<int>> file_row_group_ids = schema.get_row_group_ids();
+	file_row_group_ids.resize(files.size());
+	bool reads_whole_files = std::all_of(file_row_group_ids.begin(),
+		file_row_group_ids.end(),
+		[](const std::vector<int> & row_group_ids) { return row_group_ids.empty(); });
 
+	// when the metadata gave us the number of rows of every file the output is allocated once and every file is copied
+	// into its slice as soon as it is parsed, otherwise all the files are kept until they can be concatenated. Files
+	// that are filtered while parsed, or only partly read, do not have a known number of rows
+	std::vector<size_t> file_num_rows = schema.get_num_rows();
+	bool presize =
+		files.size() > 1 && file_num_rows.size() == files.size() && filter.empty() && reads_whole_files;
+	std::vector<gdf_size_type> row_offsets(files.size(), 0);
+	gdf_size_type total_rows = 0;
+	if(presize) {
+		for(size_t file_index = 0; file_index < files.size(); file_index++) {
+			row_offsets[file_index] = total_rows;
 			if(files[file_index].fileHandle != nullptr) {
-				// std::cout<<"get num columns==>"<<schema.get_num_columns()<<std::endl;
-				// std::cout<<"file is "<< user_readable_file_handles[file_index]<<" with uri
-				// "<<files[file_index].uri.getPath().toString()<<std::endl;
-				Schema fileSchema = schema.fileSchema();
-				parser->parse(files[file_index].fileHandle,
-					user_readable_file_handles[file_index],
-					converted_data,
-					fileSchema,
-					column_indices);
-				// std::cout<<"parsed file got "<<converted_data.size()<<" columns!"<<std::endl;
-				for(int i = 0; i < schema.get_num_columns(); i++) {
-					if(!schema.get_in_file()[i]) {
-						// std::cout<<"creating column!"<<std::endl;
-						auto num_rows = converted_data[0].size();
-						std::string name = schema.get_name(i);
-						if(files[file_index].is_column_string[name]) {
-							std::string string_value = files[file_index].string_values[name];
-							NVCategory * category = repeated_string_category(string_value, num_rows);
-							gdf_column_cpp column;
-							column.create_gdf_column(category, num_rows, name);
-							converted_data.push_back(column);
-						} else {
-							gdf_scalar scalar = files[file_index].column_values[name];
-
-							gdf_column_cpp column;
-							column.create_gdf_column(scalar.dtype,
-								gdf_dtype_extra_info{TIME_UNIT_ms},
-								num_rows,
-								nullptr,
-								ral::traits::get_dtype_size_in_bytes(scalar.dtype),
-								name);
-							cudf::fill(column.get_gdf_column(), scalar, 0, num_rows);
-							converted_data.push_back(column);
+				total_rows += file_num_rows[file_index];
+			}
+		}
+	}
+
+	std::vector<std::vector<gdf_column_cpp>> columns_per_file(presize ? 0 : files.size());
+	std::vector<gdf_dtype> output_dtypes;
+	std::vector<gdf_dtype_extra_info> output_dtype_infos;
+	if(presize) {
+		get_output_types(schema, column_indices, output_dtypes, output_dtype_infos);
+	}
+	presized_table output(files.size(), row_offsets, total_rows, output_dtypes, output_dtype_infos);
+
+	// a fixed number of workers take the files in order, so there are never more files being read or waiting to be
+	// appended than workers
+	size_t num_workers = std::min(
+		std::max(ral::config::BlazingConfig::getInstance().getDataLoaderThreads(), size_t{1}), files.size());
+	std::atomic<size_t> next_file_index{0};
+	std::atomic<bool> failed{false};
+	std::exception_ptr load_error;
+	std::mutex load_error_mutex;
+	int device_id = 0;
+	cudaGetDevice(&device_id);
+
+	std::vector<std::thread> workers;
+	for(size_t worker_index = 0; worker_index < num_workers; worker_index++) {
+		workers.push_back(std::thread([&]() {
+			cudaSetDevice(device_id);
+			try {
+				while(!failed) {
+					size_t file_index = next_file_index++;
+					if(file_index >= files.size()) {
+						break;
+					}
+
+					if(files[file_index].fileHandle == nullptr) {
+						Library::Logging::Logger().logError(ral::utilities::buildLogString(
+							"", "", "", "ERROR: Was unable to open " + user_readable_file_handles[file_index]));
+						continue;
+					}
+
+					row_group_counts counts;
+					std::vector<gdf_column_cpp> converted_data = load_file(*parser,
+						files[file_index],
+						user_readable_file_handles[file_index],
+						schema,
+						column_indices,
+						filter,
+						file_row_group_ids[file_index],
+						counts);
+					row_groups_pruned += counts.pruned;
+					row_groups_read += counts.read;
+
+					if(presize) {
+						size_t num_rows = converted_data.size() > 0 ? converted_data[0].size() : 0;
+						if(converted_data.size() > 0 && num_rows != file_num_rows[file_index]) {
+							throw std::runtime_error{"In data_loader::load_data function: " +
+													 user_readable_file_handles[file_index] + " has " +
+													 std::to_string(num_rows) + " rows but its metadata says " +
+													 std::to_string(file_num_rows[file_index])};
 						}
-						// std::cout<<"created column!"<<std::endl;
+						output.append(file_index, converted_data);
+					} else {
+						columns_per_file[file_index] = converted_data;
 					}
 				}
-
-				columns_per_file[file_index] = converted_data;
-			} else {
-				Library::Logging::Logger().logError(ral::utilities::buildLogString(
-					"", "", "", "ERROR: Was unable to open " + user_readable_file_handles[file_index]));
+			} catch(...) {
+				std::lock_guard<std::mutex> lock(load_error_mutex);
+				if(!load_error) {
+					load_error = std::current_exception();
+				}
+				failed = true;
 			}
 		}));
 	}
 
-	std::for_each(threads.begin(), threads.end(), [](std::thread & this_thread) { this_thread.join(); });
-	// std::cout<<"finished loading!"<<std::endl;
+	std::for_each(workers.begin(), workers.end(), [](std::thread & this_thread) { this_thread.join(); });
 	Library::Logging::Logger().logInfo(timer.logDuration(context, "data_loader::load_data part 1 parse"));
+	if(!filter.empty()) {
+		Library::Logging::Logger().logInfo(timer.logDuration(context,
+			"data_loader::load_data row group pruning",
+			"row groups pruned",
+			row_groups_pruned,
+			"row groups read",
+			row_groups_read));
+	}
 	timer.reset();
 
 	// checking if any errors occurred
@@ -118,6 +417,22 @@ void data_loader::load_data(const Context & context,
 
 	this->provider->reset();
 
+	if(load_error) {
+		std::rethrow_exception(load_error);
+	}
+
+	if(presize) {
+		columns = output.release();
+		if(columns.size() == 0) {  // we got no data
+			parser->parse(nullptr, "", columns, schema, column_indices);
+			return;
+		}
+
+		Library::Logging::Logger().logInfo(timer.logDuration(context, "data_loader::load_data part 2 concat"));
+		timer.reset();
+		return;
+	}
+
 	size_t num_columns, num_files = columns_per_file.size();
 
 	if(num_files > 0)
@@ -128,19 +443,12 @@ void data_loader::load_data(const Context & context,
 		parser->parse(nullptr, "", columns, schema, column_indices);
 		return;
 	}
-	// std::cout<<"reset provider num cols is "<<num_columns<<std::endl;
-	// be replacing no longer needed gdf_column_cpp with this dummy column we can
-	// make columns go out of scope while still preserving the size of the vector
-	gdf_column_cpp dummy_column;
-
 
 	if(num_files == 1) {  // we have only one file so we can just return the columns we parsed from that file
 		columns = columns_per_file[0];
 
 	} else {  // we have more than one file so we need to concatenate
-			  // std::cout<<"concatting!"<<std::endl;
 		columns = ral::utilities::concatTables(columns_per_file);
-		// std::cout<<"concatted!"<<std::endl;
 	}
 
 	Library::Logging::Logger().logInfo(timer.logDuration(context, "data_loader::load_data part 2 concat"));
@@ -149,12 +457,14 @@ void data_loader::load_data(const Context & context,
 
 void data_loader::get_schema(Schema & schema, std::vector<std::pair<std::string, gdf_dtype>> non_file_columns) {
 	std::vector<std::shared_ptr<arrow::io::RandomAccessFile>> files;
+	std::vector<std::string> metadata_keys;
 	bool firstIteration = true;
 	std::vector<data_handle> handles = this->provider->get_all();
 	for(auto handle : handles) {
 		files.push_back(handle.fileHandle);
+		metadata_keys.push_back(get_metadata_key(handle));
 	}
-	this->parser->parse_schema(files, schema);
+	this->parser->parse_schema(files, metadata_keys, schema);
 
 	for(auto handle : handles) {
 		schema.add_file(handle.uri.toString(true));
@@ -45,12 +45,19 @@ public:
 	 * by this function
 	 * @param include_column the different files we can read from can have more columns than we actual want to read,
 	 * this lest us filter some of them out
+	 *
+	 * Files are parsed by a fixed number of workers (BlazingConfig::getDataLoaderThreads). When the schema has the
+	 * number of rows of every file the output columns are allocated up front and each file is copied into them as soon
+	 * as it is parsed.
+	 * @param filter_condition the filter of the scan, parsers that have statistics about their files (i.e. parquet)
+	 * use it to skip data that can not satisfy it. The columns that are returned still have to be filtered
 	 */
 
 	void load_data(const Context & context,
 		std::vector<gdf_column_cpp> & columns,
 		const std::vector<size_t> & column_indices,
-		const Schema & schema);
+		const Schema & schema,
+		const std::string & filter_condition = "");
 	void get_schema(Schema & schema, std::vector<std::pair<std::string, gdf_dtype>> non_file_columns);
 
 private:
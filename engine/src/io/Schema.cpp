@@ -42,9 +42,10 @@ Schema::Schema(std::vector<std::string> names,
 	std::vector<size_t> calcite_to_file_indices,
 	std::vector<gdf_dtype> types,
 	std::vector<gdf_time_unit> time_units,
-	std::vector<size_t> num_row_groups)
+	std::vector<size_t> num_row_groups,
+	std::vector<size_t> num_rows)
 	: names(names), calcite_to_file_indices(calcite_to_file_indices), types(types), time_units(time_units),
-	  num_row_groups(num_row_groups) {
+	  num_row_groups(num_row_groups), num_rows(num_rows) {
 	// TODO Auto-generated constructor stub
 
 	in_file.resize(names.size(), true);
@@ -55,9 +56,10 @@ Schema::Schema(std::vector<std::string> names,
 	std::vector<gdf_dtype> types,
 	std::vector<size_t> num_row_groups,
 	std::vector<gdf_time_unit> time_units,
-	std::vector<bool> in_file)
+	std::vector<bool> in_file,
+	std::vector<size_t> num_rows)
 	: names(names), calcite_to_file_indices(calcite_to_file_indices), types(types), num_row_groups(num_row_groups),
-	  time_units(time_units), in_file(in_file) {
+	  num_rows(num_rows), time_units(time_units), in_file(in_file) {
 	if(in_file.size() != names.size()) {
 		this->in_file.resize(names.size(), true);
 	}
@@ -33,14 +33,16 @@ public:
 		std::vector<size_t> calcite_to_file_indices,
 		std::vector<gdf_dtype> types,
 		std::vector<gdf_time_unit> time_units,
-		std::vector<size_t> num_row_groups);
+		std::vector<size_t> num_row_groups,
+		std::vector<size_t> num_rows = {});
 
 	Schema(std::vector<std::string> names,
 		std::vector<size_t> calcite_to_file_indices,
 		std::vector<gdf_dtype> types,
 		std::vector<size_t> num_row_groups,
 		std::vector<gdf_time_unit> time_units,
-		std::vector<bool> in_file);
+		std::vector<bool> in_file,
+		std::vector<size_t> num_rows = {});
 
 	Schema(std::vector<std::string> names, std::vector<gdf_dtype> types, std::vector<gdf_time_unit> time_units);
 
@@ -56,6 +58,17 @@ public:
 	std::string get_type(size_t schema_index) const;
 	std::vector<size_t> get_calcite_to_file_indices() const { return this->calcite_to_file_indices; }
 	std::vector<size_t> get_num_row_groups() const { return this->num_row_groups; }
+	/**
+	 * number of rows of each file, only known for the file formats that have it in their metadata (i.e. parquet),
+	 * empty otherwise
+	 */
+	std::vector<size_t> get_num_rows() const { return this->num_rows; }
+	/**
+	 * row groups to read of each file, when the file is split between nodes. An empty list, or no list, means all of
+	 * them
+	 */
+	std::vector<std::vector<int>> get_row_group_ids() const { return this->row_group_ids; }
+	void set_row_group_ids(const std::vector<std::vector<int>> & row_group_ids) { this->row_group_ids = row_group_ids; }
 	Schema fileSchema() const;
 	size_t get_file_index(size_t schema_index) const;
 
@@ -85,6 +98,8 @@ private:
 	std::vector<gdf_dtype> types;
 	std::vector<gdf_time_unit> time_units;
 	std::vector<size_t> num_row_groups;
+	std::vector<size_t> num_rows;
+	std::vector<std::vector<int>> row_group_ids;
 	std::vector<bool> in_file;
 	std::vector<std::string> files;
 };
@@ -10,13 +10,24 @@
 
 #include "../Schema.h"
 #include "GDFColumn.cuh"
+#include "RowGroupFilter.h"
 #include "arrow/io/interfaces.h"
 #include <memory>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
 namespace ral {
 namespace io {
 
+/**
+ * how many row groups a parser skipped because of the filter of the scan and how many it decoded
+ */
+struct row_group_counts {
+	size_t pruned = 0;
+	size_t read = 0;
+};
+
 class data_parser {
 public:
 	/**
@@ -31,8 +42,42 @@ public:
 		std::vector<size_t> column_indices) = 0;
 
 
+	/**
+	 * same as parse, but the parser can skip the parts of the file that can not have rows satisfying the filter. The
+	 * rows that are read still have to be filtered. The filter can be empty, parsers of remote files also use this call
+	 * to announce the byte ranges they are about to read. By default the whole file is read
+	 * @param metadata_key key of the file in the metadata_cache, empty if its metadata can not be cached
+	 * @param row_group_ids the only row groups to read, all of them if empty. Only the parsers of formats with row
+	 * groups (i.e. parquet) support it
+	 */
+	virtual row_group_counts parse_filtered(std::shared_ptr<arrow::io::RandomAccessFile> file,
+		const std::string & user_readable_file_handle,
+		const std::string & metadata_key,
+		std::vector<gdf_column_cpp> & columns,
+		const Schema & schema,
+		std::vector<size_t> column_indices,
+		const row_group_filter & filter,
+		const std::vector<int> & row_group_ids) {
+		if(!row_group_ids.empty()) {
+			throw std::runtime_error{"In data_parser::parse_filtered function: " + user_readable_file_handle +
+									 " can not be read by row groups"};
+		}
+		parse(file, user_readable_file_handle, columns, schema, column_indices);
+		return row_group_counts{};
+	}
+
 	virtual void parse_schema(
 		std::vector<std::shared_ptr<arrow::io::RandomAccessFile>> files, ral::io::Schema & schema) = 0;
+
+	/**
+	 * same as parse_schema, parsers that read file footers take them from the metadata_cache when they are there
+	 * @param metadata_keys key of each file in the metadata_cache, empty if its metadata can not be cached
+	 */
+	virtual void parse_schema(std::vector<std::shared_ptr<arrow::io::RandomAccessFile>> files,
+		const std::vector<std::string> & metadata_keys,
+		ral::io::Schema & schema) {
+		parse_schema(files, schema);
+	}
 };
 
 } /* namespace io */
@@ -0,0 +1,88 @@
+#include "MetadataCache.h"
+
+#include "config/BlazingConfig.h"
+
+namespace ral {
+namespace io {
+
+metadata_cache & metadata_cache::getInstance() {
+	static metadata_cache cache(ral::config::BlazingConfig::getInstance().getMetadataCacheSize());
+	return cache;
+}
+
+metadata_cache::metadata_cache(size_t capacity_in_bytes)
+	: capacity_in_bytes{capacity_in_bytes}, size_in_bytes{0}, hits{0}, misses{0} {}
+
+std::string metadata_cache::make_key(
+	const std::string & uri, unsigned long long file_size, const std::string & version) {
+	if(uri.empty() || version.empty()) {
+		return "";
+	}
+	return uri + "|" + std::to_string(file_size) + "|" + version;
+}
+
+std::shared_ptr<const file_metadata> metadata_cache::get(const std::string & key) {
+	std::lock_guard<std::mutex> lock(cache_mutex);
+	auto it = index.find(key);
+	if(it == index.end()) {
+		misses++;
+		return nullptr;
+	}
+	hits++;
+	entries.splice(entries.begin(), entries, it->second);
+	return it->second->second;
+}
+
+void metadata_cache::put(const std::string & key, std::shared_ptr<const file_metadata> metadata) {
+	if(key.empty() || metadata == nullptr || metadata->size_in_bytes > capacity_in_bytes) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(cache_mutex);
+	auto it = index.find(key);
+	if(it != index.end()) {
+		size_in_bytes -= it->second->second->size_in_bytes;
+		entries.erase(it->second);
+		index.erase(it);
+	}
+
+	while(!entries.empty() && size_in_bytes + metadata->size_in_bytes > capacity_in_bytes) {
+		size_in_bytes -= entries.back().second->size_in_bytes;
+		index.erase(entries.back().first);
+		entries.pop_back();
+	}
+
+	entries.emplace_front(key, metadata);
+	index[key] = entries.begin();
+	size_in_bytes += metadata->size_in_bytes;
+}
+
+void metadata_cache::clear() {
+	std::lock_guard<std::mutex> lock(cache_mutex);
+	entries.clear();
+	index.clear();
+	size_in_bytes = 0;
+}
+
+size_t metadata_cache::get_hits() const {
+	std::lock_guard<std::mutex> lock(cache_mutex);
+	return hits;
+}
+
+size_t metadata_cache::get_misses() const {
+	std::lock_guard<std::mutex> lock(cache_mutex);
+	return misses;
+}
+
+size_t metadata_cache::get_num_entries() const {
+	std::lock_guard<std::mutex> lock(cache_mutex);
+	return entries.size();
+}
+
+size_t metadata_cache::get_size_in_bytes() const {
+	std::lock_guard<std::mutex> lock(cache_mutex);
+	return size_in_bytes;
+}
+
+}  // namespace io
+}  // namespace ral
@@ -0,0 +1,105 @@
+/*
+ * MetadataCache.h
+ *
+ * Process wide cache of the metadata the parsers read from file footers
+ */
+
+#ifndef METADATACACHE_H_
+#define METADATACACHE_H_
+
+#include <cudf/cudf.h>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace parquet {
+class FileMetaData;
+}
+
+namespace ral {
+namespace io {
+
+/**
+ * what a parser learned from the footer of a file
+ */
+struct file_metadata {
+	// schema of the file as the engine reads it
+	std::vector<std::string> names;
+	std::vector<gdf_dtype> dtypes;
+	std::vector<gdf_time_unit> time_units;
+
+	size_t num_rows = 0;
+	size_t num_row_groups = 0;
+
+	// decoded footer of a parquet file, including the statistics of its row groups. Null for other formats
+	std::shared_ptr<parquet::FileMetaData> parquet_metadata;
+
+	// approximate memory used by the entry, counted against the size of the cache
+	size_t size_in_bytes = 0;
+};
+
+/**
+ * LRU cache of file metadata, limited by the total size of its entries.
+ *
+ * Entries are keyed on the uri, size and version (ETag or modification time) of the file, so a file that changes gets
+ * a new key and its old entry is eventually evicted. Files whose file system does not report a version are not cached.
+ */
+class metadata_cache {
+public:
+	static metadata_cache & getInstance();
+
+	explicit metadata_cache(size_t capacity_in_bytes);
+
+	/**
+	 * @return the key for a version of a file, or an empty string if the file can not be cached
+	 */
+	static std::string make_key(const std::string & uri, unsigned long long file_size, const std::string & version);
+
+	/**
+	 * @return the metadata cached for key, or nullptr if there is none
+	 */
+	std::shared_ptr<const file_metadata> get(const std::string & key);
+
+	/**
+	 * caches metadata for key, evicting the least recently used entries until it fits. Empty keys and entries larger
+	 * than the whole cache are ignored
+	 */
+	void put(const std::string & key, std::shared_ptr<const file_metadata> metadata);
+
+	void clear();
+
+	size_t get_hits() const;
+
+	size_t get_misses() const;
+
+	size_t get_num_entries() const;
+
+	size_t get_size_in_bytes() const;
+
+	size_t get_capacity() const { return capacity_in_bytes; }
+
+private:
+	metadata_cache(const metadata_cache &) = delete;
+
+	metadata_cache & operator=(const metadata_cache &) = delete;
+
+private:
+	using entry = std::pair<std::string, std::shared_ptr<const file_metadata>>;
+
+	const size_t capacity_in_bytes;
+	// most recently used first
+	std::list<entry> entries;
+	std::unordered_map<std::string, std::list<entry>::iterator> index;
+	size_t size_in_bytes;
+	size_t hits;
+	size_t misses;
+	mutable std::mutex cache_mutex;
+};
+
+}  // namespace io
+}  // namespace ral
+
+#endif /* METADATACACHE_H_ */
@@ -11,6 +11,7 @@
 #include <GDFCounter.cuh>
 
 #include "../Schema.h"
+#include "io/data_parser/MetadataCache.h"
 #include "io/data_parser/ParserUtil.h"
 
 #include <numeric>
@@ -73,17 +74,42 @@ void orc_parser::parse(std::shared_ptr<arrow::io::RandomAccessFile> file,
 
 void orc_parser::parse_schema(
 	std::vector<std::shared_ptr<arrow::io::RandomAccessFile>> files, ral::io::Schema & schema_out) {
-	orc_args.source = cudf::source_info(files[0]);
-	orc_args.num_rows = 1;
+	parse_schema(files, {}, schema_out);
+}
+
+void orc_parser::parse_schema(std::vector<std::shared_ptr<arrow::io::RandomAccessFile>> files,
+	const std::vector<std::string> & metadata_keys,
+	ral::io::Schema & schema_out) {
+	std::string metadata_key = metadata_keys.size() > 0 ? metadata_keys[0] : "";
+	std::shared_ptr<const file_metadata> metadata;
+	if(!metadata_key.empty()) {
+		metadata = metadata_cache::getInstance().get(metadata_key);
+	}
 
-	cudf::table table_out = cudf::read_orc(orc_args);
-	assert(table_out.num_columns() > 0);
+	if(metadata == nullptr) {
+		auto orc_args = this->orc_args;  // force a copy
+		orc_args.source = cudf::source_info(files[0]);
+		orc_args.num_rows = 1;
+
+		cudf::table table_out = cudf::read_orc(orc_args);
+		assert(table_out.num_columns() > 0);
+
+		std::shared_ptr<file_metadata> read_metadata = std::make_shared<file_metadata>();
+		for(size_t i = 0; i < table_out.num_columns(); i++) {
+			gdf_column_cpp c;
+			c.create_gdf_column(table_out.get_column(i));
+			c.set_name(table_out.get_column(i)->col_name);
+			read_metadata->names.push_back(c.name());
+			read_metadata->dtypes.push_back(c.dtype());
+			read_metadata->time_units.push_back(c.dtype_info().time_unit);
+			read_metadata->size_in_bytes += c.name().size() + sizeof(gdf_dtype) + sizeof(gdf_time_unit);
+		}
+		metadata_cache::getInstance().put(metadata_key, read_metadata);
+		metadata = read_metadata;
+	}
 
-	for(size_t i = 0; i < table_out.num_columns(); i++) {
-		gdf_column_cpp c;
-		c.create_gdf_column(table_out.get_column(i));
-		c.set_name(table_out.get_column(i)->col_name);
-		schema_out.add_column(c, i);
+	for(size_t i = 0; i < metadata->names.size(); i++) {
+		schema_out.add_column(metadata->names[i], metadata->dtypes[i], i, true, metadata->time_units[i]);
 	}
 }
 
@@ -22,6 +22,13 @@ public:
 
 	void parse_schema(std::vector<std::shared_ptr<arrow::io::RandomAccessFile>> files, Schema & schema);
 
+	/**
+	 * the schema of the first file is cached, so it only has to be read once
+	 */
+	void parse_schema(std::vector<std::shared_ptr<arrow::io::RandomAccessFile>> files,
+		const std::vector<std::string> & metadata_keys,
+		Schema & schema);
+
 private:
 	cudf::orc_read_arg orc_args{cudf::source_info{""}};
 };
@@ -7,13 +7,16 @@
 
 #include "ParquetParser.h"
 #include "config/GPUManager.cuh"
+#include <blazingdb/io/FileSystem/CoalescingReadableFile.h>
 #include <blazingdb/io/Util/StringUtil.h>
 #include <cudf/legacy/column.hpp>
 #include <cudf/legacy/io_functions.hpp>
 
 #include <arrow/io/file.h>
 #include <parquet/file_reader.h>
+#include <parquet/metadata.h>
 #include <parquet/schema.h>
+#include <parquet/statistics.h>
 #include <parquet/types.h>
 #include <thread>
 
@@ -21,9 +24,12 @@
 #include <GDFCounter.cuh>
 
 #include "../Schema.h"
+#include "io/data_parser/MetadataCache.h"
 #include "io/data_parser/ParserUtil.h"
+#include "utilities/CommonOperations.h"
 
 #include <numeric>
+#include <set>
 
 namespace ral {
 namespace io {
@@ -36,53 +42,6 @@ parquet_parser::~parquet_parser() {
 	// TODO Auto-generated destructor stub
 }
 
-void parquet_parser::parse(std::shared_ptr<arrow::io::RandomAccessFile> file,
-	const std::string & user_readable_file_handle,
-	std::vector<gdf_column_cpp> & columns_out,
-	const Schema & schema,
-	std::vector<size_t> column_indices) {
-	if(column_indices.size() == 0) {  // including all columns by default
-		column_indices.resize(schema.get_num_columns());
-		std::iota(column_indices.begin(), column_indices.end(), 0);
-	}
-
-	if(file == nullptr) {
-		columns_out =
-			create_empty_columns(schema.get_names(), schema.get_dtypes(), schema.get_time_units(), column_indices);
-		return;
-	}
-
-	if(column_indices.size() > 0) {
-		// Fill data to pq_args
-		cudf::io::parquet::reader_options pq_args;
-		pq_args.strings_to_categorical = false;
-		pq_args.columns.resize(column_indices.size());
-
-		for(size_t column_i = 0; column_i < column_indices.size(); column_i++) {
-			pq_args.columns[column_i] = schema.get_name(column_indices[column_i]);
-		}
-
-		cudf::io::parquet::reader parquet_reader(file, pq_args);
-
-		cudf::table table_out = parquet_reader.read_all();
-
-		assert(table_out.num_columns() > 0);
-
-		columns_out.resize(column_indices.size());
-		for(size_t i = 0; i < columns_out.size(); i++) {
-			if(table_out.get_column(i)->dtype == GDF_STRING) {
-				NVStrings * strs = static_cast<NVStrings *>(table_out.get_column(i)->data);
-				NVCategory * category = NVCategory::create_from_strings(*strs);
-				std::string column_name(table_out.get_column(i)->col_name);
-				columns_out[i].create_gdf_column(category, table_out.get_column(i)->size, column_name);
-				gdf_column_free(table_out.get_column(i));
-			} else {
-				columns_out[i].create_gdf_column(table_out.get_column(i));
-			}
-		}
-	}
-}
-
 // This function is copied and adapted from cudf
 constexpr std::pair<gdf_dtype, gdf_dtype_extra_info> to_dtype(parquet::Type::type physical,
 	parquet::ConvertedType::type logical,
@@ -126,18 +85,240 @@ constexpr std::pair<gdf_dtype, gdf_dtype_extra_info> to_dtype(parquet::Type::typ
 	return std::make_pair(GDF_invalid, gdf_dtype_extra_info{TIME_UNIT_NONE});
 }
 
+namespace {
+
+cudf::io::parquet::reader_options get_reader_options(
+	const Schema & schema, const std::vector<size_t> & column_indices) {
+	cudf::io::parquet::reader_options pq_args;
+	pq_args.strings_to_categorical = false;
+	pq_args.columns.resize(column_indices.size());
+
+	for(size_t column_i = 0; column_i < column_indices.size(); column_i++) {
+		pq_args.columns[column_i] = schema.get_name(column_indices[column_i]);
+	}
+	return pq_args;
+}
+
+std::vector<gdf_column_cpp> to_columns(cudf::table & table_out) {
+	assert(table_out.num_columns() > 0);
+
+	std::vector<gdf_column_cpp> columns_out(table_out.num_columns());
+	for(size_t i = 0; i < columns_out.size(); i++) {
+		if(table_out.get_column(i)->dtype == GDF_STRING) {
+			NVStrings * strs = static_cast<NVStrings *>(table_out.get_column(i)->data);
+			NVCategory * category = NVCategory::create_from_strings(*strs);
+			std::string column_name(table_out.get_column(i)->col_name);
+			columns_out[i].create_gdf_column(category, table_out.get_column(i)->size, column_name);
+			gdf_column_free(table_out.get_column(i));
+		} else {
+			columns_out[i].create_gdf_column(table_out.get_column(i));
+		}
+	}
+	return columns_out;
+}
+
+
+// the statistics of some columns of a row group, by column name
+std::map<std::string, column_statistics> get_row_group_statistics(const parquet::RowGroupMetaData & row_group,
+	const parquet::SchemaDescriptor & file_schema,
+	const std::vector<std::string> & column_names) {
+	std::map<std::string, column_statistics> statistics;
+	for(const std::string & column_name : column_names) {
+		int column_index = file_schema.ColumnIndex(column_name);
+		if(column_index >= 0) {
+			statistics[column_name] =
+				get_column_statistics(*row_group.ColumnChunk(column_index), *file_schema.Column(column_index));
+		}
+	}
+	return statistics;
+}
+
+// the bytes of a column chunk in the file, as position and number of bytes
+std::pair<int64_t, int64_t> get_column_chunk_range(const parquet::ColumnChunkMetaData & column_metadata) {
+	int64_t position = column_metadata.data_page_offset();
+	if(column_metadata.has_dictionary_page() && column_metadata.dictionary_page_offset() > 0) {
+		position = std::min(position, column_metadata.dictionary_page_offset());
+	}
+	return std::make_pair(position, column_metadata.total_compressed_size());
+}
+
+// reads the footer of a parquet file, or takes it from the metadata cache when it was already read
+std::shared_ptr<const file_metadata> get_file_metadata(
+	std::shared_ptr<arrow::io::RandomAccessFile> file, const std::string & metadata_key) {
+	if(!metadata_key.empty()) {
+		std::shared_ptr<const file_metadata> cached_metadata = metadata_cache::getInstance().get(metadata_key);
+		if(cached_metadata != nullptr) {
+			return cached_metadata;
+		}
+	}
+
+	std::shared_ptr<file_metadata> metadata = std::make_shared<file_metadata>();
+	{
+		std::unique_ptr<parquet::ParquetFileReader> parquet_reader = parquet::ParquetFileReader::Open(file);
+		metadata->parquet_metadata = parquet_reader->metadata();
+		parquet_reader->Close();
+	}
+	metadata->num_rows = metadata->parquet_metadata->num_rows();
+	metadata->num_row_groups = metadata->parquet_metadata->num_row_groups();
+	metadata->size_in_bytes = metadata->parquet_metadata->size();
+
+	// the same types cudf gives to the columns it reads. We currently dont support GDF_DATE32 for parquet so lets
+	// filter those out
+	const parquet::SchemaDescriptor * schema = metadata->parquet_metadata->schema();
+	for(int column_index = 0; column_index < schema->num_columns(); column_index++) {
+		const parquet::ColumnDescriptor * column = schema->Column(column_index);
+		std::pair<gdf_dtype, gdf_dtype_extra_info> dtype =
+			to_dtype(column->physical_type(), column->converted_type(), false);
+		if(dtype.first != GDF_DATE32) {
+			metadata->names.push_back(column->name());
+			metadata->dtypes.push_back(dtype.first);
+			metadata->time_units.push_back(dtype.second.time_unit);
+			metadata->size_in_bytes += column->name().size();
+		}
+	}
+
+	metadata_cache::getInstance().put(metadata_key, metadata);
+	return metadata;
+}
+
+}  // namespace
+
+void parquet_parser::parse(std::shared_ptr<arrow::io::RandomAccessFile> file,
+	const std::string & user_readable_file_handle,
+	std::vector<gdf_column_cpp> & columns_out,
+	const Schema & schema,
+	std::vector<size_t> column_indices) {
+	if(column_indices.size() == 0) {  // including all columns by default
+		column_indices.resize(schema.get_num_columns());
+		std::iota(column_indices.begin(), column_indices.end(), 0);
+	}
+
+	if(file == nullptr) {
+		columns_out =
+			create_empty_columns(schema.get_names(), schema.get_dtypes(), schema.get_time_units(), column_indices);
+		return;
+	}
+
+	if(column_indices.size() > 0) {
+		cudf::io::parquet::reader parquet_reader(file, get_reader_options(schema, column_indices));
+
+		cudf::table table_out = parquet_reader.read_all();
+
+		columns_out = to_columns(table_out);
+	}
+}
+
+row_group_counts parquet_parser::parse_filtered(std::shared_ptr<arrow::io::RandomAccessFile> file,
+	const std::string & user_readable_file_handle,
+	const std::string & metadata_key,
+	std::vector<gdf_column_cpp> & columns_out,
+	const Schema & schema,
+	std::vector<size_t> column_indices,
+	const row_group_filter & filter,
+	const std::vector<int> & row_group_ids) {
+	// files on remote stores are told which column chunks are going to be read, so they can be fetched in parallel
+	std::shared_ptr<CoalescingReadableFile> remote_file = std::dynamic_pointer_cast<CoalescingReadableFile>(file);
+	if(file == nullptr || (filter.empty() && remote_file == nullptr && row_group_ids.empty())) {
+		parse(file, user_readable_file_handle, columns_out, schema, column_indices);
+		return row_group_counts{};
+	}
+
+	if(column_indices.size() == 0) {  // including all columns by default
+		column_indices.resize(schema.get_num_columns());
+		std::iota(column_indices.begin(), column_indices.end(), 0);
+	}
+
+	// ranges of consecutive rows, as first row and number of rows, that belong to row groups that can match the filter
+	std::vector<std::pair<size_t, size_t>> row_ranges;
+	row_group_counts counts;
+	const std::set<int> selected_row_groups(row_group_ids.begin(), row_group_ids.end());
+	bool reads_all_row_groups = true;
+	{
+		std::shared_ptr<parquet::FileMetaData> file_metadata = get_file_metadata(file, metadata_key)->parquet_metadata;
+		const parquet::SchemaDescriptor * file_schema = file_metadata->schema();
+
+		std::vector<int> loaded_column_indices;
+		for(size_t column_index : column_indices) {
+			int file_column_index = file_schema->ColumnIndex(schema.get_name(column_index));
+			if(file_column_index >= 0) {
+				loaded_column_indices.push_back(file_column_index);
+			}
+		}
+		std::vector<std::pair<int64_t, int64_t>> column_chunk_ranges;
+
+		size_t first_row = 0;
+		for(int row_group_index = 0; row_group_index < file_metadata->num_row_groups(); row_group_index++) {
+			std::unique_ptr<parquet::RowGroupMetaData> row_group = file_metadata->RowGroup(row_group_index);
+			size_t num_rows = row_group->num_rows();
+
+			if(!selected_row_groups.empty() && selected_row_groups.count(row_group_index) == 0) {
+				reads_all_row_groups = false;
+				first_row += num_rows;
+				continue;
+			}
+
+			std::map<std::string, column_statistics> statistics;
+			if(!filter.empty()) {
+				statistics = get_row_group_statistics(*row_group, *file_schema, filter.get_column_names());
+			}
+
+			if(filter.can_match(statistics, num_rows)) {
+				counts.read++;
+				if(!row_ranges.empty() && row_ranges.back().first + row_ranges.back().second == first_row) {
+					row_ranges.back().second += num_rows;
+				} else {
+					row_ranges.emplace_back(first_row, num_rows);
+				}
+				for(int column_index : loaded_column_indices) {
+					column_chunk_ranges.push_back(get_column_chunk_range(*row_group->ColumnChunk(column_index)));
+				}
+			} else {
+				counts.pruned++;
+			}
+			first_row += num_rows;
+		}
+
+		if(remote_file != nullptr) {
+			remote_file->willNeed(column_chunk_ranges);
+		}
+	}
+
+	if(counts.pruned == 0 && reads_all_row_groups) {
+		parse(file, user_readable_file_handle, columns_out, schema, column_indices);
+		return counts;
+	}
+
+	if(row_ranges.empty()) {  // no row group can match, the file does not need to be read
+		columns_out =
+			create_empty_columns(schema.get_names(), schema.get_dtypes(), schema.get_time_units(), column_indices);
+		return counts;
+	}
+
+	cudf::io::parquet::reader parquet_reader(file, get_reader_options(schema, column_indices));
+	std::vector<std::vector<gdf_column_cpp>> columns_per_range;
+	for(const auto & row_range : row_ranges) {
+		cudf::table table_out = parquet_reader.read_rows(row_range.first, row_range.second);
+		columns_per_range.push_back(to_columns(table_out));
+	}
+	columns_out =
+		columns_per_range.size() == 1 ? columns_per_range[0] : ral::utilities::concatTables(columns_per_range);
+	return counts;
+}
+
 void parquet_parser::parse_schema(
 	std::vector<std::shared_ptr<arrow::io::RandomAccessFile>> files, ral::io::Schema & schema_out) {
-	std::vector<size_t> num_row_groups(files.size());
+	parse_schema(files, {}, schema_out);
+}
+
+void parquet_parser::parse_schema(std::vector<std::shared_ptr<arrow::io::RandomAccessFile>> files,
+	const std::vector<std::string> & metadata_keys,
+	ral::io::Schema & schema_out) {
+	std::vector<std::shared_ptr<const file_metadata>> files_metadata(files.size());
 	std::thread threads[files.size()];
 	for(int file_index = 0; file_index < files.size(); file_index++) {
 		threads[file_index] = std::thread([&, file_index]() {
-			std::unique_ptr<parquet::ParquetFileReader> parquet_reader =
-				parquet::ParquetFileReader::Open(files[file_index]);
-			std::shared_ptr<parquet::FileMetaData> file_metadata = parquet_reader->metadata();
-			const parquet::SchemaDescriptor * schema = file_metadata->schema();
-			num_row_groups[file_index] = file_metadata->num_row_groups();
-			parquet_reader->Close();
+			std::string metadata_key = metadata_keys.size() == files.size() ? metadata_keys[file_index] : "";
+			files_metadata[file_index] = get_file_metadata(files[file_index], metadata_key);
 		});
 	}
 
@@ -145,29 +326,91 @@ void parquet_parser::parse_schema(
 		threads[file_index].join();
 	}
 
-	cudf::io::parquet::reader_options pq_args;
-	pq_args.strings_to_categorical = false;
-	cudf::io::parquet::reader cudf_parquet_reader(files[0], pq_args);
-	cudf::table table_out = cudf_parquet_reader.read_rows(0, 1);
-
-
-	// we currently dont support GDF_DATE32 for parquet so lets filter those out
-	std::vector<std::string> column_names_out;
-	std::vector<gdf_dtype> dtypes_out;
-	std::vector<gdf_time_unit> time_units_out;
-	for(size_t i = 0; i < table_out.num_columns(); i++) {
-		if(table_out.get_column(i)->dtype != GDF_DATE32) {
-			column_names_out.push_back(table_out.get_column(i)->col_name);
-			dtypes_out.push_back(table_out.get_column(i)->dtype);
-			time_units_out.push_back(table_out.get_column(i)->dtype_info.time_unit);
-		}
+	std::vector<size_t> num_row_groups(files.size());
+	std::vector<size_t> num_rows(files.size());
+	for(size_t file_index = 0; file_index < files.size(); file_index++) {
+		num_row_groups[file_index] = files_metadata[file_index]->num_row_groups;
+		num_rows[file_index] = files_metadata[file_index]->num_rows;
 	}
-	table_out.destroy();
 
-	std::vector<std::size_t> column_indices(column_names_out.size());
+	// the schema is taken from the footer of the first file, no data needs to be read
+	const file_metadata & first_file_metadata = *files_metadata[0];
+	std::vector<std::size_t> column_indices(first_file_metadata.names.size());
 	std::iota(column_indices.begin(), column_indices.end(), 0);
 
-	schema_out = ral::io::Schema(column_names_out, column_indices, dtypes_out, time_units_out, num_row_groups);
+	schema_out = ral::io::Schema(first_file_metadata.names,
+		column_indices,
+		first_file_metadata.dtypes,
+		first_file_metadata.time_units,
+		num_row_groups,
+		num_rows);
+}
+
+column_statistics get_column_statistics(
+	const parquet::ColumnChunkMetaData & column_metadata, const parquet::ColumnDescriptor & descriptor) {
+	column_statistics statistics;
+	if(!column_metadata.is_stats_set()) {
+		return statistics;
+	}
+	std::shared_ptr<parquet::Statistics> stats = column_metadata.statistics();
+	if(stats == nullptr) {
+		return statistics;
+	}
+
+	// a footer without a null count reads as zero nulls, so only a positive count, or a column that can not hold
+	// nulls, tells how many nulls there are
+	statistics.null_count = stats->null_count();
+	statistics.has_null_count = statistics.null_count > 0 || descriptor.max_definition_level() == 0;
+	if(!stats->HasMinMax()) {
+		return statistics;
+	}
+
+	parquet::ConvertedType::type converted_type = descriptor.converted_type();
+	switch(descriptor.physical_type()) {
+	case parquet::Type::INT32:
+		if(converted_type == parquet::ConvertedType::NONE || converted_type == parquet::ConvertedType::INT_8 ||
+			converted_type == parquet::ConvertedType::INT_16 || converted_type == parquet::ConvertedType::INT_32 ||
+			converted_type == parquet::ConvertedType::UINT_8 || converted_type == parquet::ConvertedType::UINT_16) {
+			auto typed_stats = std::static_pointer_cast<parquet::Int32Statistics>(stats);
+			statistics.has_min_max = true;
+			statistics.min = typed_stats->min();
+			statistics.max = typed_stats->max();
+		}
+		break;
+	case parquet::Type::INT64:
+		if(converted_type == parquet::ConvertedType::NONE || converted_type == parquet::ConvertedType::INT_64) {
+			auto typed_stats = std::static_pointer_cast<parquet::Int64Statistics>(stats);
+			statistics.has_min_max = true;
+			statistics.min = typed_stats->min();
+			statistics.max = typed_stats->max();
+		}
+		break;
+	case parquet::Type::FLOAT: {
+		auto typed_stats = std::static_pointer_cast<parquet::FloatStatistics>(stats);
+		statistics.has_min_max = true;
+		statistics.min = typed_stats->min();
+		statistics.max = typed_stats->max();
+	} break;
+	case parquet::Type::DOUBLE: {
+		auto typed_stats = std::static_pointer_cast<parquet::DoubleStatistics>(stats);
+		statistics.has_min_max = true;
+		statistics.min = typed_stats->min();
+		statistics.max = typed_stats->max();
+	} break;
+	case parquet::Type::BYTE_ARRAY:
+		if(converted_type == parquet::ConvertedType::NONE || converted_type == parquet::ConvertedType::UTF8) {
+			auto typed_stats = std::static_pointer_cast<parquet::ByteArrayStatistics>(stats);
+			statistics.has_min_max = true;
+			statistics.is_string = true;
+			const parquet::ByteArray & min = typed_stats->min();
+			const parquet::ByteArray & max = typed_stats->max();
+			statistics.min_string = std::string(reinterpret_cast<const char *>(min.ptr), min.len);
+			statistics.max_string = std::string(reinterpret_cast<const char *>(max.ptr), max.len);
+		}
+		break;
+	default: break;
+	}
+	return statistics;
 }
 
 } /* namespace io */
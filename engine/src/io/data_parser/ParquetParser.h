@@ -14,6 +14,11 @@
 #include <memory>
 #include <vector>
 
+namespace parquet {
+class ColumnChunkMetaData;
+class ColumnDescriptor;
+}  // namespace parquet
+
 namespace ral {
 namespace io {
 
@@ -27,9 +32,36 @@ public:
 		const Schema & schema,
 		std::vector<size_t> column_indices_requested);
 
+	/**
+	 * skips the row groups whose footer statistics show that none of their rows can satisfy the filter, and the
+	 * whole file if none can. Row groups that are not in row_group_ids are not read either
+	 */
+	row_group_counts parse_filtered(std::shared_ptr<arrow::io::RandomAccessFile> file,
+		const std::string & user_readable_file_handle,
+		const std::string & metadata_key,
+		std::vector<gdf_column_cpp> & columns_out,
+		const Schema & schema,
+		std::vector<size_t> column_indices_requested,
+		const row_group_filter & filter,
+		const std::vector<int> & row_group_ids);
+
 	void parse_schema(std::vector<std::shared_ptr<arrow::io::RandomAccessFile>> files, Schema & schema);
+
+	/**
+	 * the schema, number of rows and number of row groups are all read from the footers, which are cached
+	 */
+	void parse_schema(std::vector<std::shared_ptr<arrow::io::RandomAccessFile>> files,
+		const std::vector<std::string> & metadata_keys,
+		Schema & schema);
 };
 
+/**
+ * the statistics of a column chunk, only for the types whose statistics order matches the order of the values the
+ * engine compares, that is plain integers, floating point and strings
+ */
+column_statistics get_column_statistics(
+	const parquet::ColumnChunkMetaData & column_metadata, const parquet::ColumnDescriptor & descriptor);
+
 } /* namespace io */
 } /* namespace ral */
 
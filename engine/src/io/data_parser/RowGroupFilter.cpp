@@ -0,0 +1,161 @@
+#include "RowGroupFilter.h"
+
+#include <cmath>
+
+#include "CalciteExpressionParsing.h"
+
+namespace ral {
+namespace io {
+
+namespace {
+
+// the operator to use when the literal is on the left side, i.e. <(10, $0) is >($0, 10)
+std::string flip_comparison(const std::string & comparison) {
+	if(comparison == "<") {
+		return ">";
+	} else if(comparison == "<=") {
+		return ">=";
+	} else if(comparison == ">") {
+		return "<";
+	} else if(comparison == ">=") {
+		return "<=";
+	}
+	return comparison;
+}
+
+template <typename T>
+bool range_can_match(const std::string & comparison, const T & min, const T & max, const T & value) {
+	if(comparison == "=") {
+		return !(value < min) && !(max < value);
+	} else if(comparison == "<>") {
+		return !(min == value && max == value);
+	} else if(comparison == "<") {
+		return min < value;
+	} else if(comparison == "<=") {
+		return !(value < min);
+	} else if(comparison == ">") {
+		return value < max;
+	} else if(comparison == ">=") {
+		return !(max < value);
+	}
+	return true;
+}
+
+bool is_comparison(const std::string & token) {
+	return token == "=" || token == "<>" || token == "<" || token == "<=" || token == ">" || token == ">=";
+}
+
+}  // namespace
+
+row_group_filter::row_group_filter(const std::string & condition, const std::vector<std::string> & column_names)
+	: column_names(column_names) {
+	if(condition.empty()) {
+		return;
+	}
+	tree.build(replace_calcite_regex(condition));
+}
+
+bool row_group_filter::can_match(
+	const std::map<std::string, column_statistics> & statistics, int64_t num_rows) const {
+	if(empty()) {
+		return true;
+	}
+	return can_match(*tree.root, statistics, num_rows);
+}
+
+const column_statistics * row_group_filter::find_statistics(
+	const std::string & operand, const std::map<std::string, column_statistics> & statistics) const {
+	if(!is_var_column(operand)) {
+		return nullptr;
+	}
+
+	size_t column_index = std::stoull(operand.substr(1));
+	if(column_index >= column_names.size()) {
+		return nullptr;
+	}
+
+	auto it = statistics.find(column_names[column_index]);
+	return it == statistics.end() ? nullptr : &it->second;
+}
+
+bool row_group_filter::can_match(const ral::parser::parse_node & node,
+	const std::map<std::string, column_statistics> & statistics,
+	int64_t num_rows) const {
+	if(node.type != ral::parser::OPERATOR) {
+		return true;
+	}
+
+	if(node.value == "AND") {
+		for(const auto & child : node.children) {
+			if(!can_match(*child, statistics, num_rows)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	if(node.value == "OR") {
+		for(const auto & child : node.children) {
+			if(can_match(*child, statistics, num_rows)) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	if(node.value == "IS_NULL" || node.value == "IS_NOT_NULL") {
+		if(node.children.size() != 1) {
+			return true;
+		}
+		const column_statistics * column = find_statistics(node.children[0]->value, statistics);
+		if(column == nullptr || !column->has_null_count) {
+			return true;
+		}
+		return node.value == "IS_NULL" ? column->null_count > 0 : column->null_count < num_rows;
+	}
+
+	if(!is_comparison(node.value) || node.children.size() != 2) {
+		return true;
+	}
+
+	std::string comparison = node.value;
+	const parser::parse_node * column_operand = node.children[0].get();
+	const parser::parse_node * literal_operand = node.children[1].get();
+	if(column_operand->type != ral::parser::OPERAND || literal_operand->type != ral::parser::OPERAND) {
+		return true;
+	}
+	if(!is_var_column(column_operand->value)) {
+		std::swap(column_operand, literal_operand);
+		comparison = flip_comparison(comparison);
+	}
+
+	const column_statistics * column = find_statistics(column_operand->value, statistics);
+	if(column == nullptr) {
+		return true;
+	}
+
+	// a comparison with null is never true, neither is any comparison over a row group that only has nulls
+	if(is_null(literal_operand->value) || (column->has_null_count && column->null_count >= num_rows)) {
+		return false;
+	}
+
+	if(!column->has_min_max) {
+		return true;
+	}
+
+	const std::string & literal = literal_operand->value;
+	if(column->is_string) {
+		if(!is_string(literal) || literal.size() < 2) {
+			return true;
+		}
+		return range_can_match(comparison, column->min_string, column->max_string, literal.substr(1, literal.size() - 2));
+	}
+
+	if(!is_number(literal) || std::isnan(column->min) || std::isnan(column->max)) {
+		return true;
+	}
+	return range_can_match(comparison, column->min, column->max, std::stold(literal));
+}
+
+}  // namespace io
+}  // namespace ral
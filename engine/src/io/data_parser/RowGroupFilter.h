@@ -0,0 +1,81 @@
+/*
+ * RowGroupFilter.h
+ *
+ * Decides from the statistics in a file footer whether a row group can have rows that satisfy the filter of a scan
+ */
+
+#ifndef ROWGROUPFILTER_H_
+#define ROWGROUPFILTER_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "parser/expression_tree.hpp"
+
+namespace ral {
+namespace io {
+
+/**
+ * min/max and null count of a column in a row group, only the members whose has_ flag is set are known
+ */
+struct column_statistics {
+	bool has_min_max = false;
+	// strings use min_string/max_string, numbers use min/max
+	bool is_string = false;
+	long double min = 0;
+	long double max = 0;
+	std::string min_string;
+	std::string max_string;
+
+	bool has_null_count = false;
+	int64_t null_count = 0;
+};
+
+/**
+ * Filter of a scan evaluated against row group statistics. Supports comparisons between a column and a number or
+ * string literal, IS NULL, IS NOT NULL, AND and OR (IN lists come as ORs of equalities). Anything else is treated as
+ * possibly true, so a row group is only discarded when it is certain that none of its rows can satisfy the filter.
+ */
+class row_group_filter {
+public:
+	/**
+	 * a filter that matches every row group
+	 */
+	row_group_filter() {}
+
+	/**
+	 * @param condition the filter of the scan, as in BindableTableScan(filters=[[condition]])
+	 * @param column_names name of the column that each $n of the condition refers to
+	 */
+	row_group_filter(const std::string & condition, const std::vector<std::string> & column_names);
+
+	bool empty() const { return !tree.root; }
+
+	const std::vector<std::string> & get_column_names() const { return column_names; }
+
+	/**
+	 * @param statistics statistics of the columns of the row group by column name, columns without statistics can
+	 * be left out
+	 * @param num_rows number of rows of the row group
+	 * @return false if no row of the row group can satisfy the filter
+	 */
+	bool can_match(const std::map<std::string, column_statistics> & statistics, int64_t num_rows) const;
+
+private:
+	bool can_match(const ral::parser::parse_node & node,
+		const std::map<std::string, column_statistics> & statistics,
+		int64_t num_rows) const;
+
+	const column_statistics * find_statistics(
+		const std::string & operand, const std::map<std::string, column_statistics> & statistics) const;
+
+	ral::parser::parse_tree tree;
+	std::vector<std::string> column_names;
+};
+
+}  // namespace io
+}  // namespace ral
+
+#endif /* ROWGROUPFILTER_H_ */
@@ -14,6 +14,7 @@
 #include <memory>
 #include <vector>
 
+#include <blazingdb/io/FileSystem/FileStatus.h>
 #include <blazingdb/io/FileSystem/Uri.h>
 
 namespace ral {
@@ -26,6 +27,8 @@ struct data_handle {
 
 	std::map<std::string, gdf_scalar> column_values;  // allows us to add hive values
 	Uri uri;										  // in case the data was loaded from a file
+	// size and version of the file when it was opened, used to key cached metadata
+	FileStatus fileStatus;
 };
 
 /**
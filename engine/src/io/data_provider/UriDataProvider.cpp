@@ -80,6 +80,7 @@ data_handle uri_data_provider::get_next() {
 
 		data_handle handle;
 		handle.uri = this->directory_uris[this->directory_current_file];
+		handle.fileStatus = fileStatus;
 		if(this->uri_scalars.size() != 0) {
 			handle.column_values = this->uri_scalars[this->current_file];
 			handle.string_values = this->string_scalars[this->current_file];
@@ -171,6 +172,7 @@ data_handle uri_data_provider::get_next() {
 			data_handle handle;
 			handle.uri = current_uri;
 			handle.fileHandle = file;
+			handle.fileStatus = fileStatus;
 			if(this->uri_scalars.size() != 0) {
 				handle.column_values = this->uri_scalars[this->current_file];
 				handle.string_values = this->string_scalars[this->current_file];
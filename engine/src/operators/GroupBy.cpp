@@ -4,8 +4,10 @@
 #include "ColumnManipulation.cuh"
 #include "GDFColumn.cuh"
 #include "LogicalFilter.h"
+#include "PartialAggregation.h"
 #include "Traits/RuntimeTraits.h"
 #include "communication/CommunicationData.h"
+#include "config/BlazingConfig.h"
 #include "config/GPUManager.cuh"
 #include "distribution/primitives.h"
 #include "utilities/CommonOperations.h"
@@ -137,12 +139,72 @@ void single_node_groupby_without_aggregations(blazing_frame & input, std::vector
 	input.add_table(grouped_table);
 }
 
-void distributed_groupby_without_aggregations(
+// Sends the groups of the grouped or aggregated table of this node to the nodes that merge them, by a hash of the group
+// columns. Returns the groups of all the nodes for this node, its own included.
+std::vector<ral::distribution::NodeColumns> exchange_groups_by_hash(
+	Context & queryContext, std::vector<gdf_column_cpp> & table, std::vector<int> & group_column_indices) {
+	using ral::communication::CommunicationData;
+
+	cudf::table temp_table = ral::utilities::create_table(table);
+	gather_and_remap_nvcategory(temp_table);
+
+	// generateJoinPartitions clears the table it partitions
+	std::vector<gdf_column_cpp> partition_table(table);
+	std::vector<ral::distribution::NodeColumns> partitions =
+		ral::distribution::generateJoinPartitions(queryContext, partition_table, group_column_indices);
+
+	queryContext.incrementQuerySubstep();
+	std::vector<ral::distribution::NodeColumns> partitionsToMerge =
+		ral::distribution::exchangePartitions(queryContext, partitions);
+
+	auto it = std::find_if(partitions.begin(), partitions.end(), [&](ral::distribution::NodeColumns & el) {
+		return el.getNode() == CommunicationData::getInstance().getSelfNode();
+	});
+	assert(it != partitions.end());
+	partitionsToMerge.push_back(*it);
+	return partitionsToMerge;
+}
+
+void hash_distributed_groupby_without_aggregations(
 	Context & queryContext, blazing_frame & input, std::vector<int> & group_column_indices) {
+	static CodeTimer timer;
+	timer.reset();
+
+	std::vector<gdf_column_cpp> data_cols_in(input.get_width());
+	for(int i = 0; i < input.get_width(); i++) {
+		data_cols_in[i] = input.get_column(i);
+	}
+
+	std::vector<gdf_column_cpp> groupedTable = groupby_without_aggregations(data_cols_in, group_column_indices);
+	Library::Logging::Logger().logInfo(timer.logDuration(
+		queryContext, "hash_distributed_groupby_without_aggregations part 1 groupby_without_aggregations"));
+	timer.reset();
+
+	std::vector<ral::distribution::NodeColumns> partitionsToMerge =
+		exchange_groups_by_hash(queryContext, groupedTable, group_column_indices);
+	Library::Logging::Logger().logInfo(timer.logDuration(
+		queryContext, "hash_distributed_groupby_without_aggregations part 2 exchange_groups_by_hash"));
+	timer.reset();
+
+	ral::distribution::groupByWithoutAggregationsMerger(partitionsToMerge, group_column_indices, input);
+	Library::Logging::Logger().logInfo(timer.logDuration(
+		queryContext, "hash_distributed_groupby_without_aggregations part 3 groupByWithoutAggregationsMerger"));
+	timer.reset();
+}
+
+void distributed_groupby_without_aggregations(Context & queryContext,
+	blazing_frame & input,
+	std::vector<int> & group_column_indices,
+	groupby_partitioning partitioning) {
 	using ral::communication::CommunicationData;
 	static CodeTimer timer;
 	timer.reset();
 
+	if(partitioning == groupby_partitioning::HASH) {
+		hash_distributed_groupby_without_aggregations(queryContext, input, group_column_indices);
+		return;
+	}
+
 	std::vector<gdf_column_cpp> group_columns(group_column_indices.size());
 	for(size_t i = 0; i < group_column_indices.size(); i++) {
 		group_columns[i] = input.get_column(group_column_indices[i]);
@@ -214,8 +276,8 @@ void distributed_groupby_without_aggregations(
 	timer.reset();
 
 	queryContext.incrementQuerySubstep();
-	ral::distribution::distributePartitions(queryContext, partitions);
-	std::vector<ral::distribution::NodeColumns> partitionsToMerge = ral::distribution::collectPartitions(queryContext);
+	std::vector<ral::distribution::NodeColumns> partitionsToMerge =
+		ral::distribution::exchangePartitions(queryContext, partitions);
 
 	auto it = std::find_if(partitions.begin(), partitions.end(), [&](ral::distribution::NodeColumns & el) {
 		return el.getNode() == CommunicationData::getInstance().getSelfNode();
@@ -224,7 +286,7 @@ void distributed_groupby_without_aggregations(
 	partitionsToMerge.push_back(*it);
 
 	Library::Logging::Logger().logInfo(timer.logDuration(
-		queryContext, "distributed_groupby_without_aggregations part 3 distributePartitions collectPartitions"));
+		queryContext, "distributed_groupby_without_aggregations part 3 exchangePartitions"));
 	timer.reset();
 
 	ral::distribution::groupByWithoutAggregationsMerger(partitionsToMerge, group_column_indices, input);
@@ -342,11 +404,25 @@ void aggregations_without_groupby(const std::vector<gdf_agg_op> & agg_ops,
 	}
 }
 
+// if the aggregation was given an alias lets use it, otherwise we'll name it based on the aggregation and input
+std::string get_aggregation_output_name(
+	gdf_agg_op aggregation, const std::string & expression, const std::string & input_name, const std::string & alias) {
+	if(alias != "") {
+		return alias;
+	}
+	if(expression == "" && aggregation == GDF_COUNT) {  // COUNT(*) case
+		return aggregator_to_string(aggregation) + "(*)";
+	}
+	return aggregator_to_string(aggregation) + "(" + input_name + ")";
+}
+
+// widen_aggregation_inputs is empty or has whether each input is widened first, see widen_partial_state_input
 std::vector<gdf_column_cpp> compute_aggregations(blazing_frame & input,
 	std::vector<int> & group_column_indices,
 	std::vector<gdf_agg_op> & aggregation_types,
 	std::vector<std::string> & aggregation_input_expressions,
-	std::vector<std::string> & aggregation_column_assigned_aliases) {
+	std::vector<std::string> & aggregation_column_assigned_aliases,
+	const std::vector<bool> & widen_aggregation_inputs = std::vector<bool>()) {
 	size_t row_size = input.get_num_rows_in_table(0);
 
 	std::vector<gdf_column_cpp> group_by_columns(group_column_indices.size());
@@ -396,20 +472,15 @@ std::vector<gdf_column_cpp> compute_aggregations(blazing_frame & input,
 			}
 		}
 
+		if(!widen_aggregation_inputs.empty() && widen_aggregation_inputs[i]) {
+			aggregation_inputs[i] = widen_partial_state_input(aggregation_inputs[i]);
+		}
+
 		output_types[i] = get_aggregation_output_type(
 			aggregation_inputs[i].dtype(), aggregation_types[i], group_column_indices.size() != 0);
 
-		// if the aggregation was given an alias lets use it, otherwise we'll name it based on the aggregation and input
-		if(aggregation_column_assigned_aliases[i] == "") {
-			if(expression == "" && aggregation_types[i] == GDF_COUNT) {  // COUNT(*) case
-				output_column_names[i] = aggregator_to_string(aggregation_types[i]) + "(*)";
-			} else {
-				output_column_names[i] =
-					aggregator_to_string(aggregation_types[i]) + "(" + aggregation_inputs[i].name() + ")";
-			}
-		} else {
-			output_column_names[i] = aggregation_column_assigned_aliases[i];
-		}
+		output_column_names[i] = get_aggregation_output_name(
+			aggregation_types[i], expression, aggregation_inputs[i].name(), aggregation_column_assigned_aliases[i]);
 	}
 
 	std::vector<gdf_column_cpp> group_by_output_columns;
@@ -435,43 +506,91 @@ std::vector<gdf_column_cpp> compute_aggregations(blazing_frame & input,
 }
 
 
-void aggregationsMerger(std::vector<ral::distribution::NodeColumns> & aggregations,
-	const std::vector<int> & groupColIndices,
-	const std::vector<gdf_agg_op> & aggregationTypes,
-	blazing_frame & output) {
-	// Concat
-	size_t totalConcatsOperations = groupColIndices.size() + aggregationTypes.size();
-	std::vector<std::vector<gdf_column_cpp>> tablesToConcat(aggregations.size());
-	for(size_t i = 0; i < aggregations.size(); i++) {
-		tablesToConcat[i] = aggregations[i].getColumns();
+std::vector<gdf_column_cpp> compute_partial_aggregations(blazing_frame & input,
+	const std::vector<int> & group_column_indices,
+	const std::vector<gdf_agg_op> & aggregation_types,
+	const std::vector<std::string> & aggregation_input_expressions,
+	const std::vector<std::string> & aggregation_column_assigned_aliases) {
+	std::vector<int> state_group_column_indices(group_column_indices);
+	std::vector<gdf_agg_op> state_types;
+	std::vector<std::string> state_input_expressions;
+	std::vector<std::string> state_aliases;
+	std::vector<bool> state_widen_inputs;
+	for(size_t i = 0; i < aggregation_types.size(); i++) {
+		const std::string & expression = aggregation_input_expressions[i];
+		// the states of an aggregation are named like its final column
+		std::string alias = aggregation_column_assigned_aliases[i];
+		if(!is_own_partial_state(aggregation_types[i])) {
+			std::string input_name = (expression == "" || contains_evaluation(expression))
+										 ? ""
+										 : input.get_column(get_index(expression)).name();
+			alias = get_aggregation_output_name(aggregation_types[i], expression, input_name, alias);
+		}
+
+		for(const partial_state & state : get_partial_states(aggregation_types[i])) {
+			state_types.push_back(state.compute);
+			state_input_expressions.push_back(expression);
+			state_aliases.push_back(alias);
+			state_widen_inputs.push_back(state.widen_input);
+		}
 	}
-	std::vector<gdf_column_cpp> concatAggregations = ral::utilities::concatTables(tablesToConcat);
 
-	// Do aggregations
-	std::vector<gdf_column_cpp> groupByColumns(groupColIndices.size());
-	for(size_t i = 0; i < groupColIndices.size(); i++) {
-		groupByColumns[i] = concatAggregations[groupColIndices[i]];
+	return compute_aggregations(
+		input, state_group_column_indices, state_types, state_input_expressions, state_aliases, state_widen_inputs);
+}
+
+// The final columns of the aggregations from their merged partial states, the group columns first
+std::vector<gdf_column_cpp> finalize_partial_aggregations(std::vector<gdf_column_cpp> & merged_states,
+	size_t num_group_columns,
+	const std::vector<gdf_agg_op> & aggregation_types) {
+	std::vector<gdf_column_cpp> output_table(merged_states.begin(), merged_states.begin() + num_group_columns);
+	size_t state_index = num_group_columns;
+	for(gdf_agg_op aggregation_type : aggregation_types) {
+		size_t num_states = get_partial_states(aggregation_type).size();
+		std::vector<gdf_column_cpp> states(
+			merged_states.begin() + state_index, merged_states.begin() + state_index + num_states);
+		output_table.push_back(finalize_partial_states(aggregation_type, states, states[0].name()));
+		state_index += num_states;
+	}
+	return output_table;
+}
+
+std::vector<gdf_column_cpp> merge_partial_aggregations(std::vector<std::vector<gdf_column_cpp>> & partial_tables,
+	size_t num_group_columns,
+	const std::vector<gdf_agg_op> & aggregation_types) {
+	// Concat
+	std::vector<gdf_column_cpp> concatAggregations = ral::utilities::concatTables(partial_tables);
+
+	// no node sent groups, there is nothing to merge
+	if(num_group_columns > 0 && concatAggregations[0].size() == 0) {
+		return finalize_partial_aggregations(concatAggregations, num_group_columns, aggregation_types);
 	}
 
-	// when we are merging COUNT aggregations, we want to SUM them, not use COUNT
-	std::vector<gdf_agg_op> modAggregationTypes(aggregationTypes.size());
-	for(size_t i = 0; i < aggregationTypes.size(); i++) {
-		modAggregationTypes[i] = aggregationTypes[i] == GDF_COUNT ? GDF_SUM : aggregationTypes[i];
+	// Do aggregations
+	std::vector<gdf_column_cpp> groupByColumns(
+		concatAggregations.begin(), concatAggregations.begin() + num_group_columns);
+
+	// each state is merged with its own aggregation, i.e. the COUNT states are summed
+	std::vector<gdf_agg_op> mergeAggregationTypes;
+	for(gdf_agg_op aggregation_type : aggregation_types) {
+		for(const partial_state & state : get_partial_states(aggregation_type)) {
+			mergeAggregationTypes.push_back(state.merge);
+		}
 	}
 
-	std::vector<gdf_column_cpp> aggregation_inputs(modAggregationTypes.size());
-	std::vector<gdf_dtype> aggregation_dtypes(modAggregationTypes.size());
-	std::vector<std::string> aggregation_names(modAggregationTypes.size());
-	for(size_t i = 0; i < modAggregationTypes.size(); i++) {
-		aggregation_inputs[i] = concatAggregations[groupColIndices.size() + i];
+	std::vector<gdf_column_cpp> aggregation_inputs(mergeAggregationTypes.size());
+	std::vector<gdf_dtype> aggregation_dtypes(mergeAggregationTypes.size());
+	std::vector<std::string> aggregation_names(mergeAggregationTypes.size());
+	for(size_t i = 0; i < mergeAggregationTypes.size(); i++) {
+		aggregation_inputs[i] = concatAggregations[num_group_columns + i];
 		aggregation_dtypes[i] = aggregation_inputs[i].dtype();
 		aggregation_names[i] = aggregation_inputs[i].name();
 	}
 
 	std::vector<gdf_column_cpp> group_by_output_columns;
-	std::vector<gdf_column_cpp> output_columns_aggregations(modAggregationTypes.size());
-	if(groupColIndices.size() == 0) {
-		aggregations_without_groupby(modAggregationTypes,
+	std::vector<gdf_column_cpp> output_columns_aggregations(mergeAggregationTypes.size());
+	if(num_group_columns == 0) {
+		aggregations_without_groupby(mergeAggregationTypes,
 			aggregation_inputs,
 			output_columns_aggregations,
 			aggregation_dtypes,
@@ -479,17 +598,32 @@ void aggregationsMerger(std::vector<ral::distribution::NodeColumns> & aggregatio
 	} else {
 		aggregations_with_groupby(groupByColumns,
 			aggregation_inputs,
-			modAggregationTypes,
+			mergeAggregationTypes,
 			group_by_output_columns,
 			output_columns_aggregations,
 			aggregation_names);
 	}
 
-	std::vector<gdf_column_cpp> outputTable(group_by_output_columns);
-	outputTable.insert(outputTable.end(),
+	std::vector<gdf_column_cpp> mergedStates(group_by_output_columns);
+	mergedStates.insert(mergedStates.end(),
 		std::make_move_iterator(output_columns_aggregations.begin()),
 		std::make_move_iterator(output_columns_aggregations.end()));
 
+	return finalize_partial_aggregations(mergedStates, num_group_columns, aggregation_types);
+}
+
+void aggregationsMerger(std::vector<ral::distribution::NodeColumns> & aggregations,
+	const std::vector<int> & groupColIndices,
+	const std::vector<gdf_agg_op> & aggregationTypes,
+	blazing_frame & output) {
+	std::vector<std::vector<gdf_column_cpp>> tablesToConcat(aggregations.size());
+	for(size_t i = 0; i < aggregations.size(); i++) {
+		tablesToConcat[i] = aggregations[i].getColumns();
+	}
+
+	std::vector<gdf_column_cpp> outputTable =
+		merge_partial_aggregations(tablesToConcat, groupColIndices.size(), aggregationTypes);
+
 	output.clear();
 	output.add_table(outputTable);
 }
@@ -510,19 +644,58 @@ void single_node_aggregations(blazing_frame & input,
 	input.add_table(aggregatedTable);
 }
 
-void distributed_aggregations_with_groupby(Context & queryContext,
+void hash_distributed_aggregations_with_groupby(Context & queryContext,
 	blazing_frame & input,
 	std::vector<int> & group_column_indices,
 	std::vector<gdf_agg_op> & aggregation_types,
 	std::vector<std::string> & aggregation_input_expressions,
 	std::vector<std::string> & aggregation_column_assigned_aliases) {
+	static CodeTimer timer;
+	timer.reset();
+
+	std::vector<gdf_column_cpp> aggregatedTable = compute_partial_aggregations(input,
+		group_column_indices,
+		aggregation_types,
+		aggregation_input_expressions,
+		aggregation_column_assigned_aliases);
+	Library::Logging::Logger().logInfo(timer.logDuration(
+		queryContext, "hash_distributed_aggregations_with_groupby part 1 compute_partial_aggregations"));
+	timer.reset();
+
+	std::vector<int> groupColumnIndices(group_column_indices.size());
+	std::iota(groupColumnIndices.begin(), groupColumnIndices.end(), 0);
+
+	std::vector<ral::distribution::NodeColumns> partitionsToMerge =
+		exchange_groups_by_hash(queryContext, aggregatedTable, groupColumnIndices);
+	Library::Logging::Logger().logInfo(
+		timer.logDuration(queryContext, "hash_distributed_aggregations_with_groupby part 2 exchange_groups_by_hash"));
+	timer.reset();
+
+	aggregationsMerger(partitionsToMerge, groupColumnIndices, aggregation_types, input);
+	Library::Logging::Logger().logInfo(
+		timer.logDuration(queryContext, "hash_distributed_aggregations_with_groupby part 3 aggregationsMerger"));
+	timer.reset();
+}
+
+void distributed_aggregations_with_groupby(Context & queryContext,
+	blazing_frame & input,
+	std::vector<int> & group_column_indices,
+	std::vector<gdf_agg_op> & aggregation_types,
+	std::vector<std::string> & aggregation_input_expressions,
+	std::vector<std::string> & aggregation_column_assigned_aliases,
+	groupby_partitioning partitioning) {
 	using ral::communication::CommunicationData;
 	static CodeTimer timer;
 	timer.reset();
 
-	if(std::find(aggregation_types.begin(), aggregation_types.end(), GDF_AVG) != aggregation_types.end()) {
-		throw std::runtime_error{
-			"In distributed_aggregations_with_groupby function: AVG is currently not supported in distributed mode"};
+	if(partitioning == groupby_partitioning::HASH) {
+		hash_distributed_aggregations_with_groupby(queryContext,
+			input,
+			group_column_indices,
+			aggregation_types,
+			aggregation_input_expressions,
+			aggregation_column_assigned_aliases);
+		return;
 	}
 
 	std::vector<gdf_column_cpp> group_columns(group_column_indices.size());
@@ -546,13 +719,13 @@ void distributed_aggregations_with_groupby(Context & queryContext,
 			std::vector<std::string> & aggregation_input_expressions,
 			std::vector<std::string> & aggregation_column_assigned_aliases) {
 			static CodeTimer timer2;
-			std::vector<gdf_column_cpp> result = compute_aggregations(input,
+			std::vector<gdf_column_cpp> result = compute_partial_aggregations(input,
 				group_column_indices,
 				aggregation_types,
 				aggregation_input_expressions,
 				aggregation_column_assigned_aliases);
-			Library::Logging::Logger().logInfo(
-				timer.logDuration(queryContext, "distributed_aggregations_with_groupby async compute_aggregations"));
+			Library::Logging::Logger().logInfo(timer.logDuration(
+				queryContext, "distributed_aggregations_with_groupby async compute_partial_aggregations"));
 			timer.reset();
 			return result;
 		},
@@ -606,8 +779,8 @@ void distributed_aggregations_with_groupby(Context & queryContext,
 	timer.reset();
 
 	queryContext.incrementQuerySubstep();
-	ral::distribution::distributePartitions(queryContext, partitions);
-	std::vector<ral::distribution::NodeColumns> partitionsToMerge = ral::distribution::collectPartitions(queryContext);
+	std::vector<ral::distribution::NodeColumns> partitionsToMerge =
+		ral::distribution::exchangePartitions(queryContext, partitions);
 
 	auto it = std::find_if(partitions.begin(), partitions.end(), [&](ral::distribution::NodeColumns & el) {
 		return el.getNode() == CommunicationData::getInstance().getSelfNode();
@@ -616,7 +789,7 @@ void distributed_aggregations_with_groupby(Context & queryContext,
 	partitionsToMerge.push_back(*it);
 
 	Library::Logging::Logger().logInfo(timer.logDuration(
-		queryContext, "distributed_aggregations_with_groupby part 3 distributePartitions collectPartitions"));
+		queryContext, "distributed_aggregations_with_groupby part 3 exchangePartitions"));
 	timer.reset();
 
 	aggregationsMerger(partitionsToMerge, groupColumnIndices, aggregation_types, input);
@@ -636,14 +809,14 @@ void distributed_aggregations_without_groupby(Context & queryContext,
 	static CodeTimer timer;
 	timer.reset();
 
-	std::vector<gdf_column_cpp> aggregatedTable = compute_aggregations(input,
+	std::vector<gdf_column_cpp> aggregatedTable = compute_partial_aggregations(input,
 		group_column_indices,
 		aggregation_types,
 		aggregation_input_expressions,
 		aggregation_column_assigned_aliases);
 
-	Library::Logging::Logger().logInfo(
-		timer.logDuration(queryContext, "distributed_aggregations_without_groupby part 1 compute_aggregations"));
+	Library::Logging::Logger().logInfo(timer.logDuration(
+		queryContext, "distributed_aggregations_without_groupby part 1 compute_partial_aggregations"));
 	timer.reset();
 
 	if(queryContext.isMasterNode(CommunicationData::getInstance().getSelfNode())) {
@@ -659,13 +832,13 @@ void distributed_aggregations_without_groupby(Context & queryContext,
 			queryContext, "distributed_aggregations_without_groupby part 2 collectPartitions aggregationsMerger"));
 		timer.reset();
 	} else {
-		std::vector<gdf_column_cpp> empty_output_table(aggregatedTable.size());
-		for(size_t i = 0; i < empty_output_table.size(); i++) {
-			empty_output_table[i].create_empty(aggregatedTable[i].dtype(), aggregatedTable[i].name());
+		std::vector<gdf_column_cpp> empty_states(aggregatedTable.size());
+		for(size_t i = 0; i < empty_states.size(); i++) {
+			empty_states[i].create_empty(aggregatedTable[i].dtype(), aggregatedTable[i].name());
 		}
 
 		input.clear();
-		input.add_table(empty_output_table);
+		input.add_table(finalize_partial_aggregations(empty_states, group_column_indices.size(), aggregation_types));
 
 		std::vector<ral::distribution::NodeColumns> selfPartition;
 		selfPartition.emplace_back(queryContext.getMasterNode(), aggregatedTable);
@@ -679,7 +852,7 @@ void distributed_aggregations_without_groupby(Context & queryContext,
 	}
 }
 
-void process_aggregate(blazing_frame & input, std::string query_part, Context * queryContext) {
+aggregate_plan parse_aggregate(const std::string & query_part) {
 	/*
 	 * 			String sql = "select sum(e), sum(z), x, y from hr.emps group by x , y";
 	 * 			generates the following calcite relational algebra
@@ -691,39 +864,59 @@ void process_aggregate(blazing_frame & input, std::string query_part, Context *
 	 * 			As you can see the project following aggregate expects the columns to be grouped by to appear BEFORE the
 	 * expressions
 	 */
+	aggregate_plan plan;
+
 	// Get groups
 	auto rangeStart = query_part.find("(");
 	auto rangeEnd = query_part.rfind(")") - rangeStart - 1;
 	std::string combined_expression = query_part.substr(rangeStart + 1, rangeEnd - 1);
 
-	std::vector<int> group_column_indices = get_group_columns(combined_expression);
+	plan.group_column_indices = get_group_columns(combined_expression);
 
 	// Get aggregations
-	std::vector<gdf_agg_op> aggregation_types;
-	std::vector<std::string> aggregation_input_expressions;
-	std::vector<std::string> aggregation_column_assigned_aliases;
 	std::vector<std::string> expressions = get_expressions_from_expression_list(combined_expression);
 	for(std::string expr : expressions) {
 		std::string expression = std::regex_replace(expr, std::regex("^ +| +$|( ) +"), "$1");
 		if(expression.find("group=") == std::string::npos) {
 			gdf_agg_op operation = get_aggregation_operation(expression);
-			aggregation_types.push_back(operation);
-			aggregation_input_expressions.push_back(get_string_between_outer_parentheses(expression));
+			plan.aggregation_types.push_back(operation);
+			plan.aggregation_input_expressions.push_back(get_string_between_outer_parentheses(expression));
 
 			// if the aggregation has an alias, lets capture it here, otherwise we'll figure out what to call the
 			// aggregation based on its input
 			if(expression.find("EXPR$") == 0)
-				aggregation_column_assigned_aliases.push_back("");
+				plan.aggregation_column_assigned_aliases.push_back("");
 			else
-				aggregation_column_assigned_aliases.push_back(expression.substr(0, expression.find("=[")));
+				plan.aggregation_column_assigned_aliases.push_back(expression.substr(0, expression.find("=[")));
 		}
 	}
 
+	return plan;
+}
+
+groupby_partitioning choose_groupby_partitioning() {
+	// the groups are already aggregated in each node before they are sent, so a key with many rows is still one row
+	// per node, and a hash spreads the groups evenly unless there are only a few of them
+	return ral::config::BlazingConfig::getInstance().getGroupByRangePartitioning() ? groupby_partitioning::RANGE
+																					: groupby_partitioning::HASH;
+}
+
+void process_aggregate(blazing_frame & input, std::string query_part, Context * queryContext) {
+	process_aggregate(input, parse_aggregate(query_part), queryContext);
+}
+
+void process_aggregate(blazing_frame & input, const aggregate_plan & plan, Context * queryContext) {
+	std::vector<int> group_column_indices = plan.group_column_indices;
+	std::vector<gdf_agg_op> aggregation_types = plan.aggregation_types;
+	std::vector<std::string> aggregation_input_expressions = plan.aggregation_input_expressions;
+	std::vector<std::string> aggregation_column_assigned_aliases = plan.aggregation_column_assigned_aliases;
+
 	if(aggregation_types.size() == 0) {
 		if(!queryContext || queryContext->getTotalNodes() <= 1) {
 			single_node_groupby_without_aggregations(input, group_column_indices);
 		} else {
-			distributed_groupby_without_aggregations(*queryContext, input, group_column_indices);
+			distributed_groupby_without_aggregations(
+				*queryContext, input, group_column_indices, choose_groupby_partitioning());
 		}
 	} else {
 		if(!queryContext || queryContext->getTotalNodes() <= 1) {
@@ -746,7 +939,8 @@ void process_aggregate(blazing_frame & input, std::string query_part, Context *
 					group_column_indices,
 					aggregation_types,
 					aggregation_input_expressions,
-					aggregation_column_assigned_aliases);
+					aggregation_column_assigned_aliases,
+					choose_groupby_partitioning());
 			}
 		}
 	}
@@ -13,10 +13,56 @@ namespace {
 using blazingdb::manager::Context;
 }  // namespace
 
+/**
+ * How a distributed LogicalAggregate sends each group to the node that merges it. HASH sends the groups as soon as
+ * they are aggregated, to the node of a hash of the group columns. RANGE first samples the group columns of every node
+ * and sends the ranges between the pivots the master chooses from the samples, two more round trips, kept for the keys
+ * a hash spreads unevenly. All the nodes must use the same partitioning, so it is set when the RAL starts and read when
+ * the aggregation runs, not kept in the cached plans.
+ */
+enum class groupby_partitioning { HASH, RANGE };
+
+/**
+ * Pre-parsed parameters of a LogicalAggregate
+ */
+struct aggregate_plan {
+	std::vector<int> group_column_indices;
+	std::vector<gdf_agg_op> aggregation_types;
+	std::vector<std::string> aggregation_input_expressions;
+	std::vector<std::string> aggregation_column_assigned_aliases;
+};
+
 bool is_aggregate(std::string query_part);
 
+aggregate_plan parse_aggregate(const std::string & query_part);
+
+/**
+ * The partitioning of the distributed group by, RANGE when the configuration asks for it and HASH otherwise
+ */
+groupby_partitioning choose_groupby_partitioning();
+
 void process_aggregate(blazing_frame & input, std::string query_part, Context * queryContext);
 
+void process_aggregate(blazing_frame & input, const aggregate_plan & plan, Context * queryContext);
+
+/**
+ * First phase of a distributed aggregation: the group columns and the partial states of the aggregations of the rows
+ * of this node, see PartialAggregation.h
+ */
+std::vector<gdf_column_cpp> compute_partial_aggregations(blazing_frame & input,
+	const std::vector<int> & group_column_indices,
+	const std::vector<gdf_agg_op> & aggregation_types,
+	const std::vector<std::string> & aggregation_input_expressions,
+	const std::vector<std::string> & aggregation_column_assigned_aliases);
+
+/**
+ * Second phase of a distributed aggregation: merges the partial tables of the nodes and computes the final columns of
+ * the aggregations from the merged states, like a single node aggregation of all the rows
+ */
+std::vector<gdf_column_cpp> merge_partial_aggregations(std::vector<std::vector<gdf_column_cpp>> & partial_tables,
+	size_t num_group_columns,
+	const std::vector<gdf_agg_op> & aggregation_types);
+
 std::vector<gdf_column_cpp> groupby_without_aggregations(
 	std::vector<gdf_column_cpp> & input, const std::vector<int> & group_column_indices);
 
@@ -7,6 +7,7 @@
 #include "config/GPUManager.cuh"
 #include "cuDF/safe_nvcategory_gather.hpp"
 #include "distribution/NodeColumns.h"
+#include "distribution/collectives.h"
 #include "distribution/primitives.h"
 #include "exception/RalException.h"
 #include "utilities/CommonOperations.h"
@@ -218,8 +219,7 @@ std::vector<gdf_column_cpp> DistributedJoinOperator::process_distribution_table(
 	std::vector<NodeColumns> partitions = ral::distribution::generateJoinPartitions(*context_, table, columnIndices);
 
 	context_->incrementQuerySubstep();
-	distributePartitions(*context_, partitions);
-	std::vector<NodeColumns> remote_node_columns = ral::distribution::collectPartitions(*context_);
+	std::vector<NodeColumns> remote_node_columns = ral::distribution::exchangePartitions(*context_, partitions);
 
 	auto it = std::find_if(partitions.begin(), partitions.end(), [](const auto & e) {
 		return e.getNode() == ral::communication::CommunicationData::getInstance().getSelfNode();
@@ -235,17 +235,17 @@ blazing_frame DistributedJoinOperator::process_distribution(blazing_frame & fram
 	std::vector<std::vector<gdf_column_cpp>> tables = frame.get_columns();
 	assert(tables.size() == 2);
 
-	int self_node_idx = context_->getNodeIndex(ral::communication::CommunicationData::getInstance().getSelfNode());
-
 	context_->incrementQuerySubstep();
 	gdf_size_type local_num_rows_left = frame.get_num_rows_in_table(0);
 	gdf_size_type local_num_rows_right = frame.get_num_rows_in_table(1);
-	ral::distribution::distributeLeftRightNumRows(*context_, local_num_rows_left, local_num_rows_right);
-	std::vector<gdf_size_type> nodes_num_rows_left;
-	std::vector<gdf_size_type> nodes_num_rows_right;
-	ral::distribution::collectLeftRightNumRows(*context_, nodes_num_rows_left, nodes_num_rows_right);
-	nodes_num_rows_left[self_node_idx] = local_num_rows_left;
-	nodes_num_rows_right[self_node_idx] = local_num_rows_right;
+	std::vector<std::vector<int64_t>> nodes_num_rows =
+		ral::distribution::allGather(*context_, {local_num_rows_left, local_num_rows_right});
+	std::vector<gdf_size_type> nodes_num_rows_left(nodes_num_rows.size());
+	std::vector<gdf_size_type> nodes_num_rows_right(nodes_num_rows.size());
+	for(size_t i = 0; i < nodes_num_rows.size(); i++) {
+		nodes_num_rows_left[i] = nodes_num_rows[i][0];
+		nodes_num_rows_right[i] = nodes_num_rows[i][1];
+	}
 
 	gdf_size_type total_rows_left = std::accumulate(nodes_num_rows_left.begin(), nodes_num_rows_left.end(), 0);
 	gdf_size_type total_rows_right = std::accumulate(nodes_num_rows_right.begin(), nodes_num_rows_right.end(), 0);
@@ -294,8 +294,8 @@ blazing_frame DistributedJoinOperator::process_distribution(blazing_frame & fram
 
 	if(scatter_left || scatter_right) {
 		context_->incrementQuerySubstep();
-		int num_to_collect = 0;
 		std::vector<gdf_column_cpp> data_to_scatter;
+		std::vector<NodeColumns> collected_partitions;
 		if(scatter_left) {
 			Library::Logging::Logger().logTrace(
 				ral::utilities::buildLogString(std::to_string(context_->getContextToken()),
@@ -303,14 +303,7 @@ blazing_frame DistributedJoinOperator::process_distribution(blazing_frame & fram
 					std::to_string(context_->getQuerySubstep()),
 					"join process_distribution scatter_left"));
 			data_to_scatter = frame.get_table(0);
-			if(local_num_rows_left > 0) {
-				ral::distribution::scatterData(*context_, data_to_scatter);
-			}
-			for(size_t i = 0; i < nodes_num_rows_left.size(); i++) {
-				if(i != self_node_idx && nodes_num_rows_left[i] > 0) {
-					num_to_collect++;
-				}
-			}
+			collected_partitions = ral::distribution::allGatherTables(*context_, data_to_scatter, nodes_num_rows_left);
 		} else {
 			Library::Logging::Logger().logTrace(
 				ral::utilities::buildLogString(std::to_string(context_->getContextToken()),
@@ -318,21 +311,12 @@ blazing_frame DistributedJoinOperator::process_distribution(blazing_frame & fram
 					std::to_string(context_->getQuerySubstep()),
 					"join process_distribution scatter_right"));
 			data_to_scatter = frame.get_table(1);
-			if(local_num_rows_right > 0) {  // this node has data on the right to scatter
-				ral::distribution::scatterData(*context_, data_to_scatter);
-			}
-			for(size_t i = 0; i < nodes_num_rows_right.size(); i++) {
-				if(i != self_node_idx && nodes_num_rows_right[i] > 0) {
-					num_to_collect++;
-				}
-			}
+			collected_partitions = ral::distribution::allGatherTables(*context_, data_to_scatter, nodes_num_rows_right);
 		}
 
 		blazing_frame join_frame;
 		std::vector<gdf_column_cpp> cluster_shared_table;
-		if(num_to_collect > 0) {
-			std::vector<NodeColumns> collected_partitions =
-				ral::distribution::collectSomePartitions(*context_, num_to_collect);
+		if(!collected_partitions.empty()) {
 			cluster_shared_table = concat_columns(data_to_scatter, collected_partitions);
 		} else {
 			cluster_shared_table = data_to_scatter;
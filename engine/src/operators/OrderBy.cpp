@@ -1,4 +1,5 @@
 #include "OrderBy.h"
+#include "TopN.h"
 #include "CalciteExpressionParsing.h"
 #include "CodeTimer.h"
 #include "ColumnManipulation.cuh"
@@ -9,6 +10,7 @@
 #include "communication/CommunicationData.h"
 #include "config/GPUManager.cuh"
 #include "cuDF/safe_nvcategory_gather.hpp"
+#include "distribution/collectives.h"
 #include "distribution/primitives.h"
 #include <algorithm>
 #include <blazingdb/io/Library/Logging/Logger.h>
@@ -75,12 +77,14 @@ void distributed_limit(Context & queryContext, blazing_frame & input, gdf_size_t
 	gdf_size_type rowSize = input.get_num_rows_in_table(0);
 
 	queryContext.incrementQuerySubstep();
-	ral::distribution::distributeRowSize(queryContext, rowSize);
-	std::vector<gdf_size_type> nodesRowSize = ral::distribution::collectRowSize(queryContext);
+	std::vector<std::vector<int64_t>> nodesRowSize = ral::distribution::allGather(queryContext, {rowSize});
 
 	int self_node_idx = queryContext.getNodeIndex(CommunicationData::getInstance().getSelfNode());
 
-	gdf_size_type prevTotalRows = std::accumulate(nodesRowSize.begin(), nodesRowSize.begin() + self_node_idx, 0);
+	gdf_size_type prevTotalRows = 0;
+	for(int i = 0; i < self_node_idx; i++) {
+		prevTotalRows += nodesRowSize[i][0];
+	}
 
 	if(prevTotalRows + rowSize > limitRows) {
 		limit_table(input, std::max(limitRows - prevTotalRows, 0));
@@ -92,8 +96,7 @@ void sort(const Context & queryContext,
 	std::vector<gdf_column *> & rawCols,
 	std::vector<int8_t> & sortOrderTypes,
 	std::vector<gdf_column_cpp> & sortedTable) {
-	static CodeTimer timer;
-	timer.reset();
+	CodeTimer timer;
 
 	gdf_column_cpp asc_desc_col;
 	asc_desc_col.create_gdf_column(GDF_INT8,
@@ -163,6 +166,49 @@ void single_node_sort(const Context & queryContext,
 	input.add_table(sortedTable);
 }
 
+// Sorts only the first limitRows rows of the order, every column is materialized for those rows only
+void top_n_sort(const Context & queryContext,
+	blazing_frame & input,
+	std::vector<gdf_column *> & rawCols,
+	std::vector<int8_t> & sortOrderTypes,
+	gdf_size_type limitRows) {
+	CodeTimer timer;
+
+	gdf_column_cpp index_col = top_n_indices(rawCols, sortOrderTypes, limitRows);
+
+	Library::Logging::Logger().logInfo(timer.logDuration(queryContext, "top_n_sort part 1 top_n_indices"));
+	timer.reset();
+
+	std::vector<gdf_column_cpp> sortedTable(input.get_size_column(0));
+	for(int i = 0; i < sortedTable.size(); i++) {
+		auto & input_col = input.get_column(i);
+		if(input_col.valid())
+			sortedTable[i].create_gdf_column(input_col.dtype(),
+				input_col.dtype_info(),
+				index_col.size(),
+				nullptr,
+				ral::traits::get_dtype_size_in_bytes(input_col.dtype()),
+				input_col.name());
+		else
+			sortedTable[i].create_gdf_column(input_col.dtype(),
+				input_col.dtype_info(),
+				index_col.size(),
+				nullptr,
+				nullptr,
+				ral::traits::get_dtype_size_in_bytes(input_col.dtype()),
+				input_col.name());
+
+		materialize_column(input_col.get_gdf_column(), sortedTable[i].get_gdf_column(), index_col.get_gdf_column());
+		sortedTable[i].update_null_count();
+	}
+
+	input.clear();
+	input.add_table(sortedTable);
+
+	Library::Logging::Logger().logInfo(timer.logDuration(queryContext, "top_n_sort part 2 materialize_column"));
+	timer.reset();
+}
+
 void distributed_sort(Context & queryContext,
 	blazing_frame & input,
 	std::vector<gdf_column_cpp> & cols,
@@ -257,11 +303,11 @@ void distributed_sort(Context & queryContext,
 	timer.reset();
 
 	queryContext.incrementQuerySubstep();
-	ral::distribution::distributePartitions(queryContext, partitions);
-	std::vector<ral::distribution::NodeColumns> partitionsToMerge = ral::distribution::collectPartitions(queryContext);
+	std::vector<ral::distribution::NodeColumns> partitionsToMerge =
+		ral::distribution::exchangePartitions(queryContext, partitions);
 
 	Library::Logging::Logger().logInfo(
-		timer.logDuration(queryContext, "distributed_sort part 4 distributePartitions collectPartitions"));
+		timer.logDuration(queryContext, "distributed_sort part 4 exchangePartitions"));
 	timer.reset();
 
 	auto it = std::find_if(partitions.begin(), partitions.end(), [&](ral::distribution::NodeColumns & el) {
@@ -275,41 +321,129 @@ void distributed_sort(Context & queryContext,
 	timer.reset();
 }
 
-void process_sort(blazing_frame & input, std::string query_part, Context * queryContext) {
+// Each node keeps its first limitRows rows and only those go to the master, which merges them and keeps the first
+// limitRows of all. The network carries at most nodes x limitRows rows instead of the shuffle of every row, and the
+// master merges the chunks as they arrive, so it holds about twice limitRows rows instead of all of them.
+void distributed_top_n(Context & queryContext,
+	blazing_frame & input,
+	std::vector<gdf_column *> & rawCols,
+	std::vector<int8_t> & sortOrderTypes,
+	std::vector<int> & sortColIndices,
+	gdf_size_type limitRows) {
+	using ral::communication::CommunicationData;
+	static CodeTimer timer;
+	timer.reset();
+
+	top_n_sort(queryContext, input, rawCols, sortOrderTypes, limitRows);
+	std::vector<gdf_column_cpp> candidates = input.get_table(0);
+
+	Library::Logging::Logger().logInfo(timer.logDuration(queryContext, "distributed_top_n part 1 top_n_sort"));
+	timer.reset();
+
+	if(queryContext.isMasterNode(CommunicationData::getInstance().getSelfNode())) {
+		std::vector<ral::distribution::NodeColumns> partitionsToMerge;
+		partitionsToMerge.emplace_back(CommunicationData::getInstance().getSelfNode(), candidates);
+		gdf_size_type rowsToMerge = input.get_num_rows_in_table(0);
+		auto mergeAndLimit = [&]() {
+			ral::distribution::sortedMerger(partitionsToMerge, sortOrderTypes, sortColIndices, input);
+			limit_table(input, limitRows);
+			partitionsToMerge.clear();
+			partitionsToMerge.emplace_back(CommunicationData::getInstance().getSelfNode(), input.get_table(0));
+			rowsToMerge = input.get_num_rows_in_table(0);
+		};
+
+		queryContext.incrementQuerySubstep();
+		ral::distribution::collectSomePartitions(
+			queryContext, queryContext.getTotalNodes() - 1, [&](ral::distribution::NodeColumns && chunk) {
+				std::vector<gdf_column_cpp> columns = chunk.getColumns();
+				rowsToMerge += columns.empty() ? 0 : columns[0].size();
+				partitionsToMerge.push_back(std::move(chunk));
+				if(rowsToMerge > 2 * limitRows) {
+					mergeAndLimit();
+				}
+			});
+		mergeAndLimit();
+
+		Library::Logging::Logger().logInfo(
+			timer.logDuration(queryContext, "distributed_top_n part 2 collectPartitions sortedMerger"));
+		timer.reset();
+	} else {
+		std::vector<gdf_column_cpp> empty_output_table(candidates.size());
+		for(size_t i = 0; i < empty_output_table.size(); i++) {
+			empty_output_table[i].create_empty(candidates[i].dtype(), candidates[i].name());
+		}
+
+		input.clear();
+		input.add_table(empty_output_table);
+
+		std::vector<ral::distribution::NodeColumns> selfPartition;
+		selfPartition.emplace_back(queryContext.getMasterNode(), candidates);
+
+		queryContext.incrementQuerySubstep();
+		ral::distribution::distributePartitions(queryContext, selfPartition);
+
+		Library::Logging::Logger().logInfo(
+			timer.logDuration(queryContext, "distributed_top_n part 2 distributePartitions"));
+		timer.reset();
+	}
+}
+
+sort_plan parse_sort(const std::string & query_part) {
 	auto rangeStart = query_part.find("(");
 	auto rangeEnd = query_part.rfind(")") - rangeStart - 1;
 	std::string combined_expression = query_part.substr(rangeStart + 1, rangeEnd);
 
+	size_t num_sort_columns = count_string_occurrence(combined_expression, "sort");
+
+	sort_plan plan;
+	plan.sort_column_indices.resize(num_sort_columns);
+	plan.sort_order_types.resize(num_sort_columns);
+	for(int i = 0; i < num_sort_columns; i++) {
+		plan.sort_column_indices[i] =
+			get_index(get_named_expression(combined_expression, "sort" + std::to_string(i)));
+		plan.sort_order_types[i] =
+			(get_named_expression(combined_expression, "dir" + std::to_string(i)) == DESCENDING_ORDER_SORT_TEXT);
+	}
+
 	std::string limitRowsStr = get_named_expression(combined_expression, "fetch");
+	if(!limitRowsStr.empty()) {
+		plan.limit_rows = std::stoi(limitRowsStr);
+	}
 
-	size_t num_sort_columns = count_string_occurrence(combined_expression, "sort");
+	return plan;
+}
+
+void process_sort(blazing_frame & input, std::string query_part, Context * queryContext) {
+	process_sort(input, parse_sort(query_part), queryContext);
+}
+
+void process_sort(blazing_frame & input, const sort_plan & plan, Context * queryContext) {
+	size_t num_sort_columns = plan.sort_column_indices.size();
 
 	std::vector<gdf_column_cpp> cols(num_sort_columns);
 	std::vector<gdf_column *> rawCols(num_sort_columns);
-	std::vector<int8_t> sortOrderTypes(num_sort_columns);
-	std::vector<int> sortColIndices(num_sort_columns);
+	std::vector<int8_t> sortOrderTypes = plan.sort_order_types;
+	std::vector<int> sortColIndices = plan.sort_column_indices;
 	for(int i = 0; i < num_sort_columns; i++) {
-		int sort_column_index = get_index(get_named_expression(combined_expression, "sort" + std::to_string(i)));
-		cols[i] = input.get_column(sort_column_index).clone();
+		cols[i] = input.get_column(sortColIndices[i]).clone();
 		rawCols[i] = cols[i].get_gdf_column();
-		sortOrderTypes[i] =
-			(get_named_expression(combined_expression, "dir" + std::to_string(i)) == DESCENDING_ORDER_SORT_TEXT);
-		sortColIndices[i] = sort_column_index;
 	}
 
 	if(!queryContext || queryContext->getTotalNodes() <= 1) {
-		if(num_sort_columns > 0) {
+		if(num_sort_columns > 0 && plan.limit_rows >= 0) {
+			top_n_sort(*queryContext, input, rawCols, sortOrderTypes, plan.limit_rows);
+		} else if(num_sort_columns > 0) {
 			single_node_sort(*queryContext, input, rawCols, sortOrderTypes);
-		}
-		if(!limitRowsStr.empty()) {
-			limit_table(input, std::stoi(limitRowsStr));
+		} else if(plan.limit_rows >= 0) {
+			limit_table(input, plan.limit_rows);
 		}
 	} else {
-		if(num_sort_columns > 0) {
+		if(num_sort_columns > 0 && plan.limit_rows >= 0) {
+			distributed_top_n(*queryContext, input, rawCols, sortOrderTypes, sortColIndices, plan.limit_rows);
+		} else if(num_sort_columns > 0) {
 			distributed_sort(*queryContext, input, cols, rawCols, sortOrderTypes, sortColIndices);
-		}
-		if(!limitRowsStr.empty()) {
-			distributed_limit(*queryContext, input, std::stoi(limitRowsStr));
+		} else if(plan.limit_rows >= 0) {
+			distributed_limit(*queryContext, input, plan.limit_rows);
 		}
 	}
 }
@@ -13,10 +13,24 @@ namespace {
 using blazingdb::manager::Context;
 }  // namespace
 
+/**
+ * Pre-parsed parameters of a LogicalSort
+ */
+struct sort_plan {
+	std::vector<int> sort_column_indices;
+	std::vector<int8_t> sort_order_types;
+	// number of rows to return (from fetch), -1 when the sort has no limit
+	int limit_rows = -1;
+};
+
 bool is_sort(std::string query_part);
 
+sort_plan parse_sort(const std::string & query_part);
+
 void process_sort(blazing_frame & input, std::string query_part, Context * queryContext);
 
+void process_sort(blazing_frame & input, const sort_plan & plan, Context * queryContext);
+
 }  // namespace operators
 }  // namespace ral
 
@@ -0,0 +1,59 @@
+#include "PartialAggregation.h"
+#include "cudf/legacy/unary.hpp"
+#include <stdexcept>
+
+namespace ral {
+namespace operators {
+
+std::vector<partial_state> get_partial_states(gdf_agg_op aggregation) {
+	switch(aggregation) {
+	case GDF_SUM: return {{GDF_SUM, GDF_SUM, false}};
+	case GDF_MIN: return {{GDF_MIN, GDF_MIN, false}};
+	case GDF_MAX: return {{GDF_MAX, GDF_MAX, false}};
+	// the counts of the nodes add up
+	case GDF_COUNT: return {{GDF_COUNT, GDF_SUM, false}};
+	// a group by sums in the type of its input, the sum of an INT32 AVG would overflow long before its average does
+	case GDF_AVG: return {{GDF_SUM, GDF_SUM, true}, {GDF_COUNT, GDF_SUM, false}};
+	case GDF_COUNT_DISTINCT:
+		throw std::runtime_error{
+			"In get_partial_states function: COUNT DISTINCT is currently not supported in distributed mode"};
+	default: throw std::runtime_error{"In get_partial_states function: unexpected gdf_agg_op"};
+	}
+}
+
+bool is_own_partial_state(gdf_agg_op aggregation) {
+	std::vector<partial_state> states = get_partial_states(aggregation);
+	return states.size() == 1 && states[0].compute == aggregation;
+}
+
+gdf_column_cpp widen_partial_state_input(gdf_column_cpp & input) {
+	gdf_dtype widened_type;
+	switch(input.dtype()) {
+	case GDF_INT8:
+	case GDF_INT16:
+	case GDF_INT32: widened_type = GDF_INT64; break;
+	case GDF_FLOAT32: widened_type = GDF_FLOAT64; break;
+	default: return input;
+	}
+
+	gdf_column * widened = new gdf_column{};
+	*widened = cudf::cast(*input.get_gdf_column(), widened_type);
+	gdf_column_cpp output;
+	output.create_gdf_column(widened);
+	output.set_name(input.name());
+	return output;
+}
+
+gdf_column_cpp finalize_partial_states(
+	gdf_agg_op aggregation, std::vector<gdf_column_cpp> & states, const std::string & name) {
+	if(aggregation == GDF_AVG) {
+		return average_from_sum_and_count(states[0], states[1], name);
+	}
+
+	gdf_column_cpp output = states[0];
+	output.set_name(name);
+	return output;
+}
+
+}  // namespace operators
+}  // namespace ral
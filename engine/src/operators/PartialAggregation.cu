@@ -0,0 +1,85 @@
+#include "PartialAggregation.h"
+#include "Utils.cuh"
+
+namespace ral {
+namespace operators {
+
+namespace {
+
+constexpr int AVERAGE_BLOCK_SIZE = 256;
+
+// Each thread computes the rows of one gdf_valid_type, so it writes their validity without atomics
+template <typename S, typename C>
+__global__ void average_kernel(const S * sums,
+	const gdf_valid_type * sum_valid,
+	const C * counts,
+	double * averages,
+	gdf_valid_type * valid,
+	gdf_size_type num_rows) {
+	const gdf_size_type num_valid = (num_rows + GDF_VALID_BITSIZE - 1) / GDF_VALID_BITSIZE;
+	for(gdf_size_type valid_index = blockIdx.x * blockDim.x + threadIdx.x; valid_index < num_valid;
+		valid_index += gridDim.x * blockDim.x) {
+		gdf_valid_type valid_bits = 0;
+		for(gdf_size_type bit = 0; bit < GDF_VALID_BITSIZE; bit++) {
+			const gdf_size_type row = valid_index * GDF_VALID_BITSIZE + bit;
+			if(row >= num_rows) {
+				break;
+			}
+			const bool has_sum = sum_valid == nullptr || ((sum_valid[valid_index] >> bit) & 1);
+			if(has_sum && counts[row] != 0) {
+				averages[row] = static_cast<double>(sums[row]) / static_cast<double>(counts[row]);
+				valid_bits |= gdf_valid_type{1} << bit;
+			}
+		}
+		valid[valid_index] = valid_bits;
+	}
+}
+
+template <typename S, typename C>
+void average(gdf_column * sum, gdf_column * count, gdf_column * output) {
+	const gdf_size_type num_valid = (output->size + GDF_VALID_BITSIZE - 1) / GDF_VALID_BITSIZE;
+	const int num_blocks = (num_valid + AVERAGE_BLOCK_SIZE - 1) / AVERAGE_BLOCK_SIZE;
+	average_kernel<S, C><<<num_blocks, AVERAGE_BLOCK_SIZE>>>(static_cast<const S *>(sum->data),
+		sum->valid,
+		static_cast<const C *>(count->data),
+		static_cast<double *>(output->data),
+		output->valid,
+		output->size);
+	CheckCudaErrors(cudaGetLastError());
+}
+
+template <typename S>
+void average(gdf_column * sum, gdf_column * count, gdf_column * output) {
+	switch(count->dtype) {
+	case GDF_INT32: return average<S, int32_t>(sum, count, output);
+	case GDF_INT64: return average<S, int64_t>(sum, count, output);
+	default: throw std::runtime_error{"In average_from_sum_and_count function: unexpected count type"};
+	}
+}
+
+}  // namespace
+
+gdf_column_cpp average_from_sum_and_count(gdf_column_cpp & sum, gdf_column_cpp & count, const std::string & name) {
+	gdf_column_cpp output;
+	if(sum.size() == 0) {
+		output.create_empty(GDF_FLOAT64, name);
+		return output;
+	}
+
+	output.create_gdf_column(
+		GDF_FLOAT64, gdf_dtype_extra_info{TIME_UNIT_NONE, nullptr}, sum.size(), nullptr, sizeof(double), name);
+	switch(sum.dtype()) {
+	case GDF_INT8: average<int8_t>(sum.get_gdf_column(), count.get_gdf_column(), output.get_gdf_column()); break;
+	case GDF_INT16: average<int16_t>(sum.get_gdf_column(), count.get_gdf_column(), output.get_gdf_column()); break;
+	case GDF_INT32: average<int32_t>(sum.get_gdf_column(), count.get_gdf_column(), output.get_gdf_column()); break;
+	case GDF_INT64: average<int64_t>(sum.get_gdf_column(), count.get_gdf_column(), output.get_gdf_column()); break;
+	case GDF_FLOAT32: average<float>(sum.get_gdf_column(), count.get_gdf_column(), output.get_gdf_column()); break;
+	case GDF_FLOAT64: average<double>(sum.get_gdf_column(), count.get_gdf_column(), output.get_gdf_column()); break;
+	default: throw std::runtime_error{"In average_from_sum_and_count function: unexpected sum type"};
+	}
+	output.update_null_count();
+	return output;
+}
+
+}  // namespace operators
+}  // namespace ral
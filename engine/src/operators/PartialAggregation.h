@@ -0,0 +1,60 @@
+#ifndef BLAZINGDB_RAL_PARTIAL_AGGREGATION_H
+#define BLAZINGDB_RAL_PARTIAL_AGGREGATION_H
+
+#include "GDFColumn.cuh"
+#include <string>
+#include <vector>
+
+namespace ral {
+namespace operators {
+
+/**
+ * Two-phase aggregation of a distributed LogicalAggregate: every node aggregates its rows into the partial states of
+ * each aggregation, only the states are exchanged, and the node that gets all the states of a group merges them and
+ * computes the final value from them. An aggregation that can be merged with itself, like SUM, MIN or MAX, is its own
+ * state. AVG is the SUM and the COUNT of its input.
+ */
+struct partial_state {
+	// aggregation of the input rows of a node into the state
+	gdf_agg_op compute;
+	// aggregation of the states of all the nodes
+	gdf_agg_op merge;
+	// the input is widened to GDF_INT64 or GDF_FLOAT64 before it is aggregated, for a SUM state whose final value is
+	// not a sum of the input type, so that the sums cannot overflow it
+	bool widen_input;
+};
+
+/**
+ * The partial states of the aggregation, in the order of their columns
+ */
+std::vector<partial_state> get_partial_states(gdf_agg_op aggregation);
+
+/**
+ * Whether the aggregation is its own and only partial state, so the state column is already the final column
+ */
+bool is_own_partial_state(gdf_agg_op aggregation);
+
+/**
+ * The input of a state that widens its input: integer columns as GDF_INT64 and floating point columns as GDF_FLOAT64.
+ * The input itself when it already is one of them.
+ */
+gdf_column_cpp widen_partial_state_input(gdf_column_cpp & input);
+
+/**
+ * The final column of the aggregation from its merged states
+ *
+ * @param states the merged state columns, in the order of get_partial_states
+ */
+gdf_column_cpp finalize_partial_states(
+	gdf_agg_op aggregation, std::vector<gdf_column_cpp> & states, const std::string & name);
+
+/**
+ * AVG from the merged SUM and COUNT of its input, as a GDF_FLOAT64 column. Null where the sum is null or the count is
+ * zero, the groups that only had nulls.
+ */
+gdf_column_cpp average_from_sum_and_count(gdf_column_cpp & sum, gdf_column_cpp & count, const std::string & name);
+
+}  // namespace operators
+}  // namespace ral
+
+#endif  // BLAZINGDB_RAL_PARTIAL_AGGREGATION_H
@@ -0,0 +1,57 @@
+#include "TopN.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ral {
+namespace operators {
+
+bool use_top_n_threshold(gdf_size_type num_rows, gdf_size_type limit) {
+	// a sample of every row would not save anything
+	return num_rows > TOP_N_SAMPLE_SIZE && limit <= num_rows / TOP_N_MIN_ROWS_PER_LIMIT_ROW;
+}
+
+gdf_size_type top_n_threshold_rank(gdf_size_type num_rows, gdf_size_type sample_size, gdf_size_type limit) {
+	if(sample_size <= 0 || num_rows <= 0) {
+		return 0;
+	}
+	// the number of sample values before the limit-th row is binomial, with this mean and a variance below it
+	const double expected = static_cast<double>(limit) * sample_size / num_rows;
+	const double rank = std::ceil(expected + 4 * std::sqrt(expected) + 4);
+	return static_cast<gdf_size_type>(std::min<double>(rank, sample_size - 1));
+}
+
+bool host_row_order::operator()(gdf_size_type a, gdf_size_type b) const {
+	for(const auto & comparator : comparators) {
+		int order = comparator(a, b);
+		if(order != 0) {
+			return order < 0;
+		}
+	}
+	return a < b;
+}
+
+std::vector<gdf_size_type> host_top_n(gdf_size_type num_rows, gdf_size_type limit, const host_row_order & order) {
+	limit = std::max<gdf_size_type>(std::min(limit, num_rows), 0);
+	std::vector<gdf_size_type> heap;
+	heap.reserve(limit);
+	if(limit == 0) {
+		return heap;
+	}
+
+	// the last of the best rows so far is on top, a row that comes before it takes its place
+	for(gdf_size_type row = 0; row < num_rows; row++) {
+		if(static_cast<gdf_size_type>(heap.size()) < limit) {
+			heap.push_back(row);
+			std::push_heap(heap.begin(), heap.end(), std::cref(order));
+		} else if(order(row, heap.front())) {
+			std::pop_heap(heap.begin(), heap.end(), std::cref(order));
+			heap.back() = row;
+			std::push_heap(heap.begin(), heap.end(), std::cref(order));
+		}
+	}
+	std::sort_heap(heap.begin(), heap.end(), std::cref(order));
+	return heap;
+}
+
+}  // namespace operators
+}  // namespace ral
@@ -0,0 +1,192 @@
+#include "TopN.h"
+#include "ColumnManipulation.cuh"
+#include "Traits/RuntimeTraits.h"
+#include "Utils.cuh"
+
+#include <algorithm>
+#include <thrust/copy.h>
+#include <thrust/count.h>
+#include <thrust/execution_policy.h>
+#include <thrust/gather.h>
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/logical.h>
+#include <type_traits>
+
+namespace ral {
+namespace operators {
+
+namespace {
+
+// Whether a row can be among the first rows of the order, from its leading key
+template <typename T>
+struct within_threshold {
+	const T * data;
+	const gdf_valid_type * valid;
+	T threshold;
+	bool descending;
+
+	__device__ bool operator()(gdf_index_type row) const {
+		// nulls are the largest values, they come first in a descending order
+		if(valid != nullptr && !((valid[row / GDF_VALID_BITSIZE] >> (row % GDF_VALID_BITSIZE)) & 1)) {
+			return descending;
+		}
+		return descending ? !(data[row] < threshold) : !(threshold < data[row]);
+	}
+};
+
+template <typename T>
+struct is_nan {
+	__device__ bool operator()(T value) const { return value != value; }
+};
+
+gdf_column_cpp create_index_column(gdf_size_type num_rows) {
+	gdf_column_cpp index_col;
+	index_col.create_gdf_column(GDF_INT32,
+		gdf_dtype_extra_info{TIME_UNIT_NONE, nullptr},
+		num_rows,
+		nullptr,
+		ral::traits::get_dtype_size_in_bytes(GDF_INT32),
+		"");
+	return index_col;
+}
+
+// The rows whose leading key is not past a threshold taken from an evenly spread sample of it. Returns an empty
+// column when fewer than limit rows pass, nulls in the sample can make the threshold too tight, or when a floating
+// key has NaN, which < does not order for the sort of the sample nor for the threshold.
+template <typename T>
+gdf_column_cpp threshold_rows(gdf_column * key, bool descending, gdf_size_type limit) {
+	const gdf_size_type num_rows = key->size;
+	const T * data = static_cast<const T *>(key->data);
+	if(std::is_floating_point<T>::value && thrust::any_of(thrust::device, data, data + num_rows, is_nan<T>{})) {
+		return gdf_column_cpp();
+	}
+
+	const gdf_size_type sample_size = std::min(num_rows, TOP_N_SAMPLE_SIZE);
+	const gdf_size_type stride = num_rows / sample_size;
+
+	std::vector<T> sample(sample_size);
+	CheckCudaErrors(cudaMemcpy2D(sample.data(),
+		sizeof(T),
+		key->data,
+		stride * sizeof(T),
+		sizeof(T),
+		sample_size,
+		cudaMemcpyDeviceToHost));
+	std::sort(sample.begin(), sample.end());
+	const gdf_size_type rank = top_n_threshold_rank(num_rows, sample_size, limit);
+	const T threshold = descending ? sample[sample_size - 1 - rank] : sample[rank];
+
+	within_threshold<T> predicate{data, key->valid, threshold, descending};
+	auto first_row = thrust::make_counting_iterator<gdf_index_type>(0);
+	auto last_row = thrust::make_counting_iterator<gdf_index_type>(num_rows);
+	// counted first so that only the rows that pass are allocated
+	gdf_size_type num_candidates = thrust::count_if(thrust::device, first_row, last_row, predicate);
+	if(num_candidates < limit) {
+		return gdf_column_cpp();
+	}
+
+	gdf_column_cpp candidates = create_index_column(num_candidates);
+	thrust::copy_if(thrust::device, first_row, last_row, static_cast<gdf_index_type *>(candidates.data()), predicate);
+	return candidates;
+}
+
+gdf_column_cpp threshold_rows(gdf_column * key, bool descending, gdf_size_type limit) {
+	switch(key->dtype) {
+	case GDF_INT8:
+	case GDF_BOOL8: return threshold_rows<int8_t>(key, descending, limit);
+	case GDF_INT16: return threshold_rows<int16_t>(key, descending, limit);
+	case GDF_INT32:
+	case GDF_DATE32:
+	// the keys of a category are sorted, its codes have the order of its strings
+	case GDF_STRING_CATEGORY: return threshold_rows<int32_t>(key, descending, limit);
+	case GDF_INT64:
+	case GDF_DATE64:
+	case GDF_TIMESTAMP: return threshold_rows<int64_t>(key, descending, limit);
+	case GDF_FLOAT32: return threshold_rows<float>(key, descending, limit);
+	case GDF_FLOAT64: return threshold_rows<double>(key, descending, limit);
+	default: return gdf_column_cpp();
+	}
+}
+
+// gdf_order_by of the columns, the order of the rows as a GDF_INT32 column
+gdf_column_cpp order_by(std::vector<gdf_column *> & columns, const std::vector<int8_t> & sort_order_types) {
+	gdf_column_cpp asc_desc_col;
+	asc_desc_col.create_gdf_column(GDF_INT8,
+		gdf_dtype_extra_info{TIME_UNIT_NONE, nullptr},
+		sort_order_types.size(),
+		const_cast<int8_t *>(sort_order_types.data()),
+		ral::traits::get_dtype_size_in_bytes(GDF_INT8),
+		"");
+
+	gdf_column_cpp index_col = create_index_column(columns[0]->size);
+
+	gdf_context context;
+	context.flag_null_sort_behavior = GDF_NULL_AS_LARGEST;  // Nulls are are treated as largest
+
+	CUDF_CALL(gdf_order_by(columns.data(),
+		(int8_t *) (asc_desc_col.get_gdf_column()->data),
+		columns.size(),
+		index_col.get_gdf_column(),
+		&context));
+	return index_col;
+}
+
+}  // namespace
+
+gdf_column_cpp top_n_indices(std::vector<gdf_column *> & sort_columns,
+	const std::vector<int8_t> & sort_order_types,
+	gdf_size_type limit) {
+	const gdf_size_type num_rows = sort_columns[0]->size;
+	limit = std::max<gdf_size_type>(std::min(limit, num_rows), 0);
+
+	gdf_column_cpp candidates;
+	if(use_top_n_threshold(num_rows, limit)) {
+		candidates = threshold_rows(sort_columns[0], sort_order_types[0] != 0, limit);
+	}
+
+	gdf_column_cpp top_rows = create_index_column(limit);
+	if(candidates.get_gdf_column() == nullptr) {
+		// every row is a candidate
+		gdf_column_cpp order = order_by(sort_columns, sort_order_types);
+		CheckCudaErrors(cudaMemcpy(top_rows.data(), order.data(), limit * sizeof(gdf_index_type), cudaMemcpyDefault));
+		return top_rows;
+	}
+
+	std::vector<gdf_column_cpp> candidate_columns(sort_columns.size());
+	std::vector<gdf_column *> raw_candidate_columns(sort_columns.size());
+	for(size_t i = 0; i < sort_columns.size(); i++) {
+		gdf_column * column = sort_columns[i];
+		if(column->valid != nullptr) {
+			candidate_columns[i].create_gdf_column(column->dtype,
+				column->dtype_info,
+				candidates.size(),
+				nullptr,
+				ral::traits::get_dtype_size_in_bytes(column->dtype),
+				"");
+		} else {
+			candidate_columns[i].create_gdf_column(column->dtype,
+				column->dtype_info,
+				candidates.size(),
+				nullptr,
+				nullptr,
+				ral::traits::get_dtype_size_in_bytes(column->dtype),
+				"");
+		}
+		materialize_column(column, candidate_columns[i].get_gdf_column(), candidates.get_gdf_column());
+		candidate_columns[i].update_null_count();
+		raw_candidate_columns[i] = candidate_columns[i].get_gdf_column();
+	}
+
+	// the order is of the candidates, their first rows are the rows of the input to take
+	gdf_column_cpp order = order_by(raw_candidate_columns, sort_order_types);
+	const gdf_index_type * order_data = static_cast<const gdf_index_type *>(order.data());
+	thrust::gather(thrust::device,
+		order_data,
+		order_data + limit,
+		static_cast<const gdf_index_type *>(candidates.data()),
+		static_cast<gdf_index_type *>(top_rows.data()));
+	return top_rows;
+}
+
+}  // namespace operators
+}  // namespace ral
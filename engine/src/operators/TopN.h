@@ -0,0 +1,90 @@
+#ifndef BLAZINGDB_RAL_TOPN_OPERATOR_H
+#define BLAZINGDB_RAL_TOPN_OPERATOR_H
+
+#include "GDFColumn.cuh"
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace ral {
+namespace operators {
+
+/**
+ * Top-N of a LogicalSort with fetch: only the first limit rows of the order are computed and materialized. The rows
+ * are first narrowed down to the ones whose leading sort key is not past a threshold taken from a sample of it, so
+ * only those are sorted.
+ */
+
+// the leading key of at most this many rows is copied to the host to choose the threshold
+constexpr gdf_size_type TOP_N_SAMPLE_SIZE = 1 << 16;
+
+// the threshold is only worth it when it can leave out most of the rows
+constexpr gdf_size_type TOP_N_MIN_ROWS_PER_LIMIT_ROW = 16;
+
+/**
+ * Whether the rows should be narrowed down with a threshold before the top-N sort
+ */
+bool use_top_n_threshold(gdf_size_type num_rows, gdf_size_type limit);
+
+/**
+ * Position in a sample of sample_size of the leading key, sorted in the order of the sort, of the threshold value.
+ * The sample is evenly spread over num_rows, so the rows up to the threshold are about num_rows / sample_size times
+ * the position. It adds a margin of a few standard deviations so that they are at least limit for almost every input,
+ * the caller sorts every row otherwise.
+ */
+gdf_size_type top_n_threshold_rank(gdf_size_type num_rows, gdf_size_type sample_size, gdf_size_type limit);
+
+/**
+ * Order of the rows of the sort columns copied to the host, with nulls as the largest values like gdf_order_by with
+ * GDF_NULL_AS_LARGEST. The reference of the device top-N, for the tests.
+ */
+class host_row_order {
+public:
+	/**
+	 * @param values not copied, they must outlive the order
+	 * @param valid validity of each row, empty when the column has no nulls
+	 */
+	template <typename T>
+	void add_column(const std::vector<T> & values, std::vector<bool> valid, bool descending) {
+		comparators.push_back([&values, valid, descending](gdf_size_type a, gdf_size_type b) {
+			const bool a_valid = valid.empty() || valid[a];
+			const bool b_valid = valid.empty() || valid[b];
+			int order = 0;
+			if(!a_valid || !b_valid) {
+				order = a_valid == b_valid ? 0 : (a_valid ? -1 : 1);
+			} else if(values[a] < values[b]) {
+				order = -1;
+			} else if(values[b] < values[a]) {
+				order = 1;
+			}
+			return descending ? -order : order;
+		});
+	}
+
+	/**
+	 * @return whether row a comes before row b, the rows with the same keys keep their order
+	 */
+	bool operator()(gdf_size_type a, gdf_size_type b) const;
+
+private:
+	std::vector<std::function<int(gdf_size_type, gdf_size_type)>> comparators;
+};
+
+/**
+ * Host top-N: the first limit rows of num_rows in the order, in order. Keeps the best limit rows seen in a bounded
+ * heap, so it takes O(num_rows log limit) and memory for limit rows only.
+ */
+std::vector<gdf_size_type> host_top_n(gdf_size_type num_rows, gdf_size_type limit, const host_row_order & order);
+
+/**
+ * Device top-N: indices of the first limit rows in the order of the sort columns, as a GDF_INT32 column of at most
+ * limit rows. Only the sort columns of the rows that pass the threshold of the leading key are sorted.
+ */
+gdf_column_cpp top_n_indices(std::vector<gdf_column *> & sort_columns,
+	const std::vector<int8_t> & sort_order_types,
+	gdf_size_type limit);
+
+}  // namespace operators
+}  // namespace ral
+
+#endif  // BLAZINGDB_RAL_TOPN_OPERATOR_H
@@ -0,0 +1,87 @@
+#include "parser/plan_cache.hpp"
+
+#include <blazingdb/io/Util/StringUtil.h>
+
+#include "config/BlazingConfig.h"
+
+namespace ral {
+namespace parser {
+
+plan_cache & plan_cache::getInstance() {
+	static plan_cache cache(ral::config::BlazingConfig::getInstance().getPlanCacheSize());
+	return cache;
+}
+
+plan_cache::plan_cache(size_t capacity) : capacity{capacity}, hits{0}, misses{0} {}
+
+std::shared_ptr<const relational_node> plan_cache::get_plan(const std::string & logical_plan) {
+	std::string key = normalize_relational_plan(logical_plan);
+
+	{
+		std::lock_guard<std::mutex> lock(cache_mutex);
+		auto it = index.find(key);
+		if(it != index.end()) {
+			hits++;
+			entries.splice(entries.begin(), entries, it->second);
+			return it->second->second;
+		}
+		misses++;
+	}
+
+	// parsing happens outside the lock, two queries missing on the same plan at the same time both parse it
+	std::shared_ptr<const relational_node> plan = parse_relational_plan(key);
+	if(capacity == 0) {
+		return plan;
+	}
+
+	std::lock_guard<std::mutex> lock(cache_mutex);
+	auto it = index.find(key);
+	if(it != index.end()) {
+		entries.splice(entries.begin(), entries, it->second);
+		return it->second->second;
+	}
+
+	entries.emplace_front(key, plan);
+	index[key] = entries.begin();
+	if(entries.size() > capacity) {
+		index.erase(entries.back().first);
+		entries.pop_back();
+	}
+	return plan;
+}
+
+void plan_cache::clear() {
+	std::lock_guard<std::mutex> lock(cache_mutex);
+	entries.clear();
+	index.clear();
+}
+
+size_t plan_cache::get_hits() const {
+	std::lock_guard<std::mutex> lock(cache_mutex);
+	return hits;
+}
+
+size_t plan_cache::get_misses() const {
+	std::lock_guard<std::mutex> lock(cache_mutex);
+	return misses;
+}
+
+size_t plan_cache::get_size() const {
+	std::lock_guard<std::mutex> lock(cache_mutex);
+	return entries.size();
+}
+
+std::string normalize_relational_plan(const std::string & logical_plan) {
+	std::string normalized_plan;
+	for(std::string line : StringUtil::split(logical_plan, "\n")) {
+		size_t end = line.find_last_not_of(" \t\r");
+		if(end == std::string::npos) {
+			continue;
+		}
+		normalized_plan += line.substr(0, end + 1) + "\n";
+	}
+	return normalized_plan;
+}
+
+}  // namespace parser
+}  // namespace ral
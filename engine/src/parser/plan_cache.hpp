@@ -0,0 +1,65 @@
+#pragma once
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "parser/relational_plan.hpp"
+
+namespace ral {
+namespace parser {
+
+/**
+ * LRU cache of parsed relational algebra, keyed on the normalized plan text.
+ *
+ * The cached plans are immutable and shared, so the same plan can be evaluated by several queries at the same time.
+ */
+class plan_cache {
+public:
+	static plan_cache & getInstance();
+
+	explicit plan_cache(size_t capacity);
+
+	/**
+	 * Returns the parsed plan for logical_plan, parsing it and caching it if it is not cached yet
+	 * @throws std::runtime_error if the plan can not be parsed, plans that fail to parse are not cached
+	 */
+	std::shared_ptr<const relational_node> get_plan(const std::string & logical_plan);
+
+	void clear();
+
+	size_t get_hits() const;
+
+	size_t get_misses() const;
+
+	size_t get_size() const;
+
+	size_t get_capacity() const { return capacity; }
+
+private:
+	plan_cache(const plan_cache &) = delete;
+
+	plan_cache & operator=(const plan_cache &) = delete;
+
+private:
+	using entry = std::pair<std::string, std::shared_ptr<const relational_node>>;
+
+	const size_t capacity;
+	// most recently used first
+	std::list<entry> entries;
+	std::unordered_map<std::string, std::list<entry>::iterator> index;
+	size_t hits;
+	size_t misses;
+	mutable std::mutex cache_mutex;
+};
+
+/**
+ * Removes the carriage returns, trailing spaces and empty lines of a plan, the indentation is kept because it
+ * defines the tree
+ */
+std::string normalize_relational_plan(const std::string & logical_plan);
+
+}  // namespace parser
+}  // namespace ral
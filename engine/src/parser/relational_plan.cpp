@@ -0,0 +1,191 @@
+#include "parser/relational_plan.hpp"
+
+#include <map>
+#include <stdexcept>
+
+#include <blazingdb/io/Util/StringUtil.h>
+
+#include "CalciteExpressionParsing.h"
+#include "CalciteInterpreter.h"
+
+namespace ral {
+namespace parser {
+
+namespace {
+
+const std::map<std::string, relational_node_type> relational_node_types = {
+	{"LogicalTableScan", relational_node_type::SCAN},
+	{"EnumerableTableScan", relational_node_type::SCAN},
+	{"BindableTableScan", relational_node_type::BINDABLE_SCAN},
+	{"LogicalFilter", relational_node_type::FILTER},
+	{"LogicalProject", relational_node_type::PROJECT},
+	{"LogicalAggregate", relational_node_type::AGGREGATE},
+	{"LogicalSort", relational_node_type::SORT},
+	{"LogicalJoin", relational_node_type::JOIN},
+	{"LogicalUnion", relational_node_type::UNION}};
+
+// BindableTableScan(table=[[main, emps]], filters=[[<($0, 10)]], projects=[[0, 2]], aliases=[[id, $f1]])
+std::string get_filter_expression(const std::string & statement) {
+	std::string filter_string = statement.substr(statement.find("filters="));
+	size_t start = filter_string.find("[[") + 2;
+	size_t end = filter_string.find("]]");
+	return filter_string.substr(start, end - start);
+}
+
+void parse_scan(relational_node & node) {
+	node.table_name = extract_table_name(node.statement);
+	if(StringUtil::beginsWith(node.table_name, "main.")) {
+		node.table_name = node.table_name.substr(5);
+	}
+
+	if(node.type == relational_node_type::BINDABLE_SCAN) {
+		std::string project_string = get_named_expression(node.statement, "projects");
+		for(const std::string & project : get_expressions_from_expression_list(project_string, true)) {
+			node.projections.push_back(std::stoull(project));
+		}
+
+		std::string aliases_string = get_named_expression(node.statement, "aliases");
+		node.aliases = get_expressions_from_expression_list(aliases_string, true);
+
+		// This is for the count(*) case, we don't want to load all the columns
+		if(node.projections.size() == 0 && node.aliases.size() == 1) {
+			node.projections.push_back(0);
+		}
+
+		if(node.statement.find("filters") != std::string::npos) {
+			node.condition = get_filter_expression(node.statement);
+		}
+	}
+}
+
+// LogicalProject(x=[$0], y=[$1], z=[$2], e=[$3], join_x=[$4], y0=[$5], EXPR$6=[+($0, $5)])
+void parse_project(relational_node & node) {
+	std::string combined_expression = node.statement.substr(
+		node.statement.find("(") + 1, (node.statement.rfind(")") - node.statement.find("(")) - 1);
+
+	for(const std::string & named_expression : get_expressions_from_expression_list(combined_expression)) {
+		size_t assignment = named_expression.find("=[");
+		node.expression_names.push_back(named_expression.substr(0, assignment));
+		node.expressions.push_back(named_expression.substr(assignment + 2, (named_expression.size() - assignment) - 3));
+	}
+}
+
+void parse_join(relational_node & node) {
+	std::string filter_statement;
+	split_inequality_join_into_join_and_filter(node.statement, node.join_statement, filter_statement);
+	if(filter_statement != "") {
+		node.condition = get_named_expression(filter_statement, "condition");
+	}
+}
+
+std::unique_ptr<relational_node> parse_relational_node(const std::string & statement) {
+	std::string operator_name = statement.substr(0, statement.find("("));
+	StringUtil::trim(operator_name);
+	auto type_it = relational_node_types.find(operator_name);
+	if(type_it == relational_node_types.end()) {
+		throw std::runtime_error{"In parse_relational_plan function: unsupported query operator " + operator_name};
+	}
+
+	std::unique_ptr<relational_node> node(new relational_node());
+	node->type = type_it->second;
+	node->statement = statement;
+
+	switch(node->type) {
+	case relational_node_type::SCAN:
+	case relational_node_type::BINDABLE_SCAN: parse_scan(*node); break;
+	case relational_node_type::FILTER: node->condition = get_named_expression(statement, "condition"); break;
+	case relational_node_type::PROJECT: parse_project(*node); break;
+	case relational_node_type::AGGREGATE: node->aggregate = ral::operators::parse_aggregate(statement); break;
+	case relational_node_type::SORT: node->sort = ral::operators::parse_sort(statement); break;
+	case relational_node_type::JOIN: parse_join(*node); break;
+	case relational_node_type::UNION: node->union_all = (get_named_expression(statement, "all") == "true"); break;
+	}
+
+	return node;
+}
+
+}  // namespace
+
+bool relational_node::needs_communication() const {
+	if(type == relational_node_type::JOIN || type == relational_node_type::AGGREGATE ||
+		type == relational_node_type::SORT) {
+		return true;
+	}
+	for(const auto & child : children) {
+		if(child->needs_communication()) {
+			return true;
+		}
+	}
+	return false;
+}
+
+std::vector<std::string> relational_node::get_table_names() const {
+	if(is_scan()) {
+		return {table_name};
+	}
+
+	std::vector<std::string> table_names;
+	for(const auto & child : children) {
+		std::vector<std::string> child_table_names = child->get_table_names();
+		table_names.insert(table_names.end(), child_table_names.begin(), child_table_names.end());
+	}
+	return table_names;
+}
+
+std::string extract_table_name(const std::string & scan_statement) {
+	size_t start = scan_statement.find("[[") + 2;
+	size_t end = scan_statement.find("]]");
+	std::string table_name_text = scan_statement.substr(start, end - start);
+	std::vector<std::string> table_parts = StringUtil::split(table_name_text, ',');
+	std::string table_name = "";
+	for(int i = 0; i < table_parts.size(); i++) {
+		if(table_parts[i][0] == ' ') {
+			table_parts[i] = table_parts[i].substr(1, table_parts[i].size() - 1);
+		}
+		table_name += table_parts[i];
+		if(i != table_parts.size() - 1) {
+			table_name += ".";
+		}
+	}
+
+	return table_name;
+}
+
+std::unique_ptr<relational_node> parse_relational_plan(const std::string & logical_plan) {
+	std::unique_ptr<relational_node> root;
+	// the last node seen at each depth, the parent of a node is the last one seen one level above it
+	std::vector<relational_node *> ancestors;
+	size_t root_indentation = 0;
+
+	for(const std::string & line : StringUtil::split(logical_plan, "\n")) {
+		size_t indentation = line.find_first_not_of(' ');
+		if(indentation == std::string::npos) {
+			continue;
+		}
+
+		std::unique_ptr<relational_node> node = parse_relational_node(line.substr(indentation));
+		if(!root) {
+			root_indentation = indentation;
+			ancestors.push_back(node.get());
+			root = std::move(node);
+			continue;
+		}
+
+		size_t depth = (indentation - root_indentation) / 2;
+		if(depth == 0 || depth > ancestors.size()) {
+			throw std::runtime_error{"In parse_relational_plan function: malformed relational algebra at " + line};
+		}
+		ancestors.resize(depth);
+		ancestors.push_back(node.get());
+		ancestors[depth - 1]->children.push_back(std::move(node));
+	}
+
+	if(!root) {
+		throw std::runtime_error{"In parse_relational_plan function: empty relational algebra"};
+	}
+
+	return root;
+}
+
+}  // namespace parser
+}  // namespace ral
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "operators/GroupBy.h"
+#include "operators/OrderBy.h"
+
+namespace ral {
+namespace parser {
+
+enum class relational_node_type { SCAN, BINDABLE_SCAN, FILTER, PROJECT, AGGREGATE, SORT, JOIN, UNION };
+
+/**
+ * A node of the relational algebra produced by Calcite, parsed once so the interpreter does not need to identify
+ * and re-parse the plan text every time it visits a node.
+ *
+ * Only the members that correspond to the type of the node are filled.
+ */
+struct relational_node {
+	relational_node_type type;
+	// the Calcite text of the node, without indentation
+	std::string statement;
+	std::vector<std::unique_ptr<relational_node>> children;
+
+	// SCAN, BINDABLE_SCAN: name of the table without the main. schema prefix
+	std::string table_name;
+	// BINDABLE_SCAN: columns to load and their aliases
+	std::vector<size_t> projections;
+	std::vector<std::string> aliases;
+
+	// FILTER, BINDABLE_SCAN and JOIN: the filter condition, empty if there is nothing to filter. For joins this is
+	// the part of the condition that is not an equijoin and has to be applied after the join
+	std::string condition;
+
+	// PROJECT: names and expressions of the output columns
+	std::vector<std::string> expression_names;
+	std::vector<std::string> expressions;
+
+	// AGGREGATE
+	ral::operators::aggregate_plan aggregate;
+
+	// SORT
+	ral::operators::sort_plan sort;
+
+	// JOIN: equijoin statement to pass to process_join
+	std::string join_statement;
+
+	// UNION
+	bool union_all = false;
+
+	bool is_scan() const { return type == relational_node_type::SCAN || type == relational_node_type::BINDABLE_SCAN; }
+
+	bool is_double_input() const { return type == relational_node_type::JOIN || type == relational_node_type::UNION; }
+
+	/**
+	 * whether this node or any of its descendants exchange messages with other nodes when running distributed
+	 */
+	bool needs_communication() const;
+
+	/**
+	 * names of the tables scanned by this node and its descendants
+	 */
+	std::vector<std::string> get_table_names() const;
+};
+
+/**
+ * Input: [[hr, emps]] or [[emps]] Output: hr.emps or emps
+ */
+std::string extract_table_name(const std::string & scan_statement);
+
+/**
+ * Parses the relational algebra text produced by Calcite, one node per line and two spaces of indentation per level
+ * @throws std::runtime_error if the plan contains an unsupported operator
+ */
+std::unique_ptr<relational_node> parse_relational_plan(const std::string & logical_plan);
+
+}  // namespace parser
+}  // namespace ral
@@ -0,0 +1,125 @@
+#include "GDFColumn.cuh"
+#include "config/BlazingConfig.h"
+#include "distribution/collectives.h"
+#include "forked_nodes.h"
+#include <blazingdb/manager/Context.h>
+#include <cuda_runtime_api.h>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <vector>
+
+// Every node of the simulated cluster of forked_nodes.h runs the same collectives.
+
+namespace {
+
+using blazingdb::manager::Context;
+using ral::distribution::NodeColumns;
+namespace collectives = ral::distribution::collectives;
+
+std::vector<gdf_column_cpp> makeTable(std::vector<int64_t> values) {
+	std::vector<gdf_column_cpp> table(1);
+	table[0].create_gdf_column(GDF_INT64, gdf_dtype_extra_info{}, values.size(), values.data(), sizeof(int64_t), "a");
+	return table;
+}
+
+std::vector<int64_t> toHost(std::vector<gdf_column_cpp> & table) {
+	std::vector<int64_t> values(table[0].size());
+	cudaMemcpy(values.data(), table[0].data(), values.size() * sizeof(int64_t), cudaMemcpyDeviceToHost);
+	return values;
+}
+
+std::vector<int64_t> iota(std::size_t size, int64_t first) {
+	std::vector<int64_t> values(size);
+	std::iota(values.begin(), values.end(), first);
+	return values;
+}
+
+}  // namespace
+
+TEST(CollectivesTest, BinomialTreeReachesEveryNodeOnce) {
+	for(int num_nodes = 1; num_nodes <= 64; num_nodes++) {
+		std::vector<int> parents(num_nodes, 0);
+		for(int rank = 0; rank < num_nodes; rank++) {
+			for(int child : collectives::binomialTreeChildren(rank, num_nodes)) {
+				EXPECT_EQ(collectives::binomialTreeParent(child), rank);
+				parents[child]++;
+			}
+		}
+		EXPECT_EQ(collectives::binomialTreeParent(0), -1);
+		for(int rank = 1; rank < num_nodes; rank++) {
+			EXPECT_EQ(parents[rank], 1);
+		}
+		// the root sends once per round instead of once per node
+		EXPECT_EQ(collectives::binomialTreeChildren(0, num_nodes).size(),
+			static_cast<std::size_t>(collectives::allGatherRounds(num_nodes)));
+	}
+}
+
+TEST(CollectivesTest, AllGather) {
+	const int num_nodes = 5;
+	int failures = runNodes(num_nodes, 9100, [&](Context & context, int self) {
+		std::vector<std::vector<int64_t>> node_values = ral::distribution::allGather(context, {self, self * self});
+		ASSERT_EQ(node_values.size(), static_cast<std::size_t>(num_nodes));
+		for(int i = 0; i < num_nodes; i++) {
+			EXPECT_EQ(node_values[i], (std::vector<int64_t>{i, i * i}));
+		}
+	});
+	EXPECT_EQ(failures, 0);
+}
+
+TEST(CollectivesTest, AllReduce) {
+	const int num_nodes = 6;
+	int failures = runNodes(num_nodes, 9200, [&](Context & context, int self) {
+		std::vector<int64_t> sums =
+			ral::distribution::allReduce(context, {self, 1}, [](int64_t a, int64_t b) { return a + b; });
+		EXPECT_EQ(sums, (std::vector<int64_t>{15, 6}));
+
+		context.incrementQuerySubstep();
+		std::vector<int64_t> maximum =
+			ral::distribution::allReduce(context, {self}, [](int64_t a, int64_t b) { return std::max(a, b); });
+		EXPECT_EQ(maximum, std::vector<int64_t>{5});
+	});
+	EXPECT_EQ(failures, 0);
+}
+
+TEST(CollectivesTest, BroadcastTableInChunks) {
+	const int num_nodes = 6;
+	const int root = 2;
+	int failures = runNodes(num_nodes, 9300, [&](Context & context, int self) {
+		// 100 rows per chunk
+		ral::config::BlazingConfig::getInstance().setPartitionChunkSize(100 * sizeof(int64_t));
+		std::vector<gdf_column_cpp> table;
+		if(self == root) {
+			table = makeTable(iota(1050, 0));
+		}
+		std::vector<gdf_column_cpp> received = ral::distribution::broadcastTable(context, root, table);
+		ASSERT_EQ(received.size(), 1u);
+		EXPECT_EQ(toHost(received), iota(1050, 0));
+	});
+	EXPECT_EQ(failures, 0);
+}
+
+TEST(CollectivesTest, AllGatherTablesSkipsEmptyNodes) {
+	const int num_nodes = 5;
+	int failures = runNodes(num_nodes, 9400, [&](Context & context, int self) {
+		ral::config::BlazingConfig::getInstance().setPartitionChunkSize(100 * sizeof(int64_t));
+		// nodes 0, 1 and 3 have no rows, they only forward the tables of the others
+		std::vector<gdf_size_type> nodes_num_rows{0, 0, 300, 0, 600};
+		std::vector<gdf_column_cpp> table = makeTable(iota(nodes_num_rows[self], 1000 * self));
+
+		std::vector<NodeColumns> node_columns = ral::distribution::allGatherTables(context, table, nodes_num_rows);
+		std::vector<int64_t> rows_per_node(num_nodes, 0);
+		for(auto & chunk : node_columns) {
+			int node_idx = context.getNodeIndex(chunk.getNode());
+			std::vector<gdf_column_cpp> columns = chunk.getColumns();
+			for(int64_t value : toHost(columns)) {
+				EXPECT_EQ(value / 1000, node_idx);
+			}
+			rows_per_node[node_idx] += columns[0].size();
+		}
+		for(int i = 0; i < num_nodes; i++) {
+			EXPECT_EQ(rows_per_node[i], i == self ? 0 : nodes_num_rows[i]);
+		}
+	});
+	EXPECT_EQ(failures, 0);
+}
@@ -0,0 +1,206 @@
+#include "DataFrame.h"
+#include "GDFColumn.cuh"
+#include "distribution/collectives.h"
+#include "forked_nodes.h"
+#include "operators/GroupBy.h"
+#include <algorithm>
+#include <blazingdb/manager/Context.h>
+#include <cuda_runtime_api.h>
+#include <gtest/gtest.h>
+#include <map>
+#include <nvstrings/NVCategory.h>
+#include <nvstrings/NVStrings.h>
+#include <tuple>
+#include <vector>
+
+// Every node of the simulated cluster of forked_nodes.h groups its own rows with the HASH partitioning and then all of
+// them gather the groups of the others, to check that each group ends in exactly one node.
+
+namespace {
+
+using blazingdb::manager::Context;
+
+const std::vector<const char *> words{"kiwi", "lime", "pear", "plum"};
+
+// a group: the int key, the index of the string key in words and -1 for the nulls
+using group_key = std::pair<int64_t, int64_t>;
+
+// The rows of node self: every group is in most nodes, the nulls of the int key have a different value under them in
+// each row and the last node has no rows
+struct node_rows {
+	node_rows(int self, int num_nodes) {
+		const gdf_size_type num_rows = self == num_nodes - 1 ? 0 : 150 + 25 * self;
+		valid.assign((num_rows + GDF_VALID_BITSIZE - 1) / GDF_VALID_BITSIZE, 0);
+		for(gdf_size_type row = 0; row < num_rows; row++) {
+			int64_t int_key = (row + self) % 7;
+			int64_t string_key = (row * 3 + self) % 5;
+			if(int_key != 6) {
+				valid[row / GDF_VALID_BITSIZE] |= 1 << (row % GDF_VALID_BITSIZE);
+			} else {
+				int_key = -1;
+			}
+			if(string_key == 4) {
+				string_key = -1;
+			}
+
+			int_keys.push_back(int_key != -1 ? int_key : row * 1000 + self);
+			strings.push_back(string_key != -1 ? words[string_key] : nullptr);
+			values.push_back(self + 1);
+			groups.emplace_back(int_key, string_key);
+		}
+	}
+
+	std::vector<gdf_column_cpp> table() {
+		std::vector<gdf_column_cpp> columns(3);
+		columns[0].create_gdf_column(GDF_INT64,
+			gdf_dtype_extra_info{},
+			int_keys.size(),
+			int_keys.data(),
+			valid.data(),
+			sizeof(int64_t),
+			"int_key");
+		NVCategory * category = NVCategory::create_from_array(strings.data(), strings.size());
+		columns[1].create_gdf_column(category, strings.size(), "string_key");
+		columns[2].create_gdf_column(
+			GDF_INT64, gdf_dtype_extra_info{}, values.size(), values.data(), sizeof(int64_t), "value");
+		return columns;
+	}
+
+	std::vector<int64_t> int_keys;
+	std::vector<gdf_valid_type> valid;
+	std::vector<const char *> strings;
+	std::vector<int64_t> values;
+	std::vector<group_key> groups;
+};
+
+// the groups in the output of the node
+std::vector<group_key> toHostGroups(blazing_frame & output) {
+	gdf_column_cpp & int_keys = output.get_column(0);
+	gdf_column_cpp & string_keys = output.get_column(1);
+	const gdf_size_type num_rows = int_keys.size();
+	if(num_rows == 0) {
+		return {};
+	}
+
+	std::vector<int64_t> values(num_rows);
+	cudaMemcpy(values.data(), int_keys.data(), num_rows * sizeof(int64_t), cudaMemcpyDeviceToHost);
+	std::vector<gdf_valid_type> valid((num_rows + GDF_VALID_BITSIZE - 1) / GDF_VALID_BITSIZE, 0xff);
+	if(int_keys.valid() != nullptr) {
+		cudaMemcpy(valid.data(), int_keys.valid(), valid.size(), cudaMemcpyDeviceToHost);
+	}
+
+	NVCategory * category = static_cast<NVCategory *>(string_keys.dtype_info().category);
+	NVStrings * strings =
+		category->gather_strings(static_cast<nv_category_index_type *>(string_keys.data()), num_rows, true);
+	std::vector<unsigned char> string_valid((num_rows + 7) / 8, 0);
+	strings->set_null_bitarray(string_valid.data(), false, false);
+	std::vector<std::vector<char>> buffers(num_rows, std::vector<char>(8));
+	std::vector<char *> host_strings;
+	for(auto & buffer : buffers) {
+		host_strings.push_back(buffer.data());
+	}
+	strings->to_host(host_strings.data(), 0, num_rows);
+	NVStrings::destroy(strings);
+
+	std::vector<group_key> groups;
+	for(gdf_size_type row = 0; row < num_rows; row++) {
+		int64_t int_key = (valid[row / GDF_VALID_BITSIZE] >> (row % GDF_VALID_BITSIZE)) & 1 ? values[row] : -1;
+		int64_t string_key = -1;
+		if((string_valid[row / 8] >> (row % 8)) & 1) {
+			const std::string string(buffers[row].data());
+			auto word = std::find_if(words.begin(), words.end(), [&](const char * word) { return string == word; });
+			EXPECT_NE(word, words.end());
+			string_key = word - words.begin();
+		}
+		groups.emplace_back(int_key, string_key);
+	}
+	return groups;
+}
+
+std::vector<int64_t> toHost(gdf_column_cpp & column) {
+	std::vector<int64_t> values(column.size());
+	cudaMemcpy(values.data(), column.data(), values.size() * sizeof(int64_t), cudaMemcpyDeviceToHost);
+	return values;
+}
+
+// Gathers the groups of every node, with their sums when there are, and checks that each group of the rows of all
+// the nodes is in exactly one node
+void checkGroupsInOneNode(Context & context, int self, blazing_frame & output, bool with_sums) {
+	const int num_nodes = context.getTotalNodes();
+	std::vector<group_key> groups = toHostGroups(output);
+	std::vector<int64_t> sums = with_sums ? toHost(output.get_column(2)) : std::vector<int64_t>(groups.size(), 0);
+	std::vector<int64_t> flattened;
+	for(std::size_t row = 0; row < groups.size(); row++) {
+		flattened.insert(flattened.end(), {groups[row].first, groups[row].second, sums[row]});
+	}
+
+	context.incrementQuerySubstep();
+	std::vector<std::vector<int64_t>> node_groups = ral::distribution::allGather(context, flattened);
+	ASSERT_EQ(node_groups.size(), static_cast<std::size_t>(num_nodes));
+
+	// the node of each group and its sum
+	std::map<group_key, std::pair<int, int64_t>> found;
+	for(int i = 0; i < num_nodes; i++) {
+		for(std::size_t row = 0; row < node_groups[i].size(); row += 3) {
+			group_key group{node_groups[i][row], node_groups[i][row + 1]};
+			auto inserted = found.emplace(group, std::make_pair(i, node_groups[i][row + 2]));
+			EXPECT_TRUE(inserted.second) << "group (" << group.first << ", " << group.second << ") in nodes "
+										 << inserted.first->second.first << " and " << i;
+		}
+	}
+
+	std::map<group_key, int64_t> expected;
+	for(int i = 0; i < num_nodes; i++) {
+		node_rows rows(i, num_nodes);
+		for(std::size_t row = 0; row < rows.groups.size(); row++) {
+			expected[rows.groups[row]] += with_sums ? rows.values[row] : 0;
+		}
+	}
+	// the null int keys and the null strings are groups too
+	EXPECT_EQ(expected.size(), 7u * 5u);
+	EXPECT_EQ(found.size(), expected.size());
+	for(auto & group : expected) {
+		auto it = found.find(group.first);
+		ASSERT_NE(it, found.end()) << "group (" << group.first.first << ", " << group.first.second << ") is missing";
+		EXPECT_EQ(it->second.second, group.second);
+	}
+}
+
+}  // namespace
+
+TEST(HashGroupByTest, AggregationsWithGroupBy) {
+	const int num_nodes = 4;
+	int failures = runNodes(num_nodes, 9800, [&](Context & context, int self) {
+		node_rows rows(self, num_nodes);
+		blazing_frame input;
+		input.add_table(rows.table());
+
+		ral::operators::aggregate_plan plan;
+		plan.group_column_indices = {0, 1};
+		plan.aggregation_types = {GDF_SUM};
+		plan.aggregation_input_expressions = {"$2"};
+		plan.aggregation_column_assigned_aliases = {""};
+		ral::operators::process_aggregate(input, plan, &context);
+
+		ASSERT_EQ(input.get_width(), 3u);
+		checkGroupsInOneNode(context, self, input, true);
+	});
+	EXPECT_EQ(failures, 0);
+}
+
+TEST(HashGroupByTest, GroupByWithoutAggregations) {
+	const int num_nodes = 4;
+	int failures = runNodes(num_nodes, 9900, [&](Context & context, int self) {
+		node_rows rows(self, num_nodes);
+		blazing_frame input;
+		input.add_table(rows.table());
+
+		ral::operators::aggregate_plan plan;
+		plan.group_column_indices = {0, 1};
+		ral::operators::process_aggregate(input, plan, &context);
+
+		ASSERT_GE(input.get_width(), 2u);
+		checkGroupsInOneNode(context, self, input, false);
+	});
+	EXPECT_EQ(failures, 0);
+}
@@ -0,0 +1,271 @@
+#include "DataFrame.h"
+#include "GDFColumn.cuh"
+#include "distribution/NodeColumns.h"
+#include "distribution/kway_merge.h"
+#include "distribution/primitives.h"
+#include <algorithm>
+#include <blazingdb/transport/Address.h>
+#include <blazingdb/transport/Node.h>
+#include <cuda_runtime_api.h>
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <nvstrings/NVCategory.h>
+#include <nvstrings/NVStrings.h>
+#include <random>
+#include <rmm/rmm.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+using blazingdb::transport::Address;
+using blazingdb::transport::Node;
+using ral::distribution::host_kway_merge;
+using ral::distribution::merge_position;
+using ral::distribution::NodeColumns;
+
+// A sorted run of the tests: ascending by first, then descending by second
+struct host_run {
+	std::vector<int64_t> first;
+	std::vector<int32_t> second;
+	// position of each row in the concatenation of all the runs
+	std::vector<int32_t> row;
+};
+
+bool run_less(const host_run & a, gdf_size_type a_row, const host_run & b, gdf_size_type b_row) {
+	if(a.first[a_row] != b.first[b_row]) {
+		return a.first[a_row] < b.first[b_row];
+	}
+	return a.second[a_row] > b.second[b_row];
+}
+
+// few distinct keys, so that many rows of different runs have the same keys
+std::vector<host_run> random_runs(const std::vector<gdf_size_type> & run_sizes, int64_t max_key, unsigned seed) {
+	std::mt19937 generator(seed);
+	std::uniform_int_distribution<int64_t> distribution(0, max_key);
+	std::vector<host_run> runs(run_sizes.size());
+	int32_t row = 0;
+	for(size_t i = 0; i < runs.size(); i++) {
+		std::vector<std::pair<int64_t, int32_t>> keys(run_sizes[i]);
+		for(auto & key : keys) {
+			key = {distribution(generator), static_cast<int32_t>(distribution(generator) % 8)};
+		}
+		std::sort(keys.begin(), keys.end(), [](std::pair<int64_t, int32_t> a, std::pair<int64_t, int32_t> b) {
+			return a.first != b.first ? a.first < b.first : a.second > b.second;
+		});
+		for(const auto & key : keys) {
+			runs[i].first.push_back(key.first);
+			runs[i].second.push_back(key.second);
+			runs[i].row.push_back(row++);
+		}
+	}
+	return runs;
+}
+
+std::vector<merge_position> host_merge(const std::vector<host_run> & runs) {
+	std::vector<gdf_size_type> run_sizes;
+	for(const host_run & run : runs) {
+		run_sizes.push_back(run.first.size());
+	}
+	return host_kway_merge(run_sizes, [&runs](const merge_position & a, const merge_position & b) {
+		return run_less(runs[a.run], a.row, runs[b.run], b.row);
+	});
+}
+
+std::vector<gdf_column_cpp> to_device(const host_run & run, int num_payload_columns) {
+	const gdf_size_type num_rows = run.first.size();
+	std::vector<gdf_column_cpp> table(3 + num_payload_columns);
+	table[0].create_gdf_column(GDF_INT64,
+		gdf_dtype_extra_info{},
+		num_rows,
+		const_cast<int64_t *>(run.first.data()),
+		sizeof(int64_t),
+		"first");
+	table[1].create_gdf_column(GDF_INT32,
+		gdf_dtype_extra_info{},
+		num_rows,
+		const_cast<int32_t *>(run.second.data()),
+		sizeof(int32_t),
+		"second");
+	table[2].create_gdf_column(
+		GDF_INT32, gdf_dtype_extra_info{}, num_rows, const_cast<int32_t *>(run.row.data()), sizeof(int32_t), "row");
+	for(int i = 0; i < num_payload_columns; i++) {
+		table[3 + i].create_gdf_column(GDF_INT64,
+			gdf_dtype_extra_info{},
+			num_rows,
+			const_cast<int64_t *>(run.first.data()),
+			sizeof(int64_t),
+			"payload");
+	}
+	return table;
+}
+
+std::vector<int32_t> to_host(gdf_column_cpp & column) {
+	std::vector<int32_t> values(column.size());
+	cudaMemcpy(values.data(), column.data(), values.size() * sizeof(int32_t), cudaMemcpyDeviceToHost);
+	return values;
+}
+
+gdf_column_cpp string_column(const std::vector<std::string> & strings, const std::string & name) {
+	std::vector<const char *> host_strings;
+	for(const std::string & string : strings) {
+		host_strings.push_back(string.c_str());
+	}
+	NVCategory * category = NVCategory::create_from_array(host_strings.data(), host_strings.size());
+	gdf_column_cpp column;
+	column.create_gdf_column(category, strings.size(), name);
+	return column;
+}
+
+// the strings of a GDF_STRING_CATEGORY column whose strings all have length characters
+std::vector<std::string> to_host_strings(gdf_column_cpp & column, size_t length) {
+	NVCategory * category = static_cast<NVCategory *>(column.dtype_info().category);
+	NVStrings * strings =
+		category->gather_strings(static_cast<nv_category_index_type *>(column.data()), column.size(), true);
+	std::vector<std::vector<char>> buffers(column.size(), std::vector<char>(length + 1));
+	std::vector<char *> host_strings;
+	for(auto & buffer : buffers) {
+		host_strings.push_back(buffer.data());
+	}
+	strings->to_host(host_strings.data(), 0, column.size());
+	NVStrings::destroy(strings);
+
+	std::vector<std::string> values;
+	for(auto & buffer : buffers) {
+		values.emplace_back(buffer.data(), length);
+	}
+	return values;
+}
+
+struct SortedMergerTest : public ::testing::Test {
+	void SetUp() {
+		rmmInitialize(nullptr);
+		node = Node::Make(Address::TCP("127.0.0.1", 8000, 9000));
+	}
+
+	std::vector<NodeColumns> node_columns(const std::vector<host_run> & runs, int num_payload_columns) {
+		std::vector<NodeColumns> columns;
+		for(const host_run & run : runs) {
+			columns.emplace_back(*node, to_device(run, num_payload_columns));
+		}
+		return columns;
+	}
+
+	std::shared_ptr<Node> node;
+	std::vector<int8_t> sortOrderTypes{0, 1};
+	std::vector<int> sortColIndices{0, 1};
+};
+
+}  // namespace
+
+TEST(HostKWayMergeTest, same_rows_as_a_stable_sort) {
+	std::mt19937 generator(1);
+	for(int k = 0; k <= 64; k++) {
+		std::vector<gdf_size_type> run_sizes(k);
+		for(auto & run_size : run_sizes) {
+			// some of the runs are empty
+			run_size = generator() % 4 == 0 ? 0 : generator() % 100;
+		}
+		std::vector<host_run> runs = random_runs(run_sizes, 20, k);
+
+		std::vector<merge_position> expected;
+		for(int run = 0; run < k; run++) {
+			for(gdf_size_type row = 0; row < run_sizes[run]; row++) {
+				expected.push_back({run, row});
+			}
+		}
+		std::stable_sort(expected.begin(), expected.end(), [&runs](const merge_position & a, const merge_position & b) {
+			return run_less(runs[a.run], a.row, runs[b.run], b.row);
+		});
+		EXPECT_EQ(host_merge(runs), expected) << "k " << k;
+	}
+}
+
+TEST_F(SortedMergerTest, same_rows_as_the_host) {
+	for(int k : {1, 2, 3, 5, 8, 13, 17}) {
+		std::vector<gdf_size_type> run_sizes(k, 1000);
+		// an empty partition in the middle
+		if(k > 2) {
+			run_sizes[1] = 0;
+		}
+		std::vector<host_run> runs = random_runs(run_sizes, 50, k);
+		std::vector<NodeColumns> columns = node_columns(runs, 1);
+
+		blazing_frame output;
+		ral::distribution::sortedMerger(columns, sortOrderTypes, sortColIndices, output);
+
+		std::vector<merge_position> expected = host_merge(runs);
+		ASSERT_EQ(output.get_num_rows_in_table(0), expected.size()) << "k " << k;
+		EXPECT_EQ(output.get_column(2).name(), "row");
+		// the merge is stable, the rows of the same keys are also the same
+		std::vector<int32_t> rows = to_host(output.get_column(2));
+		for(size_t i = 0; i < expected.size(); i++) {
+			ASSERT_EQ(rows[i], runs[expected[i].run].row[expected[i].row]) << "k " << k << " row " << i;
+		}
+	}
+}
+
+TEST_F(SortedMergerTest, no_rows) {
+	std::vector<host_run> runs = random_runs({0, 0, 0}, 50, 1);
+	std::vector<NodeColumns> columns = node_columns(runs, 1);
+
+	blazing_frame output;
+	ral::distribution::sortedMerger(columns, sortOrderTypes, sortColIndices, output);
+	EXPECT_EQ(output.get_num_rows_in_table(0), 0);
+	EXPECT_EQ(output.get_width(), 4);
+}
+
+TEST_F(SortedMergerTest, string_category_keys_and_payloads) {
+	// every partition has its own keys and payloads, so the categories of the same column differ between them
+	const std::vector<gdf_size_type> run_sizes{300, 0, 500, 1, 200};
+	std::mt19937 generator(1);
+	std::vector<std::vector<std::string>> keys(run_sizes.size());
+	std::vector<std::vector<std::string>> payloads(run_sizes.size());
+	std::vector<NodeColumns> columns;
+	int32_t row = 0;
+	for(size_t run = 0; run < run_sizes.size(); run++) {
+		char key[8];
+		for(gdf_size_type i = 0; i < run_sizes[run]; i++) {
+			// some keys are in every partition and some only in this one
+			int value = generator() % 40;
+			snprintf(key, sizeof(key), "k%02d-%02d", value, value % 2 == 0 ? 0 : static_cast<int>(run));
+			keys[run].push_back(key);
+		}
+		std::sort(keys[run].begin(), keys[run].end());
+
+		std::vector<int32_t> rows(run_sizes[run]);
+		char payload[12];
+		for(gdf_size_type i = 0; i < run_sizes[run]; i++) {
+			rows[i] = row++;
+			snprintf(payload, sizeof(payload), "p%02d-r%06d", static_cast<int>(run), rows[i]);
+			payloads[run].push_back(payload);
+		}
+
+		std::vector<gdf_column_cpp> table(3);
+		table[0] = string_column(keys[run], "key");
+		table[1].create_gdf_column(GDF_INT32, gdf_dtype_extra_info{}, rows.size(), rows.data(), sizeof(int32_t), "row");
+		table[2] = string_column(payloads[run], "payload");
+		columns.emplace_back(*node, table);
+	}
+
+	std::vector<int8_t> keyOrderTypes{0};
+	std::vector<int> keyColIndices{0};
+	blazing_frame output;
+	ral::distribution::sortedMerger(columns, keyOrderTypes, keyColIndices, output);
+
+	std::vector<merge_position> expected =
+		host_kway_merge(run_sizes, [&keys](const merge_position & a, const merge_position & b) {
+			return keys[a.run][a.row] < keys[b.run][b.row];
+		});
+	ASSERT_EQ(output.get_num_rows_in_table(0), expected.size());
+	EXPECT_EQ(output.get_column(0).dtype(), GDF_STRING_CATEGORY);
+	EXPECT_EQ(output.get_column(2).dtype(), GDF_STRING_CATEGORY);
+
+	std::vector<std::string> output_keys = to_host_strings(output.get_column(0), 6);
+	std::vector<std::string> output_payloads = to_host_strings(output.get_column(2), 11);
+	for(size_t i = 0; i < expected.size(); i++) {
+		ASSERT_EQ(output_keys[i], keys[expected[i].run][expected[i].row]) << "row " << i;
+		ASSERT_EQ(output_payloads[i], payloads[expected[i].run][expected[i].row]) << "row " << i;
+	}
+}
@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+
+#include "io/data_parser/MetadataCache.h"
+
+using ral::io::file_metadata;
+using ral::io::metadata_cache;
+
+struct MetadataCacheTest : public ::testing::Test {
+  std::shared_ptr<const file_metadata> metadata(size_t num_rows, size_t size_in_bytes) {
+    std::shared_ptr<file_metadata> metadata = std::make_shared<file_metadata>();
+    metadata->names = {"n_nationkey", "n_name"};
+    metadata->dtypes = {GDF_INT32, GDF_STRING};
+    metadata->time_units = {TIME_UNIT_NONE, TIME_UNIT_NONE};
+    metadata->num_rows = num_rows;
+    metadata->num_row_groups = 1;
+    metadata->size_in_bytes = size_in_bytes;
+    return metadata;
+  }
+};
+
+TEST_F(MetadataCacheTest, key_includes_size_and_version) {
+  std::string key = metadata_cache::make_key("s3://bucket/nation.parquet", 2048, "\"etag1\"");
+
+  EXPECT_NE(key, metadata_cache::make_key("s3://bucket/nation.parquet", 4096, "\"etag1\""));
+  EXPECT_NE(key, metadata_cache::make_key("s3://bucket/nation.parquet", 2048, "\"etag2\""));
+  EXPECT_EQ(metadata_cache::make_key("s3://bucket/nation.parquet", 2048, ""), "");
+}
+
+TEST_F(MetadataCacheTest, hit_returns_cached_metadata) {
+  metadata_cache cache(1024);
+  std::string key = metadata_cache::make_key("/data/nation.parquet", 2048, "1571234567.0");
+
+  EXPECT_EQ(cache.get(key), nullptr);
+  cache.put(key, metadata(25, 100));
+
+  std::shared_ptr<const file_metadata> cached = cache.get(key);
+  ASSERT_NE(cached, nullptr);
+  EXPECT_EQ(cached->num_rows, 25);
+  EXPECT_EQ(cached->names[1], "n_name");
+  EXPECT_EQ(cache.get_hits(), 1);
+  EXPECT_EQ(cache.get_misses(), 1);
+}
+
+TEST_F(MetadataCacheTest, evicts_least_recently_used_by_size) {
+  metadata_cache cache(250);
+
+  cache.put("nation", metadata(25, 100));
+  cache.put("region", metadata(5, 100));
+  cache.get("nation");
+  cache.put("orders", metadata(1500000, 100));
+
+  // region was the least recently used entry
+  EXPECT_NE(cache.get("nation"), nullptr);
+  EXPECT_EQ(cache.get("region"), nullptr);
+  EXPECT_NE(cache.get("orders"), nullptr);
+  EXPECT_EQ(cache.get_num_entries(), 2);
+  EXPECT_EQ(cache.get_size_in_bytes(), 200);
+}
+
+TEST_F(MetadataCacheTest, replacing_entry_keeps_size) {
+  metadata_cache cache(250);
+
+  cache.put("nation", metadata(25, 100));
+  cache.put("nation", metadata(25, 120));
+
+  EXPECT_EQ(cache.get_num_entries(), 1);
+  EXPECT_EQ(cache.get_size_in_bytes(), 120);
+}
+
+TEST_F(MetadataCacheTest, uncacheable_entries_are_ignored) {
+  metadata_cache cache(250);
+
+  cache.put("", metadata(25, 100));
+  cache.put("lineitem", metadata(6000000, 1000));
+
+  EXPECT_EQ(cache.get_num_entries(), 0);
+  EXPECT_EQ(cache.get_size_in_bytes(), 0);
+}
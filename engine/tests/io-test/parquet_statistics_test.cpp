@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+
+#include "io/data_parser/ParquetParser.h"
+#include "io/data_parser/RowGroupFilter.h"
+
+#include <arrow/buffer.h>
+#include <arrow/io/memory.h>
+#include <parquet/file_reader.h>
+#include <parquet/metadata.h>
+#include <parquet/schema.h>
+
+using ral::io::column_statistics;
+using ral::io::row_group_filter;
+
+// The footer of a file with one row group of 3 rows and two INT64 columns with statistics of min 10 and max 20 but
+// without a null count, as older writers leave them: n_nationkey is OPTIONAL and n_regionkey is REQUIRED. The writers
+// we can call here always set the null count, so the thrift bytes are written by hand. Only the footer is read, so
+// the column chunks are zeros
+const std::vector<uint8_t> footer_without_null_count{
+    0x15, 0x02, 0x19, 0x3c, 0x48, 0x06, 0x73, 0x63, 0x68, 0x65, 0x6d, 0x61, 0x15, 0x04, 0x00, 0x15,
+    0x04, 0x25, 0x02, 0x18, 0x0b, 0x6e, 0x5f, 0x6e, 0x61, 0x74, 0x69, 0x6f, 0x6e, 0x6b, 0x65, 0x79,
+    0x00, 0x15, 0x04, 0x25, 0x00, 0x18, 0x0b, 0x6e, 0x5f, 0x72, 0x65, 0x67, 0x69, 0x6f, 0x6e, 0x6b,
+    0x65, 0x79, 0x00, 0x16, 0x06, 0x19, 0x1c, 0x19, 0x2c, 0x26, 0x08, 0x1c, 0x15, 0x04, 0x19, 0x15,
+    0x00, 0x19, 0x18, 0x0b, 0x6e, 0x5f, 0x6e, 0x61, 0x74, 0x69, 0x6f, 0x6e, 0x6b, 0x65, 0x79, 0x15,
+    0x00, 0x16, 0x06, 0x16, 0x30, 0x16, 0x30, 0x26, 0x08, 0x3c, 0x18, 0x08, 0x14, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x18, 0x08, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x26, 0x38, 0x1c, 0x15, 0x04, 0x19, 0x15, 0x00, 0x19, 0x18, 0x0b, 0x6e, 0x5f, 0x72, 0x65,
+    0x67, 0x69, 0x6f, 0x6e, 0x6b, 0x65, 0x79, 0x15, 0x00, 0x16, 0x06, 0x16, 0x30, 0x16, 0x30, 0x26,
+    0x38, 0x3c, 0x18, 0x08, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x18, 0x08, 0x0a, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x16, 0x60, 0x16, 0x06, 0x00, 0x28, 0x19,
+    0x70, 0x61, 0x72, 0x71, 0x75, 0x65, 0x74, 0x2d, 0x63, 0x70, 0x70, 0x20, 0x76, 0x65, 0x72, 0x73,
+    0x69, 0x6f, 0x6e, 0x20, 0x31, 0x2e, 0x35, 0x2e, 0x31, 0x00,
+};
+
+struct ParquetStatisticsTest : public ::testing::Test {
+  std::map<std::string, column_statistics> read_statistics(const std::vector<uint8_t> &footer) {
+    std::string file("PAR1");
+    file.append(48, '\0');
+    file.append(footer.begin(), footer.end());
+    int32_t footer_size = footer.size();
+    file.append(reinterpret_cast<const char *>(&footer_size), sizeof(footer_size));
+    file.append("PAR1");
+
+    std::unique_ptr<parquet::ParquetFileReader> reader = parquet::ParquetFileReader::Open(
+        std::make_shared<arrow::io::BufferReader>(arrow::Buffer::FromString(std::move(file))));
+    std::shared_ptr<parquet::FileMetaData> metadata = reader->metadata();
+    std::unique_ptr<parquet::RowGroupMetaData> row_group = metadata->RowGroup(0);
+
+    std::map<std::string, column_statistics> statistics;
+    for (int column_index = 0; column_index < metadata->num_columns(); column_index++) {
+      const parquet::ColumnDescriptor *descriptor = metadata->schema()->Column(column_index);
+      statistics[descriptor->name()] =
+          ral::io::get_column_statistics(*row_group->ColumnChunk(column_index), *descriptor);
+    }
+    return statistics;
+  }
+
+  const std::vector<std::string> column_names{"n_nationkey", "n_regionkey"};
+};
+
+TEST_F(ParquetStatisticsTest, missing_null_count_is_unknown) {
+  std::map<std::string, column_statistics> statistics = read_statistics(footer_without_null_count);
+
+  ASSERT_EQ(statistics.size(), 2);
+  EXPECT_TRUE(statistics["n_nationkey"].has_min_max);
+  EXPECT_EQ(statistics["n_nationkey"].min, 10);
+  EXPECT_EQ(statistics["n_nationkey"].max, 20);
+  EXPECT_FALSE(statistics["n_nationkey"].has_null_count);
+  // a required column has no nulls whatever the footer says
+  EXPECT_TRUE(statistics["n_regionkey"].has_null_count);
+  EXPECT_EQ(statistics["n_regionkey"].null_count, 0);
+
+  EXPECT_TRUE(row_group_filter("IS NULL($0)", column_names).can_match(statistics, 3));
+  EXPECT_TRUE(row_group_filter("IS NOT NULL($0)", column_names).can_match(statistics, 3));
+  EXPECT_FALSE(row_group_filter("IS NULL($1)", column_names).can_match(statistics, 3));
+  EXPECT_FALSE(row_group_filter(">($0, 20)", column_names).can_match(statistics, 3));
+}
@@ -2,6 +2,7 @@
 
 #include <cstdlib>
 #include <iostream>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -108,4 +109,96 @@ TEST_F(ParseCSVTest, csv_with_strings) {
               << input_table[column_index].get_gdf_column()->size << std::endl;
     print_gdf_column(input_table[column_index].get_gdf_column());
   }
-}
\ No newline at end of file
+}
+struct MultiFileCSVTest : public ::testing::Test {
+
+  void SetUp() {
+    rmmInitialize(nullptr);
+
+    std::istringstream lines(content);
+    std::string line;
+    for (size_t file_index = 0; file_index < num_files; file_index++) {
+      std::string filename = "/tmp/nation_" + std::to_string(file_index) + ".psv";
+      std::ofstream outfile(filename, std::ofstream::out);
+      for (size_t row = 0; row < rows_per_file[file_index] && std::getline(lines, line); row++) {
+        outfile << line << std::endl;
+      }
+      outfile.close();
+      uris.push_back(Uri{filename});
+    }
+
+    args.names = {"n_nationkey", "n_name", "n_regionkey", "n_comment"};
+    args.dtype = {"int32", "str", "int32", "str"};
+    args.header = -1;
+    args.delimiter = '|';
+    args.use_cols_names = {"n_nationkey", "n_name", "n_regionkey", "n_comment"};
+  }
+
+  ral::io::Schema make_schema(std::vector<size_t> num_rows) {
+    std::vector<gdf_dtype> types{GDF_INT32, GDF_STRING_CATEGORY, GDF_INT32, GDF_STRING_CATEGORY};
+    return ral::io::Schema({"n_nationkey", "n_name", "n_regionkey", "n_comment"},
+                           {0, 1, 2, 3},
+                           types,
+                           {},
+                           std::vector<gdf_time_unit>(4, TIME_UNIT_NONE),
+                           std::vector<bool>(4, true),
+                           num_rows);
+  }
+
+  std::vector<gdf_column_cpp> load(const ral::io::Schema &schema) {
+    auto parser = std::make_shared<ral::io::csv_parser>(args);
+    auto provider = std::make_shared<ral::io::uri_data_provider>(uris);
+    ral::io::data_loader loader(parser, provider);
+
+    Context queryContext{0, std::vector<std::shared_ptr<Node>>(), std::shared_ptr<Node>(), ""};
+    std::vector<gdf_column_cpp> input_table;
+    loader.load_data(queryContext, input_table, {}, schema);
+    return input_table;
+  }
+
+  std::vector<int32_t> to_host(gdf_column_cpp &column) {
+    std::vector<int32_t> values(column.size());
+    cudaMemcpy(values.data(), column.data(), column.size() * sizeof(int32_t), cudaMemcpyDeviceToHost);
+    return values;
+  }
+
+  static constexpr size_t num_files = 3;
+  const std::vector<size_t> rows_per_file{10, 10, 5};
+  std::vector<Uri> uris;
+  cudf::csv_read_arg args{cudf::source_info{""}};
+};
+
+TEST_F(MultiFileCSVTest, concatenates_files) {
+  std::vector<gdf_column_cpp> input_table = load(make_schema({}));
+
+  ASSERT_EQ(input_table.size(), 4);
+  EXPECT_EQ(input_table[0].size(), 25);
+  EXPECT_EQ(input_table[1].size(), 25);
+
+  std::vector<int32_t> keys = to_host(input_table[0]);
+  for (int32_t row = 0; row < 25; row++) {
+    EXPECT_EQ(keys[row], row);
+  }
+}
+
+TEST_F(MultiFileCSVTest, appends_into_presized_columns) {
+  std::vector<gdf_column_cpp> input_table = load(make_schema(rows_per_file));
+
+  ASSERT_EQ(input_table.size(), 4);
+  EXPECT_EQ(input_table[0].size(), 25);
+  EXPECT_EQ(input_table[0].null_count(), 0);
+  EXPECT_EQ(input_table[1].dtype(), GDF_STRING_CATEGORY);
+  EXPECT_EQ(input_table[1].size(), 25);
+
+  std::vector<int32_t> keys = to_host(input_table[0]);
+  std::vector<int32_t> region_keys = to_host(input_table[2]);
+  for (int32_t row = 0; row < 25; row++) {
+    EXPECT_EQ(keys[row], row);
+  }
+  EXPECT_EQ(region_keys[4], 4);
+  EXPECT_EQ(region_keys[24], 1);
+}
+
+TEST_F(MultiFileCSVTest, wrong_row_count_throws) {
+  EXPECT_THROW(load(make_schema({10, 10, 6})), std::runtime_error);
+}
@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+
+#include "io/data_parser/RowGroupFilter.h"
+
+using ral::io::column_statistics;
+using ral::io::row_group_filter;
+
+struct RowGroupFilterTest : public ::testing::Test {
+  column_statistics number_range(long double min, long double max, int64_t null_count = 0) {
+    column_statistics statistics;
+    statistics.has_min_max = true;
+    statistics.min = min;
+    statistics.max = max;
+    statistics.has_null_count = true;
+    statistics.null_count = null_count;
+    return statistics;
+  }
+
+  column_statistics string_range(const std::string &min, const std::string &max) {
+    column_statistics statistics;
+    statistics.has_min_max = true;
+    statistics.is_string = true;
+    statistics.min_string = min;
+    statistics.max_string = max;
+    return statistics;
+  }
+
+  const std::vector<std::string> column_names{"n_nationkey", "n_name", "n_regionkey"};
+};
+
+TEST_F(RowGroupFilterTest, comparisons) {
+  std::map<std::string, column_statistics> statistics{{"n_nationkey", number_range(10, 20)}};
+
+  EXPECT_TRUE(row_group_filter("=($0, 15)", column_names).can_match(statistics, 100));
+  EXPECT_FALSE(row_group_filter("=($0, 21)", column_names).can_match(statistics, 100));
+  EXPECT_FALSE(row_group_filter("<($0, 10)", column_names).can_match(statistics, 100));
+  EXPECT_TRUE(row_group_filter("<=($0, 10)", column_names).can_match(statistics, 100));
+  EXPECT_FALSE(row_group_filter(">($0, 20)", column_names).can_match(statistics, 100));
+  EXPECT_TRUE(row_group_filter(">=($0, 20)", column_names).can_match(statistics, 100));
+  EXPECT_TRUE(row_group_filter("<>($0, 15)", column_names).can_match(statistics, 100));
+  // literal on the left side
+  EXPECT_FALSE(row_group_filter("<(20, $0)", column_names).can_match(statistics, 100));
+  EXPECT_TRUE(row_group_filter("<(19.5, $0)", column_names).can_match(statistics, 100));
+}
+
+TEST_F(RowGroupFilterTest, not_equal_single_value) {
+  std::map<std::string, column_statistics> statistics{{"n_nationkey", number_range(7, 7)}};
+
+  EXPECT_FALSE(row_group_filter("<>($0, 7)", column_names).can_match(statistics, 100));
+  EXPECT_TRUE(row_group_filter("<>($0, 8)", column_names).can_match(statistics, 100));
+}
+
+TEST_F(RowGroupFilterTest, and_or_in) {
+  std::map<std::string, column_statistics> statistics{{"n_nationkey", number_range(10, 20)},
+                                                       {"n_regionkey", number_range(0, 2)}};
+
+  EXPECT_FALSE(row_group_filter("AND(>($0, 12), >($2, 3))", column_names).can_match(statistics, 100));
+  EXPECT_TRUE(row_group_filter("OR(>($0, 12), >($2, 3))", column_names).can_match(statistics, 100));
+  EXPECT_FALSE(row_group_filter("OR(=($0, 1), =($0, 2), =($0, 3))", column_names).can_match(statistics, 100));
+  EXPECT_TRUE(row_group_filter("OR(=($0, 1), =($0, 12))", column_names).can_match(statistics, 100));
+}
+
+TEST_F(RowGroupFilterTest, nulls) {
+  std::map<std::string, column_statistics> no_nulls{{"n_nationkey", number_range(10, 20, 0)}};
+  std::map<std::string, column_statistics> some_nulls{{"n_nationkey", number_range(10, 20, 5)}};
+  column_statistics only_nulls_stats;
+  only_nulls_stats.has_null_count = true;
+  only_nulls_stats.null_count = 100;
+  std::map<std::string, column_statistics> only_nulls{{"n_nationkey", only_nulls_stats}};
+
+  EXPECT_FALSE(row_group_filter("IS NULL($0)", column_names).can_match(no_nulls, 100));
+  EXPECT_TRUE(row_group_filter("IS NULL($0)", column_names).can_match(some_nulls, 100));
+  EXPECT_TRUE(row_group_filter("IS NOT NULL($0)", column_names).can_match(some_nulls, 100));
+  EXPECT_FALSE(row_group_filter("IS NOT NULL($0)", column_names).can_match(only_nulls, 100));
+  EXPECT_FALSE(row_group_filter(">($0, 0)", column_names).can_match(only_nulls, 100));
+}
+
+TEST_F(RowGroupFilterTest, strings) {
+  std::map<std::string, column_statistics> statistics{{"n_name", string_range("ALGERIA", "EGYPT")}};
+
+  EXPECT_TRUE(row_group_filter("=($1, 'BRAZIL')", column_names).can_match(statistics, 25));
+  EXPECT_FALSE(row_group_filter("=($1, 'PERU')", column_names).can_match(statistics, 25));
+  EXPECT_FALSE(row_group_filter("<($1, 'AAA')", column_names).can_match(statistics, 25));
+}
+
+TEST_F(RowGroupFilterTest, unknown_is_kept) {
+  std::map<std::string, column_statistics> statistics{{"n_nationkey", number_range(10, 20)}};
+
+  // no statistics for the column
+  EXPECT_TRUE(row_group_filter("=($2, 100)", column_names).can_match(statistics, 100));
+  // expressions that are not a comparison between a column and a literal
+  EXPECT_TRUE(row_group_filter("=(+($0, 1), 100)", column_names).can_match(statistics, 100));
+  EXPECT_TRUE(row_group_filter("NOT(=($0, 15))", column_names).can_match(statistics, 100));
+  EXPECT_TRUE(row_group_filter("", column_names).can_match(statistics, 100));
+}
@@ -0,0 +1,103 @@
+#include "DataFrame.h"
+#include "GDFColumn.cuh"
+#include "forked_nodes.h"
+#include "operators/OrderBy.h"
+#include <algorithm>
+#include <blazingdb/manager/Context.h>
+#include <cuda_runtime_api.h>
+#include <gtest/gtest.h>
+#include <vector>
+
+// Every node of the simulated cluster of forked_nodes.h runs the same LIMIT query on its own rows.
+
+namespace {
+
+using blazingdb::manager::Context;
+
+// The keys of node self, in descending order so the rows must be sorted, all different across the nodes
+std::vector<int64_t> nodeKeys(int self, int num_nodes, gdf_size_type num_rows) {
+	std::vector<int64_t> keys;
+	for(gdf_size_type row = num_rows - 1; row >= 0; row--) {
+		keys.push_back(row * num_nodes + self);
+	}
+	return keys;
+}
+
+// the key and a payload that has to stay with it
+std::vector<gdf_column_cpp> makeTable(const std::vector<int64_t> & keys) {
+	std::vector<int64_t> payloads;
+	for(int64_t key : keys) {
+		payloads.push_back(key * 10);
+	}
+	std::vector<gdf_column_cpp> table(2);
+	table[0].create_gdf_column(
+		GDF_INT64, gdf_dtype_extra_info{}, keys.size(), const_cast<int64_t *>(keys.data()), sizeof(int64_t), "key");
+	table[1].create_gdf_column(
+		GDF_INT64, gdf_dtype_extra_info{}, payloads.size(), payloads.data(), sizeof(int64_t), "payload");
+	return table;
+}
+
+std::vector<int64_t> toHost(gdf_column_cpp & column) {
+	std::vector<int64_t> values(column.size());
+	cudaMemcpy(values.data(), column.data(), values.size() * sizeof(int64_t), cudaMemcpyDeviceToHost);
+	return values;
+}
+
+// Runs ORDER BY key LIMIT limit_rows in every node. The master must return the first limit_rows keys of all the nodes
+// and the other nodes nothing.
+void checkTopN(Context & context, int self, const std::vector<gdf_size_type> & nodes_num_rows, int limit_rows) {
+	const int num_nodes = nodes_num_rows.size();
+	blazing_frame input;
+	input.add_table(makeTable(nodeKeys(self, num_nodes, nodes_num_rows[self])));
+
+	ral::operators::sort_plan plan;
+	plan.sort_column_indices = {0};
+	plan.sort_order_types = {0};
+	plan.limit_rows = limit_rows;
+	ral::operators::process_sort(input, plan, &context);
+
+	std::vector<int64_t> expected;
+	if(self == 0) {
+		for(int i = 0; i < num_nodes; i++) {
+			std::vector<int64_t> keys = nodeKeys(i, num_nodes, nodes_num_rows[i]);
+			expected.insert(expected.end(), keys.begin(), keys.end());
+		}
+		std::sort(expected.begin(), expected.end());
+		expected.resize(std::min<std::size_t>(expected.size(), limit_rows));
+	}
+
+	ASSERT_EQ(input.get_size_column(0), 2u);
+	std::vector<int64_t> keys = toHost(input.get_column(0));
+	std::vector<int64_t> payloads = toHost(input.get_column(1));
+	EXPECT_EQ(keys, expected);
+	ASSERT_EQ(payloads.size(), keys.size());
+	for(std::size_t row = 0; row < keys.size(); row++) {
+		EXPECT_EQ(payloads[row], keys[row] * 10);
+	}
+	EXPECT_EQ(input.get_column(0).name(), "key");
+	EXPECT_EQ(input.get_column(1).name(), "payload");
+}
+
+}  // namespace
+
+TEST(DistributedTopNTest, MasterReturnsTheFirstRowsOfAllTheNodes) {
+	int failures = runNodes(4, 9500, [](Context & context, int self) {
+		checkTopN(context, self, {40, 30, 50, 20}, 25);
+	});
+	EXPECT_EQ(failures, 0);
+}
+
+TEST(DistributedTopNTest, NodesWithFewerRowsThanTheLimit) {
+	// the master and node 2 have no rows, node 1 has fewer rows than the limit
+	int failures = runNodes(4, 9600, [](Context & context, int self) {
+		checkTopN(context, self, {0, 3, 0, 60}, 10);
+	});
+	EXPECT_EQ(failures, 0);
+}
+
+TEST(DistributedTopNTest, LimitLargerThanAllTheRows) {
+	int failures = runNodes(3, 9700, [](Context & context, int self) {
+		checkTopN(context, self, {5, 0, 7}, 100);
+	});
+	EXPECT_EQ(failures, 0);
+}
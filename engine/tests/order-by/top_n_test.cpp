@@ -0,0 +1,218 @@
+#include "DataFrame.h"
+#include "GDFColumn.cuh"
+#include "operators/OrderBy.h"
+#include "operators/TopN.h"
+#include <algorithm>
+#include <blazingdb/manager/Context.h>
+#include <blazingdb/transport/Address.h>
+#include <blazingdb/transport/Node.h>
+#include <cmath>
+#include <cuda_runtime_api.h>
+#include <gtest/gtest.h>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <rmm/rmm.h>
+#include <vector>
+
+namespace {
+
+using blazingdb::manager::Context;
+using blazingdb::transport::Address;
+using blazingdb::transport::Node;
+using ral::operators::host_row_order;
+using ral::operators::host_top_n;
+
+// the first limit rows of a stable sort, what the top-N must return
+std::vector<gdf_size_type> sort_and_limit(gdf_size_type num_rows, gdf_size_type limit, const host_row_order & order) {
+	std::vector<gdf_size_type> rows(num_rows);
+	std::iota(rows.begin(), rows.end(), 0);
+	std::stable_sort(rows.begin(), rows.end(), std::cref(order));
+	rows.resize(std::min(limit, num_rows));
+	return rows;
+}
+
+template <typename T>
+std::vector<T> random_values(std::size_t size, T max, unsigned seed) {
+	std::mt19937 generator(seed);
+	std::uniform_int_distribution<int64_t> distribution(0, max);
+	std::vector<T> values(size);
+	for(auto & value : values) {
+		value = static_cast<T>(distribution(generator));
+	}
+	return values;
+}
+
+std::vector<bool> random_valid(std::size_t size, unsigned seed) {
+	std::mt19937 generator(seed);
+	std::vector<bool> valid(size);
+	for(std::size_t i = 0; i < size; i++) {
+		valid[i] = generator() % 5 != 0;
+	}
+	return valid;
+}
+
+template <typename T>
+std::vector<T> to_host(gdf_column_cpp & column) {
+	std::vector<T> values(column.size());
+	cudaMemcpy(values.data(), column.data(), values.size() * sizeof(T), cudaMemcpyDeviceToHost);
+	return values;
+}
+
+struct TopNTest : public ::testing::Test {
+	void SetUp() { rmmInitialize(nullptr); }
+
+	Context make_context() {
+		std::shared_ptr<Node> node = Node::Make(Address::TCP("127.0.0.1", 8000, 9000));
+		return Context(7601, {node}, node, "");
+	}
+};
+
+}  // namespace
+
+TEST(HostTopNTest, same_rows_as_sort_and_limit) {
+	const gdf_size_type num_rows = 5000;
+	// few distinct values, so the rows with the same keys keep their order
+	std::vector<int32_t> first = random_values<int32_t>(num_rows, 20, 1);
+	std::vector<bool> first_valid = random_valid(num_rows, 2);
+	std::vector<double> second = random_values<double>(num_rows, 1000, 3);
+
+	for(bool first_descending : {false, true}) {
+		host_row_order order;
+		order.add_column(first, first_valid, first_descending);
+		order.add_column(second, {}, true);
+		for(gdf_size_type limit : {0, 1, 7, 100, 4999, 5000, 6000}) {
+			EXPECT_EQ(host_top_n(num_rows, limit, order), sort_and_limit(num_rows, limit, order)) << "limit " << limit;
+		}
+	}
+}
+
+TEST(HostTopNTest, nulls_are_the_largest) {
+	std::vector<int64_t> values{5, 1, 0, 3};
+	std::vector<bool> valid{true, true, false, true};
+	host_row_order ascending;
+	ascending.add_column(values, valid, false);
+	EXPECT_EQ(host_top_n(4, 4, ascending), (std::vector<gdf_size_type>{1, 3, 0, 2}));
+
+	host_row_order descending;
+	descending.add_column(values, valid, true);
+	EXPECT_EQ(host_top_n(4, 2, descending), (std::vector<gdf_size_type>{2, 0}));
+}
+
+TEST(HostTopNTest, threshold) {
+	using ral::operators::top_n_threshold_rank;
+	using ral::operators::use_top_n_threshold;
+
+	EXPECT_FALSE(use_top_n_threshold(1000, 10));
+	EXPECT_TRUE(use_top_n_threshold(1 << 20, 100));
+	EXPECT_FALSE(use_top_n_threshold(1 << 20, 1 << 17));
+
+	// the rank is past the expected one and never past the sample
+	const gdf_size_type sample_size = ral::operators::TOP_N_SAMPLE_SIZE;
+	EXPECT_GT(top_n_threshold_rank(1 << 30, sample_size, 100), 0);
+	EXPECT_GT(top_n_threshold_rank(1 << 20, sample_size, 1000), 1000 / 16);
+	EXPECT_EQ(top_n_threshold_rank(1 << 20, sample_size, 1 << 20), sample_size - 1);
+
+	// with a sample of uniform values, the threshold leaves at least limit rows
+	const gdf_size_type num_rows = 1 << 22;
+	std::vector<int64_t> values = random_values<int64_t>(num_rows, num_rows, 4);
+	const gdf_size_type stride = num_rows / sample_size;
+	for(gdf_size_type limit : {1, 10, 100, 10000}) {
+		std::vector<int64_t> sample;
+		for(gdf_size_type i = 0; i < sample_size; i++) {
+			sample.push_back(values[i * stride]);
+		}
+		std::sort(sample.begin(), sample.end());
+		int64_t threshold = sample[top_n_threshold_rank(num_rows, sample_size, limit)];
+		gdf_size_type passed = std::count_if(values.begin(), values.end(), [&](int64_t value) {
+			return value <= threshold;
+		});
+		EXPECT_GE(passed, limit);
+		EXPECT_LT(passed, limit * 4 + 100 * stride);
+	}
+}
+
+TEST_F(TopNTest, same_rows_as_the_host) {
+	// large enough for the threshold, with nulls in the leading key
+	const gdf_size_type num_rows = 1 << 20;
+	std::vector<int64_t> keys = random_values<int64_t>(num_rows, int64_t{1} << 40, 5);
+	std::vector<bool> keys_valid = random_valid(num_rows, 6);
+	std::vector<int32_t> payload(num_rows);
+	std::iota(payload.begin(), payload.end(), 0);
+
+	std::vector<gdf_valid_type> host_valid((num_rows + GDF_VALID_BITSIZE - 1) / GDF_VALID_BITSIZE, 0);
+	for(gdf_size_type i = 0; i < num_rows; i++) {
+		if(keys_valid[i]) {
+			host_valid[i / GDF_VALID_BITSIZE] |= 1 << (i % GDF_VALID_BITSIZE);
+		}
+	}
+
+	Context context = make_context();
+	for(bool descending : {false, true}) {
+		std::vector<gdf_column_cpp> table(2);
+		table[0].create_gdf_column(
+			GDF_INT64, gdf_dtype_extra_info{}, num_rows, keys.data(), host_valid.data(), sizeof(int64_t), "key");
+		table[1].create_gdf_column(GDF_INT32, gdf_dtype_extra_info{}, num_rows, payload.data(), sizeof(int32_t), "row");
+		blazing_frame input;
+		input.add_table(table);
+
+		ral::operators::sort_plan plan;
+		plan.sort_column_indices = {0};
+		plan.sort_order_types = {descending};
+		plan.limit_rows = 1000;
+		ral::operators::process_sort(input, plan, &context);
+
+		host_row_order order;
+		order.add_column(keys, keys_valid, descending);
+		std::vector<gdf_size_type> expected = host_top_n(num_rows, plan.limit_rows, order);
+		ASSERT_EQ(input.get_num_rows_in_table(0), plan.limit_rows);
+
+		// the values and nulls of the keys are the same, the rows with the same keys can be others
+		std::vector<int32_t> rows = to_host<int32_t>(input.get_column(1));
+		for(gdf_size_type i = 0; i < plan.limit_rows; i++) {
+			EXPECT_EQ(keys_valid[rows[i]], keys_valid[expected[i]]);
+			if(keys_valid[expected[i]]) {
+				EXPECT_EQ(keys[rows[i]], keys[expected[i]]);
+			}
+		}
+	}
+}
+
+TEST_F(TopNTest, nan_keys) {
+	// large enough for the threshold, the keys with NaN must be ordered like the sort of all the rows orders them
+	const gdf_size_type num_rows = 1 << 20;
+	std::vector<double> keys = random_values<double>(num_rows, 1 << 20, 7);
+	for(gdf_size_type i = 0; i < num_rows; i += 97) {
+		keys[i] = std::numeric_limits<double>::quiet_NaN();
+	}
+	std::vector<int32_t> payload(num_rows);
+	std::iota(payload.begin(), payload.end(), 0);
+
+	Context context = make_context();
+	for(bool descending : {false, true}) {
+		std::vector<std::vector<double>> sorted_keys;
+		for(int limit_rows : {1000, -1}) {
+			std::vector<gdf_column_cpp> table(2);
+			table[0].create_gdf_column(
+				GDF_FLOAT64, gdf_dtype_extra_info{}, num_rows, keys.data(), sizeof(double), "key");
+			table[1].create_gdf_column(
+				GDF_INT32, gdf_dtype_extra_info{}, num_rows, payload.data(), sizeof(int32_t), "row");
+			blazing_frame input;
+			input.add_table(table);
+
+			ral::operators::sort_plan plan;
+			plan.sort_column_indices = {0};
+			plan.sort_order_types = {descending};
+			plan.limit_rows = limit_rows;
+			ral::operators::process_sort(input, plan, &context);
+			sorted_keys.push_back(to_host<double>(input.get_column(0)));
+		}
+
+		ASSERT_EQ(sorted_keys[0].size(), 1000u);
+		for(std::size_t i = 0; i < sorted_keys[0].size(); i++) {
+			double top = sorted_keys[0][i];
+			double sorted = sorted_keys[1][i];
+			EXPECT_TRUE(top == sorted || (std::isnan(top) && std::isnan(sorted))) << "row " << i;
+		}
+	}
+}
@@ -0,0 +1,64 @@
+#include "parser/plan_cache.hpp"
+#include <gtest/gtest.h>
+
+using namespace ral::parser;
+
+struct PlanCacheTest : public ::testing::Test {
+	PlanCacheTest() {}
+
+	~PlanCacheTest() {}
+};
+
+TEST_F(PlanCacheTest, hit_returns_same_plan) {
+	plan_cache cache(2);
+	std::string logical_plan =
+		"LogicalProject(n_name=[$1])\n"
+		"  LogicalTableScan(table=[[main, nation]])\n";
+
+	std::shared_ptr<const relational_node> first = cache.get_plan(logical_plan);
+	std::shared_ptr<const relational_node> second = cache.get_plan(logical_plan);
+
+	EXPECT_EQ(first.get(), second.get());
+	EXPECT_EQ(cache.get_hits(), 1);
+	EXPECT_EQ(cache.get_misses(), 1);
+	EXPECT_EQ(cache.get_size(), 1);
+	EXPECT_EQ(first->type, relational_node_type::PROJECT);
+	EXPECT_EQ(first->children[0]->table_name, "nation");
+}
+
+TEST_F(PlanCacheTest, normalized_plans_share_entry) {
+	plan_cache cache(2);
+
+	cache.get_plan("LogicalProject(n_name=[$1])\n  LogicalTableScan(table=[[main, nation]])\n");
+	cache.get_plan("LogicalProject(n_name=[$1])  \r\n  LogicalTableScan(table=[[main, nation]])\n\n");
+
+	EXPECT_EQ(cache.get_hits(), 1);
+	EXPECT_EQ(cache.get_size(), 1);
+}
+
+TEST_F(PlanCacheTest, evicts_least_recently_used) {
+	plan_cache cache(2);
+	std::string nation = "LogicalTableScan(table=[[main, nation]])";
+	std::string region = "LogicalTableScan(table=[[main, region]])";
+	std::string orders = "LogicalTableScan(table=[[main, orders]])";
+
+	cache.get_plan(nation);
+	cache.get_plan(region);
+	cache.get_plan(nation);
+	cache.get_plan(orders);
+	EXPECT_EQ(cache.get_size(), 2);
+
+	// region was the least recently used plan
+	cache.get_plan(nation);
+	cache.get_plan(region);
+	EXPECT_EQ(cache.get_hits(), 2);
+	EXPECT_EQ(cache.get_misses(), 4);
+}
+
+TEST_F(PlanCacheTest, invalid_plan_is_not_cached) {
+	plan_cache cache(2);
+
+	EXPECT_THROW(cache.get_plan("LogicalWindow(window#0=[window(partition {0})])"), std::runtime_error);
+	EXPECT_EQ(cache.get_size(), 0);
+	EXPECT_EQ(cache.get_misses(), 1);
+}
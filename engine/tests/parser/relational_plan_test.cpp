@@ -0,0 +1,99 @@
+#include "config/BlazingConfig.h"
+#include "parser/relational_plan.hpp"
+#include <gtest/gtest.h>
+
+using namespace ral::parser;
+
+struct RelationalPlanTest : public ::testing::Test {
+	RelationalPlanTest() {}
+
+	~RelationalPlanTest() {}
+};
+
+TEST_F(RelationalPlanTest, single_scan) {
+	std::unique_ptr<relational_node> plan = parse_relational_plan("LogicalTableScan(table=[[main, nation]])\n");
+
+	EXPECT_EQ(plan->type, relational_node_type::SCAN);
+	EXPECT_EQ(plan->table_name, "nation");
+	EXPECT_TRUE(plan->children.empty());
+}
+
+TEST_F(RelationalPlanTest, bindable_scan) {
+	std::unique_ptr<relational_node> plan = parse_relational_plan(
+		"BindableTableScan(table=[[main, nation]], filters=[[<($0, 10)]], projects=[[0, 2]], aliases=[[n_nationkey, "
+		"n_regionkey]])");
+
+	EXPECT_EQ(plan->type, relational_node_type::BINDABLE_SCAN);
+	EXPECT_EQ(plan->table_name, "nation");
+	EXPECT_EQ(plan->projections, std::vector<size_t>({0, 2}));
+	EXPECT_EQ(plan->aliases, std::vector<std::string>({"n_nationkey", "n_regionkey"}));
+	EXPECT_EQ(plan->condition, "<($0, 10)");
+}
+
+TEST_F(RelationalPlanTest, project_over_join) {
+	std::string logical_plan =
+		"LogicalProject(n_name=[$1], EXPR$1=[+($0, 1)])\n"
+		"  LogicalJoin(condition=[AND(=($0, $3), >($2, $4))], joinType=[inner])\n"
+		"    LogicalFilter(condition=[<($0, 10)])\n"
+		"      LogicalTableScan(table=[[main, nation]])\n"
+		"    LogicalTableScan(table=[[main, region]])\n";
+	std::unique_ptr<relational_node> plan = parse_relational_plan(logical_plan);
+
+	EXPECT_EQ(plan->type, relational_node_type::PROJECT);
+	EXPECT_EQ(plan->expression_names, std::vector<std::string>({"n_name", "EXPR$1"}));
+	EXPECT_EQ(plan->expressions, std::vector<std::string>({"$1", "+($0, 1)"}));
+	ASSERT_EQ(plan->children.size(), 1);
+
+	const relational_node & join = *plan->children[0];
+	EXPECT_EQ(join.type, relational_node_type::JOIN);
+	EXPECT_EQ(join.join_statement, "LogicalJoin(condition=[=($0, $3)], joinType=[inner])");
+	EXPECT_EQ(join.condition, ">($2, $4)");
+	EXPECT_TRUE(join.needs_communication());
+	EXPECT_EQ(join.get_table_names(), std::vector<std::string>({"nation", "region"}));
+	ASSERT_EQ(join.children.size(), 2);
+
+	const relational_node & filter = *join.children[0];
+	EXPECT_EQ(filter.type, relational_node_type::FILTER);
+	EXPECT_EQ(filter.condition, "<($0, 10)");
+	EXPECT_FALSE(filter.needs_communication());
+	ASSERT_EQ(filter.children.size(), 1);
+	EXPECT_EQ(filter.children[0]->table_name, "nation");
+
+	EXPECT_EQ(join.children[1]->type, relational_node_type::SCAN);
+	EXPECT_EQ(join.children[1]->table_name, "region");
+}
+
+TEST_F(RelationalPlanTest, sort_with_fetch) {
+	std::string logical_plan =
+		"LogicalSort(sort0=[$1], sort1=[$0], dir0=[DESC], dir1=[ASC], fetch=[5])\n"
+		"  LogicalTableScan(table=[[main, nation]])\n";
+	std::unique_ptr<relational_node> plan = parse_relational_plan(logical_plan);
+
+	EXPECT_EQ(plan->type, relational_node_type::SORT);
+	EXPECT_EQ(plan->sort.sort_column_indices, std::vector<int>({1, 0}));
+	EXPECT_EQ(plan->sort.sort_order_types, std::vector<int8_t>({1, 0}));
+	EXPECT_EQ(plan->sort.limit_rows, 5);
+}
+
+TEST_F(RelationalPlanTest, aggregate_partitioning) {
+	std::string logical_plan =
+		"LogicalAggregate(group=[{0}], EXPR$1=[AVG($1)])\n"
+		"  LogicalTableScan(table=[[main, nation]])\n";
+	std::unique_ptr<relational_node> plan = parse_relational_plan(logical_plan);
+
+	EXPECT_EQ(plan->type, relational_node_type::AGGREGATE);
+	EXPECT_EQ(plan->aggregate.group_column_indices, std::vector<int>({0}));
+	EXPECT_EQ(ral::operators::choose_groupby_partitioning(), ral::operators::groupby_partitioning::HASH);
+
+	// the plan is the same, the partitioning is read when it is aggregated
+	ral::config::BlazingConfig::getInstance().setGroupByRangePartitioning(true);
+	std::unique_ptr<relational_node> same_plan = parse_relational_plan(logical_plan);
+	EXPECT_EQ(ral::operators::choose_groupby_partitioning(), ral::operators::groupby_partitioning::RANGE);
+	ral::config::BlazingConfig::getInstance().setGroupByRangePartitioning(false);
+	EXPECT_EQ(same_plan->aggregate.group_column_indices, plan->aggregate.group_column_indices);
+}
+
+TEST_F(RelationalPlanTest, unsupported_operator) {
+	EXPECT_THROW(parse_relational_plan("LogicalWindow(window#0=[window(partition {} order by [0])])"),
+		std::runtime_error);
+}
@@ -0,0 +1,291 @@
+#include "DataFrame.h"
+#include "GDFColumn.cuh"
+#include "operators/GroupBy.h"
+#include "operators/PartialAggregation.h"
+#include <cuda_runtime_api.h>
+#include <gtest/gtest.h>
+#include <map>
+#include <numeric>
+#include <random>
+#include <rmm/rmm.h>
+#include <vector>
+
+namespace {
+
+using ral::operators::aggregate_plan;
+
+// the values of a column copied to the host as doubles, with the validity of each row
+struct host_column {
+	std::string name;
+	std::vector<double> values;
+	std::vector<bool> valid;
+};
+
+template <typename T>
+std::vector<double> to_host_values(gdf_column_cpp & column) {
+	std::vector<T> values(column.size());
+	cudaMemcpy(values.data(), column.data(), values.size() * sizeof(T), cudaMemcpyDeviceToHost);
+	return std::vector<double>(values.begin(), values.end());
+}
+
+host_column to_host(gdf_column_cpp & column) {
+	host_column output;
+	output.name = column.name();
+	switch(column.dtype()) {
+	case GDF_INT32: output.values = to_host_values<int32_t>(column); break;
+	case GDF_INT64: output.values = to_host_values<int64_t>(column); break;
+	case GDF_FLOAT64: output.values = to_host_values<double>(column); break;
+	default: ADD_FAILURE() << "unexpected dtype " << column.dtype();
+	}
+
+	output.valid.assign(column.size(), true);
+	if(column.valid() != nullptr) {
+		std::vector<gdf_valid_type> valid((column.size() + GDF_VALID_BITSIZE - 1) / GDF_VALID_BITSIZE);
+		cudaMemcpy(valid.data(), column.valid(), valid.size(), cudaMemcpyDeviceToHost);
+		for(gdf_size_type i = 0; i < column.size(); i++) {
+			output.valid[i] = (valid[i / GDF_VALID_BITSIZE] >> (i % GDF_VALID_BITSIZE)) & 1;
+		}
+	}
+	return output;
+}
+
+// The rows of an aggregated table by the value of its first column, which must be a group column
+std::map<double, std::vector<std::pair<bool, double>>> rows_by_group(std::vector<gdf_column_cpp> & table) {
+	std::vector<host_column> columns;
+	for(gdf_column_cpp & column : table) {
+		columns.push_back(to_host(column));
+	}
+
+	std::map<double, std::vector<std::pair<bool, double>>> rows;
+	for(size_t row = 0; row < columns[0].values.size(); row++) {
+		for(host_column & column : columns) {
+			rows[columns[0].values[row]].emplace_back(column.valid[row], column.valid[row] ? column.values[row] : 0);
+		}
+	}
+	return rows;
+}
+
+struct PartialAggregationTest : public ::testing::Test {
+	void SetUp() {
+		rmmInitialize(nullptr);
+
+		const gdf_size_type num_rows = 10000;
+		std::mt19937 generator(1);
+		keys.resize(num_rows);
+		values.resize(num_rows);
+		valid.assign((num_rows + GDF_VALID_BITSIZE - 1) / GDF_VALID_BITSIZE, 0);
+		for(gdf_size_type i = 0; i < num_rows; i++) {
+			keys[i] = generator() % 10;
+			values[i] = generator() % 1000;
+			// the values of the group 9 are all null, so are some of the others
+			if(keys[i] != 9 && generator() % 4 != 0) {
+				valid[i / GDF_VALID_BITSIZE] |= 1 << (i % GDF_VALID_BITSIZE);
+			}
+		}
+
+		plan.aggregation_types = {GDF_SUM, GDF_COUNT, GDF_AVG, GDF_MIN, GDF_COUNT, GDF_AVG};
+		plan.aggregation_input_expressions = {"$1", "$1", "$1", "$1", "", "$1"};
+		plan.aggregation_column_assigned_aliases = {"", "", "", "", "", "mean"};
+	}
+
+	// the rows from first to last of the test data, as one table
+	blazing_frame make_input(gdf_size_type first, gdf_size_type last) {
+		std::vector<gdf_valid_type> chunk_valid((last - first + GDF_VALID_BITSIZE - 1) / GDF_VALID_BITSIZE, 0);
+		for(gdf_size_type i = first; i < last; i++) {
+			if((valid[i / GDF_VALID_BITSIZE] >> (i % GDF_VALID_BITSIZE)) & 1) {
+				chunk_valid[(i - first) / GDF_VALID_BITSIZE] |= 1 << ((i - first) % GDF_VALID_BITSIZE);
+			}
+		}
+
+		std::vector<gdf_column_cpp> table(2);
+		table[0].create_gdf_column(
+			GDF_INT32, gdf_dtype_extra_info{}, last - first, keys.data() + first, sizeof(int32_t), "key");
+		table[1].create_gdf_column(GDF_INT64,
+			gdf_dtype_extra_info{},
+			last - first,
+			values.data() + first,
+			chunk_valid.data(),
+			sizeof(int64_t),
+			"value");
+		blazing_frame input;
+		input.add_table(table);
+		return input;
+	}
+
+	// the aggregation of the test data in three nodes
+	std::vector<gdf_column_cpp> two_phase_aggregation() {
+		std::vector<std::vector<gdf_column_cpp>> partial_tables;
+		std::vector<std::pair<gdf_size_type, gdf_size_type>> node_rows{{0, 1234}, {1234, 1300}, {1300, 10000}};
+		for(std::pair<gdf_size_type, gdf_size_type> rows : node_rows) {
+			blazing_frame input = make_input(rows.first, rows.second);
+			partial_tables.push_back(ral::operators::compute_partial_aggregations(input,
+				plan.group_column_indices,
+				plan.aggregation_types,
+				plan.aggregation_input_expressions,
+				plan.aggregation_column_assigned_aliases));
+		}
+		return ral::operators::merge_partial_aggregations(
+			partial_tables, plan.group_column_indices.size(), plan.aggregation_types);
+	}
+
+	std::vector<gdf_column_cpp> single_node_aggregation() {
+		blazing_frame input = make_input(0, keys.size());
+		ral::operators::process_aggregate(input, plan, nullptr);
+		std::vector<gdf_column_cpp> output;
+		for(size_t i = 0; i < input.get_width(); i++) {
+			output.push_back(input.get_column(i));
+		}
+		return output;
+	}
+
+	std::vector<int32_t> keys;
+	std::vector<int64_t> values;
+	std::vector<gdf_valid_type> valid;
+	aggregate_plan plan;
+};
+
+}  // namespace
+
+TEST(PartialStatesTest, average_is_sum_and_count) {
+	using ral::operators::get_partial_states;
+	using ral::operators::is_own_partial_state;
+
+	std::vector<ral::operators::partial_state> states = get_partial_states(GDF_AVG);
+	ASSERT_EQ(states.size(), 2);
+	EXPECT_EQ(states[0].compute, GDF_SUM);
+	EXPECT_EQ(states[0].merge, GDF_SUM);
+	EXPECT_EQ(states[1].compute, GDF_COUNT);
+	EXPECT_EQ(states[1].merge, GDF_SUM);
+	EXPECT_TRUE(states[0].widen_input);
+	EXPECT_FALSE(states[1].widen_input);
+	EXPECT_FALSE(is_own_partial_state(GDF_AVG));
+
+	EXPECT_EQ(get_partial_states(GDF_COUNT)[0].merge, GDF_SUM);
+	EXPECT_TRUE(is_own_partial_state(GDF_COUNT));
+	EXPECT_TRUE(is_own_partial_state(GDF_MAX));
+	EXPECT_THROW(get_partial_states(GDF_COUNT_DISTINCT), std::runtime_error);
+}
+
+TEST_F(PartialAggregationTest, average_from_sum_and_count) {
+	std::vector<int64_t> sums{10, 7, 0, 0, 5, 6, 7, 8, 9};
+	std::vector<gdf_valid_type> sums_valid{0xfb, 0x01};
+	std::vector<int64_t> counts{4, 0, 3, 2, 5, 6, 7, 8, 9};
+	gdf_column_cpp sum;
+	sum.create_gdf_column(
+		GDF_INT64, gdf_dtype_extra_info{}, sums.size(), sums.data(), sums_valid.data(), sizeof(int64_t), "sum");
+	gdf_column_cpp count;
+	count.create_gdf_column(GDF_INT64, gdf_dtype_extra_info{}, counts.size(), counts.data(), sizeof(int64_t), "count");
+
+	gdf_column_cpp average = ral::operators::average_from_sum_and_count(sum, count, "avg");
+	host_column output = to_host(average);
+	EXPECT_EQ(output.name, "avg");
+	EXPECT_EQ(average.null_count(), 2);
+	EXPECT_EQ(output.valid, (std::vector<bool>{true, false, false, true, true, true, true, true, true}));
+	EXPECT_EQ(output.values[0], 2.5);
+	EXPECT_EQ(output.values[3], 0.0);
+	EXPECT_EQ(output.values[8], 1.0);
+}
+
+TEST_F(PartialAggregationTest, same_as_single_node_with_groupby) {
+	plan.group_column_indices = {0};
+	std::vector<gdf_column_cpp> expected = single_node_aggregation();
+	std::vector<gdf_column_cpp> merged = two_phase_aggregation();
+
+	ASSERT_EQ(merged.size(), expected.size());
+	for(size_t i = 0; i < merged.size(); i++) {
+		EXPECT_EQ(merged[i].name(), expected[i].name());
+		EXPECT_EQ(merged[i].dtype(), expected[i].dtype()) << merged[i].name();
+	}
+
+	auto merged_rows = rows_by_group(merged);
+	auto expected_rows = rows_by_group(expected);
+	ASSERT_EQ(merged_rows.size(), 10);
+	for(auto & group : expected_rows) {
+		std::vector<std::pair<bool, double>> & merged_row = merged_rows[group.first];
+		ASSERT_EQ(merged_row.size(), group.second.size());
+		for(size_t i = 0; i < merged_row.size(); i++) {
+			EXPECT_EQ(merged_row[i].first, group.second[i].first) << "group " << group.first << " column " << i;
+			EXPECT_DOUBLE_EQ(merged_row[i].second, group.second[i].second)
+				<< "group " << group.first << " column " << i;
+		}
+	}
+	// the group without values has no average
+	EXPECT_FALSE(merged_rows[9][3].first);
+}
+
+TEST_F(PartialAggregationTest, same_as_single_node_without_groupby) {
+	std::vector<gdf_column_cpp> expected = single_node_aggregation();
+	std::vector<gdf_column_cpp> merged = two_phase_aggregation();
+
+	ASSERT_EQ(merged.size(), expected.size());
+	for(size_t i = 0; i < merged.size(); i++) {
+		EXPECT_EQ(merged[i].name(), expected[i].name());
+		host_column merged_column = to_host(merged[i]);
+		host_column expected_column = to_host(expected[i]);
+		ASSERT_EQ(merged_column.values.size(), 1);
+		ASSERT_EQ(expected_column.values.size(), 1);
+		EXPECT_EQ(merged_column.valid[0], expected_column.valid[0]) << merged[i].name();
+		EXPECT_DOUBLE_EQ(merged_column.values[0], expected_column.values[0]) << merged[i].name();
+	}
+}
+
+TEST_F(PartialAggregationTest, average_of_int32_sums_past_int32) {
+	// the values of every node add up to more than 2^31 in each group
+	const gdf_size_type rows_per_node = 1000;
+	std::vector<std::vector<int32_t>> node_keys(3);
+	std::vector<std::vector<int32_t>> node_values(3);
+	std::map<int32_t, std::pair<double, int64_t>> expected;
+	std::mt19937 generator(2);
+	for(size_t node = 0; node < node_keys.size(); node++) {
+		for(gdf_size_type i = 0; i < rows_per_node; i++) {
+			int32_t key = generator() % 2;
+			int32_t value = 2000000000 - static_cast<int32_t>(generator() % 1000);
+			node_keys[node].push_back(key);
+			node_values[node].push_back(value);
+			expected[key].first += value;
+			expected[key].second++;
+		}
+	}
+	double total_sum = expected[0].first + expected[1].first;
+	int64_t total_count = expected[0].second + expected[1].second;
+
+	plan.aggregation_types = {GDF_AVG};
+	plan.aggregation_input_expressions = {"$1"};
+	plan.aggregation_column_assigned_aliases = {""};
+	for(std::vector<int> group_column_indices : {std::vector<int>{0}, std::vector<int>{}}) {
+		std::vector<std::vector<gdf_column_cpp>> partial_tables;
+		for(size_t node = 0; node < node_keys.size(); node++) {
+			std::vector<gdf_column_cpp> table(2);
+			table[0].create_gdf_column(
+				GDF_INT32, gdf_dtype_extra_info{}, rows_per_node, node_keys[node].data(), sizeof(int32_t), "key");
+			table[1].create_gdf_column(
+				GDF_INT32, gdf_dtype_extra_info{}, rows_per_node, node_values[node].data(), sizeof(int32_t), "value");
+			blazing_frame input;
+			input.add_table(table);
+			partial_tables.push_back(ral::operators::compute_partial_aggregations(input,
+				group_column_indices,
+				plan.aggregation_types,
+				plan.aggregation_input_expressions,
+				plan.aggregation_column_assigned_aliases));
+			// the sum state is widened
+			EXPECT_EQ(partial_tables.back()[group_column_indices.size()].dtype(), GDF_INT64);
+		}
+		std::vector<gdf_column_cpp> merged = ral::operators::merge_partial_aggregations(
+			partial_tables, group_column_indices.size(), plan.aggregation_types);
+
+		if(group_column_indices.empty()) {
+			ASSERT_EQ(merged.size(), 1);
+			host_column average = to_host(merged[0]);
+			ASSERT_EQ(average.values.size(), 1);
+			EXPECT_DOUBLE_EQ(average.values[0], total_sum / total_count);
+		} else {
+			auto rows = rows_by_group(merged);
+			ASSERT_EQ(rows.size(), 2);
+			for(auto & group : expected) {
+				ASSERT_TRUE(rows[group.first][1].first);
+				EXPECT_DOUBLE_EQ(rows[group.first][1].second, group.second.first / group.second.second)
+					<< "group " << group.first;
+			}
+		}
+	}
+}
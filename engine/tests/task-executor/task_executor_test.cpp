@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+
+#include "execution/TaskExecutor.h"
+
+using ral::execution::task_executor;
+
+// an idle executor without memory reserve admits the first task it gets
+TEST(TaskExecutorTest, RunsAdmittedTask) {
+	task_executor executor(2, 0.0);
+	std::future<int> result = executor.try_submit([]() { return 42; });
+	ASSERT_TRUE(result.valid());
+	EXPECT_EQ(result.get(), 42);
+}
+
+TEST(TaskExecutorTest, PropagatesExceptions) {
+	task_executor executor(2, 0.0);
+	std::future<int> result = executor.try_submit([]() -> int { throw std::runtime_error("task error"); });
+	ASSERT_TRUE(result.valid());
+	EXPECT_THROW(result.get(), std::runtime_error);
+}
+
+TEST(TaskExecutorTest, RejectsTasksWhenAllWorkersAreBusy) {
+	task_executor executor(1, 0.0);
+	std::promise<void> release;
+	std::shared_future<void> released = release.get_future().share();
+	std::future<void> busy = executor.try_submit([released]() { released.wait(); });
+	ASSERT_TRUE(busy.valid());
+
+	EXPECT_FALSE(executor.try_submit([]() {}).valid());
+	release.set_value();
+	busy.get();
+}
+
+TEST(TaskExecutorTest, NestedSubmissionsDoNotDeadlock) {
+	task_executor & executor = task_executor::getInstance();
+	std::atomic<int> executed{0};
+
+	// every level either gets a worker or runs inline, never waits for a busy worker
+	std::function<void(int)> run_level = [&](int level) {
+		executed++;
+		if(level == 0) {
+			return;
+		}
+		std::future<void> left = executor.try_submit([&, level]() { run_level(level - 1); });
+		run_level(level - 1);
+		if(left.valid()) {
+			left.get();
+		} else {
+			run_level(level - 1);
+		}
+	};
+	run_level(6);
+
+	EXPECT_EQ(executed.load(), 127);
+}
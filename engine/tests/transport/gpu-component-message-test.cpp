@@ -0,0 +1,167 @@
+#include "GDFColumn.cuh"
+#include "communication/messages/GPUComponentMessage.h"
+#include <blazingdb/transport/Address.h>
+#include <blazingdb/transport/Node.h>
+#include <cuda_runtime_api.h>
+#include <gtest/gtest.h>
+#include <nvstrings/NVCategory.h>
+#include <nvstrings/NVStrings.h>
+#include <rmm/rmm.h>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+using ral::communication::messages::GPUComponentMessage;
+using Address = blazingdb::transport::Address;
+using ColumnTransport = blazingdb::transport::ColumnTransport;
+using GPUMessage = blazingdb::transport::GPUMessage;
+using Node = blazingdb::transport::Node;
+
+// every string of the tests has this length, so the strings can be copied to the host in fixed buffers
+constexpr size_t string_length = 5;
+
+const std::string null_string = "NULL";
+
+gdf_column_cpp string_column(const std::vector<const char *> & strings, const std::string & name) {
+	NVCategory * category = NVCategory::create_from_array(strings.data(), strings.size());
+	gdf_column_cpp column;
+	column.create_gdf_column(category, strings.size(), name);
+	return column;
+}
+
+// the strings of a GDF_STRING_CATEGORY column, null_string for the nulls
+std::vector<std::string> to_host_strings(gdf_column_cpp & column) {
+	if(column.size() == 0) {
+		return {};
+	}
+	std::vector<gdf_valid_type> valid((column.size() + GDF_VALID_BITSIZE - 1) / GDF_VALID_BITSIZE, 0xff);
+	if(column.valid() != nullptr) {
+		cudaMemcpy(valid.data(), column.valid(), valid.size(), cudaMemcpyDeviceToHost);
+	}
+
+	NVCategory * category = static_cast<NVCategory *>(column.dtype_info().category);
+	NVStrings * strings =
+		category->gather_strings(static_cast<nv_category_index_type *>(column.data()), column.size(), true);
+	std::vector<std::vector<char>> buffers(column.size(), std::vector<char>(string_length + 1));
+	std::vector<char *> host_strings;
+	for(auto & buffer : buffers) {
+		host_strings.push_back(buffer.data());
+	}
+	strings->to_host(host_strings.data(), 0, column.size());
+	NVStrings::destroy(strings);
+
+	std::vector<std::string> values;
+	for(gdf_size_type i = 0; i < column.size(); i++) {
+		const bool is_valid = (valid[i / GDF_VALID_BITSIZE] >> (i % GDF_VALID_BITSIZE)) & 1;
+		values.push_back(is_valid ? std::string(buffers[i].data(), string_length) : null_string);
+	}
+	return values;
+}
+
+std::vector<std::string> expected_strings(const std::vector<const char *> & strings) {
+	std::vector<std::string> values;
+	for(const char * string : strings) {
+		values.push_back(string != nullptr ? string : null_string);
+	}
+	return values;
+}
+
+// What the server gets: a copy of each buffer, which the message made from them owns
+std::vector<char *> copy_buffers(const std::vector<int64_t> & buffer_sizes, const std::vector<char *> & buffers) {
+	std::vector<char *> copies(buffers.size(), nullptr);
+	for(size_t i = 0; i < buffers.size(); i++) {
+		if(buffer_sizes[i] > 0) {
+			RMM_TRY(RMM_ALLOC(reinterpret_cast<void **>(&copies[i]), buffer_sizes[i], 0));
+			cudaMemcpy(copies[i], buffers[i], buffer_sizes[i], cudaMemcpyDeviceToDevice);
+		}
+	}
+	return copies;
+}
+
+struct GPUComponentMessageTest : public ::testing::Test {
+	void SetUp() {
+		rmmInitialize(nullptr);
+		node = Node::Make(Address::TCP("127.0.0.1", 8000, 9000));
+	}
+
+	std::shared_ptr<Node> node;
+};
+
+}  // namespace
+
+TEST_F(GPUComponentMessageTest, string_columns_round_trip) {
+	const std::vector<const char *> strings{"berry", "apple", nullptr, "cocoa", "apple", "dates"};
+	gdf_column_cpp owner = string_column(strings, "owner");
+
+	// the partitions of a column share its category: a view of all the rows keeps every key, a view of two rows
+	// has more keys than rows and is compacted
+	gdf_column all_rows = *owner.get_gdf_column();
+	gdf_column two_rows = *owner.get_gdf_column();
+	two_rows.data = static_cast<int *>(two_rows.data) + 3;
+	two_rows.valid = nullptr;
+	two_rows.size = 2;
+	two_rows.null_count = 0;
+	// an empty column without a category, like the ones some cudf functions return
+	gdf_column no_category{};
+	no_category.dtype = GDF_STRING_CATEGORY;
+
+	std::vector<gdf_column_cpp> samples(6);
+	samples[0] = owner;
+	samples[1].create_gdf_column(&all_rows, false);
+	samples[1].set_name("all_rows");
+	samples[2].create_gdf_column(&two_rows, false);
+	samples[2].set_name("two_rows");
+	samples[3] = string_column({}, "empty");
+	samples[4].create_gdf_column(&no_category, false);
+	samples[4].set_name("no_category");
+	std::vector<int32_t> values{1, 2, 3};
+	samples[5].create_gdf_column(GDF_INT32, gdf_dtype_extra_info{}, values.size(), values.data(), sizeof(int32_t), "n");
+
+	GPUComponentMessage message("message", 1, node, samples, owner.size());
+	std::vector<int64_t> buffer_sizes;
+	std::vector<char *> buffers;
+	std::vector<ColumnTransport> columns;
+	std::tie(buffer_sizes, buffers, columns) = message.GetRawColumns();
+	ASSERT_EQ(columns.size(), samples.size());
+
+	// the columns that share a category share its keys, the compacted one has its own
+	EXPECT_EQ(columns[1].strings_data, columns[0].strings_data);
+	EXPECT_EQ(columns[1].strings_nullmask, columns[0].strings_nullmask);
+	EXPECT_NE(columns[2].strings_data, columns[0].strings_data);
+	EXPECT_EQ(columns[0].metadata.dictionary_size, 5);
+	EXPECT_EQ(columns[2].metadata.dictionary_size, 2);
+	EXPECT_EQ(columns[2].strings_nullmask, -1);
+
+	// the compacted category is reused by the next sends of the message
+	std::vector<char *> resent_buffers = std::get<1>(message.GetRawColumns());
+	EXPECT_EQ(resent_buffers, buffers);
+
+	std::vector<char *> received_buffers = copy_buffers(buffer_sizes, buffers);
+	std::shared_ptr<GPUMessage> received = GPUComponentMessage::MakeFrom(
+		message.metadata(), node->address()->metadata(), columns, received_buffers);
+	std::vector<gdf_column_cpp> received_samples =
+		std::static_pointer_cast<GPUComponentMessage>(received)->getSamples();
+	ASSERT_EQ(received_samples.size(), samples.size());
+
+	EXPECT_EQ(to_host_strings(received_samples[0]), expected_strings(strings));
+	EXPECT_EQ(received_samples[0].null_count(), 1);
+	EXPECT_EQ(to_host_strings(received_samples[1]), expected_strings(strings));
+	EXPECT_EQ(received_samples[1].name(), "all_rows");
+	EXPECT_EQ(to_host_strings(received_samples[2]), (std::vector<std::string>{"cocoa", "apple"}));
+	EXPECT_EQ(static_cast<NVCategory *>(received_samples[2].dtype_info().category)->keys_size(), 2);
+	for(int i : {3, 4}) {
+		EXPECT_EQ(received_samples[i].dtype(), GDF_STRING_CATEGORY);
+		EXPECT_EQ(received_samples[i].size(), 0);
+		EXPECT_NE(received_samples[i].dtype_info().category, nullptr);
+	}
+
+	std::vector<int32_t> received_values(values.size());
+	ASSERT_EQ(received_samples[5].size(), values.size());
+	cudaMemcpy(received_values.data(),
+		received_samples[5].data(),
+		values.size() * sizeof(int32_t),
+		cudaMemcpyDeviceToHost);
+	EXPECT_EQ(received_values, values);
+}
@@ -0,0 +1,73 @@
+#ifndef BLAZINGDB_RAL_TESTS_FORKED_NODES_H
+#define BLAZINGDB_RAL_TESTS_FORKED_NODES_H
+
+#include "communication/CommunicationData.h"
+#include "communication/network/Server.h"
+#include <blazingdb/manager/Context.h>
+#include <blazingdb/transport/Address.h>
+#include <blazingdb/transport/Node.h>
+#include <blazingdb/transport/io/reader_writer.h>
+#include <cuda.h>
+#include <functional>
+#include <gtest/gtest.h>
+#include <memory>
+#include <rmm/rmm.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+// Simulates a cluster on one machine for the distributed tests: each node is a forked process with its own server on
+// a loopback port, and every node runs the same code with a context of all of them.
+
+// the token of the context of the nodes, each test runs its own processes
+constexpr uint32_t forked_nodes_context_token = 7001;
+
+inline std::vector<std::shared_ptr<blazingdb::transport::Node>> makeNodes(int num_nodes, unsigned short first_port) {
+	using blazingdb::transport::Address;
+	using blazingdb::transport::Node;
+
+	std::vector<std::shared_ptr<Node>> nodes;
+	for(int i = 0; i < num_nodes; i++) {
+		nodes.push_back(Node::Make(Address::TCP("127.0.0.1", first_port + i, first_port + 100 + i)));
+	}
+	return nodes;
+}
+
+// Runs run_node in num_nodes processes, each one with the index of its node. Node 0 is the master. Returns the number
+// of nodes that failed.
+inline int runNodes(int num_nodes,
+	unsigned short first_port,
+	const std::function<void(blazingdb::manager::Context &, int)> & run_node) {
+	std::vector<pid_t> pids;
+	for(int i = 0; i < num_nodes; i++) {
+		pid_t pid = fork();
+		if(pid == 0) {
+			cuInit(0);
+			rmmInitialize(nullptr);
+			blazingdb::transport::io::setPinnedBufferProvider(1 << 20, 16);
+			ral::communication::CommunicationData::getInstance().initialize(
+				0, "127.0.0.1", 0, "127.0.0.1", first_port + i, first_port + 100 + i);
+			ral::communication::network::Server::start(first_port + i);
+			ral::communication::network::Server::getInstance().registerContext(forked_nodes_context_token);
+
+			std::vector<std::shared_ptr<blazingdb::transport::Node>> nodes = makeNodes(num_nodes, first_port);
+			blazingdb::manager::Context context(forked_nodes_context_token, nodes, nodes[0], "");
+			run_node(context, i);
+			// the failures of the node are only known by its process
+			_exit(::testing::Test::HasFailure() ? 1 : 0);
+		}
+		pids.push_back(pid);
+	}
+
+	int failures = 0;
+	for(pid_t pid : pids) {
+		int status = 0;
+		waitpid(pid, &status, 0);
+		if(!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+			failures++;
+		}
+	}
+	return failures;
+}
+
+#endif
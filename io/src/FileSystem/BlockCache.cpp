@@ -0,0 +1,218 @@
+/*
+ * Copyright 2019 BlazingDB, Inc.
+ */
+
+#include "BlockCache.h"
+
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+#include "ExceptionHandling/BlazingException.h"
+#include "Library/Logging/Logger.h"
+
+namespace Logging = Library::Logging;
+
+namespace {
+
+const std::string BLOCK_FILE_EXTENSION = ".block";
+
+std::mutex instanceMutex;
+std::shared_ptr<BlockCache> instance;
+
+// creates the directory and its missing parents
+bool makeDirectories(const std::string & directory) {
+	for(size_t slash = directory.find('/', 1); slash != std::string::npos; slash = directory.find('/', slash + 1)) {
+		if(mkdir(directory.substr(0, slash).c_str(), 0700) != 0 && errno != EEXIST) {
+			return false;
+		}
+	}
+	return mkdir(directory.c_str(), 0700) == 0 || errno == EEXIST;
+}
+
+bool writeCompletely(const std::string & path, const uint8_t * data, int64_t nbytes) {
+	int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+	if(fd < 0) {
+		return false;
+	}
+	int64_t written = 0;
+	while(written < nbytes) {
+		ssize_t result = write(fd, data + written, nbytes - written);
+		if(result < 0 && errno == EINTR) {
+			continue;
+		}
+		if(result <= 0) {
+			close(fd);
+			return false;
+		}
+		written += result;
+	}
+	return close(fd) == 0;
+}
+
+bool readCompletely(int fd, uint8_t * out, int64_t nbytes) {
+	int64_t bytesRead = 0;
+	while(bytesRead < nbytes) {
+		ssize_t result = pread(fd, out + bytesRead, nbytes - bytesRead, bytesRead);
+		if(result < 0 && errno == EINTR) {
+			continue;
+		}
+		if(result <= 0) {
+			return false;
+		}
+		bytesRead += result;
+	}
+	return true;
+}
+
+}  // namespace
+
+std::shared_ptr<BlockCache> BlockCache::getInstance() {
+	std::lock_guard<std::mutex> lock(instanceMutex);
+	return instance;
+}
+
+void BlockCache::setInstance(std::shared_ptr<BlockCache> cache) {
+	std::lock_guard<std::mutex> lock(instanceMutex);
+	instance = cache;
+}
+
+BlockCache::BlockCache(const BlockCacheOptions & options)
+	: options(options), sizeInBytes(0), nextBlockId(0), hits(0), misses(0), evictions(0) {
+	if(this->options.directory.empty() || this->options.blockSize <= 0) {
+		throw BlazingFileSystemException("The block cache needs a directory and a block size");
+	}
+	if(this->options.directory.back() == '/') {
+		this->options.directory.pop_back();
+	}
+	if(!makeDirectories(this->options.directory)) {
+		throw BlazingFileSystemException("Unable to create the block cache directory " + this->options.directory);
+	}
+
+	// workers on the same host share the directory, every cache keeps its blocks in a directory of its own
+	std::string blockDirectory = this->options.directory + "/" + std::to_string(getpid()) + "-XXXXXX";
+	std::vector<char> blockDirectoryTemplate(blockDirectory.begin(), blockDirectory.end());
+	blockDirectoryTemplate.push_back('\0');
+	if(mkdtemp(blockDirectoryTemplate.data()) == nullptr) {
+		throw BlazingFileSystemException("Unable to create a directory in the block cache directory " +
+										 this->options.directory);
+	}
+	this->blockDirectory = blockDirectoryTemplate.data();
+}
+
+BlockCache::~BlockCache() {
+	this->clear();
+	rmdir(this->blockDirectory.c_str());
+}
+
+std::string BlockCache::makeKey(const std::string & fileKey, int64_t blockIndex) {
+	return fileKey + "#" + std::to_string(blockIndex);
+}
+
+bool BlockCache::get(const std::string & fileKey, int64_t blockIndex, uint8_t * out, int64_t * nbytes) {
+	int fd = -1;
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		auto it = this->index.find(makeKey(fileKey, blockIndex));
+		if(it != this->index.end()) {
+			// opened with the lock held, so an eviction can not remove the file before it is read
+			fd = open(it->second->path.c_str(), O_RDONLY);
+			*nbytes = it->second->nbytes;
+			this->blocks.splice(this->blocks.begin(), this->blocks, it->second);
+		}
+		if(fd < 0) {
+			this->misses++;
+			return false;
+		}
+		this->hits++;
+	}
+
+	bool ok = readCompletely(fd, out, *nbytes);
+	close(fd);
+	if(!ok) {
+		Logging::Logger().logWarn("Unable to read a block from the block cache directory " + this->options.directory);
+	}
+	return ok;
+}
+
+void BlockCache::put(const std::string & fileKey, int64_t blockIndex, const uint8_t * data, int64_t nbytes) {
+	if(nbytes > this->options.capacity || nbytes > this->options.blockSize) {
+		return;
+	}
+
+	Block block;
+	block.key = makeKey(fileKey, blockIndex);
+	block.nbytes = nbytes;
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		if(this->index.find(block.key) != this->index.end()) {
+			return;
+		}
+		block.path = this->blockDirectory + "/" + std::to_string(this->nextBlockId++) + BLOCK_FILE_EXTENSION;
+	}
+
+	// written without the lock, so reads of other blocks do not wait for the disk
+	if(!writeCompletely(block.path, data, nbytes)) {
+		Logging::Logger().logWarn("Unable to write a block to the block cache directory " + this->options.directory);
+		unlink(block.path.c_str());
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(this->mutex);
+	if(this->index.find(block.key) != this->index.end()) {  // another thread cached it meanwhile
+		unlink(block.path.c_str());
+		return;
+	}
+	this->evict(nbytes);
+	this->blocks.push_front(block);
+	this->index[block.key] = this->blocks.begin();
+	this->sizeInBytes += nbytes;
+}
+
+void BlockCache::evict(int64_t nbytes) {
+	while(!this->blocks.empty() && this->sizeInBytes + nbytes > this->options.capacity) {
+		const Block & block = this->blocks.back();
+		unlink(block.path.c_str());
+		this->sizeInBytes -= block.nbytes;
+		this->index.erase(block.key);
+		this->blocks.pop_back();
+		this->evictions++;
+	}
+}
+
+void BlockCache::clear() {
+	std::lock_guard<std::mutex> lock(this->mutex);
+	for(const Block & block : this->blocks) {
+		unlink(block.path.c_str());
+	}
+	this->blocks.clear();
+	this->index.clear();
+	this->sizeInBytes = 0;
+}
+
+long long BlockCache::getHits() const {
+	std::lock_guard<std::mutex> lock(this->mutex);
+	return this->hits;
+}
+
+long long BlockCache::getMisses() const {
+	std::lock_guard<std::mutex> lock(this->mutex);
+	return this->misses;
+}
+
+long long BlockCache::getEvictions() const {
+	std::lock_guard<std::mutex> lock(this->mutex);
+	return this->evictions;
+}
+
+long long BlockCache::getNumBlocks() const {
+	std::lock_guard<std::mutex> lock(this->mutex);
+	return this->blocks.size();
+}
+
+long long BlockCache::getSizeInBytes() const {
+	std::lock_guard<std::mutex> lock(this->mutex);
+	return this->sizeInBytes;
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright 2019 BlazingDB, Inc.
+ */
+
+#ifndef _BLAZING_BLOCK_CACHE_H_
+#define _BLAZING_BLOCK_CACHE_H_
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+struct BlockCacheOptions {
+	// local directory where the blocks are stored, it is created if it does not exist
+	std::string directory;
+	// files are cached in blocks of this size, the last block of a file can be smaller
+	int64_t blockSize = 4 * 1024 * 1024;
+	// the least recently used blocks are evicted to keep the blocks stored under this size
+	int64_t capacity = 10LL * 1024 * 1024 * 1024;
+};
+
+/**
+ * LRU cache of fixed size blocks of remote files, stored on a local disk. Can be used from any thread.
+ *
+ * Blocks are keyed on a file key, which must change when the file changes (for example uri and ETag), and the index of
+ * the block in the file. Each block is stored in its own file, in a directory that the cache creates inside the cache
+ * directory and removes when it is destroyed, so processes on the same host can share the cache directory. The index
+ * lives in memory and a cache only ever removes the blocks it wrote.
+ */
+class BlockCache {
+public:
+	/**
+	 * the cache used by the file systems registered from now on, nullptr if there is none (the default)
+	 */
+	static std::shared_ptr<BlockCache> getInstance();
+
+	static void setInstance(std::shared_ptr<BlockCache> cache);
+
+	explicit BlockCache(const BlockCacheOptions & options);
+	~BlockCache();
+
+	int64_t getBlockSize() const { return this->options.blockSize; }
+
+	int64_t getCapacity() const { return this->options.capacity; }
+
+	/**
+	 * reads the block into out, that must have room for a whole block
+	 * @return false if the block is not cached
+	 */
+	bool get(const std::string & fileKey, int64_t blockIndex, uint8_t * out, int64_t * nbytes);
+
+	/**
+	 * stores a block, evicting the least recently used blocks until it fits. Blocks that can not be written to the
+	 * disk are not cached
+	 */
+	void put(const std::string & fileKey, int64_t blockIndex, const uint8_t * data, int64_t nbytes);
+
+	void clear();
+
+	long long getHits() const;
+	long long getMisses() const;
+	long long getEvictions() const;
+	long long getNumBlocks() const;
+	long long getSizeInBytes() const;
+
+private:
+	struct Block {
+		std::string key;
+		std::string path;
+		int64_t nbytes;
+	};
+
+	static std::string makeKey(const std::string & fileKey, int64_t blockIndex);
+
+	// must be called with the mutex held
+	void evict(int64_t nbytes);
+
+	BlockCacheOptions options;
+	// inside options.directory, only used by this cache
+	std::string blockDirectory;
+
+	mutable std::mutex mutex;
+	// most recently used first
+	std::list<Block> blocks;
+	std::unordered_map<std::string, std::list<Block>::iterator> index;
+	int64_t sizeInBytes;
+	long long nextBlockId;
+	long long hits;
+	long long misses;
+	long long evictions;
+
+	BlockCache(const BlockCache &) = delete;
+	BlockCache & operator=(const BlockCache &) = delete;
+};
+
+#endif /* _BLAZING_BLOCK_CACHE_H_ */
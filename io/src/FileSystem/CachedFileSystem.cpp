@@ -0,0 +1,102 @@
+/*
+ * Copyright 2019 BlazingDB, Inc.
+ */
+
+#include "CachedFileSystem.h"
+
+#include "private/CachedReadableFile.h"
+
+CachedFileSystem::CachedFileSystem(std::unique_ptr<FileSystemInterface> fileSystem, std::shared_ptr<BlockCache> cache)
+	: fileSystem(std::move(fileSystem)), cache(cache) {}
+
+CachedFileSystem::~CachedFileSystem() {}
+
+FileSystemType CachedFileSystem::getFileSystemType() const noexcept { return this->fileSystem->getFileSystemType(); }
+
+FileSystemConnection CachedFileSystem::getFileSystemConnection() const noexcept {
+	return this->fileSystem->getFileSystemConnection();
+}
+
+Path CachedFileSystem::getRoot() const noexcept { return this->fileSystem->getRoot(); }
+
+bool CachedFileSystem::exists(const Uri & uri) const { return this->fileSystem->exists(uri); }
+
+void CachedFileSystem::rememberFileStatus(const FileStatus & fileStatus) const {
+	if(!fileStatus.isFile()) {
+		return;
+	}
+	std::lock_guard<std::mutex> lock(this->fileStatusesMutex);
+	this->fileStatuses[fileStatus.getUri().toString()] = fileStatus;
+}
+
+FileStatus CachedFileSystem::getFileStatus(const Uri & uri) const {
+	const FileStatus fileStatus = this->fileSystem->getFileStatus(uri);
+	this->rememberFileStatus(fileStatus);
+	return fileStatus;
+}
+
+std::vector<FileStatus> CachedFileSystem::list(const Uri & uri, const FileFilter & filter) const {
+	std::vector<FileStatus> fileStatuses = this->fileSystem->list(uri, filter);
+	for(const FileStatus & fileStatus : fileStatuses) {
+		this->rememberFileStatus(fileStatus);
+	}
+	return fileStatuses;
+}
+
+std::vector<FileStatus> CachedFileSystem::list(
+	const Uri & uri, FileType fileType, const std::string & wildcard) const {
+	std::vector<FileStatus> fileStatuses = this->fileSystem->list(uri, fileType, wildcard);
+	for(const FileStatus & fileStatus : fileStatuses) {
+		this->rememberFileStatus(fileStatus);
+	}
+	return fileStatuses;
+}
+
+std::vector<Uri> CachedFileSystem::list(const Uri & uri, const std::string & wildcard) const {
+	return this->fileSystem->list(uri, wildcard);
+}
+
+std::vector<std::string> CachedFileSystem::listResourceNames(
+	const Uri & uri, FileType fileType, const std::string & wildcard) const {
+	return this->fileSystem->listResourceNames(uri, fileType, wildcard);
+}
+
+std::vector<std::string> CachedFileSystem::listResourceNames(const Uri & uri, const std::string & wildcard) const {
+	return this->fileSystem->listResourceNames(uri, wildcard);
+}
+
+bool CachedFileSystem::makeDirectory(const Uri & uri) const { return this->fileSystem->makeDirectory(uri); }
+
+// files that change get a new version, so their cached blocks are not read anymore and are eventually evicted
+bool CachedFileSystem::remove(const Uri & uri) const { return this->fileSystem->remove(uri); }
+
+bool CachedFileSystem::move(const Uri & src, const Uri & dst) const { return this->fileSystem->move(src, dst); }
+
+bool CachedFileSystem::truncateFile(const Uri & uri, long long length) const {
+	return this->fileSystem->truncateFile(uri, length);
+}
+
+std::shared_ptr<arrow::io::RandomAccessFile> CachedFileSystem::openReadable(const Uri & uri) const {
+	FileStatus fileStatus;
+	{
+		std::lock_guard<std::mutex> lock(this->fileStatusesMutex);
+		auto fileStatusIt = this->fileStatuses.find(uri.toString());
+		if(fileStatusIt != this->fileStatuses.end()) {
+			fileStatus = fileStatusIt->second;
+		}
+	}
+	if(!fileStatus.isFile()) {
+		fileStatus = this->getFileStatus(uri);
+	}
+	if(!fileStatus.isFile() || fileStatus.getVersion().empty()) {
+		return this->fileSystem->openReadable(uri);
+	}
+
+	const std::string fileKey =
+		uri.toString() + "|" + std::to_string(fileStatus.getFileSize()) + "|" + fileStatus.getVersion();
+	return std::make_shared<CachedReadableFile>(this->fileSystem, uri, this->cache, fileKey, fileStatus.getFileSize());
+}
+
+std::shared_ptr<arrow::io::OutputStream> CachedFileSystem::openWriteable(const Uri & uri) const {
+	return this->fileSystem->openWriteable(uri);
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright 2019 BlazingDB, Inc.
+ */
+
+#ifndef _BLAZING_CACHED_FILE_SYSTEM_H_
+#define _BLAZING_CACHED_FILE_SYSTEM_H_
+
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include "FileSystem/BlockCache.h"
+#include "FileSystem/FileSystemInterface.h"
+
+/**
+ * Read-through cache in front of another file system, usually a remote one.
+ *
+ * Files are read in blocks through the BlockCache, keyed on their uri and the version the file system reports (the
+ * ETag on S3 and Google Cloud Storage), so a file that changes is read again from the file system. Files without a
+ * version are not cached. Everything else goes straight to the file system.
+ *
+ * The size and version of a file are the ones of the last status of its uri this file system returned, from
+ * getFileStatus or list, so opening a file right after the data loader got its status does not ask the file system for
+ * it again. A file whose status was never asked for is only asked for once, when it is first opened.
+ */
+class CachedFileSystem : public FileSystemInterface {
+public:
+	CachedFileSystem(std::unique_ptr<FileSystemInterface> fileSystem, std::shared_ptr<BlockCache> cache);
+	virtual ~CachedFileSystem();
+
+	FileSystemType getFileSystemType() const noexcept;
+
+	// Connection
+	FileSystemConnection getFileSystemConnection() const noexcept;
+
+	// State
+	Path getRoot() const noexcept;
+
+	// Query
+	bool exists(const Uri & uri) const;
+	FileStatus getFileStatus(const Uri & uri) const;
+
+	// List
+	std::vector<FileStatus> list(const Uri & uri, const FileFilter & filter) const;
+	std::vector<FileStatus> list(const Uri & uri, FileType fileType, const std::string & wildcard = "*") const;
+	std::vector<Uri> list(const Uri & uri, const std::string & wildcard = "*") const;
+	std::vector<std::string> listResourceNames(
+		const Uri & uri, FileType fileType, const std::string & wildcard = "*") const;
+	std::vector<std::string> listResourceNames(const Uri & uri, const std::string & wildcard = "*") const;
+
+	// Operations
+	bool makeDirectory(const Uri & uri) const;
+	bool remove(const Uri & uri) const;
+	bool move(const Uri & src, const Uri & dst) const;
+	bool truncateFile(const Uri & uri, long long length) const;
+
+	// I/O
+	std::shared_ptr<arrow::io::RandomAccessFile> openReadable(const Uri & uri) const;
+	std::shared_ptr<arrow::io::OutputStream> openWriteable(const Uri & uri) const;
+
+	std::shared_ptr<BlockCache> getCache() const { return this->cache; }
+
+private:
+	// keeps the size and version of a file, see openReadable
+	void rememberFileStatus(const FileStatus & fileStatus) const;
+
+	// shared with the files that are open, they open the file on the file system only when a block is not cached
+	std::shared_ptr<FileSystemInterface> fileSystem;
+	std::shared_ptr<BlockCache> cache;
+
+	mutable std::mutex fileStatusesMutex;
+	// the last status of each file, by uri
+	mutable std::map<std::string, FileStatus> fileStatuses;
+};
+
+#endif /* _BLAZING_CACHED_FILE_SYSTEM_H_ */
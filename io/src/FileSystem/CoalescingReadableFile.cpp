@@ -0,0 +1,418 @@
+/*
+ * Copyright 2019 BlazingDB, Inc.
+ */
+
+#include "CoalescingReadableFile.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <functional>
+#include <future>
+#include <thread>
+
+#include "arrow/buffer.h"
+#include <arrow/memory_pool.h>
+
+namespace {
+
+std::mutex defaultOptionsMutex;
+CoalescingReadOptions defaultOptions;
+
+// a few threads shared by all the files, so the number of requests in flight does not grow with the number of files
+class FetchPool {
+public:
+	static FetchPool & getInstance() {
+		static FetchPool pool(std::max(CoalescingReadableFile::getDefaultOptions().fetchThreads, 1));
+		return pool;
+	}
+
+	explicit FetchPool(int numThreads) : stopping(false) {
+		for(int i = 0; i < numThreads; i++) {
+			this->threads.emplace_back([this]() { this->run(); });
+		}
+	}
+
+	~FetchPool() {
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			this->stopping = true;
+		}
+		this->condition.notify_all();
+		for(std::thread & thread : this->threads) {
+			thread.join();
+		}
+	}
+
+	std::shared_future<arrow::Status> submit(std::function<arrow::Status()> task) {
+		// the task is released once it runs, only its status is kept with the result
+		auto status = std::make_shared<std::promise<arrow::Status>>();
+		std::shared_future<arrow::Status> result = status->get_future().share();
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			this->tasks.push_back([status, task]() {
+				try {
+					status->set_value(task());
+				} catch(const std::exception & e) {
+					status->set_value(arrow::Status::IOError(e.what()));
+				}
+			});
+		}
+		this->condition.notify_one();
+		return result;
+	}
+
+private:
+	void run() {
+		while(true) {
+			std::function<void()> task;
+			{
+				std::unique_lock<std::mutex> lock(this->mutex);
+				this->condition.wait(lock, [this]() { return this->stopping || !this->tasks.empty(); });
+				if(this->tasks.empty()) {
+					return;
+				}
+				task = std::move(this->tasks.front());
+				this->tasks.pop_front();
+			}
+			task();
+		}
+	}
+
+	std::mutex mutex;
+	std::condition_variable condition;
+	std::deque<std::function<void()>> tasks;
+	std::vector<std::thread> threads;
+	bool stopping;
+};
+
+}  // namespace
+
+struct CoalescingReadableFile::FetchedRange {
+	int64_t position;
+	int64_t nbytes;
+	std::vector<uint8_t> data;
+	int64_t bytesRead = 0;
+	std::shared_future<arrow::Status> status;
+};
+
+void CoalescingReadableFile::setDefaultOptions(const CoalescingReadOptions & options) {
+	std::lock_guard<std::mutex> lock(defaultOptionsMutex);
+	defaultOptions = options;
+}
+
+CoalescingReadOptions CoalescingReadableFile::getDefaultOptions() {
+	std::lock_guard<std::mutex> lock(defaultOptionsMutex);
+	return defaultOptions;
+}
+
+CoalescingReadableFile::CoalescingReadableFile(
+	std::shared_ptr<RangeSource> source, const CoalescingReadOptions & options)
+	: source(source), options(options), position(0), size(-1), isClosed(false), fetchedBytes(0),
+	  requestCount(std::make_shared<std::atomic<long long>>(0)) {
+	this->options.maxRequestSize = std::max(this->options.maxRequestSize, int64_t{1});
+}
+
+CoalescingReadableFile::~CoalescingReadableFile() {}
+
+void CoalescingReadableFile::willNeed(const std::vector<std::pair<int64_t, int64_t>> & ranges) {
+	std::vector<std::pair<int64_t, int64_t>> sortedRanges;
+	for(const auto & range : ranges) {
+		if(range.second > 0) {
+			sortedRanges.push_back(range);
+		}
+	}
+	std::sort(sortedRanges.begin(), sortedRanges.end());
+
+	std::vector<std::pair<int64_t, int64_t>> mergedRanges;
+	for(const auto & range : sortedRanges) {
+		if(!mergedRanges.empty() &&
+			range.first <= mergedRanges.back().first + mergedRanges.back().second + this->options.mergeGap) {
+			int64_t end = std::max(mergedRanges.back().first + mergedRanges.back().second, range.first + range.second);
+			mergedRanges.back().second = end - mergedRanges.back().first;
+		} else {
+			mergedRanges.push_back(range);
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(this->mutex);
+	for(const auto & range : sortedRanges) {
+		this->addAnnounced(range.first, range.first + range.second);
+	}
+	this->pendingRanges.insert(this->pendingRanges.end(), mergedRanges.begin(), mergedRanges.end());
+	this->submitPending();
+}
+
+void CoalescingReadableFile::addAnnounced(int64_t begin, int64_t end) {
+	auto it = this->announcedRanges.upper_bound(begin);
+	if(it != this->announcedRanges.begin() && std::prev(it)->second >= begin) {
+		it = std::prev(it);
+		begin = it->first;
+	}
+	while(it != this->announcedRanges.end() && it->first <= end) {
+		end = std::max(end, it->second);
+		it = this->announcedRanges.erase(it);
+	}
+	this->announcedRanges[begin] = end;
+}
+
+void CoalescingReadableFile::removeAnnounced(int64_t begin, int64_t end) {
+	auto it = this->announcedRanges.upper_bound(begin);
+	if(it != this->announcedRanges.begin() && std::prev(it)->second > begin) {
+		it = std::prev(it);
+	}
+	while(it != this->announcedRanges.end() && it->first < end) {
+		int64_t rangeBegin = it->first;
+		int64_t rangeEnd = it->second;
+		it = this->announcedRanges.erase(it);
+		if(rangeBegin < begin) {
+			this->announcedRanges[rangeBegin] = begin;
+		}
+		if(rangeEnd > end) {
+			this->announcedRanges[end] = rangeEnd;
+		}
+	}
+}
+
+int64_t CoalescingReadableFile::firstAnnounced(int64_t begin, int64_t end) const {
+	auto it = this->announcedRanges.upper_bound(begin);
+	if(it != this->announcedRanges.begin() && std::prev(it)->second > begin) {
+		return begin;
+	}
+	return it != this->announcedRanges.end() ? std::min(it->first, end) : end;
+}
+
+void CoalescingReadableFile::submit(int64_t position, int64_t nbytes) {
+	int64_t end = position + nbytes;
+	if(this->size >= 0) {
+		end = std::min(end, this->size);
+	}
+
+	int64_t current = position;
+	while(current < end) {
+		auto next = this->fetchedRanges.upper_bound(current);
+		if(next != this->fetchedRanges.begin()) {
+			auto previous = std::prev(next);
+			int64_t previousEnd = previous->first + previous->second->nbytes;
+			if(previousEnd > current) {  // already fetched or being fetched
+				current = previousEnd;
+				continue;
+			}
+		}
+
+		int64_t pieceEnd = std::min(end, current + this->options.maxRequestSize);
+		if(next != this->fetchedRanges.end()) {
+			pieceEnd = std::min(pieceEnd, next->first);
+		}
+
+		auto range = std::make_shared<FetchedRange>();
+		range->position = current;
+		range->nbytes = pieceEnd - current;
+		range->data.resize(range->nbytes);
+
+		std::shared_ptr<RangeSource> source = this->source;
+		std::shared_ptr<std::atomic<long long>> requestCount = this->requestCount;
+		range->status = FetchPool::getInstance().submit([source, requestCount, range]() {
+			(*requestCount)++;
+			return source->fetchRange(range->position, range->nbytes, range->data.data(), &range->bytesRead);
+		});
+
+		this->fetchedRanges[current] = range;
+		this->fetchedBytes += range->nbytes;
+		current = pieceEnd;
+	}
+}
+
+void CoalescingReadableFile::submitPending() {
+	while(!this->pendingRanges.empty() && this->fetchedBytes < this->options.prefetchSize) {
+		std::pair<int64_t, int64_t> range = this->pendingRanges.front();
+		this->pendingRanges.pop_front();
+
+		int64_t nbytes = std::min(range.second, this->options.maxRequestSize);
+		if(nbytes < range.second) {
+			this->pendingRanges.emplace_front(range.first + nbytes, range.second - nbytes);
+		}
+		this->submit(range.first, nbytes);
+	}
+}
+
+arrow::Status CoalescingReadableFile::Close() {
+	std::lock_guard<std::mutex> lock(this->mutex);
+	// fetches in flight keep their range alive until they finish
+	this->fetchedRanges.clear();
+	this->pendingRanges.clear();
+	this->announcedRanges.clear();
+	this->fetchedBytes = 0;
+	this->isClosed = true;
+	return arrow::Status::OK();
+}
+
+arrow::Status CoalescingReadableFile::getSize(int64_t * size) {
+	std::lock_guard<std::mutex> lock(this->mutex);
+	if(this->size < 0) {
+		(*this->requestCount)++;
+		ARROW_RETURN_NOT_OK(this->source->fetchSize(&this->size));
+	}
+	*size = this->size;
+	return arrow::Status::OK();
+}
+
+arrow::Status CoalescingReadableFile::GetSize(int64_t * size) { return this->getSize(size); }
+
+arrow::Status CoalescingReadableFile::Read(int64_t nbytes, int64_t * bytesRead, void * buffer) {
+	int64_t position;
+	this->Tell(&position);
+	return this->ReadAt(position, nbytes, bytesRead, buffer);
+}
+
+arrow::Status CoalescingReadableFile::Read(int64_t nbytes, std::shared_ptr<arrow::Buffer> * out) {
+	int64_t position;
+	this->Tell(&position);
+	return this->ReadAt(position, nbytes, out);
+}
+
+arrow::Status CoalescingReadableFile::ReadAt(int64_t position, int64_t nbytes, int64_t * bytesRead, void * buffer) {
+	*bytesRead = 0;
+
+	int64_t fileSize;
+	ARROW_RETURN_NOT_OK(this->getSize(&fileSize));
+	int64_t end = std::min(position + nbytes, fileSize);
+	if(position >= end) {
+		return arrow::Status::OK();
+	}
+
+	// the ranges covering the read, in order. What was not announced is fetched now
+	std::vector<std::shared_ptr<FetchedRange>> ranges;
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->submit(position, end - position);
+
+		auto it = this->fetchedRanges.upper_bound(position);
+		if(it != this->fetchedRanges.begin()) {
+			it = std::prev(it);
+		}
+		for(; it != this->fetchedRanges.end() && it->first < end; ++it) {
+			if(it->first + it->second->nbytes > position) {
+				ranges.push_back(it->second);
+			}
+		}
+	}
+
+	uint8_t * out = static_cast<uint8_t *>(buffer);
+	int64_t copied = position;
+	arrow::Status status = arrow::Status::OK();
+	for(const std::shared_ptr<FetchedRange> & range : ranges) {
+		status = range->status.get();
+		if(!status.ok() || range->position > copied) {
+			break;
+		}
+
+		int64_t copyEnd = std::min(end, range->position + range->bytesRead);
+		if(copyEnd > copied) {
+			std::memcpy(out + (copied - position), range->data.data() + (copied - range->position), copyEnd - copied);
+			copied = copyEnd;
+		}
+		if(range->bytesRead < range->nbytes) {  // the file ended before the range did
+			break;
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		// the bytes the read went through are not needed anymore, the ranges that failed are fetched again on the next
+		// read
+		this->removeAnnounced(position, copied);
+		for(const std::shared_ptr<FetchedRange> & range : ranges) {
+			this->releaseRead(range);
+		}
+
+		// announced ranges the read went through were fetched by it
+		std::deque<std::pair<int64_t, int64_t>> pendingRanges;
+		for(const auto & range : this->pendingRanges) {
+			int64_t rangeEnd = range.first + range.second;
+			if(range.first < position) {
+				pendingRanges.emplace_back(range.first, std::min(rangeEnd, position) - range.first);
+			}
+			if(rangeEnd > copied) {
+				int64_t rangeBegin = std::max(range.first, copied);
+				pendingRanges.emplace_back(rangeBegin, rangeEnd - rangeBegin);
+			}
+		}
+		this->pendingRanges.swap(pendingRanges);
+
+		this->submitPending();
+		this->position = copied;
+	}
+
+	*bytesRead = copied - position;
+	return status;
+}
+
+void CoalescingReadableFile::releaseRead(const std::shared_ptr<FetchedRange> & range) {
+	auto it = this->fetchedRanges.find(range->position);
+	if(it == this->fetchedRanges.end() || it->second != range) {
+		return;
+	}
+
+	bool fetched = range->status.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+	int64_t rangeEnd = range->position + range->nbytes;
+	int64_t trimPosition = this->firstAnnounced(range->position, rangeEnd);
+	if(trimPosition == rangeEnd || (fetched && !range->status.get().ok())) {
+		this->fetchedBytes -= range->nbytes;
+		this->fetchedRanges.erase(it);
+		return;
+	}
+
+	// the bytes left are copied to a smaller range, only when that frees at least half of it so every byte is copied a
+	// few times at most. Reads that still use the old range keep it alive
+	int64_t trimmedBytes = trimPosition - range->position;
+	if(!fetched || trimmedBytes * 2 < range->nbytes) {
+		return;
+	}
+	auto trimmedRange = std::make_shared<FetchedRange>();
+	trimmedRange->position = trimPosition;
+	trimmedRange->nbytes = range->nbytes - trimmedBytes;
+	trimmedRange->bytesRead = std::max(range->bytesRead - trimmedBytes, int64_t{0});
+	trimmedRange->data.assign(range->data.begin() + std::min(trimmedBytes, range->bytesRead),
+		range->data.begin() + range->bytesRead);
+	trimmedRange->data.resize(trimmedRange->nbytes);
+	trimmedRange->status = range->status;
+
+	this->fetchedRanges.erase(it);
+	this->fetchedRanges[trimPosition] = trimmedRange;
+	this->fetchedBytes -= trimmedBytes;
+}
+
+arrow::Status CoalescingReadableFile::ReadAt(int64_t position, int64_t nbytes, std::shared_ptr<arrow::Buffer> * out) {
+	std::shared_ptr<arrow::ResizableBuffer> buffer;
+	ARROW_RETURN_NOT_OK(AllocateResizableBuffer(arrow::default_memory_pool(), nbytes, &buffer));
+
+	int64_t bytesRead = 0;
+	ARROW_RETURN_NOT_OK(this->ReadAt(position, nbytes, &bytesRead, buffer->mutable_data()));
+	if(bytesRead < nbytes) {
+		ARROW_RETURN_NOT_OK(buffer->Resize(bytesRead));
+	}
+	*out = buffer;
+	return arrow::Status::OK();
+}
+
+bool CoalescingReadableFile::supports_zero_copy() const { return false; }
+
+arrow::Status CoalescingReadableFile::Seek(int64_t position) {
+	std::lock_guard<std::mutex> lock(this->mutex);
+	this->position = position;
+	return arrow::Status::OK();
+}
+
+arrow::Status CoalescingReadableFile::Tell(int64_t * position) const {
+	std::lock_guard<std::mutex> lock(this->mutex);
+	*position = this->position;
+	return arrow::Status::OK();
+}
+
+bool CoalescingReadableFile::closed() const {
+	std::lock_guard<std::mutex> lock(this->mutex);
+	return this->isClosed;
+}
+
+long long CoalescingReadableFile::getRequestCount() const { return *this->requestCount; }
@@ -0,0 +1,131 @@
+/*
+ * Copyright 2019 BlazingDB, Inc.
+ */
+
+#ifndef _BLAZING_COALESCING_READABLE_FILE_H_
+#define _BLAZING_COALESCING_READABLE_FILE_H_
+
+#include <atomic>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "arrow/io/interfaces.h"
+#include "arrow/status.h"
+
+struct CoalescingReadOptions {
+	// ranges separated by fewer bytes than this are fetched with a single request
+	int64_t mergeGap = 64 * 1024;
+	// requests larger than this are split and the pieces are fetched in parallel
+	int64_t maxRequestSize = 16 * 1024 * 1024;
+	// how many of the bytes announced with willNeed can be fetched ahead of the reads
+	int64_t prefetchSize = 64 * 1024 * 1024;
+	// threads fetching ranges, shared by all the files. Only read when the first file is created
+	int fetchThreads = 8;
+};
+
+/**
+ * The requests a CoalescingReadableFile sends to the store that has the data, they can be called from any thread
+ */
+class RangeSource {
+public:
+	virtual ~RangeSource() {}
+
+	// reads nbytes starting at position into out, with a single request
+	virtual arrow::Status fetchRange(int64_t position, int64_t nbytes, uint8_t * out, int64_t * bytesRead) = 0;
+
+	virtual arrow::Status fetchSize(int64_t * size) = 0;
+};
+
+/**
+ * A file on a remote store where every request has a high latency, for example an object in S3.
+ *
+ * The size is only requested once. Readers can announce the ranges they are about to read with willNeed, nearby
+ * ranges are merged into one request and fetched in parallel in the background, up to prefetchSize bytes ahead of the
+ * reads. Reads of ranges that were not announced are sent right away, split in parallel requests when they are large.
+ * A fetched range is trimmed as the announced bytes at its start are read, and released once none of its announced
+ * bytes are left to read, so the bytes between announced ranges are not kept.
+ */
+class CoalescingReadableFile : public arrow::io::RandomAccessFile {
+public:
+	static void setDefaultOptions(const CoalescingReadOptions & options);
+
+	static CoalescingReadOptions getDefaultOptions();
+
+	explicit CoalescingReadableFile(
+		std::shared_ptr<RangeSource> source, const CoalescingReadOptions & options = getDefaultOptions());
+	~CoalescingReadableFile();
+
+	/**
+	 * announces ranges, as position and number of bytes, that will be read soon. They do not need to be sorted
+	 */
+	void willNeed(const std::vector<std::pair<int64_t, int64_t>> & ranges);
+
+	arrow::Status Close() override;
+
+	arrow::Status GetSize(int64_t * size) override;
+
+	arrow::Status Read(int64_t nbytes, int64_t * bytesRead, void * buffer) override;
+
+	arrow::Status Read(int64_t nbytes, std::shared_ptr<arrow::Buffer> * out) override;
+
+	arrow::Status ReadAt(int64_t position, int64_t nbytes, int64_t * bytesRead, void * buffer) override;
+
+	arrow::Status ReadAt(int64_t position, int64_t nbytes, std::shared_ptr<arrow::Buffer> * out) override;
+
+	bool supports_zero_copy() const override;
+
+	arrow::Status Seek(int64_t position) override;
+	arrow::Status Tell(int64_t * position) const override;
+
+	bool closed() const override;
+
+	// requests sent to the source, including the size request
+	long long getRequestCount() const;
+
+private:
+	struct FetchedRange;
+
+	arrow::Status getSize(int64_t * size);
+
+	// fetches the parts of [position, position + nbytes) that are not fetched or being fetched already. Must be called
+	// with the mutex held
+	void submit(int64_t position, int64_t nbytes);
+
+	// submits announced ranges while there are less than prefetchSize bytes fetched ahead. Must be called with the
+	// mutex held
+	void submitPending();
+
+	// the announced bytes that were not read yet, as disjoint ranges. Must be called with the mutex held
+	void addAnnounced(int64_t begin, int64_t end);
+	void removeAnnounced(int64_t begin, int64_t end);
+	// the first announced byte that was not read yet in [begin, end), or end. Must be called with the mutex held
+	int64_t firstAnnounced(int64_t begin, int64_t end) const;
+
+	// drops the bytes of a fetched range that come before its first announced byte, or the whole range when it has none
+	// left or its fetch failed. Must be called with the mutex held
+	void releaseRead(const std::shared_ptr<FetchedRange> & range);
+
+	std::shared_ptr<RangeSource> source;
+	CoalescingReadOptions options;
+
+	mutable std::mutex mutex;
+	int64_t position;
+	int64_t size;
+	bool isClosed;
+	// fetched or being fetched, by position
+	std::map<int64_t, std::shared_ptr<FetchedRange>> fetchedRanges;
+	int64_t fetchedBytes;
+	// announced but not fetched yet, coalesced
+	std::deque<std::pair<int64_t, int64_t>> pendingRanges;
+	// announced and not read yet, by position, with the end of each range
+	std::map<int64_t, int64_t> announcedRanges;
+	std::shared_ptr<std::atomic<long long>> requestCount;
+
+	ARROW_DISALLOW_COPY_AND_ASSIGN(CoalescingReadableFile);
+};
+
+#endif /* _BLAZING_COALESCING_READABLE_FILE_H_ */
@@ -5,15 +5,17 @@
 
 #include "FileStatus.h"
 
-FileStatus::FileStatus() : uri(Uri()), fileType(FileType::UNDEFINED), fileSize(0) {}
+FileStatus::FileStatus() : uri(Uri()), fileType(FileType::UNDEFINED), fileSize(0), version() {}
 
-FileStatus::FileStatus(const Uri & uri, FileType fileType, unsigned long long fileSize)
-	: uri(uri), fileType(fileType), fileSize(fileSize) {}
+FileStatus::FileStatus(const Uri & uri, FileType fileType, unsigned long long fileSize, const std::string & version)
+	: uri(uri), fileType(fileType), fileSize(fileSize), version(version) {}
 
-FileStatus::FileStatus(const FileStatus & other) : uri(other.uri), fileType(other.fileType), fileSize(other.fileSize) {}
+FileStatus::FileStatus(const FileStatus & other)
+	: uri(other.uri), fileType(other.fileType), fileSize(other.fileSize), version(other.version) {}
 
 FileStatus::FileStatus(FileStatus && other)
-	: uri(std::move(other.uri)), fileType(std::move(other.fileType)), fileSize(std::move(other.fileSize)) {}
+	: uri(std::move(other.uri)), fileType(std::move(other.fileType)), fileSize(std::move(other.fileSize)),
+	  version(std::move(other.version)) {}
 
 FileStatus::~FileStatus() {}
 
@@ -23,6 +25,8 @@ FileType FileStatus::getFileType() const noexcept { return this->fileType; }
 
 unsigned long long FileStatus::getFileSize() const noexcept { return this->fileSize; }
 
+std::string FileStatus::getVersion() const noexcept { return this->version; }
+
 bool FileStatus::isFile() const noexcept { return (this->fileType == FileType::FILE); }
 
 bool FileStatus::isDirectory() const noexcept { return (this->fileType == FileType::DIRECTORY); }
@@ -35,6 +39,7 @@ FileStatus & FileStatus::operator=(const FileStatus & other) {
 	this->uri = other.uri;
 	this->fileType = other.fileType;
 	this->fileSize = other.fileSize;
+	this->version = other.version;
 
 	return *this;
 }
@@ -43,6 +48,7 @@ FileStatus & FileStatus::operator=(FileStatus && other) {
 	this->uri = std::move(other.uri);
 	this->fileType = std::move(other.fileType);
 	this->fileSize = std::move(other.fileSize);
+	this->version = std::move(other.version);
 
 	return *this;
 }
@@ -51,8 +57,9 @@ bool FileStatus::operator==(const FileStatus & other) const {
 	const bool pathEquals = (this->uri == other.uri);
 	const bool fileTypeEquals = (this->fileType == other.fileType);
 	const bool fileSizeEquals = (this->fileSize == other.fileSize);
+	const bool versionEquals = (this->version == other.version);
 
-	const bool equals = (pathEquals && fileTypeEquals && fileSizeEquals);
+	const bool equals = (pathEquals && fileTypeEquals && fileSizeEquals && versionEquals);
 
 	return equals;
 }
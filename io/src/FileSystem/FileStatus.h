@@ -14,7 +14,7 @@
 class FileStatus {
 public:
 	FileStatus();
-	FileStatus(const Uri & uri, FileType fileType, unsigned long long fileSize);
+	FileStatus(const Uri & uri, FileType fileType, unsigned long long fileSize, const std::string & version = "");
 	FileStatus(const FileStatus & other);
 	FileStatus(FileStatus && other);
 	~FileStatus();
@@ -23,6 +23,10 @@ public:
 	FileType getFileType() const noexcept;
 	unsigned long long getFileSize() const noexcept;
 
+	// identifies the content of the file: the ETag for object stores and the modification time for file systems,
+	// empty when the file system does not provide one
+	std::string getVersion() const noexcept;
+
 	// Helpers
 	bool isFile() const noexcept;
 	bool isDirectory() const noexcept;
@@ -52,6 +56,7 @@ private:
 	Uri uri;
 	FileType fileType;
 	unsigned long long fileSize;
+	std::string version;
 };
 
 #endif /* _BLAZING_FILE_STATUS_H_ */
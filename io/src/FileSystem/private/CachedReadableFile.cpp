@@ -0,0 +1,135 @@
+/*
+ * Copyright 2019 BlazingDB, Inc.
+ */
+
+#include "CachedReadableFile.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+CachedRangeSource::CachedRangeSource(std::shared_ptr<FileSystemInterface> fileSystem,
+	const Uri & uri,
+	std::shared_ptr<BlockCache> cache,
+	const std::string & fileKey,
+	int64_t size)
+	: fileSystem(fileSystem), uri(uri), cache(cache), fileKey(fileKey), size(size) {}
+
+arrow::Status CachedRangeSource::readBlocks(
+	int64_t firstBlock, int64_t numBlocks, uint8_t * out, int64_t * bytesRead) {
+	std::shared_ptr<arrow::io::RandomAccessFile> file;
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		if(this->file == nullptr) {
+			try {
+				this->file = this->fileSystem->openReadable(this->uri);
+			} catch(const std::exception & e) {
+				return arrow::Status::IOError(e.what());
+			}
+		}
+		file = this->file;
+	}
+
+	const int64_t blockSize = this->cache->getBlockSize();
+	const int64_t begin = firstBlock * blockSize;
+	const int64_t end = std::min((firstBlock + numBlocks) * blockSize, this->size);
+	ARROW_RETURN_NOT_OK(file->ReadAt(begin, end - begin, bytesRead, out));
+
+	for(int64_t block = firstBlock; block < firstBlock + numBlocks; block++) {
+		const int64_t blockBegin = block * blockSize;
+		const int64_t blockEnd = std::min(blockBegin + blockSize, this->size);
+		if(blockEnd > begin + *bytesRead) {
+			break;
+		}
+		this->cache->put(this->fileKey, block, out + (blockBegin - begin), blockEnd - blockBegin);
+	}
+	return arrow::Status::OK();
+}
+
+arrow::Status CachedRangeSource::fetchRange(int64_t position, int64_t nbytes, uint8_t * out, int64_t * bytesRead) {
+	*bytesRead = 0;
+	const int64_t end = std::min(position + nbytes, this->size);
+	if(position >= end) {
+		return arrow::Status::OK();
+	}
+
+	const int64_t blockSize = this->cache->getBlockSize();
+	const int64_t firstBlock = position / blockSize;
+	const int64_t lastBlock = (end - 1) / blockSize;
+
+	// copies the part of a block that overlaps the range
+	auto copyBlock = [&](int64_t block, const uint8_t * data) {
+		const int64_t copyBegin = std::max(block * blockSize, position);
+		const int64_t copyEnd = std::min(block * blockSize + blockSize, end);
+		std::memcpy(out + (copyBegin - position), data + (copyBegin - block * blockSize), copyEnd - copyBegin);
+	};
+
+	std::vector<uint8_t> data(blockSize);
+	std::vector<int64_t> missingBlocks;
+	for(int64_t block = firstBlock; block <= lastBlock; block++) {
+		const int64_t expectedBytes = std::min(block * blockSize + blockSize, this->size) - block * blockSize;
+		int64_t blockBytes = 0;
+		if(this->cache->get(this->fileKey, block, data.data(), &blockBytes) && blockBytes == expectedBytes) {
+			copyBlock(block, data.data());
+		} else {
+			missingBlocks.push_back(block);
+		}
+	}
+
+	// consecutive missing blocks are read together
+	for(size_t i = 0; i < missingBlocks.size();) {
+		size_t j = i + 1;
+		while(j < missingBlocks.size() && missingBlocks[j] == missingBlocks[j - 1] + 1) {
+			j++;
+		}
+		const int64_t firstMissing = missingBlocks[i];
+		const int64_t numMissing = j - i;
+		const int64_t expectedBytes =
+			std::min((firstMissing + numMissing) * blockSize, this->size) - firstMissing * blockSize;
+
+		data.resize(expectedBytes);
+		int64_t missingBytesRead = 0;
+		ARROW_RETURN_NOT_OK(this->readBlocks(firstMissing, numMissing, data.data(), &missingBytesRead));
+		if(missingBytesRead < expectedBytes) {
+			return arrow::Status::IOError("File " + this->uri.toString() + " is smaller than when it was opened");
+		}
+		for(int64_t block = firstMissing; block < firstMissing + numMissing; block++) {
+			copyBlock(block, data.data() + (block - firstMissing) * blockSize);
+		}
+		i = j;
+	}
+
+	*bytesRead = end - position;
+	return arrow::Status::OK();
+}
+
+arrow::Status CachedRangeSource::fetchSize(int64_t * size) {
+	*size = this->size;
+	return arrow::Status::OK();
+}
+
+arrow::Status CachedRangeSource::close() {
+	std::lock_guard<std::mutex> lock(this->mutex);
+	if(this->file != nullptr) {
+		ARROW_RETURN_NOT_OK(this->file->Close());
+		this->file = nullptr;
+	}
+	return arrow::Status::OK();
+}
+
+CachedReadableFile::CachedReadableFile(std::shared_ptr<FileSystemInterface> fileSystem,
+	const Uri & uri,
+	std::shared_ptr<BlockCache> cache,
+	const std::string & fileKey,
+	int64_t size)
+	: CachedReadableFile(std::make_shared<CachedRangeSource>(fileSystem, uri, cache, fileKey, size)) {}
+
+CachedReadableFile::CachedReadableFile(std::shared_ptr<CachedRangeSource> source)
+	: CoalescingReadableFile(source), source(source) {}
+
+CachedReadableFile::~CachedReadableFile() {}
+
+arrow::Status CachedReadableFile::Close() {
+	ARROW_RETURN_NOT_OK(CoalescingReadableFile::Close());
+	return this->source->close();
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright 2019 BlazingDB, Inc.
+ */
+
+#ifndef _BLAZING_CACHED_READABLE_FILE_H_
+#define _BLAZING_CACHED_READABLE_FILE_H_
+
+#include <memory>
+#include <mutex>
+
+#include "FileSystem/BlockCache.h"
+#include "FileSystem/CoalescingReadableFile.h"
+#include "FileSystem/FileSystemInterface.h"
+#include "arrow/io/interfaces.h"
+#include "arrow/status.h"
+
+/**
+ * The ranges of a file read through a BlockCache. Blocks that are not cached are read from the file system,
+ * consecutive missing blocks with a single read, and then cached. The file is only opened on the file system when a
+ * block is missing
+ */
+class CachedRangeSource : public RangeSource {
+public:
+	CachedRangeSource(std::shared_ptr<FileSystemInterface> fileSystem,
+		const Uri & uri,
+		std::shared_ptr<BlockCache> cache,
+		const std::string & fileKey,
+		int64_t size);
+
+	arrow::Status fetchRange(int64_t position, int64_t nbytes, uint8_t * out, int64_t * bytesRead) override;
+
+	arrow::Status fetchSize(int64_t * size) override;
+
+	// closes the file on the file system, if it was opened
+	arrow::Status close();
+
+private:
+	// reads blocks [firstBlock, firstBlock + numBlocks) from the file system into out and caches them
+	arrow::Status readBlocks(int64_t firstBlock, int64_t numBlocks, uint8_t * out, int64_t * bytesRead);
+
+	std::shared_ptr<FileSystemInterface> fileSystem;
+	Uri uri;
+	std::shared_ptr<BlockCache> cache;
+	std::string fileKey;
+	int64_t size;
+
+	std::mutex mutex;
+	std::shared_ptr<arrow::io::RandomAccessFile> file;
+};
+
+/**
+ * Reads of a file through a BlockCache. The ranges announced with willNeed are coalesced and prefetched like the ones
+ * of any other remote file (see CoalescingReadableFile), and only their blocks that are not cached reach the file
+ * system
+ */
+class CachedReadableFile : public CoalescingReadableFile {
+public:
+	CachedReadableFile(std::shared_ptr<FileSystemInterface> fileSystem,
+		const Uri & uri,
+		std::shared_ptr<BlockCache> cache,
+		const std::string & fileKey,
+		int64_t size);
+	~CachedReadableFile();
+
+	arrow::Status Close() override;
+
+private:
+	CachedReadableFile(std::shared_ptr<CachedRangeSource> source);
+
+	std::shared_ptr<CachedRangeSource> source;
+
+	ARROW_DISALLOW_COPY_AND_ASSIGN(CachedReadableFile);
+};
+
+#endif /* _BLAZING_CACHED_READABLE_FILE_H_ */
@@ -8,6 +8,7 @@
 #include <iostream>
 
 #include "ExceptionHandling/BlazingException.h"
+#include "FileSystem/CachedFileSystem.h"
 #include "FileSystemFactory.h"
 #include "Library/Logging/Logger.h"
 #include "Util/FileUtil.h"
@@ -54,6 +55,12 @@ bool FileSystemManager::Private::registerFileSystem(const FileSystemEntity & fil
 			return false;
 		}
 
+		// remote file systems are read through the local block cache, when there is one
+		std::shared_ptr<BlockCache> cache = BlockCache::getInstance();
+		if(cache != nullptr && fileSystem->getFileSystemType() != FileSystemType::LOCAL) {
+			fileSystem = std::unique_ptr<FileSystemInterface>(new CachedFileSystem(std::move(fileSystem), cache));
+		}
+
 		this->fileSystems.push_back(std::move(fileSystem));
 		this->fileSystemIds[authority] = this->fileSystems.size() - 1;
 	} else {  // only reuse fs that aren't null and were connected
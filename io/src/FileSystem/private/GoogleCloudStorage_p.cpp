@@ -159,7 +159,7 @@ FileStatus GoogleCloudStorage::Private::getFileStatus(const Uri & uri) const {
 			const FileStatus fileStatus(uri, fileType, contentLength);
 			return fileStatus;
 		} else {  // is probably a file (e.g. application/octet-stream or text/x-python and so on ...
-			const FileStatus fileStatus(uri, FileType::FILE, contentLength);
+			const FileStatus fileStatus(uri, FileType::FILE, contentLength, objectMetadata->etag());
 			return fileStatus;
 		}
 	} else {
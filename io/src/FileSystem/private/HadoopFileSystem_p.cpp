@@ -144,7 +144,7 @@ FileStatus HadoopFileSystem::Private::getFileStatus(const Uri & uri) const {
 		default: fileType = FileType::UNDEFINED; break;
 		}
 
-		return FileStatus(uri, fileType, stat_buf.size);
+		return FileStatus(uri, fileType, stat_buf.size, std::to_string(stat_buf.last_modified_time));
 	} else {
 		// TODO percy error handling
 	}
@@ -128,7 +128,9 @@ FileStatus LocalFileSystem::Private::getFileStatus(const Uri & uri) const {
 		default: fileType = FileType::UNDEFINED; break;
 		}
 
-		return FileStatus(uri, fileType, stat_buf.st_size);
+		const std::string version =
+			std::to_string(stat_buf.st_mtim.tv_sec) + "." + std::to_string(stat_buf.st_mtim.tv_nsec);
+		return FileStatus(uri, fileType, stat_buf.st_size, version);
 	} else {
 		switch(errno) {
 		case EACCES: throw BlazingInvalidPermissionsFileException(uri);
@@ -310,7 +310,7 @@ FileStatus S3FileSystem::Private::getFileStatus(const Uri & uri) const {
 			const FileStatus fileStatus(uri, FileType::DIRECTORY, contentLength);
 			return fileStatus;
 		} else {
-			const FileStatus fileStatus(uri, FileType::FILE, contentLength);
+			const FileStatus fileStatus(uri, FileType::FILE, contentLength, result.GetETag());
 			return fileStatus;
 		}
 	} else {
@@ -7,42 +7,41 @@
 #ifndef SRC_UTIL_BLAZINGS3_S3READABLEFILE_H_
 #define SRC_UTIL_BLAZINGS3_S3READABLEFILE_H_
 
+#include "FileSystem/CoalescingReadableFile.h"
 #include "arrow/io/interfaces.h"
 #include "arrow/status.h"
 #include <aws/core/utils/memory/stl/AWSString.h>
 #include <aws/s3/S3Client.h>
 
-class S3ReadableFile : public arrow::io::RandomAccessFile {
+/**
+ * The GetObject and HeadObject requests for an S3 object
+ */
+class S3ObjectRangeSource : public RangeSource {
 public:
-	S3ReadableFile(std::shared_ptr<Aws::S3::S3Client> s3Client, std::string bucket, std::string key);
-	~S3ReadableFile();
-
-	arrow::Status Close() override;
-
-	arrow::Status GetSize(int64_t * size) override;
+	S3ObjectRangeSource(std::shared_ptr<Aws::S3::S3Client> s3Client, std::string bucketName, std::string key);
 
-	arrow::Status Read(int64_t nbytes, int64_t * bytesRead, void * buffer) override;
+	arrow::Status fetchRange(int64_t position, int64_t nbytes, uint8_t * out, int64_t * bytesRead) override;
 
-	arrow::Status Read(int64_t nbytes, std::shared_ptr<arrow::Buffer> * out) override;
+	arrow::Status fetchSize(int64_t * size) override;
 
-	arrow::Status ReadAt(int64_t position, int64_t nbytes, int64_t * bytes_read, void * buffer) override;
-
-	arrow::Status ReadAt(int64_t position, int64_t nbytes, std::shared_ptr<arrow::Buffer> * out) override;
-
-	bool supports_zero_copy() const override;
+private:
+	std::shared_ptr<Aws::S3::S3Client> s3Client;
+	std::string bucketName;
+	std::string key;
+};
 
-	arrow::Status Seek(int64_t position) override;
-	arrow::Status Tell(int64_t * position) const override;
+/**
+ * Reads of an S3 object. Nearby ranges announced with willNeed are merged into one GetObject request and fetched in
+ * parallel ahead of the reads, and the size is only requested once (see CoalescingReadableFile)
+ */
+class S3ReadableFile : public CoalescingReadableFile {
+public:
+	S3ReadableFile(std::shared_ptr<Aws::S3::S3Client> s3Client, std::string bucket, std::string key);
+	~S3ReadableFile();
 
 	bool isValid() { return valid; }
 
-	bool closed() const override;
-
 private:
-	std::shared_ptr<Aws::S3::S3Client> s3Client;
-	std::string bucketName;
-	std::string key;
-	size_t position;
 	bool valid;
 
 	ARROW_DISALLOW_COPY_AND_ASSIGN(S3ReadableFile);
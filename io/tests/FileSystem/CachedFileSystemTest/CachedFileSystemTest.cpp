@@ -0,0 +1,270 @@
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "FileSystem/CachedFileSystem.h"
+#include "FileSystem/CoalescingReadableFile.h"
+#include "FileSystem/LocalFileSystem.h"
+
+// what the file system was asked for
+struct FileSystemCounts {
+	std::atomic<int> opens{0};
+	std::atomic<int> statuses{0};
+	std::atomic<int> reads{0};
+};
+
+// a file of the file system that counts its reads
+class CountingReadableFile : public arrow::io::RandomAccessFile {
+public:
+	CountingReadableFile(std::shared_ptr<arrow::io::RandomAccessFile> file, std::shared_ptr<FileSystemCounts> counts)
+		: file(file), counts(counts) {}
+
+	arrow::Status Close() override { return this->file->Close(); }
+	arrow::Status GetSize(int64_t * size) override { return this->file->GetSize(size); }
+	arrow::Status Read(int64_t nbytes, int64_t * bytesRead, void * buffer) override {
+		this->counts->reads++;
+		return this->file->Read(nbytes, bytesRead, buffer);
+	}
+	arrow::Status Read(int64_t nbytes, std::shared_ptr<arrow::Buffer> * out) override {
+		this->counts->reads++;
+		return this->file->Read(nbytes, out);
+	}
+	arrow::Status ReadAt(int64_t position, int64_t nbytes, int64_t * bytesRead, void * buffer) override {
+		this->counts->reads++;
+		return this->file->ReadAt(position, nbytes, bytesRead, buffer);
+	}
+	arrow::Status ReadAt(int64_t position, int64_t nbytes, std::shared_ptr<arrow::Buffer> * out) override {
+		this->counts->reads++;
+		return this->file->ReadAt(position, nbytes, out);
+	}
+	bool supports_zero_copy() const override { return this->file->supports_zero_copy(); }
+	arrow::Status Seek(int64_t position) override { return this->file->Seek(position); }
+	arrow::Status Tell(int64_t * position) const override { return this->file->Tell(position); }
+	bool closed() const override { return this->file->closed(); }
+
+private:
+	std::shared_ptr<arrow::io::RandomAccessFile> file;
+	std::shared_ptr<FileSystemCounts> counts;
+};
+
+// the local file system playing the role of a remote one, counting the requests it gets
+class CountingLocalFileSystem : public LocalFileSystem {
+public:
+	explicit CountingLocalFileSystem(std::shared_ptr<FileSystemCounts> counts) : counts(counts) {}
+
+	FileStatus getFileStatus(const Uri & uri) const {
+		this->counts->statuses++;
+		return LocalFileSystem::getFileStatus(uri);
+	}
+
+	std::shared_ptr<arrow::io::RandomAccessFile> openReadable(const Uri & uri) const {
+		this->counts->opens++;
+		return std::make_shared<CountingReadableFile>(LocalFileSystem::openReadable(uri), this->counts);
+	}
+
+private:
+	std::shared_ptr<FileSystemCounts> counts;
+};
+
+class CachedFileSystemTest : public testing::Test {
+protected:
+	CachedFileSystemTest() : counts(std::make_shared<FileSystemCounts>()) {}
+
+	virtual void SetUp() {
+		char directory[] = "/tmp/CachedFileSystemTestXXXXXX";
+		ASSERT_NE(mkdtemp(directory), nullptr);
+		this->directory = directory;
+		this->filePath = this->directory + "/remote.bin";
+		this->writeFile(10 * 1024 + 100, 0);
+	}
+
+	virtual void TearDown() {
+		this->fileSystem.reset();
+		this->cache.reset();
+		unlink(this->filePath.c_str());
+		rmdir((this->directory + "/cache").c_str());
+		rmdir(this->directory.c_str());
+	}
+
+	void writeFile(size_t size, int seed) {
+		this->data.resize(size);
+		for(size_t i = 0; i < size; i++) {
+			this->data[i] = static_cast<uint8_t>((i * 7 + seed) % 251);
+		}
+		std::ofstream file(this->filePath, std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<const char *>(this->data.data()), this->data.size());
+	}
+
+	void createFileSystem(int64_t capacity) {
+		BlockCacheOptions options;
+		options.directory = this->directory + "/cache";
+		options.blockSize = 1024;
+		options.capacity = capacity;
+		this->cache = std::make_shared<BlockCache>(options);
+		this->fileSystem.reset(new CachedFileSystem(
+			std::unique_ptr<FileSystemInterface>(new CountingLocalFileSystem(this->counts)), this->cache));
+	}
+
+	void expectRead(int64_t position, int64_t nbytes) {
+		std::shared_ptr<arrow::io::RandomAccessFile> file = this->fileSystem->openReadable(Uri(this->filePath));
+		std::vector<uint8_t> buffer(nbytes);
+		int64_t bytesRead = 0;
+		ASSERT_TRUE(file->ReadAt(position, nbytes, &bytesRead, buffer.data()).ok());
+
+		int64_t expectedBytes = std::min(nbytes, static_cast<int64_t>(this->data.size()) - position);
+		ASSERT_EQ(bytesRead, expectedBytes);
+		for(int64_t i = 0; i < bytesRead; i++) {
+			ASSERT_EQ(buffer[i], this->data[position + i]) << "at byte " << position + i;
+		}
+	}
+
+	std::string directory;
+	std::string filePath;
+	std::vector<uint8_t> data;
+	std::shared_ptr<FileSystemCounts> counts;
+	std::shared_ptr<BlockCache> cache;
+	std::unique_ptr<CachedFileSystem> fileSystem;
+};
+
+TEST_F(CachedFileSystemTest, SecondReadIsServedFromTheCache) {
+	this->createFileSystem(1024 * 1024);
+
+	this->expectRead(0, this->data.size());
+	EXPECT_EQ(this->counts->opens, 1);
+	EXPECT_EQ(this->cache->getMisses(), 11);
+	EXPECT_EQ(this->cache->getNumBlocks(), 11);
+	EXPECT_EQ(this->cache->getSizeInBytes(), static_cast<long long>(this->data.size()));
+
+	this->expectRead(0, this->data.size());
+	EXPECT_EQ(this->counts->opens, 1);
+	EXPECT_EQ(this->cache->getHits(), 11);
+	EXPECT_EQ(this->cache->getMisses(), 11);
+}
+
+TEST_F(CachedFileSystemTest, ReadsAcrossCachedAndMissingBlocks) {
+	this->createFileSystem(1024 * 1024);
+
+	this->expectRead(1500, 100);    // block 1
+	this->expectRead(3000, 2000);   // blocks 2 to 4
+	this->expectRead(1000, 9000);   // blocks 0 to 9, some of them cached
+	this->expectRead(10200, 1000);  // the last block, which is smaller, up to the end of the file
+	EXPECT_EQ(this->cache->getNumBlocks(), 11);
+
+	long long misses = this->cache->getMisses();
+	this->expectRead(17, 10 * 1024);
+	EXPECT_EQ(this->cache->getMisses(), misses);
+}
+
+TEST_F(CachedFileSystemTest, ChangedFilesAreReadAgain) {
+	this->createFileSystem(1024 * 1024);
+	this->expectRead(0, this->data.size());
+
+	// the data loader asks for the status of each file before it opens it
+	this->writeFile(5000, 1);
+	this->fileSystem->getFileStatus(Uri(this->filePath));
+	this->expectRead(0, this->data.size());
+	EXPECT_EQ(this->counts->opens, 2);
+}
+
+TEST_F(CachedFileSystemTest, StatusIsOnlyAskedForOnce) {
+	this->createFileSystem(1024 * 1024);
+
+	this->fileSystem->getFileStatus(Uri(this->filePath));
+	this->expectRead(0, 100);
+	EXPECT_EQ(this->counts->statuses, 1);
+
+	// a file whose status is not known yet
+	this->fileSystem.reset();
+	this->createFileSystem(1024 * 1024);
+	this->expectRead(0, 100);
+	this->expectRead(100, 100);
+	EXPECT_EQ(this->counts->statuses, 2);
+}
+
+TEST_F(CachedFileSystemTest, AnnouncedRangesAreCoalesced) {
+	this->createFileSystem(1024 * 1024);
+
+	// what the parquet parser does with the files of S3, Google Cloud Storage and HDFS
+	std::shared_ptr<arrow::io::RandomAccessFile> file = this->fileSystem->openReadable(Uri(this->filePath));
+	std::shared_ptr<CoalescingReadableFile> remoteFile = std::dynamic_pointer_cast<CoalescingReadableFile>(file);
+	ASSERT_NE(remoteFile, nullptr);
+
+	const std::vector<std::pair<int64_t, int64_t>> ranges{{100, 200}, {1500, 300}, {5000, 100}};
+	remoteFile->willNeed(ranges);
+	for(const auto & range : ranges) {
+		std::vector<uint8_t> buffer(range.second);
+		int64_t bytesRead = 0;
+		ASSERT_TRUE(file->ReadAt(range.first, range.second, &bytesRead, buffer.data()).ok());
+		ASSERT_EQ(bytesRead, range.second);
+		for(int64_t i = 0; i < bytesRead; i++) {
+			ASSERT_EQ(buffer[i], this->data[range.first + i]) << "at byte " << range.first + i;
+		}
+	}
+	// the three ranges are close enough to be one request, of the blocks 0 to 4
+	EXPECT_EQ(this->counts->reads, 1);
+	EXPECT_EQ(this->cache->getNumBlocks(), 5);
+
+	// only the blocks that are not cached yet are read
+	this->expectRead(4000, 3000);
+	EXPECT_EQ(this->counts->reads, 2);
+	EXPECT_EQ(this->cache->getNumBlocks(), 7);
+}
+
+TEST_F(CachedFileSystemTest, LeastRecentlyUsedBlocksAreEvicted) {
+	this->createFileSystem(4 * 1024);
+
+	this->expectRead(0, 4 * 1024);  // blocks 0 to 3
+	this->expectRead(0, 1024);		// block 0 is now the most recently used
+	this->expectRead(4 * 1024, 1024);
+	EXPECT_EQ(this->cache->getEvictions(), 1);
+	EXPECT_EQ(this->cache->getNumBlocks(), 4);
+	EXPECT_EQ(this->cache->getSizeInBytes(), 4 * 1024);
+
+	long long hits = this->cache->getHits();
+	this->expectRead(0, 1024);
+	EXPECT_EQ(this->cache->getHits(), hits + 1);
+
+	long long misses = this->cache->getMisses();
+	this->expectRead(1024, 1024);
+	EXPECT_EQ(this->cache->getMisses(), misses + 1);
+}
+
+TEST_F(CachedFileSystemTest, CachesSharingADirectoryKeepTheirOwnBlocks) {
+	std::string otherFile = this->directory + "/cache/0.block";
+	mkdir((this->directory + "/cache").c_str(), 0700);
+	std::ofstream(otherFile) << "other";
+
+	this->createFileSystem(1024 * 1024);
+	BlockCacheOptions options;
+	options.directory = this->directory + "/cache";
+	options.blockSize = 1024;
+	std::unique_ptr<BlockCache> otherCache(new BlockCache(options));
+	std::vector<uint8_t> otherBlock(1024, 7);
+	otherCache->put("other", 0, otherBlock.data(), otherBlock.size());
+	EXPECT_EQ(access(otherFile.c_str(), F_OK), 0);
+
+	this->expectRead(0, 1024);
+	EXPECT_EQ(this->cache->getNumBlocks(), 1);
+	EXPECT_EQ(this->cache->getMisses(), 1);
+
+	// the blocks of one cache are not overwritten nor removed by the other
+	std::vector<uint8_t> buffer(1024);
+	int64_t nbytes = 0;
+	ASSERT_TRUE(otherCache->get("other", 0, buffer.data(), &nbytes));
+	EXPECT_EQ(buffer, otherBlock);
+	this->fileSystem.reset();
+	this->cache.reset();
+	ASSERT_TRUE(otherCache->get("other", 0, buffer.data(), &nbytes));
+	EXPECT_EQ(buffer, otherBlock);
+
+	otherCache.reset();
+	EXPECT_EQ(access(otherFile.c_str(), F_OK), 0);
+	unlink(otherFile.c_str());
+}
@@ -0,0 +1,205 @@
+#include <algorithm>
+#include <mutex>
+#include <numeric>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "FileSystem/CoalescingReadableFile.h"
+
+// an object in memory that records the requests it receives
+class MemoryRangeSource : public RangeSource {
+public:
+	explicit MemoryRangeSource(int64_t size) : data(size) { std::iota(data.begin(), data.end(), 0); }
+
+	arrow::Status fetchRange(int64_t position, int64_t nbytes, uint8_t * out, int64_t * bytesRead) override {
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			this->requests.emplace_back(position, nbytes);
+		}
+		*bytesRead = std::max(std::min(nbytes, static_cast<int64_t>(this->data.size()) - position), int64_t{0});
+		std::copy(this->data.begin() + position, this->data.begin() + position + *bytesRead, out);
+		return arrow::Status::OK();
+	}
+
+	arrow::Status fetchSize(int64_t * size) override {
+		this->sizeRequests++;
+		*size = this->data.size();
+		return arrow::Status::OK();
+	}
+
+	std::vector<std::pair<int64_t, int64_t>> getRequests() {
+		std::lock_guard<std::mutex> lock(this->mutex);
+		std::vector<std::pair<int64_t, int64_t>> sortedRequests = this->requests;
+		std::sort(sortedRequests.begin(), sortedRequests.end());
+		return sortedRequests;
+	}
+
+	std::vector<uint8_t> data;
+	int sizeRequests = 0;
+
+private:
+	std::mutex mutex;
+	std::vector<std::pair<int64_t, int64_t>> requests;
+};
+
+static CoalescingReadOptions testOptions() {
+	CoalescingReadOptions options;
+	options.mergeGap = 100;
+	options.maxRequestSize = 1000;
+	options.prefetchSize = 10000;
+	return options;
+}
+
+static void expectBytes(const MemoryRangeSource & source, const std::vector<uint8_t> & buffer, int64_t position) {
+	for(size_t i = 0; i < buffer.size(); i++) {
+		ASSERT_EQ(buffer[i], source.data[position + i]) << "at byte " << position + i;
+	}
+}
+
+TEST(CoalescingReadableFileTest, SizeIsRequestedOnce) {
+	auto source = std::make_shared<MemoryRangeSource>(5000);
+	CoalescingReadableFile file(source, testOptions());
+
+	int64_t size = 0;
+	ASSERT_TRUE(file.GetSize(&size).ok());
+	ASSERT_TRUE(file.GetSize(&size).ok());
+
+	std::vector<uint8_t> buffer(10);
+	int64_t bytesRead = 0;
+	ASSERT_TRUE(file.ReadAt(100, 10, &bytesRead, buffer.data()).ok());
+
+	EXPECT_EQ(size, 5000);
+	EXPECT_EQ(source->sizeRequests, 1);
+}
+
+TEST(CoalescingReadableFileTest, NearbyRangesAreMerged) {
+	auto source = std::make_shared<MemoryRangeSource>(5000);
+	CoalescingReadableFile file(source, testOptions());
+
+	file.willNeed({{300, 50}, {0, 100}, {150, 100}, {2000, 100}});
+
+	std::vector<uint8_t> buffer(50);
+	int64_t bytesRead = 0;
+	ASSERT_TRUE(file.ReadAt(300, 50, &bytesRead, buffer.data()).ok());
+	EXPECT_EQ(bytesRead, 50);
+	expectBytes(*source, buffer, 300);
+
+	ASSERT_TRUE(file.ReadAt(2000, 50, &bytesRead, buffer.data()).ok());
+	expectBytes(*source, buffer, 2000);
+
+	// the first three ranges are less than mergeGap apart
+	std::vector<std::pair<int64_t, int64_t>> expected{{0, 350}, {2000, 100}};
+	EXPECT_EQ(source->getRequests(), expected);
+}
+
+TEST(CoalescingReadableFileTest, LargeReadsAreSplit) {
+	auto source = std::make_shared<MemoryRangeSource>(5000);
+	CoalescingReadableFile file(source, testOptions());
+
+	std::vector<uint8_t> buffer(2500);
+	int64_t bytesRead = 0;
+	ASSERT_TRUE(file.ReadAt(500, 2500, &bytesRead, buffer.data()).ok());
+	EXPECT_EQ(bytesRead, 2500);
+	expectBytes(*source, buffer, 500);
+
+	std::vector<std::pair<int64_t, int64_t>> expected{{500, 1000}, {1500, 1000}, {2500, 500}};
+	EXPECT_EQ(source->getRequests(), expected);
+}
+
+TEST(CoalescingReadableFileTest, ReadsAcrossFetchedAndMissingRanges) {
+	auto source = std::make_shared<MemoryRangeSource>(5000);
+	CoalescingReadableFile file(source, testOptions());
+
+	file.willNeed({{1000, 200}});
+
+	std::vector<uint8_t> buffer(400);
+	int64_t bytesRead = 0;
+	ASSERT_TRUE(file.ReadAt(900, 400, &bytesRead, buffer.data()).ok());
+	EXPECT_EQ(bytesRead, 400);
+	expectBytes(*source, buffer, 900);
+
+	std::vector<std::pair<int64_t, int64_t>> expected{{900, 100}, {1000, 200}, {1200, 100}};
+	EXPECT_EQ(source->getRequests(), expected);
+}
+
+TEST(CoalescingReadableFileTest, PrefetchStaysWithinBudget) {
+	auto source = std::make_shared<MemoryRangeSource>(50000);
+	CoalescingReadOptions options = testOptions();
+	options.prefetchSize = 2000;
+	CoalescingReadableFile file(source, options);
+
+	file.willNeed({{0, 3000}, {10000, 1000}});
+	// reading the first range lets the rest be fetched
+	std::vector<uint8_t> buffer(3000);
+	int64_t bytesRead = 0;
+	ASSERT_TRUE(file.ReadAt(0, 3000, &bytesRead, buffer.data()).ok());
+	expectBytes(*source, buffer, 0);
+	ASSERT_TRUE(file.ReadAt(10000, 1000, &bytesRead, buffer.data()).ok());
+	EXPECT_EQ(bytesRead, 1000);
+
+	std::vector<std::pair<int64_t, int64_t>> expected{{0, 1000}, {1000, 1000}, {2000, 1000}, {10000, 1000}};
+	EXPECT_EQ(source->getRequests(), expected);
+}
+
+TEST(CoalescingReadableFileTest, SequentialReadsStopAtEndOfFile) {
+	auto source = std::make_shared<MemoryRangeSource>(250);
+	CoalescingReadableFile file(source, testOptions());
+
+	std::shared_ptr<arrow::Buffer> buffer;
+	ASSERT_TRUE(file.Read(200, &buffer).ok());
+	EXPECT_EQ(buffer->size(), 200);
+	ASSERT_TRUE(file.Read(200, &buffer).ok());
+	EXPECT_EQ(buffer->size(), 50);
+	EXPECT_EQ(buffer->data()[0], source->data[200]);
+
+	int64_t position = 0;
+	file.Tell(&position);
+	EXPECT_EQ(position, 250);
+}
+
+TEST(CoalescingReadableFileTest, PartlyReadRangesAreTrimmed) {
+	auto source = std::make_shared<MemoryRangeSource>(5000);
+	CoalescingReadOptions options = testOptions();
+	options.prefetchSize = 800;
+	CoalescingReadableFile file(source, options);
+
+	// the first two ranges are fetched together and fill the budget
+	file.willNeed({{0, 400}, {450, 400}, {3000, 500}});
+
+	std::vector<uint8_t> buffer(400);
+	int64_t bytesRead = 0;
+	ASSERT_TRUE(file.ReadAt(0, 400, &bytesRead, buffer.data()).ok());
+	expectBytes(*source, buffer, 0);
+
+	// the bytes read and the gap after them are dropped, which leaves room to prefetch the last range whole
+	std::vector<uint8_t> smallBuffer(100);
+	ASSERT_TRUE(file.ReadAt(3000, 100, &bytesRead, smallBuffer.data()).ok());
+	EXPECT_EQ(bytesRead, 100);
+	expectBytes(*source, smallBuffer, 3000);
+
+	ASSERT_TRUE(file.ReadAt(450, 400, &bytesRead, buffer.data()).ok());
+	EXPECT_EQ(bytesRead, 400);
+	expectBytes(*source, buffer, 450);
+
+	std::vector<std::pair<int64_t, int64_t>> expected{{0, 850}, {3000, 500}};
+	EXPECT_EQ(source->getRequests(), expected);
+}
+
+TEST(CoalescingReadableFileTest, RangesAreKeptUntilAllAnnouncedBytesAreRead) {
+	auto source = std::make_shared<MemoryRangeSource>(5000);
+	CoalescingReadableFile file(source, testOptions());
+
+	file.willNeed({{0, 400}, {450, 400}});
+
+	// reading the end of the range first does not release the start
+	std::vector<uint8_t> buffer(400);
+	int64_t bytesRead = 0;
+	ASSERT_TRUE(file.ReadAt(450, 400, &bytesRead, buffer.data()).ok());
+	expectBytes(*source, buffer, 450);
+	ASSERT_TRUE(file.ReadAt(0, 400, &bytesRead, buffer.data()).ok());
+	expectBytes(*source, buffer, 0);
+
+	std::vector<std::pair<int64_t, int64_t>> expected{{0, 850}};
+	EXPECT_EQ(source->getRequests(), expected);
+}
@@ -9,6 +9,7 @@ from urllib.parse import urlparse
 from threading import Lock
 from weakref import ref
 from pyblazing.apiv2.filesystem import FileSystem
+from pyblazing.apiv2.filesystem import setFileCache
 from pyblazing.apiv2 import DataType
 
 
@@ -36,6 +37,7 @@ import dask.distributed
 import netifaces as ni
 
 import random
+import heapq
 
 jpype.addClassPath(
     os.path.join(
@@ -106,7 +108,8 @@ def checkSocket(socketNum):
     return socket_free
 
 
-def initializeBlazing(ralId=0, networkInterface='lo', singleNode=False):
+def initializeBlazing(ralId=0, networkInterface='lo', singleNode=False,
+                      config_options=None):
     #print(networkInterface)
     workerIp = ni.ifaddresses(networkInterface)[ni.AF_INET][0]['addr']
     ralCommunicationPort = random.randint(10000, 32000) + ralId
@@ -124,7 +127,8 @@ def initializeBlazing(ralId=0, networkInterface='lo', singleNode=False):
         networkInterface.encode(),
         workerIp.encode(),
         ralCommunicationPort,
-        singleNode)
+        singleNode,
+        config_options if config_options is not None else {})
     cwd = os.getcwd()
     return ralCommunicationPort, workerIp, cwd
 
@@ -224,6 +228,88 @@ def modifyAlgebraForDataframesWithOnlyWantedColumns(algebra, tableScanInfo,origi
             algebra = algebra.replace(orig_scan, new_scan)
     return algebra
 
+# the string literals, the quoted identifiers and the comments of a query
+SQL_TOKENS = re.compile(r"""('(?:[^']|'')*'|"(?:[^"]|"")*"|--[^\n]*|/\*.*?\*/)""", re.DOTALL)
+
+# removes the comments, collapses the whitespace outside of string literals and
+# quoted identifiers and removes the trailing semicolon, so that queries that
+# only differ in formatting share a plan
+def normalizeSql(sql):
+    parts = SQL_TOKENS.split(sql)
+    normalized = []
+    text = ''
+    for index, part in enumerate(parts):
+        if index % 2 == 0:
+            text = text + part
+        elif part[0] in '\'"':
+            normalized.append(re.sub(r'\s+', ' ', text))
+            normalized.append(part)
+            text = ''
+        else:
+            # a comment separates the tokens around it like a space
+            text = text + ' '
+    normalized.append(re.sub(r'\s+', ' ', text))
+    return ''.join(normalized).strip().rstrip(';').strip()
+
+# a table schema fingerprint, a plan is only valid while the fingerprints of
+# the tables it reads are the same ones it was planned with. The generation
+# changes every time a table is (re)created so that a table replaced by
+# another one with the same schema does not reuse the plan of the old one
+def getTableFingerprint(table, generation):
+    # the dtypes of a dask_cudf frame come from its metadata, nothing is computed
+    dtypes = table.input.dtypes
+    columns = tuple((str(name), str(dtype)) for name, dtype in dtypes.items())
+    files = tuple(table.files) if table.files is not None else None
+    return (generation, table.fileType, columns, files)
+
+# LRU cache of query plans. Each plan holds the optimized algebra, already
+# modified for the wanted columns, and the tables produced by
+# getTableScanInfoCaller, so a hit skips Calcite and the table scan parsing
+class PlanCache(object):
+    def __init__(self, capacity=256):
+        self.capacity = capacity
+        self.plans = OrderedDict()
+        self.hits = 0
+        self.misses = 0
+        self.lock = Lock()
+
+    def get(self, key, table_fingerprints):
+        with self.lock:
+            entry = self.plans.get(key)
+            if entry is not None:
+                fingerprints, plan = entry
+                if all(table_fingerprints.get(name) == fingerprint
+                       for name, fingerprint in fingerprints.items()):
+                    self.plans.move_to_end(key)
+                    self.hits = self.hits + 1
+                    return plan
+                del self.plans[key]
+            self.misses = self.misses + 1
+            return None
+
+    def put(self, key, fingerprints, plan):
+        if self.capacity <= 0:
+            return
+        with self.lock:
+            self.plans[key] = (fingerprints, plan)
+            self.plans.move_to_end(key)
+            while len(self.plans) > self.capacity:
+                self.plans.popitem(last=False)
+
+    # drops the plans that read table_name, they hold references to its data
+    def invalidate(self, table_name):
+        with self.lock:
+            for key in [key for key, (fingerprints, plan) in self.plans.items()
+                        if table_name in fingerprints]:
+                del self.plans[key]
+
+    def info(self):
+        with self.lock:
+            return {'hits': self.hits,
+                    'misses': self.misses,
+                    'size': len(self.plans),
+                    'capacity': self.capacity}
+
 class BlazingTable(object):
     def __init__(
             self,
@@ -233,6 +319,9 @@ class BlazingTable(object):
             datasource=[],
             calcite_to_file_indices=None,
             num_row_groups=None,
+            num_rows=None,
+            file_sizes=None,
+            row_group_ids=None,
             args={},
             convert_gdf_to_dask=False,
             convert_gdf_to_dask_partitions=1,
@@ -257,6 +346,14 @@ class BlazingTable(object):
 
         self.datasource = datasource
         self.num_row_groups = num_row_groups
+        # rows of each file, only known for parquet, used by the engine to
+        # pre-size the loaded columns
+        self.num_rows = num_rows if num_rows is not None and len(num_rows) > 0 else None
+        # bytes of each file, 0 when unknown, used to balance the scan
+        self.file_sizes = file_sizes if file_sizes is not None and len(file_sizes) > 0 else None
+        # row groups of each file this table reads, an empty list means all
+        # of them. Set on the slices of parquet files split between nodes
+        self.row_group_ids = row_group_ids
 
         self.args = args
         if fileType == DataType.CUDF or DataType.DASK_CUDF:
@@ -293,27 +390,100 @@ class BlazingTable(object):
 # until this is implemented we cant do self join with arrow tables
 #    def unionColumns(self,otherTable):
 
+    # estimated cost of scanning each file: its bytes when they are known,
+    # otherwise its rows, row groups or just 1
+    def _fileCosts(self):
+        if self.file_sizes is not None and len(self.file_sizes) == len(self.files) and \
+                all(size > 0 for size in self.file_sizes):
+            return list(self.file_sizes)
+        if self.num_rows is not None and len(self.num_rows) == len(self.files):
+            return [max(num_rows, 1) for num_rows in self.num_rows]
+        if self._canSplitFiles():
+            return [max(num_row_groups, 1) for num_row_groups in self.num_row_groups]
+        return [1] * len(self.files)
+
+    def _canSplitFiles(self):
+        return self.fileType == DataType.PARQUET and self.num_row_groups is not None and \
+            len(self.num_row_groups) == len(self.files) and self.row_group_ids is None
+
+    # assigns the files to numSlices slices so every slice costs about the
+    # same to scan. Parquet files that cost more than half a slice are split in
+    # ranges of row groups that can go to different slices. Returns, for each
+    # slice, a map of file index to the row groups to read (None for all)
+    def _balanceFiles(self, numSlices):
+        costs = self._fileCosts()
+        target = sum(costs) / numSlices
+        can_split = self._canSplitFiles()
+
+        pieces = []
+        for file_index, cost in enumerate(costs):
+            num_row_groups = self.num_row_groups[file_index] if can_split else 0
+            if num_row_groups > 1 and cost > target / 2:
+                row_groups_per_piece = max(int(num_row_groups * target / (2 * cost)), 1)
+                for first in range(0, num_row_groups, row_groups_per_piece):
+                    row_groups = list(range(first, min(first + row_groups_per_piece, num_row_groups)))
+                    pieces.append((cost * len(row_groups) / num_row_groups, file_index, row_groups))
+            else:
+                pieces.append((cost, file_index, None))
+
+        # the most expensive pieces first, each one to the slice with less work
+        pieces.sort(key=lambda piece: -piece[0])
+        slices = [OrderedDict() for _ in range(numSlices)]
+        loads = [(0, slice_index) for slice_index in range(numSlices)]
+        for cost, file_index, row_groups in pieces:
+            load, slice_index = heapq.heappop(loads)
+            slice_files = slices[slice_index]
+            if row_groups is None:
+                slice_files[file_index] = None
+            else:
+                slice_files[file_index] = slice_files.get(file_index, []) + row_groups
+            heapq.heappush(loads, (load + cost, slice_index))
+
+        for slice_files in slices:
+            for file_index, row_groups in slice_files.items():
+                if row_groups is not None and len(row_groups) == self.num_row_groups[file_index]:
+                    slice_files[file_index] = None
+                elif row_groups is not None:
+                    row_groups.sort()
+        return [OrderedDict(sorted(slice_files.items())) for slice_files in slices]
+
     def getSlices(self, numSlices):
         nodeFilesList = []
         if self.files is None:
             for i in range(0, numSlices):
                 nodeFilesList.append(BlazingTable(self.input, self.fileType))
             return nodeFilesList
-        remaining = len(self.files)
-        startIndex = 0
-        for i in range(0, numSlices):
-            batchSize = int(remaining / (numSlices - i))
-            # #print(batchSize)
-            # #print(startIndex)
-            tempFiles = self.files[startIndex: startIndex + batchSize]
-            uri_values = self.uri_values[startIndex: startIndex + batchSize]
+
+        for slice_files in self._balanceFiles(numSlices):
+            file_indices = list(slice_files.keys())
+            tempFiles = [self.files[i] for i in file_indices]
+            uri_values = self.uri_values
+            if len(self.uri_values) == len(self.files):
+                uri_values = [self.uri_values[i] for i in file_indices]
+            file_sizes = None
+            if self.file_sizes is not None:
+                file_sizes = [self.file_sizes[i] for i in file_indices]
 
             if self.num_row_groups is not None:
+                split = any(row_groups is not None for row_groups in slice_files.values())
+                row_group_ids = None
+                num_rows = None
+                num_row_groups = self.num_row_groups
+                if len(self.num_row_groups) == len(self.files):
+                    num_row_groups = [self.num_row_groups[i] for i in file_indices]
+                if split:
+                    row_group_ids = [row_groups if row_groups is not None else [] for row_groups in slice_files.values()]
+                elif self.num_rows is not None:
+                    # the engine only pre-sizes its output for whole files
+                    num_rows = [self.num_rows[i] for i in file_indices]
                 nodeFilesList.append(BlazingTable(self.input,
                                                   self.fileType,
                                                   files=tempFiles,
                                                   calcite_to_file_indices=self.calcite_to_file_indices,
-                                                  num_row_groups=self.num_row_groups[startIndex: startIndex + batchSize],
+                                                  num_row_groups=num_row_groups,
+                                                  num_rows=num_rows,
+                                                  file_sizes=file_sizes,
+                                                  row_group_ids=row_group_ids,
                                                   uri_values=uri_values,
                                                   args=self.args))
             else:
@@ -323,10 +493,9 @@ class BlazingTable(object):
                         self.fileType,
                         files=tempFiles,
                         calcite_to_file_indices=self.calcite_to_file_indices,
+                        file_sizes=file_sizes,
                         uri_values=uri_values,
                         args=self.args))
-            startIndex = startIndex + batchSize
-            remaining = remaining - batchSize
         return nodeFilesList
 
     def get_partitions(self, worker):
@@ -335,10 +504,21 @@ class BlazingTable(object):
 
 class BlazingContext(object):
 
-    def __init__(self, dask_client=None, network_interface=None):
+    def __init__(self, dask_client=None, network_interface=None, plan_cache_size=256,
+                 config_options=None):
         """
         :param connection: BlazingSQL cluster URL to connect to
             (e.g. 125.23.14.1:8889, blazingsql-gateway:7887).
+        :param plan_cache_size: number of query plans to keep, 0 disables
+            the plan cache
+        :param config_options: engine options given to every node, e.g.
+            RECEIVE_CREDIT_LIMIT and RECEIVE_TOTAL_CREDIT_LIMIT, the bytes of
+            the partitions of each sending node and query, and of all of
+            them, that a node keeps waiting to be merged, and
+            TRANSPORT_COMPRESSION, the codec of the buffers sent between the
+            nodes: none, lz4, zstd or automatic (the default), and
+            GROUP_BY_RANGE_PARTITIONING, True to send the groups of a
+            distributed GROUP BY by sampled ranges instead of by hash
         """
         self.lock = Lock()
         self.finalizeCaller = ref(cio.finalizeCaller)
@@ -363,6 +543,7 @@ class BlazingContext(object):
                         ralId=i,
                         networkInterface=network_interface,
                         singleNode=False,
+                        config_options=config_options,
                         workers=[worker]))
                 worker_list.append(worker)
                 i = i + 1
@@ -380,7 +561,8 @@ class BlazingContext(object):
                 i = i + 1
         else:
             ralPort, ralIp, cwd = initializeBlazing(
-                ralId=0, networkInterface='lo', singleNode=True)
+                ralId=0, networkInterface='lo', singleNode=True,
+                config_options=config_options)
             node = {}
             node['ip'] = ralIp
             node['communication_port'] = ralPort
@@ -396,6 +578,9 @@ class BlazingContext(object):
         self.schema = BlazingSchemaClass(self.db)
         self.generator = RelationalAlgebraGeneratorClass(self.schema)
         self.tables = {}
+        self.table_fingerprints = {}
+        self.table_generation = 0
+        self.plan_cache = PlanCache(plan_cache_size)
         self.logs_initialized = False
 
         # waitForPingSuccess(self.client)
@@ -435,6 +620,32 @@ class BlazingContext(object):
     def show_filesystems(self):
         print(self.fs)
 
+    # Use result, error_msg = file_cache(directory) before registering the
+    # remote file systems (s3, gs, hdfs) that should be read through it
+    def file_cache(self, directory, **kwargs):
+        """
+        Caches the files read from remote file systems on a local disk, in
+        blocks keyed by file and version (ETag), evicting the least recently
+        used blocks.
+
+        :param directory: local directory for the cached blocks
+        :param capacity: bytes the cache can use, 0 disables it
+        :param block_size: size of the cached blocks in bytes
+        """
+        capacity = kwargs.get('capacity', 10 * 1024 * 1024 * 1024)
+        block_size = kwargs.get('block_size', 4 * 1024 * 1024)
+        return setFileCache(self.dask_client, directory, capacity, block_size)
+
+    def file_cache_info(self):
+        """
+        :return: hits, misses, evictions, blocks, size and capacity of the
+            file cache of each node
+        """
+        if self.dask_client is None:
+            return [cio.getFileCacheInfoCaller()]
+        engine_info = self.dask_client.run(cio.getFileCacheInfoCaller)
+        return [engine_info[node['worker']] for node in self.nodes]
+
     # END  FileSystem interface
     def _to_url(self, str_input):
         url = urlparse(str_input)
@@ -473,11 +684,16 @@ class BlazingContext(object):
                 self.db.addTable(tableJava)
                 self.schema = BlazingSchemaClass(self.db)
                 self.generator = RelationalAlgebraGeneratorClass(self.schema)
+                self.table_generation = self.table_generation + 1
+                self.table_fingerprints[tableName] = getTableFingerprint(
+                    table, self.table_generation)
             else:
                 self.db.removeTable(tableName)
                 self.schema = BlazingSchemaClass(self.db)
                 self.generator = RelationalAlgebraGeneratorClass(self.schema)
                 del self.tables[tableName]
+                del self.table_fingerprints[tableName]
+            self.plan_cache.invalidate(tableName)
         finally:
             self.lock.release()
 
@@ -531,6 +747,8 @@ class BlazingContext(object):
                 datasource=parsedSchema['datasource'],
                 calcite_to_file_indices=parsedSchema['calcite_to_file_indices'],
                 num_row_groups=parsedSchema['num_row_groups'],
+                num_rows=parsedSchema['num_rows'],
+                file_sizes=parsedSchema['file_sizes'],
                 args=parsedSchema['args'],
                 uri_values=uri_values,
                 in_file=in_file)
@@ -570,20 +788,31 @@ class BlazingContext(object):
         # table , tells us partitions that map to that table
 
         if (algebra is None):
-            algebra = self.explain(sql)
+            plan_key = ('sql', normalizeSql(sql))
+        else:
+            plan_key = ('algebra', algebra)
+        plan = self.plan_cache.get(plan_key, self.table_fingerprints)
 
-        if self.dask_client is None:
-            new_tables, relational_algebra_steps = cio.getTableScanInfoCaller(algebra,self.tables)
+        if plan is not None:
+            algebra, new_tables = plan
         else:
-            worker = tuple(self.dask_client.scheduler_info()['workers'])[0]
-            connection = self.dask_client.submit(
-                cio.getTableScanInfoCaller,
-                algebra,
-                self.tables,
-                workers=[worker])
-            new_tables, relational_algebra_steps = connection.result()
+            if (algebra is None):
+                algebra = self.explain(sql)
 
-        algebra = modifyAlgebraForDataframesWithOnlyWantedColumns(algebra, relational_algebra_steps,self.tables)
+            if self.dask_client is None:
+                new_tables, relational_algebra_steps = cio.getTableScanInfoCaller(algebra,self.tables)
+            else:
+                worker = tuple(self.dask_client.scheduler_info()['workers'])[0]
+                connection = self.dask_client.submit(
+                    cio.getTableScanInfoCaller,
+                    algebra,
+                    self.tables,
+                    workers=[worker])
+                new_tables, relational_algebra_steps = connection.result()
+
+            algebra = modifyAlgebraForDataframesWithOnlyWantedColumns(algebra, relational_algebra_steps,self.tables)
+            fingerprints = {table: self.table_fingerprints[table] for table in new_tables}
+            self.plan_cache.put(plan_key, fingerprints, (algebra, new_tables))
         #print (new_tables)
         for table in new_tables:
             fileTypes.append(new_tables[table].fileType)
@@ -638,6 +867,19 @@ class BlazingContext(object):
             result = dask.dataframe.from_delayed(dask_futures)
         return result
 
+    def plan_cache_info(self):
+        """
+        :return: hits, misses, size and capacity of the query plan cache.
+            'engine' has the counters of the parsed plan cache of each node
+        """
+        info = self.plan_cache.info()
+        if self.dask_client is None:
+            info['engine'] = [cio.getPlanCacheInfoCaller()]
+        else:
+            engine_info = self.dask_client.run(cio.getPlanCacheInfoCaller)
+            info['engine'] = [engine_info[node['worker']] for node in self.nodes]
+        return info
+
     # END SQL interface
 
     # BEGIN LOG interface
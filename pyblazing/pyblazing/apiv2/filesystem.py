@@ -38,6 +38,34 @@ def registerFileSystem(client, fs, root, prefix):
     return ok, msg, fs
 
 
+def setFileCache(client, directory, capacity, block_size):
+    ok = False
+    msg = ""
+    if client is None:
+        ok, msg = cio.setFileCacheCaller(directory, capacity, block_size)
+        msg = msg.decode("utf-8")
+        if not ok:
+            print(msg)
+    else:
+        # every worker keeps its own cache, in the same local directory
+        dask_futures = []
+        for worker in list(client.scheduler_info()["workers"]):
+            dask_futures.append(
+                client.submit(
+                    cio.setFileCacheCaller,
+                    directory,
+                    capacity,
+                    block_size,
+                    pure=False,
+                    workers=[worker]))
+        for connection in dask_futures:
+            ok, msg = connection.result()
+            msg = msg.decode("utf-8")
+            if not ok:
+                print(msg + " with dask worker")
+    return ok, msg
+
+
 class FileSystem(object):
 
     def __init__(self):
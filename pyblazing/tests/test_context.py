@@ -2,7 +2,11 @@ import unittest
 
 import blazingsql
 
+from collections import OrderedDict
 from cudf import DataFrame
+from pyblazing.apiv2 import DataType
+from pyblazing.apiv2.context import BlazingTable
+from pyblazing.apiv2.context import normalizeSql
 import pandas as pd
 import pyarrow as pa
 
@@ -168,5 +172,91 @@ class TestCreateTableFromGDF(unittest.TestCase):
         print(now)
 
 
+class TestBalanceFiles(unittest.TestCase):
+
+    def table(self, fileType, files, file_sizes=None, num_row_groups=None, num_rows=None):
+        return BlazingTable(None, fileType, files=files, file_sizes=file_sizes,
+                            num_row_groups=num_row_groups, num_rows=num_rows)
+
+    def test_uneven_file_sizes(self):
+        table = self.table(DataType.CSV, ['a.csv', 'b.csv', 'c.csv', 'd.csv', 'e.csv'],
+                           file_sizes=[100, 10, 10, 10, 70])
+
+        self.assertFalse(table._canSplitFiles())
+        # the largest file alone, the rest together cost the same
+        self.assertEqual(table._balanceFiles(2),
+                         [OrderedDict([(0, None)]),
+                          OrderedDict([(1, None), (2, None), (3, None), (4, None)])])
+
+        slices = table.getSlices(2)
+        self.assertEqual(slices[0].files, ['a.csv'])
+        self.assertEqual(slices[1].files, ['b.csv', 'c.csv', 'd.csv', 'e.csv'])
+        self.assertEqual(slices[1].file_sizes, [10, 10, 10, 70])
+
+    def test_split_files(self):
+        table = self.table(DataType.PARQUET, ['a.parquet', 'b.parquet'],
+                           file_sizes=[800, 100], num_row_groups=[8, 1], num_rows=[8000, 1000])
+
+        self.assertTrue(table._canSplitFiles())
+        # the large file is split in pieces of two row groups
+        self.assertEqual(table._balanceFiles(2),
+                         [OrderedDict([(0, [0, 1, 4, 5]), (1, None)]),
+                          OrderedDict([(0, [2, 3, 6, 7])])])
+
+        slices = table.getSlices(2)
+        self.assertEqual(slices[0].files, ['a.parquet', 'b.parquet'])
+        self.assertEqual(slices[0].row_group_ids, [[0, 1, 4, 5], []])
+        self.assertEqual(slices[1].files, ['a.parquet'])
+        self.assertEqual(slices[1].row_group_ids, [[2, 3, 6, 7]])
+        # the engine only pre-sizes whole files
+        self.assertIsNone(slices[0].num_rows)
+        # slices are not split again
+        self.assertFalse(slices[0]._canSplitFiles())
+
+    def test_split_files_without_sizes(self):
+        table = self.table(DataType.PARQUET, ['a.parquet', 'b.parquet', 'c.parquet'],
+                           file_sizes=[0, 0, 0], num_row_groups=[4, 1, 1], num_rows=[400, 100, 100])
+
+        # the costs are the rows when a size is unknown
+        self.assertEqual(table._balanceFiles(2),
+                         [OrderedDict([(0, [0, 2]), (1, None)]),
+                          OrderedDict([(0, [1, 3]), (2, None)])])
+
+    def test_single_slice_reads_whole_files(self):
+        table = self.table(DataType.PARQUET, ['a.parquet', 'b.parquet'],
+                           file_sizes=[800, 100], num_row_groups=[8, 1], num_rows=[8000, 1000])
+
+        self.assertEqual(table._balanceFiles(1), [OrderedDict([(0, None), (1, None)])])
+
+        slices = table.getSlices(1)
+        self.assertIsNone(slices[0].row_group_ids)
+        self.assertEqual(slices[0].num_rows, [8000, 1000])
+
+
+
+class TestNormalizeSql(unittest.TestCase):
+
+    def test_formatting_is_ignored(self):
+        self.assertEqual(normalizeSql("select a,\n  b\tfrom t ;"), normalizeSql("select a, b from t"))
+        self.assertEqual(normalizeSql("select a /* the key */ from t"), normalizeSql("select a from t"))
+
+    def test_string_literals_are_kept(self):
+        self.assertNotEqual(normalizeSql("select * from t where s = 'a  b'"),
+                            normalizeSql("select * from t where s = 'a b'"))
+        self.assertNotEqual(normalizeSql("select * from t where s = 'it''s  -- here'"),
+                            normalizeSql("select * from t where s = 'it''s'"))
+
+    def test_quoted_identifiers_are_kept(self):
+        self.assertNotEqual(normalizeSql('select "a  b" from t'), normalizeSql('select "a b" from t'))
+
+    def test_line_comments_end_at_the_newline(self):
+        # the WHERE is part of the comment in the second query
+        self.assertNotEqual(normalizeSql("select a from t -- note\nWHERE x = 1"),
+                            normalizeSql("select a from t -- note WHERE x = 1"))
+        self.assertEqual(normalizeSql("select a from t -- note\nWHERE x = 1"),
+                         normalizeSql("select a from t WHERE x = 1"))
+        self.assertEqual(normalizeSql("select a from t -- note WHERE x = 1"), normalizeSql("select a from t"))
+
+
 if __name__ == '__main__':
     unittest.main()